@@ -23,9 +23,15 @@ namespace adria
 	{
 		g_ThreadPool.Initialize();
 		GfxShaderCompiler::Initialize();
-		gfx = std::make_unique<GfxDevice>(window, init.gfx_options);
 		ShaderManager::Initialize(init.gfx_options.shader_debug);
+		//the Aftermath tracker created with the device needs to see every compiled shader, background precompilation does not broadcast them
+		Bool const background_shader_precompile = init.gfx_options.background_shader_precompile && !init.gfx_options.aftermath;
+		if (background_shader_precompile) ShaderManager::PrecompileShaders(true);
+		gfx = std::make_unique<GfxDevice>(window, init.gfx_options);
+		if (!background_shader_precompile) ShaderManager::PrecompileShaders(false);
 		g_TextureManager.Initialize(gfx.get());
+		//background precompilation overlaps device and texture manager creation, it is joined before the renderer creates its PSOs
+		ShaderManager::WaitForPrecompile();
 		renderer = std::make_unique<Renderer>(reg, gfx.get(), window->Width(), window->Height());
 		scene_loader = std::make_unique<SceneLoader>(reg, gfx.get());
 
@@ -71,6 +77,11 @@ namespace adria
 		static Timer timer;
 		Float const dt = timer.MarkInSeconds();
 		g_Input.Tick();
+		if (ShaderManager::HasRecompiledShaders())
+		{
+			gfx->WaitForGPU();
+			ShaderManager::SwapRecompiledShaders();
+		}
 		Update(dt);
 		Render();
 	}
@@ -29,6 +29,8 @@ namespace adria
 
 	std::string const paths::ShaderCacheDir = SavedDir + "ShaderCache/";
 
+	std::string const paths::ModelCacheDir = SavedDir + "ModelCache/";
+
 	std::string const paths::ShaderPDBDir = SavedDir + "ShaderPDB/";
 
 	std::string const paths::IniDir = SavedDir + "Ini/";
@@ -19,6 +19,7 @@ namespace adria::paths
 	extern std::string const PixCapturesDir;
 	extern std::string const RenderGraphDir;
 	extern std::string const ShaderCacheDir;
+	extern std::string const ModelCacheDir;
 	extern std::string const ShaderPDBDir;
 	extern std::string const IniDir;
 	extern std::string const ScenesDir;
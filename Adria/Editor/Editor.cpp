@@ -610,6 +610,40 @@ namespace adria
 					ImGui::SliderFloat("Emissive Factor", &material->emissive_factor, 0.0f, 32.0f);
 				}
 
+				auto mesh = engine->reg.try_get<Mesh>(selected_entity);
+				if (mesh && ImGui::CollapsingHeader("Mesh"))
+				{
+					//meshes are only changed through patch, the renderer packs the patched mesh again instead of the whole scene
+					ImGui::PushID("Mesh");
+					Vector3 translation(0.0f, 0.0f, 0.0f);
+					if (ImGui::DragFloat3("Move", &translation.x, 0.1f))
+					{
+						engine->reg.patch<Mesh>(selected_entity, [&translation](Mesh& patched_mesh)
+						{
+							Matrix const translation_matrix = Matrix::CreateTranslation(translation);
+							for (SubMeshInstance& instance : patched_mesh.instances) instance.world_transform *= translation_matrix;
+						});
+					}
+
+					if (!mesh->materials.empty())
+					{
+						static Int material_index = 0;
+						material_index = std::clamp(material_index, 0, (Int)mesh->materials.size() - 1);
+						ImGui::SliderInt("Material", &material_index, 0, (Int)mesh->materials.size() - 1);
+
+						Material material = mesh->materials[material_index];
+						Bool material_changed = ImGui::ColorEdit3("Base Color", material.albedo_color);
+						material_changed |= ImGui::SliderFloat("Metallic Factor", &material.metallic_factor, 0.0f, 1.0f);
+						material_changed |= ImGui::SliderFloat("Roughness Factor", &material.roughness_factor, 0.0f, 1.0f);
+						material_changed |= ImGui::SliderFloat("Emissive Factor", &material.emissive_factor, 0.0f, 32.0f);
+						if (material_changed)
+						{
+							engine->reg.patch<Mesh>(selected_entity, [&material](Mesh& patched_mesh) { patched_mesh.materials[material_index] = material; });
+						}
+					}
+					ImGui::PopID();
+				}
+
 				auto transform = engine->reg.try_get<Transform>(selected_entity);
 				if (transform && ImGui::CollapsingHeader("Transform"))
 				{
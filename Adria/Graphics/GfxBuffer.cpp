@@ -2,36 +2,45 @@
 #include "GfxDevice.h"
 #include "GfxCommandList.h"
 #include "GfxLinearDynamicAllocator.h"
+#include "GfxHeap.h"
 
 #include <format>
 
 namespace adria
 {
+	namespace
+	{
+		void InitD3D12ResourceDesc(GfxBufferDesc const& desc, D3D12_RESOURCE_DESC& resource_desc)
+		{
+			UINT64 buffer_size = desc.size;
+			if (HasAllFlags(desc.misc_flags, GfxBufferMiscFlag::ConstantBuffer))
+				buffer_size = Align(buffer_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+			resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+			resource_desc.Format = DXGI_FORMAT_UNKNOWN;
+			resource_desc.Width = buffer_size;
+			resource_desc.Height = 1;
+			resource_desc.MipLevels = 1;
+			resource_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+			resource_desc.DepthOrArraySize = 1;
+			resource_desc.Alignment = 0;
+			resource_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+			resource_desc.SampleDesc.Count = 1;
+			resource_desc.SampleDesc.Quality = 0;
+
+			if (HasAllFlags(desc.bind_flags, GfxBindFlag::UnorderedAccess))
+				resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+			if (!HasAllFlags(desc.bind_flags, GfxBindFlag::ShaderResource))
+				resource_desc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+		}
+	}
 
 	GfxBuffer::GfxBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data) : gfx(gfx), desc(desc)
 	{
-		UINT64 buffer_size = desc.size;
-		if (HasAllFlags(desc.misc_flags, GfxBufferMiscFlag::ConstantBuffer))
-			buffer_size = Align(buffer_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
-
 		D3D12_RESOURCE_DESC resource_desc{};
-		resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		resource_desc.Format = DXGI_FORMAT_UNKNOWN;
-		resource_desc.Width = buffer_size;
-		resource_desc.Height = 1;
-		resource_desc.MipLevels = 1;
-		resource_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		resource_desc.DepthOrArraySize = 1;
-		resource_desc.Alignment = 0;
-		resource_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-		resource_desc.SampleDesc.Count = 1;
-		resource_desc.SampleDesc.Quality = 0;
-
-		if (HasAllFlags(desc.bind_flags, GfxBindFlag::UnorderedAccess))
-			resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-
-		if (!HasAllFlags(desc.bind_flags, GfxBindFlag::ShaderResource))
-			resource_desc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+		InitD3D12ResourceDesc(desc, resource_desc);
+		UINT64 const buffer_size = resource_desc.Width;
 
 		D3D12_RESOURCE_STATES resource_state = D3D12_RESOURCE_STATE_COMMON;
 		if (HasAllFlags(desc.misc_flags, GfxBufferMiscFlag::AccelStruct))
@@ -104,6 +113,40 @@ namespace adria
 		}
 	}
 
+	GfxBuffer::GfxBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxHeap const& heap, Uint64 heap_offset) : gfx(gfx), desc(desc)
+	{
+		ADRIA_ASSERT(desc.resource_usage == GfxResourceUsage::Default);
+		ADRIA_ASSERT(!HasAllFlags(desc.misc_flags, GfxBufferMiscFlag::AccelStruct));
+
+		D3D12_RESOURCE_DESC resource_desc{};
+		InitD3D12ResourceDesc(desc, resource_desc);
+
+		HRESULT hr = E_FAIL;
+		auto allocator = gfx->GetAllocator();
+		if (gfx->GetCapabilities().SupportsEnhancedBarriers())
+		{
+			D3D12_RESOURCE_DESC1 resource_desc1 = CD3DX12_RESOURCE_DESC1(resource_desc);
+			hr = allocator->CreateAliasingResource2(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc1,
+				D3D12_BARRIER_LAYOUT_UNDEFINED,
+				nullptr, 0, nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		else
+		{
+			hr = allocator->CreateAliasingResource(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc,
+				D3D12_RESOURCE_STATE_COMMON,
+				nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		GFX_CHECK_HR(hr);
+	}
+
 	GfxBuffer::~GfxBuffer()
 	{
 		if (mapped_data != nullptr)
@@ -112,6 +155,8 @@ namespace adria
 			resource->Unmap(0, nullptr);
 			mapped_data = nullptr;
 		}
+		//placed buffers alias heap memory that frames in flight may still read, release them with the queue like textures
+		if (!allocation) gfx->AddToReleaseQueue(resource.Detach());
 	}
 
 	void* GfxBuffer::GetMappedData() const
@@ -200,6 +245,14 @@ namespace adria
 		}
 	}
 
+	GfxAllocationInfo GfxBuffer::GetAllocationInfo(GfxDevice* gfx, GfxBufferDesc const& desc)
+	{
+		D3D12_RESOURCE_DESC resource_desc{};
+		InitD3D12ResourceDesc(desc, resource_desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info = gfx->GetDevice()->GetResourceAllocationInfo(0, 1, &resource_desc);
+		return GfxAllocationInfo{ .size = allocation_info.SizeInBytes, .alignment = allocation_info.Alignment };
+	}
+
 	void GfxBuffer::SetName(Char const* name)
 	{
 		resource->SetName(ToWideString(name).c_str());
@@ -3,6 +3,9 @@
 
 namespace adria
 {
+	class GfxHeap;
+	struct GfxAllocationInfo;
+
 	struct GfxBufferDesc
 	{
 		Uint64 size = 0;
@@ -34,6 +37,7 @@ namespace adria
 	{
 	public:
 		GfxBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data = {});
+		GfxBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxHeap const& heap, Uint64 heap_offset); //placed buffer, aliases the heap memory at heap_offset
 		ADRIA_NONCOPYABLE_NONMOVABLE(GfxBuffer)
 		~GfxBuffer();
 
@@ -58,6 +62,8 @@ namespace adria
 
 		void SetName(Char const* name);
 
+		static GfxAllocationInfo GetAllocationInfo(GfxDevice* gfx, GfxBufferDesc const& desc);
+
 	private:
 		GfxDevice* gfx;
 		Ref<ID3D12Resource> resource;
@@ -375,6 +375,38 @@ namespace adria
 		}
 	}
 
+	void GfxCommandList::TextureBarrierBegin(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		TextureBarrier(texture, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+		else texture_barriers.back().SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::TextureBarrierEnd(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		TextureBarrier(texture, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+		else texture_barriers.back().SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::BufferBarrierBegin(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		BufferBarrier(buffer, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+		else buffer_barriers.back().SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::BufferBarrierEnd(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		BufferBarrier(buffer, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+		else buffer_barriers.back().SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
 	void GfxCommandList::GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after)
 	{
 		if (use_legacy_barriers)
@@ -402,6 +434,66 @@ namespace adria
 		}
 	}
 
+	void GfxCommandList::TextureAliasingBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		if (use_legacy_barriers)
+		{
+			D3D12_RESOURCE_BARRIER barrier{};
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			barrier.Aliasing.pResourceBefore = nullptr;
+			barrier.Aliasing.pResourceAfter = texture.GetNative();
+			legacy_barriers.push_back(barrier);
+
+			//render targets and depth stencils that start using aliased memory must be discarded or fully cleared before use
+			if (HasAnyFlag(flags_before, GfxResourceState::RTV | GfxResourceState::DSV))
+			{
+				FlushBarriers();
+				cmd_list->DiscardResource(texture.GetNative(), nullptr);
+				++command_count;
+			}
+			if (flags_before != flags_after) TextureBarrier(texture, flags_before, flags_after);
+		}
+		else
+		{
+			D3D12_TEXTURE_BARRIER barrier{};
+			barrier.SyncBefore = D3D12_BARRIER_SYNC_ALL;
+			barrier.SyncAfter = ToD3D12BarrierSync(flags_after);
+			barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+			barrier.AccessAfter = ToD3D12BarrierAccess(flags_after);
+			barrier.LayoutBefore = D3D12_BARRIER_LAYOUT_UNDEFINED;
+			barrier.LayoutAfter = ToD3D12BarrierLayout(flags_after);
+			barrier.pResource = texture.GetNative();
+			barrier.Subresources = CD3DX12_BARRIER_SUBRESOURCE_RANGE(D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+			barrier.Flags = D3D12_TEXTURE_BARRIER_FLAG_DISCARD;
+			texture_barriers.push_back(barrier);
+		}
+	}
+
+	void GfxCommandList::BufferAliasingBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		if (use_legacy_barriers)
+		{
+			D3D12_RESOURCE_BARRIER barrier{};
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			barrier.Aliasing.pResourceBefore = nullptr;
+			barrier.Aliasing.pResourceAfter = buffer.GetNative();
+			legacy_barriers.push_back(barrier);
+			if (flags_before != flags_after) BufferBarrier(buffer, flags_before, flags_after);
+		}
+		else
+		{
+			D3D12_BUFFER_BARRIER barrier{};
+			barrier.SyncBefore = D3D12_BARRIER_SYNC_ALL;
+			barrier.SyncAfter = ToD3D12BarrierSync(flags_after);
+			barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+			barrier.AccessAfter = ToD3D12BarrierAccess(flags_after);
+			barrier.pResource = buffer.GetNative();
+			barrier.Offset = 0;
+			barrier.Size = UINT64_MAX;
+			buffer_barriers.push_back(barrier);
+		}
+	}
+
 	void GfxCommandList::FlushBarriers()
 	{
 		if (use_legacy_barriers)
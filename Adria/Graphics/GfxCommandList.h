@@ -56,6 +56,8 @@ namespace adria
 		void Submit();
 		void SignalAll();
 		void ResetState();
+		Bool HasPendingWaits() const { return !pending_waits.empty(); }
+		Bool HasPendingSignals() const { return !pending_signals.empty(); }
 
 		void BeginQuery(GfxQueryHeap& query_heap, Uint32 index);
 		void EndQuery(GfxQueryHeap& query_heap, Uint32 index);
@@ -73,7 +75,13 @@ namespace adria
 
 		void TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
 		void BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
+		void TextureBarrierBegin(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after);
+		void TextureBarrierEnd(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after);
+		void BufferBarrierBegin(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
+		void BufferBarrierEnd(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
 		void GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after);
+		void TextureAliasingBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after);
+		void BufferAliasingBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
 		void FlushBarriers();
 
 		void CopyBuffer(GfxBuffer& dst, GfxBuffer const& src);
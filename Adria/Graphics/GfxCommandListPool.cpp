@@ -15,40 +15,41 @@ namespace adria
 	}
 	GfxCommandList* GfxCommandListPool::GetLatestCmdList() const
 	{
-		return cmd_lists.back().get();
+		return cmd_lists[active_count - 1].get();
 	}
 
 	GfxCommandList* GfxCommandListPool::AllocateCmdList()
 	{
-		cmd_lists.push_back(std::make_unique<GfxCommandList>(gfx, type));
-		cmd_lists.back()->ResetAllocator();
-		cmd_lists.back()->Begin();
-		return cmd_lists.back().get();
+		//command lists allocated in previous frames are kept around and reused in allocation order
+		if (active_count == cmd_lists.size()) cmd_lists.push_back(std::make_unique<GfxCommandList>(gfx, type));
+		GfxCommandList* cmd_list = cmd_lists[active_count++].get();
+		cmd_list->ResetAllocator();
+		cmd_list->Begin();
+		return cmd_list;
 	}
 	void GfxCommandListPool::FreeCmdList(GfxCommandList* _cmd_list)
 	{
-		for (auto& cmd_list : cmd_lists)
+		for (Uint64 i = 0; i < active_count; ++i)
 		{
-			if (cmd_list.get() == _cmd_list)
+			if (cmd_lists[i].get() == _cmd_list)
 			{
-				cmd_list.swap(cmd_lists.back());
+				cmd_lists[i].swap(cmd_lists[active_count - 1]);
 				break;
 			}
 		}
-		cmd_lists.pop_back();
+		--active_count;
 	}
 
 	void GfxCommandListPool::BeginCmdLists()
 	{
-		for (auto& cmd_list : cmd_lists)
-		{
-			cmd_list->ResetAllocator();
-			cmd_list->Begin();
-		}
+		active_count = 1;
+		GfxCommandList* main_cmd_list = GetMainCmdList();
+		main_cmd_list->ResetAllocator();
+		main_cmd_list->Begin();
 	}
 	void GfxCommandListPool::EndCmdLists()
 	{
-		for (auto& cmd_list : cmd_lists) cmd_list->End();
+		for (Uint64 i = 0; i < active_count; ++i) cmd_lists[i]->End();
 	}
 
 	GfxGraphicsCommandListPool::GfxGraphicsCommandListPool(GfxDevice* gfx) : GfxCommandListPool(gfx, GfxCommandListType::Graphics)
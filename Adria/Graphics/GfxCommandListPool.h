@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <span>
 
 namespace adria
 {
@@ -26,6 +27,11 @@ namespace adria
 		void BeginCmdLists();
 		void EndCmdLists();
 
+		std::span<std::unique_ptr<GfxCommandList> const> GetActiveCmdLists() const
+		{
+			return std::span(cmd_lists.data(), active_count);
+		}
+
 	protected:
 		GfxCommandListPool(GfxDevice* gfx, GfxCommandListType type);
 
@@ -33,6 +39,7 @@ namespace adria
 		GfxDevice* gfx;
 		GfxCommandListType const type;
 		std::vector<std::unique_ptr<GfxCommandList>> cmd_lists;
+		Uint64 active_count = 1;
 	};
 
 	class GfxGraphicsCommandListPool : public GfxCommandListPool
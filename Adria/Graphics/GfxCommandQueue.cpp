@@ -38,19 +38,39 @@ namespace adria
 	{
 		if (cmd_lists.empty()) return;
 
-		for (GfxCommandList* cmd_list : cmd_lists) cmd_list->WaitAll();
-
-		std::vector<ID3D12CommandList*> d3d12_cmd_lists(cmd_lists.size());
-		for (Uint64 i = 0; i < d3d12_cmd_lists.size(); ++i) d3d12_cmd_lists[i] = cmd_lists[i]->GetNative();
-		command_queue->ExecuteCommandLists((Uint32)d3d12_cmd_lists.size(), d3d12_cmd_lists.data());
+		//command lists are submitted in batches split at their waits and signals, so that a wait or a signal only orders the lists around it.
+		//Waiting for all of them before the first list would deadlock when another queue waits for a signal in the middle of this batch
+		std::vector<ID3D12CommandList*> d3d12_cmd_lists;
+		d3d12_cmd_lists.reserve(cmd_lists.size());
+		auto FlushCommandLists = [&]()
+		{
+			if (d3d12_cmd_lists.empty()) return;
+			command_queue->ExecuteCommandLists((Uint32)d3d12_cmd_lists.size(), d3d12_cmd_lists.data());
+			d3d12_cmd_lists.clear();
+		};
 
-		for (GfxCommandList* cmd_list : cmd_lists) cmd_list->SignalAll();
+		for (GfxCommandList* cmd_list : cmd_lists)
+		{
+			if (cmd_list->HasPendingWaits())
+			{
+				FlushCommandLists();
+				cmd_list->WaitAll();
+			}
+			d3d12_cmd_lists.push_back(cmd_list->GetNative());
+			if (cmd_list->HasPendingSignals())
+			{
+				FlushCommandLists();
+				cmd_list->SignalAll();
+			}
+		}
+		FlushCommandLists();
 	}
 
 	void GfxCommandQueue::ExecuteCommandListPool(GfxCommandListPool& cmd_list_pool)
 	{
-		std::vector<GfxCommandList*> cmd_lists; cmd_lists.reserve(cmd_list_pool.cmd_lists.size());
-		for (auto& cmd_list : cmd_list_pool.cmd_lists) cmd_lists.push_back(cmd_list.get());
+		auto active_cmd_lists = cmd_list_pool.GetActiveCmdLists();
+		std::vector<GfxCommandList*> cmd_lists; cmd_lists.reserve(active_cmd_lists.size());
+		for (auto& cmd_list : active_cmd_lists) cmd_lists.push_back(cmd_list.get());
 		ExecuteCommandLists(cmd_lists);
 	}
 
@@ -363,6 +363,7 @@ namespace adria
 
 		frame_fence.Create(this, "Frame Fence");
 		upload_fence.Create(this, "Upload Fence");
+		graphics_fence.Create(this, "Graphics Fence");
 		async_compute_fence.Create(this, "Async Compute Fence");
 		wait_fence.Create(this, "Wait Fence");
 		release_fence.Create(this, "Release Fence");
@@ -430,6 +431,7 @@ namespace adria
 		dynamic_allocators[backbuffer_index]->Clear();
 
 		graphics_cmd_list_pool[backbuffer_index]->BeginCmdLists();
+		compute_cmd_list_pool[backbuffer_index]->BeginCmdLists();
 		copy_cmd_list_pool[backbuffer_index]->BeginCmdLists();
 	}
 	void GfxDevice::EndFrame()
@@ -438,9 +440,11 @@ namespace adria
 		Uint32 backbuffer_index = swapchain->GetBackbufferIndex();
 
 		graphics_cmd_list_pool[backbuffer_index]->EndCmdLists();
+		compute_cmd_list_pool[backbuffer_index]->EndCmdLists();
 		copy_cmd_list_pool[backbuffer_index]->EndCmdLists();
 
 		graphics_queue.ExecuteCommandListPool(*graphics_cmd_list_pool[backbuffer_index]);
+		compute_queue.ExecuteCommandListPool(*compute_cmd_list_pool[backbuffer_index]);
 		copy_queue.ExecuteCommandListPool(*copy_cmd_list_pool[backbuffer_index]);
 		ProcessReleaseQueue();
 
@@ -122,6 +122,11 @@ namespace adria
 		GfxCommandList* AllocateCommandList(GfxCommandListType type) const;
 		void			FreeCommandList(GfxCommandList*, GfxCommandListType type);
 
+		GfxFence& GetGraphicsFence() { return graphics_fence; }
+		Uint64 IncrementGraphicsFenceValue() { return ++graphics_fence_value; }
+		GfxFence& GetAsyncComputeFence() { return async_compute_fence; }
+		Uint64 IncrementAsyncComputeFenceValue() { return ++async_compute_fence_value; }
+
 		GfxTexture* GetBackbuffer() const;
 
 		template<Releasable T>
@@ -220,6 +225,8 @@ namespace adria
 		GfxFence	 frame_fence;
 		Uint64		 frame_fence_value = 0;
 		Uint64       frame_fence_values[GFX_BACKBUFFER_COUNT];
+		GfxFence	 graphics_fence;
+		Uint64		 graphics_fence_value = 0;
 
 		std::unique_ptr<GfxComputeCommandListPool> compute_cmd_list_pool[GFX_BACKBUFFER_COUNT];
 		GfxFence async_compute_fence;
@@ -0,0 +1,42 @@
+#include "GfxHeap.h"
+#include "GfxDevice.h"
+#include "Utilities/AllocatorUtil.h"
+
+namespace adria
+{
+	static constexpr D3D12_HEAP_FLAGS ToD3D12HeapFlags(GfxHeapType heap_type)
+	{
+		switch (heap_type)
+		{
+		case GfxHeapType::Buffers:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		case GfxHeapType::RenderTargetTextures:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		case GfxHeapType::NonRenderTargetTextures:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		}
+		return D3D12_HEAP_FLAG_NONE;
+	}
+
+	GfxHeap::GfxHeap(GfxDevice* gfx, GfxHeapDesc const& desc) : gfx(gfx), desc(desc)
+	{
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+		allocation_desc.ExtraHeapFlags = ToD3D12HeapFlags(desc.type);
+		allocation_desc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info{};
+		allocation_info.SizeInBytes = Align(desc.size, (Uint64)D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+		allocation_info.Alignment = desc.type == GfxHeapType::RenderTargetTextures ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+		D3D12MA::Allocation* alloc = nullptr;
+		HRESULT hr = gfx->GetAllocator()->AllocateMemory(&allocation_desc, &allocation_info, &alloc);
+		GFX_CHECK_HR(hr);
+		allocation.reset(alloc);
+	}
+
+	GfxHeap::~GfxHeap()
+	{
+		gfx->AddToReleaseQueue(allocation.release());
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Utilities/Releasable.h"
+
+namespace adria
+{
+	class GfxDevice;
+
+	//Resource heap tier 1 hardware cannot mix these resource categories in one heap
+	enum class GfxHeapType : Uint8
+	{
+		Buffers,
+		RenderTargetTextures,
+		NonRenderTargetTextures,
+		Count
+	};
+
+	struct GfxHeapDesc
+	{
+		Uint64 size = 0;
+		GfxHeapType type = GfxHeapType::Buffers;
+	};
+
+	struct GfxAllocationInfo
+	{
+		Uint64 size = 0;
+		Uint64 alignment = 0;
+	};
+
+	class GfxHeap
+	{
+	public:
+		GfxHeap(GfxDevice* gfx, GfxHeapDesc const& desc);
+		ADRIA_NONCOPYABLE_NONMOVABLE(GfxHeap)
+		~GfxHeap();
+
+		GfxHeapDesc const& GetDesc() const { return desc; }
+		D3D12MA::Allocation* GetAllocation() const { return allocation.get(); }
+
+	private:
+		GfxDevice* gfx;
+		GfxHeapDesc desc;
+		ReleasablePtr<D3D12MA::Allocation> allocation = nullptr;
+	};
+}
@@ -14,30 +14,24 @@ namespace adria
 
 	GfxDynamicAllocation GfxLinearDynamicAllocator::Allocate(Uint64 size_in_bytes, Uint64 alignment)
 	{
-		Uint64 offset = INVALID_ALLOC_OFFSET;
-		GfxAllocationPage& last_page = alloc_pages[current_page];
-		{
-			std::lock_guard<std::mutex> guard(alloc_mutex);
-			offset = last_page.linear_allocator.Allocate(size_in_bytes, alignment);
-		}
-
-		if (offset != INVALID_ALLOC_OFFSET)
-		{
-			GfxDynamicAllocation allocation{};
-			allocation.buffer = last_page.buffer.get();
-			allocation.cpu_address = reinterpret_cast<Uint8*>(last_page.cpu_address) + offset;
-			allocation.gpu_address = last_page.buffer->GetGpuAddress() + offset;
-			allocation.offset = offset;
-			allocation.size = size_in_bytes;
-
-			return allocation;
-		}
-		else
+		//page switching has to happen under the lock too, command lists can be recorded from multiple threads
+		std::lock_guard<std::mutex> guard(alloc_mutex);
+		Uint64 offset = alloc_pages[current_page].linear_allocator.Allocate(size_in_bytes, alignment);
+		while (offset == INVALID_ALLOC_OFFSET)
 		{
 			++current_page;
-			GfxAllocationPage& last_page = current_page < alloc_pages.size() ? alloc_pages[current_page] : alloc_pages.emplace_back(gfx, std::max(size_in_bytes, page_size));
-			return Allocate(size_in_bytes, alignment);
+			if (current_page == alloc_pages.size()) alloc_pages.emplace_back(gfx, std::max(size_in_bytes + alignment, page_size));
+			offset = alloc_pages[current_page].linear_allocator.Allocate(size_in_bytes, alignment);
 		}
+
+		GfxAllocationPage& page = alloc_pages[current_page];
+		GfxDynamicAllocation allocation{};
+		allocation.buffer = page.buffer.get();
+		allocation.cpu_address = reinterpret_cast<Uint8*>(page.cpu_address) + offset;
+		allocation.gpu_address = page.buffer->GetGpuAddress() + offset;
+		allocation.offset = offset;
+		allocation.size = size_in_bytes;
+		return allocation;
 	}
 	void GfxLinearDynamicAllocator::Clear()
 	{
@@ -12,5 +12,6 @@ namespace adria
 		Bool aftermath = false;
 		Bool vsync = false;
 		Bool shader_debug = false;
+		Bool background_shader_precompile = false;
 	};
 }
\ No newline at end of file
@@ -180,6 +180,25 @@ namespace adria
 			f(current_pso_desc);
 		}
 
+		//Resolves keys [0, permutation_count) to PSOs up front, setup configures the permutation of one key through AddDefine/Set* calls.
+		//Keys are usually bitmasks of the defines and state toggles a pass switches between draws.
+		template<typename F> requires std::is_invocable_v<F, GfxPipelineStatePermutations&, Uint32>
+		void AddPermutations(Uint32 permutation_count, F&& setup)
+		{
+			permutation_table.resize(permutation_count);
+			for (Uint32 permutation_key = 0; permutation_key < permutation_count; ++permutation_key)
+			{
+				setup(*this, permutation_key);
+				permutation_table[permutation_key] = Get();
+			}
+		}
+
+		PSO* Get(Uint32 permutation_key) const
+		{
+			ADRIA_ASSERT(permutation_key < permutation_table.size());
+			return permutation_table[permutation_key];
+		}
+
 		PSO* Get() const
 		{
 			Uint64 pso_hash = PSODescHasher{}(current_pso_desc);
@@ -197,6 +216,7 @@ namespace adria
 		PSODesc const base_pso_desc;
 		mutable PSOPermutationMap pso_permutations;
 		mutable PSODesc current_pso_desc;
+		std::vector<PSO*> permutation_table;
 	};
 
 	using GfxGraphicsPipelineStatePermutations	 = GfxPipelineStatePermutations<GfxGraphicsPipelineState>;
@@ -72,7 +72,7 @@ namespace adria
 			Uint32 profile_index = scope_counter++;
 #if GFX_MULTITHREADED
 			{
-				std::scoped_lock(map_mutex);
+				std::scoped_lock lock(map_mutex);
 				name_to_index_map[name] = profile_index;
 			}
 #else
@@ -91,7 +91,7 @@ namespace adria
 			Uint32 profile_index = -1;
 #if GFX_MULTITHREADED
 			{
-				std::scoped_lock(map_mutex);
+				std::scoped_lock lock(map_mutex);
 				profile_index = name_to_index_map[name];
 			}
 #else
@@ -0,0 +1,356 @@
+#pragma comment(lib, "bcrypt.lib")
+#include <bcrypt.h>
+#include <filesystem>
+#include "GfxShaderCache.h"
+#include "GfxShaderCompiler.h"
+#include "Core/Paths.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct GfxShaderCacheHeader
+		{
+			static constexpr Uint32 MAGIC = 0x43535841; //AXSC
+			static constexpr Uint32 VERSION = 1;
+
+			Uint32 magic;
+			Uint32 version;
+			//incremented every time the archive is opened, entries remember the last session that used them
+			Uint32 session;
+			Uint32 entry_count;
+		};
+
+		struct GfxShaderCacheEntry
+		{
+			GfxShaderCacheKey key;
+			Uint64 shader_hash[2];
+			Uint64 offset;
+			Uint32 size;
+			Uint32 last_used_session;
+		};
+		static_assert(sizeof(GfxShaderCacheEntry) == 64);
+
+		struct GfxShaderCacheKeyHash
+		{
+			Uint64 operator()(GfxShaderCacheKey const& key) const
+			{
+				Uint64 hash;
+				memcpy(&hash, key.digest, sizeof(hash));
+				return hash;
+			}
+		};
+
+		struct GfxShaderCacheNewEntry
+		{
+			Uint64 shader_hash[2];
+			GfxShaderBlob blob;
+		};
+
+		//entries that were not used for this many sessions are dropped when the archive is written
+		constexpr Uint32 MAX_UNUSED_SESSIONS = 16;
+
+		HANDLE archive_file = INVALID_HANDLE_VALUE;
+		HANDLE archive_mapping = nullptr;
+		Uint8* archive_view = nullptr;
+		Uint32 current_session = 0;
+		Bool archive_has_stale_entries = false;
+		//built in Initialize and read-only afterwards, lookups do not need the mutex
+		std::unordered_map<GfxShaderCacheKey, GfxShaderCacheEntry*, GfxShaderCacheKeyHash> archive_entries;
+
+		std::mutex new_entries_mutex;
+		std::unordered_map<GfxShaderCacheKey, GfxShaderCacheNewEntry, GfxShaderCacheKeyHash> new_entries;
+
+		struct GfxShaderStampsHeader
+		{
+			static constexpr Uint32 MAGIC = 0x54535841; //AXST
+			static constexpr Uint32 VERSION = 1;
+
+			Uint32 magic;
+			Uint32 version;
+			Uint32 entry_count;
+		};
+
+		struct GfxShaderStampsEntry
+		{
+			GfxShaderCacheKey key;
+			std::vector<GfxShaderIncludeStamp> stamps;
+		};
+
+		//keyed by request key, the stamps are machine local and kept next to the archive instead of in it
+		std::mutex stamp_entries_mutex;
+		std::unordered_map<GfxShaderCacheKey, GfxShaderStampsEntry, GfxShaderCacheKeyHash> stamp_entries;
+		Bool stamp_entries_changed = false;
+
+		std::string GetArchivePath()
+		{
+			return paths::ShaderCacheDir + "shader_cache.bin";
+		}
+
+		std::string GetStampsPath()
+		{
+			return paths::ShaderCacheDir + "shader_stamps.bin";
+		}
+
+		void CloseArchive()
+		{
+			if (archive_view) UnmapViewOfFile(archive_view);
+			if (archive_mapping) CloseHandle(archive_mapping);
+			if (archive_file != INVALID_HANDLE_VALUE) CloseHandle(archive_file);
+			archive_view = nullptr;
+			archive_mapping = nullptr;
+			archive_file = INVALID_HANDLE_VALUE;
+			archive_entries.clear();
+		}
+
+		Bool OpenArchive()
+		{
+			std::string const archive_path = GetArchivePath();
+			archive_file = CreateFileA(archive_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (archive_file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER file_size{};
+			if (!GetFileSizeEx(archive_file, &file_size) || (Uint64)file_size.QuadPart < sizeof(GfxShaderCacheHeader)) return false;
+			Uint64 const archive_size = (Uint64)file_size.QuadPart;
+
+			archive_mapping = CreateFileMappingA(archive_file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+			if (!archive_mapping) return false;
+			archive_view = static_cast<Uint8*>(MapViewOfFile(archive_mapping, FILE_MAP_WRITE, 0, 0, 0));
+			if (!archive_view) return false;
+
+			GfxShaderCacheHeader* header = reinterpret_cast<GfxShaderCacheHeader*>(archive_view);
+			if (header->magic != GfxShaderCacheHeader::MAGIC || header->version != GfxShaderCacheHeader::VERSION) return false;
+			if (sizeof(GfxShaderCacheHeader) + (Uint64)header->entry_count * sizeof(GfxShaderCacheEntry) > archive_size) return false;
+
+			current_session = ++header->session;
+			GfxShaderCacheEntry* entries = reinterpret_cast<GfxShaderCacheEntry*>(archive_view + sizeof(GfxShaderCacheHeader));
+			for (Uint32 i = 0; i < header->entry_count; ++i)
+			{
+				GfxShaderCacheEntry& entry = entries[i];
+				if (entry.offset + entry.size > archive_size) return false;
+				if (current_session - entry.last_used_session > MAX_UNUSED_SESSIONS) archive_has_stale_entries = true;
+				archive_entries[entry.key] = &entry;
+			}
+			return true;
+		}
+
+		Bool ReadStamps()
+		{
+			std::ifstream is(GetStampsPath(), std::ios::binary);
+			if (!is) return false;
+			auto Read = [&is](void* data, Uint64 size) { return (Bool)is.read(reinterpret_cast<Char*>(data), size); };
+
+			GfxShaderStampsHeader header{};
+			if (!Read(&header, sizeof(header)) || header.magic != GfxShaderStampsHeader::MAGIC || header.version != GfxShaderStampsHeader::VERSION) return false;
+			for (Uint32 i = 0; i < header.entry_count; ++i)
+			{
+				GfxShaderCacheKey request_key{};
+				GfxShaderStampsEntry entry{};
+				Uint32 stamp_count = 0;
+				if (!Read(&request_key, sizeof(request_key)) || !Read(&entry.key, sizeof(entry.key)) || !Read(&stamp_count, sizeof(stamp_count))) return false;
+				entry.stamps.resize(stamp_count);
+				for (GfxShaderIncludeStamp& stamp : entry.stamps)
+				{
+					Uint32 file_length = 0;
+					if (!Read(&file_length, sizeof(file_length))) return false;
+					stamp.file.resize(file_length);
+					if (!Read(stamp.file.data(), file_length) || !Read(&stamp.write_time, sizeof(stamp.write_time)) || !Read(&stamp.size, sizeof(stamp.size))) return false;
+				}
+				stamp_entries[request_key] = std::move(entry);
+			}
+			return true;
+		}
+
+		void WriteStamps()
+		{
+			std::ofstream os(GetStampsPath(), std::ios::binary);
+			if (!os) return;
+			auto Write = [&os](void const* data, Uint64 size) { os.write(reinterpret_cast<Char const*>(data), size); };
+
+			GfxShaderStampsHeader header{};
+			header.magic = GfxShaderStampsHeader::MAGIC;
+			header.version = GfxShaderStampsHeader::VERSION;
+			header.entry_count = (Uint32)stamp_entries.size();
+			Write(&header, sizeof(header));
+			for (auto const& [request_key, entry] : stamp_entries)
+			{
+				Uint32 const stamp_count = (Uint32)entry.stamps.size();
+				Write(&request_key, sizeof(request_key));
+				Write(&entry.key, sizeof(entry.key));
+				Write(&stamp_count, sizeof(stamp_count));
+				for (GfxShaderIncludeStamp const& stamp : entry.stamps)
+				{
+					Uint32 const file_length = (Uint32)stamp.file.size();
+					Write(&file_length, sizeof(file_length));
+					Write(stamp.file.data(), file_length);
+					Write(&stamp.write_time, sizeof(stamp.write_time));
+					Write(&stamp.size, sizeof(stamp.size));
+				}
+			}
+		}
+
+		Bool WriteArchive(std::string const& archive_path)
+		{
+			std::vector<GfxShaderCacheEntry> entries;
+			entries.reserve(archive_entries.size() + new_entries.size());
+			for (auto const& [key, entry] : archive_entries)
+			{
+				if (current_session - entry->last_used_session > MAX_UNUSED_SESSIONS || new_entries.contains(key)) continue;
+				entries.push_back(*entry);
+			}
+			Uint64 const archive_entry_count = entries.size();
+			for (auto const& [key, new_entry] : new_entries)
+			{
+				GfxShaderCacheEntry& entry = entries.emplace_back();
+				entry.key = key;
+				memcpy(entry.shader_hash, new_entry.shader_hash, sizeof(entry.shader_hash));
+				entry.size = (Uint32)new_entry.blob.size();
+				entry.last_used_session = current_session;
+			}
+
+			Uint64 offset = sizeof(GfxShaderCacheHeader) + entries.size() * sizeof(GfxShaderCacheEntry);
+			std::vector<Uint8 const*> entry_data(entries.size());
+			for (Uint64 i = 0; i < entries.size(); ++i)
+			{
+				entry_data[i] = i < archive_entry_count ? archive_view + entries[i].offset : new_entries[entries[i].key].blob.data();
+				entries[i].offset = offset;
+				offset += entries[i].size;
+			}
+
+			std::ofstream os(archive_path, std::ios::binary);
+			if (!os) return false;
+			GfxShaderCacheHeader header{};
+			header.magic = GfxShaderCacheHeader::MAGIC;
+			header.version = GfxShaderCacheHeader::VERSION;
+			header.session = current_session;
+			header.entry_count = (Uint32)entries.size();
+			os.write(reinterpret_cast<Char const*>(&header), sizeof(header));
+			os.write(reinterpret_cast<Char const*>(entries.data()), entries.size() * sizeof(GfxShaderCacheEntry));
+			for (Uint64 i = 0; i < entries.size(); ++i) os.write(reinterpret_cast<Char const*>(entry_data[i]), entries[i].size);
+			return os.good();
+		}
+	}
+
+	namespace GfxShaderCache
+	{
+		void Initialize()
+		{
+			std::filesystem::create_directory(paths::ShaderCacheDir);
+			if (!ReadStamps()) stamp_entries.clear();
+			if (!OpenArchive())
+			{
+				CloseArchive();
+				current_session = 1;
+				archive_has_stale_entries = false;
+				return;
+			}
+			ADRIA_LOG(INFO, "Shader cache archive mapped with %llu entries", (Uint64)archive_entries.size());
+		}
+
+		void Destroy()
+		{
+			if (!new_entries.empty() || archive_has_stale_entries)
+			{
+				//the new archive is written next to the mapped one and replaces it once the mapping is closed
+				std::string const archive_path = GetArchivePath();
+				std::string const temp_archive_path = archive_path + ".tmp";
+				Bool const written = WriteArchive(temp_archive_path);
+				CloseArchive();
+				if (!written || !MoveFileExA(temp_archive_path.c_str(), archive_path.c_str(), MOVEFILE_REPLACE_EXISTING))
+				{
+					ADRIA_LOG(WARNING, "Failed to write shader cache archive '%s'", archive_path.c_str());
+				}
+			}
+			CloseArchive();
+			new_entries.clear();
+			archive_has_stale_entries = false;
+
+			if (stamp_entries_changed) WriteStamps();
+			stamp_entries.clear();
+			stamp_entries_changed = false;
+		}
+
+		GfxShaderCacheKey ComputeKey(void const* data, Uint64 size)
+		{
+			GfxShaderCacheKey key{};
+			NTSTATUS status = BCryptHash(BCRYPT_SHA256_ALG_HANDLE, nullptr, 0, (PUCHAR)data, (ULONG)size, key.digest, sizeof(key.digest));
+			ADRIA_ASSERT(BCRYPT_SUCCESS(status));
+			return key;
+		}
+
+		Bool Load(GfxShaderCacheKey const& key, GfxShaderCompileOutput& output)
+		{
+			if (auto it = archive_entries.find(key); it != archive_entries.end())
+			{
+				GfxShaderCacheEntry* entry = it->second;
+				std::atomic_ref<Uint32>(entry->last_used_session).store(current_session, std::memory_order_relaxed);
+				memcpy(output.shader_hash, entry->shader_hash, sizeof(output.shader_hash));
+				output.shader.SetShaderData(archive_view + entry->offset, entry->size);
+				return true;
+			}
+
+			std::lock_guard<std::mutex> lock(new_entries_mutex);
+			if (auto it = new_entries.find(key); it != new_entries.end())
+			{
+				memcpy(output.shader_hash, it->second.shader_hash, sizeof(output.shader_hash));
+				output.shader.SetShaderData(it->second.blob.data(), it->second.blob.size());
+				return true;
+			}
+			return false;
+		}
+
+		void Store(GfxShaderCacheKey const& key, GfxShaderCompileOutput const& output)
+		{
+			GfxShaderCacheNewEntry new_entry{};
+			memcpy(new_entry.shader_hash, output.shader_hash, sizeof(new_entry.shader_hash));
+			Uint8 const* shader_data = static_cast<Uint8 const*>(output.shader.GetData());
+			new_entry.blob.assign(shader_data, shader_data + output.shader.GetSize());
+
+			std::lock_guard<std::mutex> lock(new_entries_mutex);
+			new_entries[key] = std::move(new_entry);
+		}
+
+		Bool GetIncludeStamp(std::string const& file, GfxShaderIncludeStamp& stamp)
+		{
+			std::error_code ec;
+			std::filesystem::file_time_type const write_time = std::filesystem::last_write_time(file, ec);
+			if (ec) return false;
+			Uint64 const size = std::filesystem::file_size(file, ec);
+			if (ec) return false;
+
+			stamp.file = file;
+			stamp.write_time = write_time.time_since_epoch().count();
+			stamp.size = size;
+			return true;
+		}
+
+		Bool FindByIncludeStamps(GfxShaderCacheKey const& request_key, GfxShaderCacheKey& key, std::vector<std::string>& includes)
+		{
+			GfxShaderStampsEntry entry{};
+			{
+				std::lock_guard<std::mutex> lock(stamp_entries_mutex);
+				auto it = stamp_entries.find(request_key);
+				if (it == stamp_entries.end()) return false;
+				entry = it->second;
+			}
+
+			GfxShaderIncludeStamp current_stamp{};
+			for (GfxShaderIncludeStamp const& stamp : entry.stamps)
+			{
+				if (!GetIncludeStamp(stamp.file, current_stamp) || current_stamp.write_time != stamp.write_time || current_stamp.size != stamp.size) return false;
+			}
+			key = entry.key;
+			includes.clear();
+			for (GfxShaderIncludeStamp& stamp : entry.stamps) includes.push_back(std::move(stamp.file));
+			return true;
+		}
+
+		void StoreIncludeStamps(GfxShaderCacheKey const& request_key, GfxShaderCacheKey const& key, std::vector<GfxShaderIncludeStamp> stamps)
+		{
+			std::lock_guard<std::mutex> lock(stamp_entries_mutex);
+			stamp_entries[request_key] = GfxShaderStampsEntry{ key, std::move(stamps) };
+			stamp_entries_changed = true;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace adria
+{
+	struct GfxShaderCompileOutput;
+
+	//SHA-256 of the preprocessed source, the compiler arguments and the compiler version
+	struct GfxShaderCacheKey
+	{
+		Uint8 digest[32];
+
+		Bool operator==(GfxShaderCacheKey const&) const = default;
+	};
+
+	//Write time and size of a file a shader was preprocessed from
+	struct GfxShaderIncludeStamp
+	{
+		std::string file;
+		Int64 write_time;
+		Uint64 size;
+	};
+
+	//Compiled shaders are kept in a single archive in the shader cache directory. The archive is memory mapped in Initialize
+	//and looked up by key, shaders compiled during the run are appended when the archive is written back in Destroy.
+	namespace GfxShaderCache
+	{
+		void Initialize();
+		void Destroy();
+
+		GfxShaderCacheKey ComputeKey(void const* data, Uint64 size);
+		Bool Load(GfxShaderCacheKey const& key, GfxShaderCompileOutput& output);
+		void Store(GfxShaderCacheKey const& key, GfxShaderCompileOutput const& output);
+
+		//Stamps of the files a cached shader was preprocessed from are kept per request key, a hash of the source file and the compiler arguments.
+		//While none of these files changed FindByIncludeStamps returns the cache key and the include list without preprocessing the shader again.
+		Bool GetIncludeStamp(std::string const& file, GfxShaderIncludeStamp& stamp);
+		Bool FindByIncludeStamps(GfxShaderCacheKey const& request_key, GfxShaderCacheKey& key, std::vector<std::string>& includes);
+		void StoreIncludeStamps(GfxShaderCacheKey const& request_key, GfxShaderCacheKey const& key, std::vector<GfxShaderIncludeStamp> stamps);
+	}
+}
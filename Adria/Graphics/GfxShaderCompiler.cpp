@@ -2,27 +2,64 @@
 #include <d3dcompiler.h>
 #include <filesystem>
 #include "dxcapi.h"
-#include "cereal/archives/binary.hpp"
-#include "cereal/types/string.hpp"
-#include "cereal/types/vector.hpp"
 #include "GfxShaderCompiler.h"
+#include "GfxShaderCache.h"
 #include "GfxMacros.h"
 #include "Core/Paths.h"
+#include "Core/ConsoleManager.h"
 #include "Utilities/StringUtil.h"
 #include "Utilities/FilesUtil.h"
-#include "Utilities/HashUtil.h"
 #include "Utilities/Ref.h"
 #include "Logging/Logger.h"
 
 
 namespace adria
 {
+	static TAutoConsoleVariable<Bool> UseShaderCache("r.Shaders.UseCache", true, "Whether compiled shaders are loaded from and stored in the shader cache");
+
 	namespace
 	{
-		Ref<IDxcLibrary> library = nullptr;
-		Ref<IDxcCompiler3> compiler = nullptr;
-		Ref<IDxcUtils> utils = nullptr;
-		Ref<IDxcIncludeHandler> include_handler = nullptr;
+		struct DxcInstances
+		{
+			Ref<IDxcLibrary> library = nullptr;
+			Ref<IDxcCompiler3> compiler = nullptr;
+			Ref<IDxcUtils> utils = nullptr;
+			Ref<IDxcIncludeHandler> include_handler = nullptr;
+			std::string version;
+		};
+
+		//DXC instances are not thread safe, every thread that compiles shaders gets its own set on first use
+		DxcInstances& GetDxcInstances()
+		{
+			thread_local DxcInstances dxc;
+			if (!dxc.compiler)
+			{
+				GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(dxc.library.GetAddressOf())));
+				GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(dxc.compiler.GetAddressOf())));
+				GFX_CHECK_HR(dxc.library->CreateIncludeHandler(dxc.include_handler.GetAddressOf()));
+				GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(dxc.utils.GetAddressOf())));
+
+				Ref<IDxcVersionInfo> version_info;
+				if (SUCCEEDED(dxc.compiler->QueryInterface(IID_PPV_ARGS(version_info.GetAddressOf()))))
+				{
+					Uint32 major = 0, minor = 0;
+					version_info->GetVersion(&major, &minor);
+					dxc.version = std::to_string(major) + "." + std::to_string(minor);
+				}
+				Ref<IDxcVersionInfo2> version_info2;
+				if (SUCCEEDED(dxc.compiler->QueryInterface(IID_PPV_ARGS(version_info2.GetAddressOf()))))
+				{
+					Uint32 commit_count = 0;
+					Char* commit_hash = nullptr;
+					if (SUCCEEDED(version_info2->GetCommitInfo(&commit_count, &commit_hash)))
+					{
+						dxc.version += "." + std::to_string(commit_count) + "." + commit_hash;
+						CoTaskMemFree(commit_hash);
+					}
+				}
+			}
+			return dxc;
+		}
 	}
 	class GfxIncludeHandler : public IDxcIncludeHandler
 	{
@@ -52,16 +89,20 @@ namespace adria
 			if (already_included)
 			{
 				static const Char nullStr[] = " ";
-				utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
+				GetDxcInstances().utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
 				*ppIncludeSource = encoding.Detach();
 				return S_OK;
 			}
 
+			//stamped before loading, a file written in between is preprocessed again next time
+			GfxShaderIncludeStamp include_stamp{};
+			Bool const stamped = GfxShaderCache::GetIncludeStamp(include_file, include_stamp);
 			std::wstring winclude_file = ToWideString(include_file);
-			HRESULT hr = utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
+			HRESULT hr = GetDxcInstances().utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
 			if (SUCCEEDED(hr))
 			{
 				include_files.push_back(include_file);
+				if (stamped) include_stamps.push_back(std::move(include_stamp));
 				*ppIncludeSource = encoding.Detach();
 				return S_OK;
 			}
@@ -70,13 +111,14 @@ namespace adria
 		}
 		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, _COM_Outptr_ void __RPC_FAR* __RPC_FAR* ppvObject) override
 		{
-			return include_handler->QueryInterface(riid, ppvObject);
+			return GetDxcInstances().include_handler->QueryInterface(riid, ppvObject);
 		}
 
 		ULONG STDMETHODCALLTYPE AddRef(void) override { return 1; }
 		ULONG STDMETHODCALLTYPE Release(void) override { return 1; }
 
 		std::vector<std::string> include_files;
+		std::vector<GfxShaderIncludeStamp> include_stamps;
 	};
 	
 	inline constexpr std::wstring GetTarget(GfxShaderStage stage, GfxShaderModel model)
@@ -149,97 +191,82 @@ namespace adria
 		return target;
 	}
 
-	namespace GfxShaderCompiler
+	//The cache key hashes the preprocessed source instead of file timestamps, so it survives checkouts and copies of the shader directory.
+	//#line directives and include directories are left out because they contain absolute paths.
+	static Bool ComputeCacheKey(DxcInstances& dxc, DxcBuffer const& source_buffer, std::vector<Wchar const*> const& compile_args, GfxShaderCacheKey& cache_key,
+								std::vector<std::string>& includes, std::vector<GfxShaderIncludeStamp>& include_stamps)
 	{
-		static Bool CheckCache(Char const* cache_path, GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
-		{
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
+		std::vector<Wchar const*> preprocess_args = compile_args;
+		preprocess_args.push_back(L"-P");
 
-			if (!FileExists(cache_binary) || !FileExists(cache_metadata)) return false;
-			if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(input.file)) return false;
+		GfxIncludeHandler preprocess_include_handler{};
+		Ref<IDxcResult> result;
+		if (FAILED(dxc.compiler->Compile(&source_buffer, preprocess_args.data(), (Uint32)preprocess_args.size(), &preprocess_include_handler, IID_PPV_ARGS(result.GetAddressOf())))) return false;
 
-			std::ifstream is(cache_metadata, std::ios::binary);
-			cereal::BinaryInputArchive metadata_archive(is);
+		HRESULT status = S_OK;
+		if (FAILED(result->GetStatus(&status)) || FAILED(status)) return false;
+		Ref<IDxcBlobUtf8> preprocessed_source;
+		if (FAILED(result->GetOutput(DXC_OUT_HLSL, IID_PPV_ARGS(preprocessed_source.GetAddressOf()), nullptr)) || !preprocessed_source) return false;
 
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			Uint64 binary_size = 0;
-			metadata_archive(binary_size);
+		std::string key_data = dxc.version;
+		key_data += '\n';
+		for (Uint64 i = 0; i < compile_args.size(); ++i)
+		{
+			if (i > 0 && wcscmp(compile_args[i - 1], L"-I") == 0) continue;
+			key_data += ToString(compile_args[i]);
+			key_data += '\n';
+		}
 
-			//check if the one of the includes was modified after the cache binary was generated
-			for (std::string const& include : output.includes)
-			{
-				if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(include)) 
-					return false;
-			}
+		std::string_view source(preprocessed_source->GetStringPointer(), preprocessed_source->GetStringLength());
+		while (!source.empty())
+		{
+			Uint64 const line_end = source.find('\n');
+			std::string_view const line = source.substr(0, line_end);
+			if (!line.starts_with("#line")) key_data.append(line).push_back('\n');
+			source.remove_prefix(line_end == std::string_view::npos ? source.size() : line_end + 1);
+		}
 
-			std::ifstream is2(cache_binary, std::ios::binary);
-			cereal::BinaryInputArchive binary_archive(is2);
+		cache_key = GfxShaderCache::ComputeKey(key_data.data(), key_data.size());
+		includes = std::move(preprocess_include_handler.include_files);
+		include_stamps = std::move(preprocess_include_handler.include_stamps);
+		return true;
+	}
 
-			std::unique_ptr<Char[]> binary_data(new Char[binary_size]);
-			binary_archive.loadBinary(binary_data.get(), binary_size);
-			output.shader.SetShaderData(binary_data.get(), binary_size);
-			output.shader.SetDesc(input);
-			return true;
-		}
-		static Bool SaveToCache(Char const* cache_path, GfxShaderCompileOutput const& output)
+	//The request key identifies a compile request by source file and arguments, include directories included, and maps it to
+	//the cache key of its last compile together with the stamps of the files that compile was preprocessed from
+	static GfxShaderCacheKey ComputeRequestKey(DxcInstances& dxc, std::string const& file, std::vector<Wchar const*> const& compile_args)
+	{
+		std::string key_data = dxc.version;
+		key_data += '\n';
+		key_data += file;
+		key_data += '\n';
+		for (Wchar const* compile_arg : compile_args)
 		{
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
-			std::ofstream os(cache_metadata, std::ios::binary);
-			cereal::BinaryOutputArchive metadata_archive(os);
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			metadata_archive(output.shader.GetSize());
-
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::ofstream os2(cache_binary, std::ios::binary);
-			cereal::BinaryOutputArchive binary_archive(os2);
-			binary_archive.saveBinary(output.shader.GetData(), output.shader.GetSize());
-
-			return true;
+			key_data += ToString(compile_arg);
+			key_data += '\n';
 		}
+		return GfxShaderCache::ComputeKey(key_data.data(), key_data.size());
+	}
 
+	namespace GfxShaderCompiler
+	{
 		void Initialize()
 		{
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(library.GetAddressOf())));
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(compiler.GetAddressOf())));
-			GFX_CHECK_HR(library->CreateIncludeHandler(include_handler.GetAddressOf()));
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(utils.GetAddressOf())));
-
+			std::ignore = GetDxcInstances();
 			std::filesystem::create_directory(paths::ShaderPDBDir);
+			GfxShaderCache::Initialize();
 		}
 		void Destroy()
 		{
-			include_handler.Reset();
-			compiler.Reset();
-			library.Reset();
-			utils.Reset();
+			GfxShaderCache::Destroy();
+			//instances of other threads are released when those threads exit
+			GetDxcInstances() = DxcInstances{};
 		}
 		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
 		{
-			std::string define_key;
-			for (GfxShaderDefine const& define : input.defines)
-			{
-				define_key += define.name;
-				define_key += define.value;
-			}
-			Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-			std::string build_string = input.flags & GfxShaderCompilerFlag_Debug ? "debug" : "release";
-			Char cache_path[256];
-			sprintf_s(cache_path, "%s%s_%s_%llx_%s", paths::ShaderCacheDir.c_str(), GetFilenameWithoutExtension(input.file).c_str(),
-												     input.entry_point.c_str(), define_hash, build_string.c_str());
-
-			if (CheckCache(cache_path, input, output)) return true;
-			ADRIA_LOG(INFO, "Shader '%s.%s' not found in cache. Compiling...", input.file.c_str(), input.entry_point.c_str());
-
-			compile:
-			Uint32 code_page = CP_UTF8;
-			Ref<IDxcBlobEncoding> source_blob;
-
-			std::wstring shader_source = ToWideString(input.file);
-			HRESULT hr = library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
-			GFX_CHECK_HR(hr);
+			DxcInstances& dxc = GetDxcInstances();
+			output.errors.clear();
+			Bool const use_cache = UseShaderCache.Get();
 
 			std::wstring name = ToWideString(GetFilenameWithoutExtension(input.file));
 			std::wstring dir  = ToWideString(paths::ShaderDir);
@@ -288,33 +315,65 @@ namespace adria
 				compile_args.push_back(defines.back().c_str());
 			}
 
+			GfxShaderCacheKey cache_key{};
+			GfxShaderCacheKey const request_key = ComputeRequestKey(dxc, input.file, compile_args);
+			if (use_cache && GfxShaderCache::FindByIncludeStamps(request_key, cache_key, output.includes) && GfxShaderCache::Load(cache_key, output))
+			{
+				output.shader.SetDesc(input);
+				return true;
+			}
+
+			GfxShaderIncludeStamp source_stamp{};
+			Bool const source_stamped = GfxShaderCache::GetIncludeStamp(input.file, source_stamp);
+
+			Uint32 code_page = CP_UTF8;
+			Ref<IDxcBlobEncoding> source_blob;
+			std::wstring shader_source = ToWideString(input.file);
+			HRESULT hr = dxc.library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
+			GFX_CHECK_HR(hr);
+
 			DxcBuffer source_buffer{};
 			source_buffer.Ptr = source_blob->GetBufferPointer();
 			source_buffer.Size = source_blob->GetBufferSize();
 			source_buffer.Encoding = DXC_CP_ACP;
+
+			output.includes.clear();
+			std::vector<GfxShaderIncludeStamp> include_stamps;
+			Bool const cacheable = ComputeCacheKey(dxc, source_buffer, compile_args, cache_key, output.includes, include_stamps);
+			//stamps are only kept when every file of the shader could be stamped
+			Bool const stampable = cacheable && source_stamped && include_stamps.size() == output.includes.size();
+			output.includes.push_back(input.file);
+			include_stamps.push_back(std::move(source_stamp));
+			if (cacheable && use_cache && GfxShaderCache::Load(cache_key, output))
+			{
+				if (stampable) GfxShaderCache::StoreIncludeStamps(request_key, cache_key, std::move(include_stamps));
+				output.shader.SetDesc(input);
+				return true;
+			}
+			ADRIA_LOG(INFO, "Shader '%s.%s' not found in cache. Compiling...", input.file.c_str(), input.entry_point.c_str());
+
 			GfxIncludeHandler custom_include_handler{};
 
 			Ref<IDxcResult> result;
-			hr = compiler->Compile(
+			hr = dxc.compiler->Compile(
 				&source_buffer,
 				compile_args.data(), (Uint32)compile_args.size(),
 				&custom_include_handler,
 				IID_PPV_ARGS(result.GetAddressOf()));
 
 			Ref<IDxcBlobUtf8> errors;
-			if (SUCCEEDED(result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(errors.GetAddressOf()), nullptr)))
+			if (SUCCEEDED(hr) && SUCCEEDED(result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(errors.GetAddressOf()), nullptr)))
 			{
-				if (errors && errors->GetStringLength() > 0)
-				{
-					Char const* err_msg = errors->GetStringPointer();
-					ADRIA_LOG(ERROR, "%s", err_msg);
-					std::string msg = "Click OK after you fixed the following errors: \n";
-					msg += err_msg;
-					Int32 result = MessageBoxA(NULL, msg.c_str(), NULL, MB_OKCANCEL);
-					if (result == IDOK) goto compile;
-					else if (result == IDCANCEL) return false;
-				}
+				if (errors && errors->GetStringLength() > 0) output.errors = errors->GetStringPointer();
 			}
+			HRESULT compile_status = E_FAIL;
+			if (FAILED(hr) || FAILED(result->GetStatus(&compile_status)) || FAILED(compile_status))
+			{
+				//this runs on worker threads too, the caller decides whether and where to show the errors
+				ADRIA_LOG(ERROR, "%s", output.errors.c_str());
+				return false;
+			}
+			if (!output.errors.empty()) ADRIA_LOG(WARNING, "%s", output.errors.c_str());
 			
 			Ref<IDxcBlob> blob;
 			GFX_CHECK_HR(result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(blob.GetAddressOf()), nullptr));
@@ -326,7 +385,7 @@ namespace adria
 				if (SUCCEEDED(result->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(pdb_blob.GetAddressOf()), pdb_path_utf16.GetAddressOf())))
 				{
 					Ref<IDxcBlobUtf8> pdb_path_utf8;
-					if (SUCCEEDED(utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
+					if (SUCCEEDED(dxc.utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
 					{
 						Char pdb_path[256];
 						sprintf_s(pdb_path, "%s%s", paths::ShaderPDBDir.c_str(), pdb_path_utf8->GetStringPointer());
@@ -351,7 +410,11 @@ namespace adria
 			output.shader.SetShaderData(blob->GetBufferPointer(), blob->GetBufferSize());
 			output.includes = std::move(custom_include_handler.include_files);
 			output.includes.push_back(input.file);
-			SaveToCache(cache_path, output);
+			if (cacheable && use_cache)
+			{
+				GfxShaderCache::Store(cache_key, output);
+				if (stampable) GfxShaderCache::StoreIncludeStamps(request_key, cache_key, std::move(include_stamps));
+			}
 			return true;
 		}
 		void ReadBlobFromFile(std::string const& filename, GfxShaderBlob& blob)
@@ -359,7 +422,7 @@ namespace adria
 			std::wstring wide_filename = ToWideString(filename);
 			Uint32 code_page = CP_UTF8;
 			Ref<IDxcBlobEncoding> source_blob;
-			HRESULT hr = library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
+			HRESULT hr = GetDxcInstances().library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
 			GFX_CHECK_HR(hr);
 			blob.resize(source_blob->GetBufferSize());
 			memcpy(blob.data(), source_blob->GetBufferPointer(), source_blob->GetBufferSize());
@@ -9,6 +9,8 @@ namespace adria
 		GfxShader shader;
 		std::vector<std::string> includes;
 		Uint64 shader_hash[2];
+		//Compiler errors when CompileShader fails
+		std::string errors;
 	};
 	using GfxShaderCompileInput = GfxShaderDesc;
 
@@ -1,45 +1,68 @@
+#include <shared_mutex>
+#include <deque>
+#include <algorithm>
 #include "GfxShaderKey.h"
 #include "GfxShader.h"
 #include "Rendering/ShaderManager.h"
 #include "Utilities/HashUtil.h"
+#include "Logging/Logger.h"
 
 namespace adria
 {
-	struct GfxShaderKey::Impl
+	namespace
 	{
-		ShaderID id = ShaderID_Invalid;
-		std::vector<GfxShaderDefine> defines;
-	};
-
-	GfxShaderKey::GfxShaderKey()
-	{
-		impl = std::make_unique<Impl>();
-	}
-
-	GfxShaderKey::GfxShaderKey(ShaderID shader_id) : GfxShaderKey()
-	{
-		impl->id = shader_id;
-	}
+		class GfxShaderDefineTable
+		{
+		public:
+			Uint16 Intern(Char const* name, Char const* value)
+			{
+				std::string define_key(name);
+				define_key += '\0';
+				define_key += value;
+				{
+					std::shared_lock lock(mutex);
+					if (auto it = define_ids.find(define_key); it != define_ids.end()) return it->second;
+				}
+				std::unique_lock lock(mutex);
+				auto [it, inserted] = define_ids.try_emplace(std::move(define_key), (Uint16)defines.size());
+				if (inserted)
+				{
+					ADRIA_ASSERT(defines.size() < UINT16_MAX);
+					defines.emplace_back(name, value);
+				}
+				return it->second;
+			}
+
+			GfxShaderDefine const& Get(Uint16 define_id) const
+			{
+				std::shared_lock lock(mutex);
+				return defines[define_id];
+			}
+
+		private:
+			mutable std::shared_mutex mutex;
+			std::unordered_map<std::string, Uint16> define_ids;
+			std::deque<GfxShaderDefine> defines;
+		};
+		GfxShaderDefineTable& GetDefineTable()
+		{
+			static GfxShaderDefineTable define_table;
+			return define_table;
+		}
 
-	GfxShaderKey::GfxShaderKey(GfxShaderKey const& k) 
-	{
-		impl = std::make_unique<Impl>();
-		impl->id = k.impl->id;
-		impl->defines = k.impl->defines;
+		//the define hash is a sum of mixed ids so it does not depend on the order the defines were added in
+		constexpr Uint64 MixDefineId(Uint16 define_id)
+		{
+			Uint64 x = define_id + 0x9e3779b97f4a7c15ull;
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+			return x ^ (x >> 31);
+		}
 	}
 
-	GfxShaderKey::~GfxShaderKey() = default;
-
 	void GfxShaderKey::Init(ShaderID shader_id)
 	{
-		impl->id = shader_id;
-	}
-
-	GfxShaderKey& GfxShaderKey::operator=(GfxShaderKey const& k)
-	{
-		impl->id = k.impl->id;
-		impl->defines = k.impl->defines;
-		return *this;
+		id = shader_id;
 	}
 
 	void GfxShaderKey::operator=(ShaderID shader_id)
@@ -49,48 +72,58 @@ namespace adria
 
 	void GfxShaderKey::AddDefine(Char const* name, Char const* value)
 	{
-		impl->defines.emplace_back(name, value);
+		Uint16 const define_id = GetDefineTable().Intern(name, value);
+		Uint16* const defines_end = define_ids.data() + define_count;
+		Uint16* const insert_pos = std::lower_bound(define_ids.data(), defines_end, define_id);
+		if (insert_pos != defines_end && *insert_pos == define_id) return;
+
+		//dropping a define would silently compile and cache the wrong permutation, so this is fatal in every configuration
+		if (define_count >= MAX_DEFINES)
+		{
+			ADRIA_LOG(ERROR, "Shader key of shader %u has more than %u defines, %s=%s does not fit", (Uint32)id, MAX_DEFINES, name, value);
+			ADRIA_ASSERT_MSG(false, "Too many defines for one shader key");
+			std::exit(EXIT_FAILURE);
+		}
+		std::copy_backward(insert_pos, defines_end, defines_end + 1);
+		*insert_pos = define_id;
+		++define_count;
+		defines_hash += MixDefineId(define_id);
 	}
 
 	Bool GfxShaderKey::IsValid() const
 	{
-		return impl->id != ShaderID_Invalid;
+		return id != ShaderID_Invalid;
 	}
 
 	GfxShaderKey::operator ShaderID() const
 	{
-		return impl->id;
+		return id;
 	}
 
-	std::vector<GfxShaderDefine> const& GfxShaderKey::GetDefines() const
+	std::vector<GfxShaderDefine> GfxShaderKey::GetDefines() const
 	{
-		return impl->defines;
+		std::vector<GfxShaderDefine> defines;
+		defines.reserve(define_count);
+		for (Uint32 i = 0; i < define_count; ++i) defines.push_back(GetDefineTable().Get(define_ids[i]));
+		return defines;
 	}
 
 	ShaderID GfxShaderKey::GetShaderID() const
 	{
-		return impl->id;
+		return id;
 	}
 
 	Uint64 GfxShaderKey::GetHash() const
 	{
-		if (!impl) return 0;
-
-		std::string define_key;
-		for (GfxShaderDefine const& define : impl->defines)
-		{
-			define_key += define.name;
-			define_key += define.value;
-		}
-		define_key += std::to_string(impl->id);
-		Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-		return define_hash;
+		HashState hash;
+		hash.Combine((Uint64)id);
+		hash.Combine(defines_hash);
+		return hash;
 	}
 
 	Bool GfxShaderKey::operator==(GfxShaderKey const& key) const
 	{
-		if (impl->id != key.impl->id) return false;
-		return GetHash() == key.GetHash();
+		if (id != key.id || define_count != key.define_count || defines_hash != key.defines_hash) return false;
+		return std::equal(define_ids.begin(), define_ids.begin() + define_count, key.define_ids.begin());
 	}
-
 }
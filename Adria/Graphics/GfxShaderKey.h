@@ -5,16 +5,15 @@ namespace adria
 	enum ShaderID : Uint8;
 	struct GfxShaderDefine;
 
+	//Defines are interned into a process wide table, a key stores their ids sorted and inline and keeps its define hash up to date in AddDefine
 	class GfxShaderKey
 	{
-		struct Impl;
 	public:
-		GfxShaderKey();
-		GfxShaderKey(ShaderID shader_id);
-		~GfxShaderKey();
+		//Adding more defines than this is a fatal error, the inline storage keeps keys trivially copyable and hashable as raw bytes
+		static constexpr Uint32 MAX_DEFINES = 15;
 
-		GfxShaderKey(GfxShaderKey const&);
-		GfxShaderKey& operator=(GfxShaderKey const&);
+		GfxShaderKey() = default;
+		GfxShaderKey(ShaderID shader_id) : id(shader_id) {}
 
 		void Init(ShaderID shader_id);
 		void operator=(ShaderID shader_id);
@@ -22,7 +21,7 @@ namespace adria
 		void AddDefine(Char const* name, Char const* value = "");
 		Bool IsValid() const;
 
-		std::vector<GfxShaderDefine> const& GetDefines() const;
+		std::vector<GfxShaderDefine> GetDefines() const;
 		ShaderID GetShaderID() const;
 		Uint64 GetHash() const;
 
@@ -30,7 +29,10 @@ namespace adria
 		Bool operator==(GfxShaderKey const& key) const;
 
 	private:
-		std::unique_ptr<Impl> impl;
+		Uint64 defines_hash = 0;
+		std::array<Uint16, MAX_DEFINES> define_ids{};
+		ShaderID id{}; //ShaderID_Invalid
+		Uint8 define_count = 0;
 	};
 
 	struct GfxShaderKeyHash
@@ -41,4 +43,3 @@ namespace adria
 		}
 	};
 }
-
@@ -3,113 +3,127 @@
 #include "GfxBuffer.h"
 #include "GfxCommandList.h"
 #include "GfxLinearDynamicAllocator.h"
+#include "GfxHeap.h"
 #include "d3dx12.h"
 
 namespace adria
 {
-	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : gfx(gfx), desc(desc)
+	namespace
 	{
-		HRESULT hr = E_FAIL;
-		D3D12MA::ALLOCATION_DESC allocation_desc{};
-		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
-
-		D3D12_RESOURCE_DESC resource_desc{};
-		resource_desc.Format = ConvertGfxFormat(desc.format);
-		resource_desc.Width = desc.width;
-		resource_desc.Height = desc.height;
-		resource_desc.MipLevels = desc.mip_levels;
-		resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-		resource_desc.DepthOrArraySize = (Uint16)desc.array_size;
-		resource_desc.SampleDesc.Count = desc.sample_count;
-		resource_desc.SampleDesc.Quality = 0;
-		resource_desc.Alignment = 0;
-		resource_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-		if (HasAllFlags(desc.bind_flags, GfxBindFlag::DepthStencil))
+		void InitD3D12ResourceDesc(GfxTextureDesc const& desc, D3D12_RESOURCE_DESC& resource_desc)
 		{
-			resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+			resource_desc.Format = ConvertGfxFormat(desc.format);
+			resource_desc.Width = desc.width;
+			resource_desc.Height = desc.height;
+			resource_desc.MipLevels = desc.mip_levels;
+			resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+			resource_desc.DepthOrArraySize = (Uint16)desc.array_size;
+			resource_desc.SampleDesc.Count = desc.sample_count;
+			resource_desc.SampleDesc.Quality = 0;
+			resource_desc.Alignment = 0;
+			resource_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+			if (HasAllFlags(desc.bind_flags, GfxBindFlag::DepthStencil))
+			{
+				resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
 
-			if (!HasAllFlags(desc.bind_flags, GfxBindFlag::ShaderResource))
+				if (!HasAllFlags(desc.bind_flags, GfxBindFlag::ShaderResource))
+				{
+					resource_desc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+				}
+			}
+			if (HasAllFlags(desc.bind_flags, GfxBindFlag::RenderTarget))
 			{
-				resource_desc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+				resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+			}
+			if (HasAllFlags(desc.bind_flags, GfxBindFlag::UnorderedAccess))
+			{
+				resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 			}
-		}
-		if (HasAllFlags(desc.bind_flags, GfxBindFlag::RenderTarget))
-		{
-			resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
-		}
-		if (HasAllFlags(desc.bind_flags, GfxBindFlag::UnorderedAccess))
-		{
-			resource_desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-		}
 
-		switch (desc.type)
-		{
-		case GfxTextureType_1D:
-			resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
-			break;
-		case GfxTextureType_2D:
-			resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-			break;
-		case GfxTextureType_3D:
-			resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
-			resource_desc.DepthOrArraySize = (UINT16)desc.depth;
-			break;
-		default:
-			ADRIA_ASSERT(false && "Invalid Texture Type!");
-			break;
-		}
-		D3D12_CLEAR_VALUE* clear_value_ptr = nullptr;
-		D3D12_CLEAR_VALUE clear_value{};
-		if (HasAnyFlag(desc.bind_flags, GfxBindFlag::DepthStencil) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
-		{
-			clear_value.DepthStencil.Depth = desc.clear_value.depth_stencil.depth;
-			clear_value.DepthStencil.Stencil = desc.clear_value.depth_stencil.stencil;
-			switch (desc.format)
+			switch (desc.type)
 			{
-			case GfxFormat::R16_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D16_UNORM;
-				break;
-			case GfxFormat::R32_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D32_FLOAT;
+			case GfxTextureType_1D:
+				resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
 				break;
-			case GfxFormat::R24G8_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+			case GfxTextureType_2D:
+				resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 				break;
-			case GfxFormat::R32G8X24_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
+			case GfxTextureType_3D:
+				resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+				resource_desc.DepthOrArraySize = (UINT16)desc.depth;
 				break;
 			default:
-				clear_value.Format = ConvertGfxFormat(desc.format);
+				ADRIA_ASSERT(false && "Invalid Texture Type!");
 				break;
 			}
-			clear_value_ptr = &clear_value;
 		}
-		else if (HasAnyFlag(desc.bind_flags, GfxBindFlag::RenderTarget) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
+
+		D3D12_CLEAR_VALUE* InitD3D12ClearValue(GfxTextureDesc const& desc, D3D12_CLEAR_VALUE& clear_value)
 		{
-			clear_value.Color[0] = desc.clear_value.color.color[0];
-			clear_value.Color[1] = desc.clear_value.color.color[1];
-			clear_value.Color[2] = desc.clear_value.color.color[2];
-			clear_value.Color[3] = desc.clear_value.color.color[3];
-			switch (desc.format)
+			if (HasAnyFlag(desc.bind_flags, GfxBindFlag::DepthStencil) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
 			{
-			case GfxFormat::R16_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R16_UNORM;
-				break;
-			case GfxFormat::R32_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R32_FLOAT;
-				break;
-			case GfxFormat::R24G8_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-				break;
-			case GfxFormat::R32G8X24_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
-				break;
-			default:
-				clear_value.Format = ConvertGfxFormat(desc.format);
-				break;
+				clear_value.DepthStencil.Depth = desc.clear_value.depth_stencil.depth;
+				clear_value.DepthStencil.Stencil = desc.clear_value.depth_stencil.stencil;
+				switch (desc.format)
+				{
+				case GfxFormat::R16_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_D16_UNORM;
+					break;
+				case GfxFormat::R32_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_D32_FLOAT;
+					break;
+				case GfxFormat::R24G8_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+					break;
+				case GfxFormat::R32G8X24_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
+					break;
+				default:
+					clear_value.Format = ConvertGfxFormat(desc.format);
+					break;
+				}
+				return &clear_value;
 			}
-			clear_value_ptr = &clear_value;
+			else if (HasAnyFlag(desc.bind_flags, GfxBindFlag::RenderTarget) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
+			{
+				clear_value.Color[0] = desc.clear_value.color.color[0];
+				clear_value.Color[1] = desc.clear_value.color.color[1];
+				clear_value.Color[2] = desc.clear_value.color.color[2];
+				clear_value.Color[3] = desc.clear_value.color.color[3];
+				switch (desc.format)
+				{
+				case GfxFormat::R16_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_R16_UNORM;
+					break;
+				case GfxFormat::R32_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_R32_FLOAT;
+					break;
+				case GfxFormat::R24G8_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+					break;
+				case GfxFormat::R32G8X24_TYPELESS:
+					clear_value.Format = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
+					break;
+				default:
+					clear_value.Format = ConvertGfxFormat(desc.format);
+					break;
+				}
+				return &clear_value;
+			}
+			return nullptr;
 		}
+	}
+
+	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : gfx(gfx), desc(desc)
+	{
+		HRESULT hr = E_FAIL;
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+
+		D3D12_RESOURCE_DESC resource_desc{};
+		InitD3D12ResourceDesc(desc, resource_desc);
+		D3D12_CLEAR_VALUE clear_value{};
+		D3D12_CLEAR_VALUE* clear_value_ptr = InitD3D12ClearValue(desc, clear_value);
 
 		GfxResourceState initial_state = desc.initial_state;
 		if (data.sub_data != nullptr)
@@ -223,6 +237,54 @@ namespace adria
 	{
 	}
 
+	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap const& heap, Uint64 heap_offset) : gfx(gfx), desc(desc)
+	{
+		ADRIA_ASSERT(desc.heap_type == GfxResourceUsage::Default);
+
+		D3D12_RESOURCE_DESC resource_desc{};
+		InitD3D12ResourceDesc(desc, resource_desc);
+		D3D12_CLEAR_VALUE clear_value{};
+		D3D12_CLEAR_VALUE* clear_value_ptr = InitD3D12ClearValue(desc, clear_value);
+
+		HRESULT hr = E_FAIL;
+		auto allocator = gfx->GetAllocator();
+		if (gfx->GetCapabilities().SupportsEnhancedBarriers())
+		{
+			D3D12_RESOURCE_DESC1 resource_desc1 = CD3DX12_RESOURCE_DESC1(resource_desc);
+			hr = allocator->CreateAliasingResource2(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc1,
+				ToD3D12BarrierLayout(desc.initial_state),
+				clear_value_ptr, 0, nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		else
+		{
+			hr = allocator->CreateAliasingResource(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc,
+				ToD3D12LegacyResourceState(desc.initial_state),
+				clear_value_ptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		GFX_CHECK_HR(hr);
+
+		if (desc.mip_levels == 0)
+		{
+			const_cast<GfxTextureDesc&>(this->desc).mip_levels = (uint32_t)log2(std::max<Uint32>(desc.width, desc.height)) + 1;
+		}
+	}
+
+	GfxAllocationInfo GfxTexture::GetAllocationInfo(GfxDevice* gfx, GfxTextureDesc const& desc)
+	{
+		D3D12_RESOURCE_DESC resource_desc{};
+		InitD3D12ResourceDesc(desc, resource_desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info = gfx->GetDevice()->GetResourceAllocationInfo(0, 1, &resource_desc);
+		return GfxAllocationInfo{ .size = allocation_info.SizeInBytes, .alignment = allocation_info.Alignment };
+	}
+
 	GfxTexture::~GfxTexture()
 	{
 		if (mapped_data != nullptr)
@@ -234,7 +296,8 @@ namespace adria
 		if (!is_backbuffer)
 		{
 			gfx->AddToReleaseQueue(resource.Detach());
-			gfx->AddToReleaseQueue(allocation.release());
+			//placed textures alias heap memory owned by a GfxHeap and have no allocation of their own
+			if (allocation) gfx->AddToReleaseQueue(allocation.release());
 		}
 	}
 
@@ -3,6 +3,9 @@
 
 namespace adria
 {
+	class GfxHeap;
+	struct GfxAllocationInfo;
+
 	enum GfxTextureType : Uint8
 	{
 		GfxTextureType_1D,
@@ -112,6 +115,7 @@ namespace adria
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data);
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc);
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer); //constructor used by swapchain for creating backbuffer texture
+		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap const& heap, Uint64 heap_offset); //placed texture, aliases the heap memory at heap_offset
 		ADRIA_NONCOPYABLE_NONMOVABLE(GfxTexture)
 		~GfxTexture();
 
@@ -135,6 +139,8 @@ namespace adria
 
 		void SetName(Char const* name);
 
+		static GfxAllocationInfo GetAllocationInfo(GfxDevice* gfx, GfxTextureDesc const& desc);
+
 	private:
 		GfxDevice* gfx;
 		Ref<ID3D12Resource> resource;
@@ -0,0 +1,268 @@
+#include "BinaryLogDecoder.h"
+#include "BinaryLogWriter.h"
+#include "Logger.h"
+#include <chrono>
+#include <ctime>
+#include <cstring>
+
+namespace adria
+{
+	namespace
+	{
+		struct BinaryLogFormat
+		{
+			std::string file;
+			Uint32 line = 0;
+			std::string format;
+		};
+
+		class BinaryLogReader
+		{
+		public:
+			BinaryLogReader(Uint8 const* data, Uint64 size) : data(data), size(size) {}
+
+			Bool Read(void* dst, Uint64 byte_count)
+			{
+				if (offset + byte_count > size) return false;
+				memcpy(dst, data + offset, byte_count);
+				offset += byte_count;
+				return true;
+			}
+
+			template<typename T>
+			Bool Read(T& value)
+			{
+				return Read(&value, sizeof(T));
+			}
+
+			Bool ReadString(std::string& str, Uint32 length)
+			{
+				if (offset + length > size) return false;
+				str.assign(reinterpret_cast<Char const*>(data + offset), length);
+				offset += length;
+				return true;
+			}
+
+		private:
+			Uint8 const* data;
+			Uint64 size;
+			Uint64 offset = 0;
+		};
+
+		struct BinaryLogArg
+		{
+			BinaryLogArgType type;
+			Uint64 value = 0;
+			Float64 float_value = 0.0;
+			std::string string_value;
+		};
+
+		Bool ReadArg(BinaryLogReader& reader, BinaryLogArg& arg)
+		{
+			if (!reader.Read(arg.type)) return false;
+			switch (arg.type)
+			{
+			case BinaryLogArgType::Int32:
+			{
+				Int32 value;
+				if (!reader.Read(value)) return false;
+				arg.value = (Uint64)(Int64)value;
+				return true;
+			}
+			case BinaryLogArgType::Uint32:
+			{
+				Uint32 value;
+				if (!reader.Read(value)) return false;
+				arg.value = value;
+				return true;
+			}
+			case BinaryLogArgType::Int64:
+			case BinaryLogArgType::Uint64:
+			case BinaryLogArgType::Pointer:
+				return reader.Read(arg.value);
+			case BinaryLogArgType::Float64:
+				return reader.Read(arg.float_value);
+			case BinaryLogArgType::String:
+			{
+				Uint32 length;
+				return reader.Read(length) && reader.ReadString(arg.string_value, length);
+			}
+			}
+			return false;
+		}
+
+		void AppendFormatted(std::string& output, Char const* spec, auto... values)
+		{
+			Int const length = snprintf(nullptr, 0, spec, values...);
+			if (length <= 0) return;
+			Uint64 const offset = output.size();
+			output.resize(offset + length + 1);
+			snprintf(output.data() + offset, length + 1, spec, values...);
+			output.resize(offset + length);
+		}
+
+		Bool IsIntegerConversion(Char conversion)
+		{
+			return strchr("diouxXc", conversion) != nullptr;
+		}
+
+		Bool IsFloatConversion(Char conversion)
+		{
+			return strchr("fFeEgGaA", conversion) != nullptr;
+		}
+
+		//Applies one printf conversion to a captured argument. Length modifiers of the format are dropped and replaced
+		//with the ones matching the captured type, so the output does not depend on the ABI the capture was made with.
+		void FormatArg(std::string& output, std::string spec, Char conversion, BinaryLogArg const& arg)
+		{
+			switch (arg.type)
+			{
+			case BinaryLogArgType::Int32:
+			case BinaryLogArgType::Uint32:
+			case BinaryLogArgType::Int64:
+			case BinaryLogArgType::Uint64:
+			{
+				Bool const is_signed = arg.type == BinaryLogArgType::Int32 || arg.type == BinaryLogArgType::Int64;
+				if (conversion == 'c') AppendFormatted(output, (spec + 'c').c_str(), (Int)arg.value);
+				else if (IsFloatConversion(conversion)) AppendFormatted(output, (spec + conversion).c_str(), is_signed ? (Float64)(Int64)arg.value : (Float64)arg.value);
+				else if (IsIntegerConversion(conversion)) AppendFormatted(output, (spec + "ll" + conversion).c_str(), arg.value);
+				else AppendFormatted(output, (spec + (is_signed ? "lld" : "llu")).c_str(), arg.value);
+			}
+			break;
+			case BinaryLogArgType::Pointer:
+				if (IsIntegerConversion(conversion)) AppendFormatted(output, (spec + "ll" + conversion).c_str(), arg.value);
+				else AppendFormatted(output, "0x%016llX", arg.value);
+				break;
+			case BinaryLogArgType::Float64:
+				AppendFormatted(output, (spec + (IsFloatConversion(conversion) ? conversion : 'g')).c_str(), arg.float_value);
+				break;
+			case BinaryLogArgType::String:
+				AppendFormatted(output, (spec + 's').c_str(), arg.string_value.c_str());
+				break;
+			}
+		}
+
+		//Walks the printf format and consumes one captured argument per conversion, '*' width and precision included
+		std::string DecodeMessage(std::string const& format, std::vector<BinaryLogArg> const& args)
+		{
+			std::string output;
+			Uint64 arg_index = 0;
+			auto NextArg = [&]() -> BinaryLogArg const* { return arg_index < args.size() ? &args[arg_index++] : nullptr; };
+
+			for (Uint64 i = 0; i < format.size(); ++i)
+			{
+				if (format[i] != '%')
+				{
+					output += format[i];
+					continue;
+				}
+				if (i + 1 < format.size() && format[i + 1] == '%')
+				{
+					output += '%';
+					++i;
+					continue;
+				}
+
+				std::string spec = "%";
+				Uint64 j = i + 1;
+				while (j < format.size() && strchr("-+ #0", format[j])) spec += format[j++];
+				auto ReadNumber = [&]()
+				{
+					if (j < format.size() && format[j] == '*')
+					{
+						BinaryLogArg const* arg = NextArg();
+						spec += std::to_string(arg ? (Int64)arg->value : 0);
+						++j;
+					}
+					else while (j < format.size() && isdigit((Uchar)format[j])) spec += format[j++];
+				};
+				ReadNumber();
+				if (j < format.size() && format[j] == '.')
+				{
+					spec += format[j++];
+					ReadNumber();
+				}
+				while (j < format.size() && strchr("hljztLIw", format[j])) ++j;
+				if (j >= format.size()) break;
+
+				Char const conversion = format[j];
+				i = j;
+				if (conversion == 'n') continue;
+				if (BinaryLogArg const* arg = NextArg()) FormatArg(output, spec, conversion, *arg);
+				else output += "<missing argument>";
+			}
+			return output;
+		}
+
+		std::string FormatTime(Int64 time)
+		{
+			auto const time_point = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(time)));
+			time_t c_time = std::chrono::system_clock::to_time_t(time_point);
+			std::string time_str = std::string(ctime(&c_time));
+			time_str.pop_back();
+			return "[" + time_str + "]";
+		}
+	}
+
+	Bool DecodeBinaryLog(Char const* binary_log_path, Char const* text_log_path)
+	{
+		std::ifstream input(binary_log_path, std::ios::binary | std::ios::ate);
+		if (!input.is_open()) return false;
+		std::vector<Uint8> data((Uint64)input.tellg());
+		input.seekg(0);
+		input.read(reinterpret_cast<Char*>(data.data()), data.size());
+
+		BinaryLogFileHeader file_header{};
+		if (data.size() < sizeof(file_header)) return false;
+		memcpy(&file_header, data.data(), sizeof(file_header));
+		if (file_header.magic != BinaryLogFileHeader::MAGIC || file_header.version != BinaryLogFileHeader::VERSION) return false;
+
+		std::ofstream output(text_log_path, std::ios::out);
+		if (!output.is_open()) return false;
+
+		std::unordered_map<Uint32, BinaryLogFormat> formats;
+		std::vector<BinaryLogArg> args;
+		std::string entry;
+		Uint64 offset = (sizeof(file_header) + BinaryLogWriter::RECORD_ALIGNMENT - 1) & ~(BinaryLogWriter::RECORD_ALIGNMENT - 1);
+		while (offset + sizeof(BinaryLogRecordHeader) <= data.size())
+		{
+			BinaryLogRecordHeader header{};
+			memcpy(&header, data.data() + offset, sizeof(header));
+			if (header.size < sizeof(header) || offset + header.size > data.size()) break;
+
+			BinaryLogReader reader(data.data() + offset + sizeof(header), header.size - sizeof(header));
+			offset += header.size;
+
+			entry.clear();
+			Uint32 line = 0;
+			if (header.type == BinaryLogRecordType::Format || header.type == BinaryLogRecordType::Text)
+			{
+				Uint32 file_length = 0, text_length = 0;
+				std::string record_file;
+				if (!reader.Read(line) || !reader.Read(file_length) || !reader.Read(text_length)) continue;
+				if (!reader.ReadString(record_file, file_length) || !reader.ReadString(entry, text_length)) continue;
+
+				if (header.type == BinaryLogRecordType::Format)
+				{
+					formats[header.format_id] = BinaryLogFormat{ std::move(record_file), line, std::move(entry) };
+					continue;
+				}
+				output << FormatTime(file_header.start_time + header.timestamp) << LineInfoToString(record_file.c_str(), line) << LevelToString(header.level) << entry << '\n';
+				continue;
+			}
+
+			auto format_it = formats.find(header.format_id);
+			if (format_it == formats.end()) continue;
+			BinaryLogFormat const& format = format_it->second;
+
+			args.resize(header.arg_count);
+			Bool valid = true;
+			for (BinaryLogArg& arg : args) valid = valid && ReadArg(reader, arg);
+			if (!valid) continue;
+
+			entry = DecodeMessage(format.format, args);
+			output << FormatTime(file_header.start_time + header.timestamp) << LineInfoToString(format.file.c_str(), format.line) << LevelToString(header.level) << entry << '\n';
+		}
+		return true;
+	}
+}
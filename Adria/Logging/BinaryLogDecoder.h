@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Rebuilds a text log in the FileLogger format from a capture written by BinaryLogWriter, returns false if the capture cannot be read.
+	//Decoding stops at the first unfinished record, which can only happen when the capturing process did not exit cleanly.
+	Bool DecodeBinaryLog(Char const* binary_log_path, Char const* text_log_path);
+}
@@ -0,0 +1,165 @@
+#include "BinaryLogWriter.h"
+#include "Logger.h"
+#include "Core/Paths.h"
+#include <chrono>
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 AlignRecordSize(Uint64 size)
+		{
+			return (size + BinaryLogWriter::RECORD_ALIGNMENT - 1) & ~(BinaryLogWriter::RECORD_ALIGNMENT - 1);
+		}
+
+		Int64 GetSteadyTime()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		Int64 GetSystemTime()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		}
+	}
+
+	BinaryLogWriter::BinaryLogWriter(Char const* log_file, Uint64 _capacity) : capacity(AlignRecordSize(_capacity))
+	{
+		std::string const log_path = paths::LogDir + log_file;
+		HANDLE file = CreateFileA(log_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return;
+		file_handle = file;
+
+		//mapping a file larger than its size grows it, the unused tail is truncated in the destructor
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(capacity >> 32), (DWORD)(capacity & 0xffffffff), nullptr);
+		if (!mapping) return;
+		mapping_handle = mapping;
+
+		view = static_cast<Uint8*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity));
+		if (!view) return;
+
+		start_steady_time = GetSteadyTime();
+		BinaryLogFileHeader header{};
+		header.magic = BinaryLogFileHeader::MAGIC;
+		header.version = BinaryLogFileHeader::VERSION;
+		header.start_time = GetSystemTime();
+		memcpy(view, &header, sizeof(header));
+		write_offset.store(AlignRecordSize(sizeof(header)));
+	}
+
+	BinaryLogWriter::~BinaryLogWriter()
+	{
+		Uint64 const used_size = std::min(write_offset.load(), capacity);
+		if (view) UnmapViewOfFile(view);
+		if (mapping_handle) CloseHandle(mapping_handle);
+		if (file_handle)
+		{
+			LARGE_INTEGER file_size{};
+			file_size.QuadPart = (LONGLONG)used_size;
+			if (SetFilePointerEx(file_handle, file_size, nullptr, FILE_BEGIN)) SetEndOfFile(file_handle);
+			CloseHandle(file_handle);
+		}
+	}
+
+	Uint32 BinaryLogWriter::RegisterFormat(LogLevel level, Char const* format, Char const* file, Uint32 line)
+	{
+		Uint32 const format_id = next_format_id.fetch_add(1, std::memory_order_relaxed);
+		Uint32 const file_length = GetStringLength(file);
+		Uint32 const format_length = GetStringLength(format);
+		Uint64 const payload_size = 3 * sizeof(Uint32) + file_length + format_length;
+		Uint8* record = BeginRecord(sizeof(BinaryLogRecordHeader) + payload_size);
+		//the id is still handed out when the record is dropped, messages using it are dropped as well once the file is full
+		if (!record) return format_id;
+
+		Uint8* payload = record + sizeof(BinaryLogRecordHeader);
+		memcpy(payload, &line, sizeof(Uint32));
+		memcpy(payload + sizeof(Uint32), &file_length, sizeof(Uint32));
+		memcpy(payload + 2 * sizeof(Uint32), &format_length, sizeof(Uint32));
+		payload += 3 * sizeof(Uint32);
+		if (file_length) memcpy(payload, file, file_length);
+		if (format_length) memcpy(payload + file_length, format, format_length);
+		EndRecord(record, payload_size, BinaryLogRecordType::Format, level, format_id, 0);
+		return format_id;
+	}
+
+	void BinaryLogWriter::WriteText(LogLevel level, Char const* text, Char const* file, Uint32 line)
+	{
+		Uint32 const file_length = GetStringLength(file);
+		Uint32 const text_length = GetStringLength(text);
+		Uint64 const payload_size = 3 * sizeof(Uint32) + file_length + text_length;
+		Uint8* record = BeginRecord(sizeof(BinaryLogRecordHeader) + payload_size);
+		if (!record) return;
+
+		Uint8* payload = record + sizeof(BinaryLogRecordHeader);
+		memcpy(payload, &line, sizeof(Uint32));
+		memcpy(payload + sizeof(Uint32), &file_length, sizeof(Uint32));
+		memcpy(payload + 2 * sizeof(Uint32), &text_length, sizeof(Uint32));
+		payload += 3 * sizeof(Uint32);
+		if (file_length) memcpy(payload, file, file_length);
+		if (text_length) memcpy(payload + file_length, text, text_length);
+		EndRecord(record, payload_size, BinaryLogRecordType::Text, level, 0, 0);
+	}
+
+	void BinaryLogWriter::FindPointerConversions(Char const* format, Bool* pointer_args, Uint64 arg_count)
+	{
+		Uint64 arg_index = 0;
+		for (Char const* c = format; *c && arg_index < arg_count; ++c)
+		{
+			if (*c != '%') continue;
+			if (*(c + 1) == '%')
+			{
+				++c;
+				continue;
+			}
+
+			++c;
+			while (*c && strchr("-+ #0", *c)) ++c;
+			//a '*' width or precision consumes an argument of its own
+			auto SkipNumber = [&]()
+			{
+				if (*c == '*')
+				{
+					++arg_index;
+					++c;
+				}
+				else while (*c >= '0' && *c <= '9') ++c;
+			};
+			SkipNumber();
+			if (*c == '.')
+			{
+				++c;
+				SkipNumber();
+			}
+			while (*c && strchr("hljztLIw", *c)) ++c;
+			if (!*c) break;
+			if (*c == 'n') continue;
+			if (arg_index < arg_count) pointer_args[arg_index] = *c == 'p';
+			++arg_index;
+		}
+	}
+
+	Uint8* BinaryLogWriter::BeginRecord(Uint64 size)
+	{
+		if (!view) return nullptr;
+		size = AlignRecordSize(size);
+		Uint64 const offset = write_offset.fetch_add(size, std::memory_order_relaxed);
+		if (offset + size > capacity)
+		{
+			dropped_records.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		return view + offset;
+	}
+
+	void BinaryLogWriter::EndRecord(Uint8* record, Uint64 payload_size, BinaryLogRecordType type, LogLevel level, Uint32 format_id, Uint16 arg_count)
+	{
+		BinaryLogRecordHeader* header = reinterpret_cast<BinaryLogRecordHeader*>(record);
+		header->format_id = format_id;
+		header->timestamp = GetSteadyTime() - start_steady_time;
+		header->type = type;
+		header->level = level;
+		header->arg_count = arg_count;
+		//a record with zero size is unfinished, the decoder stops there
+		std::atomic_ref<Uint32>(header->size).store((Uint32)AlignRecordSize(sizeof(BinaryLogRecordHeader) + payload_size), std::memory_order_release);
+	}
+}
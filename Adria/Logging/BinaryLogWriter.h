@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace adria
+{
+	enum class LogLevel : Uint8;
+
+	enum class BinaryLogRecordType : Uint8
+	{
+		Format,
+		Message,
+		Text
+	};
+
+	enum class BinaryLogArgType : Uint8
+	{
+		Int32,
+		Uint32,
+		Int64,
+		Uint64,
+		Float64,
+		Pointer,
+		String
+	};
+
+	struct BinaryLogFileHeader
+	{
+		static constexpr Uint32 MAGIC = 0x474C4241; //ABLG
+		static constexpr Uint32 VERSION = 1;
+
+		Uint32 magic;
+		Uint32 version;
+		//system clock time at which the capture started in nanoseconds, record timestamps are relative to it
+		Int64 start_time;
+	};
+
+	//Records are 8 byte aligned, size covers the header, the payload and the padding and is written last.
+	//Format records carry line, file and format string of one log site, message records only the raw arguments of that site.
+	struct BinaryLogRecordHeader
+	{
+		Uint32 size;
+		Uint32 format_id;
+		Int64 timestamp;
+		BinaryLogRecordType type;
+		LogLevel level;
+		Uint16 arg_count;
+	};
+
+	//Writes log records into a memory mapped file. Producers reserve space with a single atomic add and copy the
+	//arguments without formatting them, records which do not fit into the file anymore are dropped and counted.
+	class BinaryLogWriter
+	{
+	public:
+		static constexpr Uint64 RECORD_ALIGNMENT = 8;
+		static constexpr Uint32 MAX_STRING_LENGTH = 4096;
+
+		BinaryLogWriter(Char const* log_file, Uint64 capacity);
+		ADRIA_NONCOPYABLE_NONMOVABLE(BinaryLogWriter)
+		~BinaryLogWriter();
+
+		Bool IsOpen() const { return view != nullptr; }
+
+		Uint32 RegisterFormat(LogLevel level, Char const* format, Char const* file, Uint32 line);
+
+		//format has to be the one registered as format_id, character pointers are captured as strings unless it prints them with %p
+		template<typename... Args>
+		void WriteMessage(Uint32 format_id, LogLevel level, Char const* format, Args const&... args)
+		{
+			static_assert(sizeof...(Args) <= UINT16_MAX);
+			Bool pointer_args[sizeof...(Args) + 1] = {};
+			if constexpr ((IsStringArg<Args>() || ...)) FindPointerConversions(format, pointer_args, sizeof...(Args));
+
+			Uint64 arg_index = 0;
+			Uint64 payload_size = 0;
+			((payload_size += GetArgSize(args, pointer_args[arg_index++])), ...);
+			Uint8* record = BeginRecord(sizeof(BinaryLogRecordHeader) + payload_size);
+			if (!record) return;
+
+			Uint8* payload = record + sizeof(BinaryLogRecordHeader);
+			arg_index = 0;
+			(WriteArg(payload, args, pointer_args[arg_index++]), ...);
+			EndRecord(record, payload_size, BinaryLogRecordType::Message, level, format_id, sizeof...(Args));
+		}
+
+		void WriteText(LogLevel level, Char const* text, Char const* file, Uint32 line);
+
+		Uint64 GetDroppedRecordCount() const { return dropped_records.load(std::memory_order_relaxed); }
+
+	private:
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+		Uint8* view = nullptr;
+		Uint64 capacity = 0;
+		Int64 start_steady_time = 0;
+		alignas(64) std::atomic<Uint64> write_offset = 0;
+		alignas(64) std::atomic<Uint32> next_format_id = 1;
+		std::atomic<Uint64> dropped_records = 0;
+
+	private:
+		Uint8* BeginRecord(Uint64 size);
+		void EndRecord(Uint8* record, Uint64 payload_size, BinaryLogRecordType type, LogLevel level, Uint32 format_id, Uint16 arg_count);
+		//Sets pointer_args[i] when the conversion consuming argument i is %p, arguments are counted the way the decoder consumes them
+		static void FindPointerConversions(Char const* format, Bool* pointer_args, Uint64 arg_count);
+
+		template<typename T>
+		static constexpr BinaryLogArgType GetArgType()
+		{
+			using U = std::decay_t<T>;
+			if constexpr (std::is_enum_v<U>) return GetArgType<std::underlying_type_t<U>>();
+			else if constexpr (std::is_same_v<U, Char*> || std::is_same_v<U, Char const*> || std::is_same_v<U, wchar_t*> || std::is_same_v<U, wchar_t const*>) return BinaryLogArgType::String;
+			else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) return BinaryLogArgType::Pointer;
+			else if constexpr (std::is_floating_point_v<U>) return BinaryLogArgType::Float64;
+			else if constexpr (std::is_integral_v<U> && sizeof(U) <= sizeof(Uint32)) return std::is_signed_v<U> ? BinaryLogArgType::Int32 : BinaryLogArgType::Uint32;
+			else if constexpr (std::is_integral_v<U>) return std::is_signed_v<U> ? BinaryLogArgType::Int64 : BinaryLogArgType::Uint64;
+			else static_assert(!sizeof(U), "Log argument type cannot be captured, pass a printf compatible argument instead");
+		}
+
+		template<typename T>
+		static constexpr Bool IsStringArg()
+		{
+			return GetArgType<T>() == BinaryLogArgType::String;
+		}
+
+		template<typename C>
+		static Uint32 GetStringLength(C const* str)
+		{
+			if (!str) return 0;
+			Uint32 length = 0;
+			while (length < MAX_STRING_LENGTH && str[length]) ++length;
+			return length;
+		}
+
+		template<typename T>
+		static Uint64 GetArgSize(T const& arg, Bool as_pointer)
+		{
+			constexpr BinaryLogArgType type = GetArgType<T>();
+			if constexpr (type == BinaryLogArgType::String)
+			{
+				if (as_pointer) return sizeof(BinaryLogArgType) + sizeof(Uint64);
+				return sizeof(BinaryLogArgType) + sizeof(Uint32) + GetStringLength(static_cast<std::decay_t<T>>(arg));
+			}
+			else if constexpr (type == BinaryLogArgType::Int32 || type == BinaryLogArgType::Uint32) return sizeof(BinaryLogArgType) + sizeof(Uint32);
+			else return sizeof(BinaryLogArgType) + sizeof(Uint64);
+		}
+
+		template<typename T>
+		static void WriteArg(Uint8*& dst, T const& arg, Bool as_pointer)
+		{
+			constexpr BinaryLogArgType type = GetArgType<T>();
+			auto WriteValue = [&dst]<typename V>(V value)
+			{
+				memcpy(dst, &value, sizeof(V));
+				dst += sizeof(V);
+			};
+
+			if constexpr (type == BinaryLogArgType::String)
+			{
+				auto const* str = static_cast<std::decay_t<T>>(arg);
+				if (as_pointer)
+				{
+					*dst++ = static_cast<Uint8>(BinaryLogArgType::Pointer);
+					WriteValue((Uint64)reinterpret_cast<Uintptr>(static_cast<void const*>(str)));
+					return;
+				}
+				*dst++ = static_cast<Uint8>(type);
+				Uint32 const length = GetStringLength(str);
+				WriteValue(length);
+				if constexpr (sizeof(*str) == sizeof(Char)) { if (length) memcpy(dst, str, length); }
+				//wide strings are narrowed, characters outside of ASCII are replaced
+				else for (Uint32 i = 0; i < length; ++i) dst[i] = (Uint32)str[i] < 0x80 ? (Char)str[i] : '?';
+				dst += length;
+			}
+			else
+			{
+				*dst++ = static_cast<Uint8>(type);
+				if constexpr (type == BinaryLogArgType::Pointer) WriteValue((Uint64)reinterpret_cast<Uintptr>(static_cast<void const*>(arg)));
+				else if constexpr (type == BinaryLogArgType::Float64) WriteValue((Float64)arg);
+				else if constexpr (type == BinaryLogArgType::Int32)	 WriteValue((Int32)arg);
+				else if constexpr (type == BinaryLogArgType::Uint32) WriteValue((Uint32)arg);
+				else if constexpr (type == BinaryLogArgType::Int64)	 WriteValue((Int64)arg);
+				else WriteValue((Uint64)arg);
+			}
+		}
+	};
+}
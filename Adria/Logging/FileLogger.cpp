@@ -16,7 +16,17 @@ namespace adria
 	void FileLogger::Log(LogLevel level, Char const* entry, Char const* file, uint32_t line)
 	{
 		if (level < logger_level) return;
-		log_stream << GetLogTime() + LineInfoToString(file, line) + LevelToString(level) + std::string(entry) << "\n";
+		batch += GetLogTime();
+		batch += LineInfoToString(file, line);
+		batch += LevelToString(level);
+		batch += entry;
+		batch += '\n';
+	}
+	void FileLogger::Flush()
+	{
+		log_stream.write(batch.data(), batch.size());
+		log_stream.flush();
+		batch.clear();
 	}
 
 }
@@ -10,9 +10,11 @@ namespace adria
 		FileLogger(Char const* log_file, LogLevel logger_level = LogLevel::LOG_DEBUG);
 		virtual ~FileLogger() override;
 		virtual void Log(LogLevel level, Char const* entry, Char const* file, Uint32 line) override;
+		virtual void Flush() override;
 	private:
 		std::ofstream log_stream;
 		LogLevel const logger_level;
+		std::string batch;
 	};
 
 }
\ No newline at end of file
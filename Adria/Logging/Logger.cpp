@@ -1,57 +1,265 @@
 #include "Logger.h"
 #include <chrono>
 #include <ctime>   
+#include <cstdarg>
+#include <cstring>
 #include <vector>
+#include <array>
 #include <thread>
-#include "Utilities/ConcurrentQueue.h"
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 namespace adria
 {
-	struct QueueEntry
+	struct LogRecord
 	{
-		LogLevel level;
-		std::string str;
-		std::string filename;
+		static constexpr Uint64 MESSAGE_SIZE = 512 - sizeof(Char const*) - sizeof(Uint32) - sizeof(LogLevel);
+
+		Char const* file;
 		Uint32 line;
+		LogLevel level;
+		Char message[MESSAGE_SIZE];
+	};
+
+	//Fixed size ring written by one logging thread and drained by the log thread. When the thread exits the ring is freed
+	//and handed to the next thread that logs, records it left behind are still drained
+	struct LogRing
+	{
+		static constexpr Uint64 CAPACITY = 256;
+
+		std::unique_ptr<LogRecord[]> records = std::make_unique<LogRecord[]>(CAPACITY);
+		std::atomic<Bool> in_use = true;
+		alignas(64) std::atomic<Uint64> write_index = 0;
+		std::atomic<Bool> writer_waiting = false;
+		alignas(64) std::atomic<Uint64> read_index = 0;
+	};
+
+	//Ring of the calling thread in one log manager. The ring is only referenced weakly, so a thread that outlives the manager
+	//does not touch it on exit
+	struct ThreadLogRing
+	{
+		Uint64 manager_id;
+		LogRing* ring;
+		std::weak_ptr<LogRing> owned_ring;
+		Bool release_on_exit;
+
+		ThreadLogRing(Uint64 manager_id, std::shared_ptr<LogRing> const& ring, Bool release_on_exit)
+			: manager_id(manager_id), ring(ring.get()), owned_ring(ring), release_on_exit(release_on_exit) {}
+		ThreadLogRing(ThreadLogRing&&) = default;
+		ThreadLogRing& operator=(ThreadLogRing&&) = default;
+		~ThreadLogRing()
+		{
+			if (!release_on_exit) return;
+			if (std::shared_ptr<LogRing> exiting_ring = owned_ring.lock()) exiting_ring->in_use.store(false, std::memory_order_release);
+		}
 	};
 
 	class LogManagerImpl
 	{
+		static constexpr Uint64 MAX_LOG_THREADS = 128;
+
 	public:
 
-		LogManagerImpl() : log_thread(&LogManagerImpl::ProcessLogs, this) {}
+		LogManagerImpl() : manager_id(next_manager_id.fetch_add(1) + 1), log_thread(&LogManagerImpl::ProcessLogs, this) {}
 		~LogManagerImpl()
 		{
 			exit.store(true);
+			wake_epoch.fetch_add(1);
+			wake_epoch.notify_one();
 			log_thread.join();
 		}
 
 		void RegisterLogger(ILogger* logger)
 		{
+			std::lock_guard<std::mutex> lock(loggers_mutex);
 			loggers.emplace_back(logger);
 		}
+
 		void Log(LogLevel level, Char const* str, Char const* filename, Uint32 line)
 		{
-			log_queue.Push(QueueEntry{ level, str, filename, line });
+			LogRing& ring = GetThreadRing();
+			LogRecord& record = BeginRecord(ring);
+			record.level = level;
+			record.file = filename;
+			record.line = line;
+			strncpy(record.message, str, LogRecord::MESSAGE_SIZE - 1);
+			record.message[LogRecord::MESSAGE_SIZE - 1] = '\0';
+			CommitRecord(ring);
+		}
+
+		void LogFormat(LogLevel level, Char const* filename, Uint32 line, Char const* format, va_list args)
+		{
+			LogRing& ring = GetThreadRing();
+			LogRecord& record = BeginRecord(ring);
+			record.level = level;
+			record.file = filename;
+			record.line = line;
+			vsnprintf(record.message, LogRecord::MESSAGE_SIZE, format, args);
+			CommitRecord(ring);
 		}
 
+	private:
+		std::mutex loggers_mutex;
 		std::vector<std::unique_ptr<ILogger>> loggers;
-		ConcurrentQueue<QueueEntry> log_queue;
-		std::thread log_thread;
+		//only touched by the log thread, records are copied out of the rings so that sinks run without holding any lock
+		std::vector<LogRecord> drained_records;
+		std::vector<ILogger*> drained_loggers;
+
+		//thread local ring lookups are keyed by the manager id, a new manager at the address of a destroyed one gets a new id
+		inline static std::atomic<Uint64> next_manager_id = 0;
+		Uint64 const manager_id;
+
+		std::array<std::atomic<LogRing*>, MAX_LOG_THREADS> rings{};
+		//owns the rings, slot i is written once by the thread that claims it, before rings[i] is published
+		std::array<std::shared_ptr<LogRing>, MAX_LOG_THREADS> owned_rings{};
+		std::atomic<Uint64> ring_count = 0;
+		//threads past MAX_LOG_THREADS share the last ring and serialize on this mutex
+		std::mutex shared_ring_mutex;
+
 		std::atomic_bool exit = false;
+		std::atomic<Bool> log_thread_parked = false;
+		std::atomic<Uint32> wake_epoch = 0;
+		std::thread log_thread;
 
 	private:
-		void ProcessLogs()
+		LogRing& GetThreadRing()
 		{
-			QueueEntry entry{};
-			while (true)
+			//usually holds a single entry, one per log manager the thread has logged to, the destructors free the rings on thread exit
+			thread_local std::vector<ThreadLogRing> thread_rings;
+			for (ThreadLogRing const& thread_ring : thread_rings)
+			{
+				if (thread_ring.manager_id == manager_id) return *thread_ring.ring;
+			}
+			std::erase_if(thread_rings, [](ThreadLogRing const& thread_ring) { return thread_ring.owned_ring.expired(); });
+
+			Uint64 const count = std::min<Uint64>(ring_count.load(), MAX_LOG_THREADS - 1);
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				LogRing* ring = rings[i].load(std::memory_order_acquire);
+				Bool in_use = false;
+				if (ring && ring->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+				{
+					return *thread_rings.emplace_back(manager_id, owned_rings[i], true).ring;
+				}
+			}
+
+			Uint64 const ring_index = ring_count.fetch_add(1);
+			if (ring_index < MAX_LOG_THREADS - 1)
+			{
+				owned_rings[ring_index] = std::make_shared<LogRing>();
+				rings[ring_index].store(owned_rings[ring_index].get(), std::memory_order_release);
+				return *thread_rings.emplace_back(manager_id, owned_rings[ring_index], true).ring;
+			}
+
+			//threads past MAX_LOG_THREADS - 1 live at once share the last ring, it is never freed
+			std::lock_guard<std::mutex> lock(shared_ring_mutex);
+			if (!owned_rings[MAX_LOG_THREADS - 1])
+			{
+				owned_rings[MAX_LOG_THREADS - 1] = std::make_shared<LogRing>();
+				rings[MAX_LOG_THREADS - 1].store(owned_rings[MAX_LOG_THREADS - 1].get(), std::memory_order_release);
+			}
+			return *thread_rings.emplace_back(manager_id, owned_rings[MAX_LOG_THREADS - 1], false).ring;
+		}
+
+		Bool IsSharedRing(LogRing const& ring) const
+		{
+			return &ring == rings[MAX_LOG_THREADS - 1].load(std::memory_order_relaxed);
+		}
+
+		LogRecord& BeginRecord(LogRing& ring)
+		{
+			if (IsSharedRing(ring)) shared_ring_mutex.lock();
+			Uint64 const write_index = ring.write_index.load(std::memory_order_relaxed);
+			Uint64 read_index = ring.read_index.load(std::memory_order_acquire);
+			if (write_index - read_index >= LogRing::CAPACITY)
 			{
-				Bool success = log_queue.TryPop(entry);
-				if (success)
+				//a full ring parks the writer until the log thread frees a record, pairs with the fence in DrainRings
+				ring.writer_waiting.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				while (write_index - (read_index = ring.read_index.load(std::memory_order_acquire)) >= LogRing::CAPACITY)
 				{
-					for (auto&& logger : loggers) if (logger) logger->Log(entry.level, entry.str.c_str(), entry.filename.c_str(), entry.line);
+					WakeLogThread();
+					ring.read_index.wait(read_index, std::memory_order_acquire);
 				}
-				if (exit.load() && log_queue.Empty()) break;
+				ring.writer_waiting.store(false, std::memory_order_relaxed);
+			}
+			return ring.records[write_index % LogRing::CAPACITY];
+		}
+
+		void CommitRecord(LogRing& ring)
+		{
+			ring.write_index.store(ring.write_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			if (IsSharedRing(ring)) shared_ring_mutex.unlock();
+			WakeLogThread();
+		}
+
+		void WakeLogThread()
+		{
+			//pairs with the fence in ProcessLogs: either the log thread sees the record or this sees the log thread parked
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (log_thread_parked.load(std::memory_order_relaxed))
+			{
+				wake_epoch.fetch_add(1);
+				wake_epoch.notify_one();
+			}
+		}
+
+		Bool HasPendingRecords() const
+		{
+			Uint64 const count = std::min<Uint64>(ring_count.load(), MAX_LOG_THREADS);
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				LogRing const* ring = rings[i].load(std::memory_order_acquire);
+				if (ring && ring->read_index.load(std::memory_order_relaxed) != ring->write_index.load(std::memory_order_acquire)) return true;
+			}
+			return false;
+		}
+
+		Bool DrainRings()
+		{
+			drained_records.clear();
+			Uint64 const count = std::min<Uint64>(ring_count.load(), MAX_LOG_THREADS);
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				LogRing* ring = rings[i].load(std::memory_order_acquire);
+				if (!ring) continue;
+
+				Uint64 const read_index = ring->read_index.load(std::memory_order_relaxed);
+				Uint64 const write_index = ring->write_index.load(std::memory_order_acquire);
+				if (read_index == write_index) continue;
+				for (Uint64 j = read_index; j < write_index; ++j) drained_records.push_back(ring->records[j % LogRing::CAPACITY]);
+				ring->read_index.store(write_index, std::memory_order_release);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (ring->writer_waiting.load(std::memory_order_relaxed)) ring->read_index.notify_all();
+			}
+			if (drained_records.empty()) return false;
+
+			{
+				std::lock_guard<std::mutex> lock(loggers_mutex);
+				drained_loggers.clear();
+				for (auto&& logger : loggers) if (logger) drained_loggers.push_back(logger.get());
+			}
+			for (LogRecord const& record : drained_records)
+			{
+				for (ILogger* logger : drained_loggers) logger->Log(record.level, record.message, record.file, record.line);
+			}
+			for (ILogger* logger : drained_loggers) logger->Flush();
+			return true;
+		}
+
+		void ProcessLogs()
+		{
+			while (true)
+			{
+				Uint32 const epoch = wake_epoch.load();
+				if (DrainRings()) continue;
+				if (exit.load()) break;
+
+				log_thread_parked.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (!HasPendingRecords() && !exit.load()) wake_epoch.wait(epoch);
+				log_thread_parked.store(false, std::memory_order_relaxed);
 			}
 		}
 	};
@@ -85,7 +293,10 @@ namespace adria
 	}
 
 	LogManager::LogManager() : pimpl(new LogManagerImpl) {}
-	LogManager::~LogManager() = default;
+	LogManager::~LogManager()
+	{
+		binary_log_writer.store(nullptr);
+	}
 
 	void LogManager::Register(ILogger* logger)
 	{
@@ -100,4 +311,34 @@ namespace adria
 	{
 		Log(level, str, location.file_name(), location.line());
 	}
-}
\ No newline at end of file
+	void LogManager::LogFormat(LogLevel level, Char const* file, Uint32 line, Char const* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		pimpl->LogFormat(level, file, line, format, args);
+		va_end(args);
+	}
+
+	void LogManager::EnableBinaryCapture(Char const* log_file, Uint64 capacity)
+	{
+		ADRIA_ASSERT(!binary_log_owner && "Binary capture can only be enabled once, log sites keep their format ids");
+		binary_log_owner = std::make_unique<BinaryLogWriter>(log_file, capacity);
+		if (!binary_log_owner->IsOpen())
+		{
+			binary_log_owner.reset();
+			ADRIA_LOG(WARNING, "Binary log capture could not be enabled, failed to map '%s'", log_file);
+			return;
+		}
+		binary_log_writer.store(binary_log_owner.get(), std::memory_order_release);
+	}
+
+	Uint32 LogManager::RegisterBinaryLogFormat(BinaryLogWriter& writer, std::atomic<Uint32>& format_id, LogLevel level, Char const* format, Char const* file, Uint32 line)
+	{
+		//the format record is written before the id is published, so every message of this site comes after it in the file
+		Uint32 const id = writer.RegisterFormat(level, format, file, line);
+		Uint32 expected = 0;
+		if (format_id.compare_exchange_strong(expected, id, std::memory_order_acq_rel)) return id;
+		//another thread registered this site first, its id is used and the extra format record stays unused
+		return expected;
+	}
+}
@@ -2,6 +2,7 @@
 #include <memory> 
 #include <string>
 #include <source_location>
+#include "BinaryLogWriter.h"
 
 namespace adria
 {
@@ -23,6 +24,8 @@ namespace adria
 	public:
 		virtual ~ILogger() = default;
 		virtual void Log(LogLevel level, Char const* entry, Char const* file, Uint32 line) = 0;
+		//Called after every batch of entries, sinks that buffer entries write them out here
+		virtual void Flush() {}
 	};
 
 	class LogManager
@@ -33,21 +36,56 @@ namespace adria
 		~LogManager();
 
 		void Register(ILogger* logger);
+		//file has to outlive the log manager, it is stored as a pointer (__FILE__ and std::source_location file names do)
 		void Log(LogLevel level, Char const* str, Char const* file, Uint32 line);
 		void Log(LogLevel level, Char const* str, std::source_location location = std::source_location::current());
+		//Formats straight into the calling thread's log ring, messages longer than the record are truncated
+		void LogFormat(LogLevel level, Char const* file, Uint32 line, Char const* format, ...);
+
+		//Used by ADRIA_LOG, format_id is a per log site id. While binary capture is enabled string literal formats are registered
+		//once per site and only the raw arguments are written, other formats are formatted and written as text.
+		//Warnings and errors are passed to the registered loggers as well.
+		template<typename Format, typename... Args>
+		void LogFormat(LogLevel level, Char const* file, Uint32 line, std::atomic<Uint32>& format_id, Format&& format, Args const&... args)
+		{
+			if (BinaryLogWriter* writer = binary_log_writer.load(std::memory_order_acquire))
+			{
+				using FormatType = std::remove_reference_t<Format>;
+				if constexpr (std::is_array_v<FormatType> && std::is_const_v<std::remove_extent_t<FormatType>>)
+				{
+					Uint32 id = format_id.load(std::memory_order_acquire);
+					if (id == 0) id = RegisterBinaryLogFormat(*writer, format_id, level, format, file, line);
+					writer->WriteMessage(id, level, format, args...);
+				}
+				else
+				{
+					Char text[BinaryLogWriter::MAX_STRING_LENGTH];
+					snprintf(text, sizeof(text), format, args...);
+					writer->WriteText(level, text, file, line);
+				}
+				if (level < LogLevel::LOG_WARNING) return;
+			}
+			LogFormat(level, file, line, static_cast<Char const*>(format), args...);
+		}
+
+		//Has to be called before any other thread logs, log_file is relative to the log directory
+		void EnableBinaryCapture(Char const* log_file, Uint64 capacity);
 
 	private:
 		std::unique_ptr<class LogManagerImpl> pimpl;
+		std::unique_ptr<BinaryLogWriter> binary_log_owner;
+		std::atomic<BinaryLogWriter*> binary_log_writer = nullptr;
+
+	private:
+		static Uint32 RegisterBinaryLogFormat(BinaryLogWriter& writer, std::atomic<Uint32>& format_id, LogLevel level, Char const* format, Char const* file, Uint32 line);
 	};
 	inline LogManager g_Log{};
 
-	#define ADRIA_LOG(level, ... ) [&]()  \
+	#define ADRIA_LOG(level, ... ) do \
 	{ \
-		Uint64 const size = snprintf(nullptr, 0, __VA_ARGS__) + 1; \
-		std::unique_ptr<Char[]> buf = std::make_unique<Char[]>(size); \
-		snprintf(buf.get(), size, __VA_ARGS__); \
-		g_Log.Log(LogLevel::LOG_##level, buf.get(), __FILE__, __LINE__);  \
-	}()
+		static std::atomic<Uint32> adria_log_format_id = 0; \
+		g_Log.LogFormat(LogLevel::LOG_##level, __FILE__, __LINE__, adria_log_format_id, __VA_ARGS__); \
+	} while(0)
 	#define ADRIA_DEBUG(...)	ADRIA_LOG(DEBUG, __VA_ARGS__)
 	#define ADRIA_INFO(...)		ADRIA_LOG(INFO, __VA_ARGS__)
 	#define ADRIA_WARNING(...)  ADRIA_LOG(WARNING, __VA_ARGS__)
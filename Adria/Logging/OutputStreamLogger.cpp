@@ -12,7 +12,18 @@ namespace adria
 	void OutputStreamLogger::Log(LogLevel level, Char const* entry, Char const* file, uint32_t line)
 	{
 		if (level < logger_level) return;
-		(use_cerr ? std::cerr : std::cout) << GetLogTime() + LineInfoToString(file, line) + LevelToString(level) + std::string(entry) << "\n";
+		batch += GetLogTime();
+		batch += LineInfoToString(file, line);
+		batch += LevelToString(level);
+		batch += entry;
+		batch += '\n';
+	}
+	void OutputStreamLogger::Flush()
+	{
+		std::ostream& stream = use_cerr ? std::cerr : std::cout;
+		stream.write(batch.data(), batch.size());
+		stream.flush();
+		batch.clear();
 	}
 
 }
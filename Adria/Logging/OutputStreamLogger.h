@@ -9,9 +9,11 @@ namespace adria
 		OutputStreamLogger(Bool use_cerr = false, LogLevel logger_level = LogLevel::LOG_DEBUG);
 		virtual ~OutputStreamLogger() override;
 		virtual void Log(LogLevel level, Char const* entry, Char const* file, Uint32 line) override;
+		virtual void Flush() override;
 	private:
 		Bool const use_cerr;
 		LogLevel const logger_level;
+		std::string batch;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "FrustumCulling.h"
+#include <immintrin.h>
+
+namespace adria
+{
+	void BoundingBoxStreams::Resize(Uint64 box_count)
+	{
+		count = box_count;
+		Uint64 const padded_count = (box_count + BOXES_PER_BLOCK - 1) / BOXES_PER_BLOCK * BOXES_PER_BLOCK;
+		for (std::vector<Float>* stream : { &center_x, &center_y, &center_z, &extents_x, &extents_y, &extents_z })
+		{
+			stream->assign(padded_count, 0.0f);
+		}
+	}
+
+	void BoundingBoxStreams::Set(Uint64 index, BoundingBox const& box)
+	{
+		ADRIA_ASSERT(index < count);
+		center_x[index] = box.Center.x;
+		center_y[index] = box.Center.y;
+		center_z[index] = box.Center.z;
+		extents_x[index] = box.Extents.x;
+		extents_y[index] = box.Extents.y;
+		extents_z[index] = box.Extents.z;
+	}
+
+	CullingPlanes CullingPlanes::FromFrustum(BoundingFrustum const& frustum)
+	{
+		CullingPlanes culling_planes{};
+		DirectX::XMVECTOR planes[6];
+		frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+		for (Uint32 i = 0; i < 6; ++i) culling_planes.planes[i] = Vector4(planes[i]);
+		culling_planes.plane_count = 6;
+		return culling_planes;
+	}
+
+	CullingPlanes CullingPlanes::FromBox(BoundingBox const& box)
+	{
+		Vector3 const min = Vector3(box.Center) - Vector3(box.Extents);
+		Vector3 const max = Vector3(box.Center) + Vector3(box.Extents);
+
+		CullingPlanes culling_planes{};
+		culling_planes.planes[0] = Vector4( 1.0f,  0.0f,  0.0f, -max.x);
+		culling_planes.planes[1] = Vector4(-1.0f,  0.0f,  0.0f,  min.x);
+		culling_planes.planes[2] = Vector4( 0.0f,  1.0f,  0.0f, -max.y);
+		culling_planes.planes[3] = Vector4( 0.0f, -1.0f,  0.0f,  min.y);
+		culling_planes.planes[4] = Vector4( 0.0f,  0.0f,  1.0f, -max.z);
+		culling_planes.planes[5] = Vector4( 0.0f,  0.0f, -1.0f,  min.z);
+		culling_planes.plane_count = 6;
+		return culling_planes;
+	}
+
+	void CullBoundingBoxes(CullingPlanes const& culling_planes, BoundingBoxStreams const& boxes, std::vector<Uint64>& visibility_mask)
+	{
+		visibility_mask.resize((boxes.Size() + 63) / 64);
+		CullBoundingBoxes(culling_planes, boxes, 0, boxes.Size(), visibility_mask);
+	}
+
+	void CullBoundingBoxes(CullingPlanes const& culling_planes, BoundingBoxStreams const& boxes, Uint64 first_box, Uint64 box_count, std::span<Uint64> visibility_mask)
+	{
+		Uint64 const end_box = first_box + box_count;
+		ADRIA_ASSERT(first_box % 64 == 0 && (end_box % 64 == 0 || end_box == boxes.Size()));
+		ADRIA_ASSERT(end_box <= boxes.Size() && visibility_mask.size() * 64 >= end_box);
+		for (Uint64 i = first_box; i < end_box; i += 64) visibility_mask[i / 64] = 0;
+
+		for (Uint64 i = first_box; i < end_box; i += BoundingBoxStreams::BOXES_PER_BLOCK)
+		{
+#if defined(__AVX__)
+			__m256 const cx = _mm256_loadu_ps(&boxes.center_x[i]);
+			__m256 const cy = _mm256_loadu_ps(&boxes.center_y[i]);
+			__m256 const cz = _mm256_loadu_ps(&boxes.center_z[i]);
+			__m256 const ex = _mm256_loadu_ps(&boxes.extents_x[i]);
+			__m256 const ey = _mm256_loadu_ps(&boxes.extents_y[i]);
+			__m256 const ez = _mm256_loadu_ps(&boxes.extents_z[i]);
+			__m256 const sign_mask = _mm256_set1_ps(-0.0f);
+
+			__m256 outside = _mm256_setzero_ps();
+			for (Uint32 p = 0; p < culling_planes.plane_count; ++p)
+			{
+				Vector4 const& plane = culling_planes.planes[p];
+				__m256 const nx = _mm256_set1_ps(plane.x);
+				__m256 const ny = _mm256_set1_ps(plane.y);
+				__m256 const nz = _mm256_set1_ps(plane.z);
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_set1_ps(plane.w));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, cy));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, cz));
+				__m256 radius = _mm256_mul_ps(_mm256_andnot_ps(sign_mask, nx), ex);
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(sign_mask, ny), ey));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_andnot_ps(sign_mask, nz), ez));
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, radius, _CMP_GT_OQ));
+			}
+			Uint64 const visible_bits = ~(Uint64)_mm256_movemask_ps(outside) & 0xff;
+#else
+			Uint64 visible_bits = 0;
+			for (Uint64 j = 0; j < BoundingBoxStreams::BOXES_PER_BLOCK; j += 4)
+			{
+				__m128 const cx = _mm_loadu_ps(&boxes.center_x[i + j]);
+				__m128 const cy = _mm_loadu_ps(&boxes.center_y[i + j]);
+				__m128 const cz = _mm_loadu_ps(&boxes.center_z[i + j]);
+				__m128 const ex = _mm_loadu_ps(&boxes.extents_x[i + j]);
+				__m128 const ey = _mm_loadu_ps(&boxes.extents_y[i + j]);
+				__m128 const ez = _mm_loadu_ps(&boxes.extents_z[i + j]);
+				__m128 const sign_mask = _mm_set1_ps(-0.0f);
+
+				__m128 outside = _mm_setzero_ps();
+				for (Uint32 p = 0; p < culling_planes.plane_count; ++p)
+				{
+					Vector4 const& plane = culling_planes.planes[p];
+					__m128 const nx = _mm_set1_ps(plane.x);
+					__m128 const ny = _mm_set1_ps(plane.y);
+					__m128 const nz = _mm_set1_ps(plane.z);
+					__m128 distance = _mm_add_ps(_mm_mul_ps(nx, cx), _mm_set1_ps(plane.w));
+					distance = _mm_add_ps(distance, _mm_mul_ps(ny, cy));
+					distance = _mm_add_ps(distance, _mm_mul_ps(nz, cz));
+					__m128 radius = _mm_mul_ps(_mm_andnot_ps(sign_mask, nx), ex);
+					radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, ny), ey));
+					radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, nz), ez));
+					outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, radius));
+				}
+				visible_bits |= (~(Uint64)_mm_movemask_ps(outside) & 0xf) << j;
+			}
+#endif
+			visibility_mask[i / 64] |= visible_bits << (i % 64);
+		}
+		//padding boxes past the end are never reported
+		if (end_box % 64 != 0) visibility_mask[end_box / 64] &= (Uint64(1) << (end_box % 64)) - 1;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <span>
+
+namespace adria
+{
+	//Axis aligned bounding boxes stored as separate center and extents streams, so that culling can load several boxes with one instruction.
+	//Streams are padded to a multiple of 8 boxes with empty boxes at the origin
+	struct BoundingBoxStreams
+	{
+		static constexpr Uint64 BOXES_PER_BLOCK = 8;
+		static constexpr Uint64 BOXES_PER_MASK_WORD = 64;
+
+		std::vector<Float> center_x;
+		std::vector<Float> center_y;
+		std::vector<Float> center_z;
+		std::vector<Float> extents_x;
+		std::vector<Float> extents_y;
+		std::vector<Float> extents_z;
+		Uint64 count = 0;
+
+		void Resize(Uint64 box_count);
+		void Set(Uint64 index, BoundingBox const& box);
+		Uint64 Size() const { return count; }
+	};
+
+	//Up to six planes with normals pointing out of the culling volume, a box is culled when it lies entirely in front of any plane
+	struct CullingPlanes
+	{
+		Vector4 planes[6];
+		Uint32 plane_count = 0;
+
+		static CullingPlanes FromFrustum(BoundingFrustum const& frustum);
+		static CullingPlanes FromBox(BoundingBox const& box);
+	};
+
+	//Conservative plane tests of all boxes, bit i of the result is set when box i may be visible.
+	//Boxes straddling frustum corners can be reported visible, which BoundingFrustum::Intersects would reject
+	void CullBoundingBoxes(CullingPlanes const& culling_planes, BoundingBoxStreams const& boxes, std::vector<Uint64>& visibility_mask);
+	//Culls boxes [first_box, first_box + box_count) and only writes the mask words covering them, so disjoint ranges can be culled concurrently.
+	//first_box must be a multiple of 64 and the range must end on a multiple of 64 or at the last box
+	void CullBoundingBoxes(CullingPlanes const& culling_planes, BoundingBoxStreams const& boxes, Uint64 first_box, Uint64 box_count, std::span<Uint64> visibility_mask);
+
+	inline Bool IsVisible(std::vector<Uint64> const& visibility_mask, Uint64 index)
+	{
+		return (visibility_mask[index / 64] >> (index % 64)) & 1;
+	}
+}
@@ -3,6 +3,28 @@
 
 namespace adria
 {
+	namespace
+	{
+		Vector2 EncodeOctahedron(Vector3 n)
+		{
+			Float const l1_norm = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+			if (l1_norm == 0.0f) return Vector2(0.0f, 0.0f);
+			n /= l1_norm;
+			if (n.z >= 0.0f) return Vector2(n.x, n.y);
+			return Vector2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+		}
+
+		Vector3 DecodeOctahedron(Vector2 const& f)
+		{
+			Vector3 n(f.x, f.y, 1.0f - std::abs(f.x) - std::abs(f.y));
+			Float const t = Clamp(-n.z);
+			n.x += n.x >= 0.0f ? -t : t;
+			n.y += n.y >= 0.0f ? -t : t;
+			n.Normalize();
+			return n;
+		}
+	}
+
 	Uint32 PackToUint(Float(&arr)[3])
 	{
 		Uint32 output = 0;
@@ -40,4 +62,58 @@ namespace adria
 		Uint32 packed_value = (static_cast<Uint32>(value1) << 16) | static_cast<Uint32>(value2);
 		return packed_value;
 	}
+
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed)
+	{
+		DirectX::PackedVector::XMHALF2 half2(packed);
+		return Vector2(DirectX::PackedVector::XMConvertHalfToFloat(half2.x), DirectX::PackedVector::XMConvertHalfToFloat(half2.y));
+	}
+
+	Uint32 PackNormalOctahedron16x2(Vector3 const& normal)
+	{
+		Vector2 const v = EncodeOctahedron(normal) * 0.5f + Vector2(0.5f);
+		Uint32 const x = (Uint32)std::lround(Clamp(v.x) * 65535.0f);
+		Uint32 const y = (Uint32)std::lround(Clamp(v.y) * 65535.0f);
+		return (x << 16) | y;
+	}
+
+	Vector3 UnpackNormalOctahedron16x2(Uint32 packed)
+	{
+		Vector2 const v((packed >> 16) / 65535.0f, (packed & 0xffff) / 65535.0f);
+		return DecodeOctahedron(v * 2.0f - Vector2(1.0f));
+	}
+
+	Uint32 PackTangentOctahedron16x15(Vector4 const& tangent)
+	{
+		Vector2 const v = EncodeOctahedron(Vector3(tangent.x, tangent.y, tangent.z)) * 0.5f + Vector2(0.5f);
+		Uint32 const x = (Uint32)std::lround(Clamp(v.x) * 65535.0f);
+		Uint32 const y = (Uint32)std::lround(Clamp(v.y) * 32767.0f);
+		return (x << 16) | (y << 1) | (tangent.w < 0.0f ? 1u : 0u);
+	}
+
+	Vector4 UnpackTangentOctahedron16x15(Uint32 packed)
+	{
+		Vector2 const v((packed >> 16) / 65535.0f, ((packed >> 1) & 0x7fff) / 32767.0f);
+		Vector3 const t = DecodeOctahedron(v * 2.0f - Vector2(1.0f));
+		return Vector4(t.x, t.y, t.z, (packed & 1) ? -1.0f : 1.0f);
+	}
+
+	Uint64 PackPositionSnorm16x4(Vector3 const& position, Vector3 const& center, Vector3 const& extents)
+	{
+		auto Quantize = [](Float value, Float center, Float extent) -> Uint64
+		{
+			Float const normalized = extent > 0.0f ? Clamp((value - center) / extent, -1.0f, 1.0f) : 0.0f;
+			return (Uint16)(Int16)std::lround(normalized * 32767.0f);
+		};
+		return Quantize(position.x, center.x, extents.x) | (Quantize(position.y, center.y, extents.y) << 16) | (Quantize(position.z, center.z, extents.z) << 32);
+	}
+
+	Vector3 UnpackPositionSnorm16x4(Uint64 packed, Vector3 const& center, Vector3 const& extents)
+	{
+		auto Dequantize = [](Uint64 bits, Float center, Float extent)
+		{
+			return center + std::max((Int16)(Uint16)bits / 32767.0f, -1.0f) * extent;
+		};
+		return Vector3(Dequantize(packed, center.x, extents.x), Dequantize(packed >> 16, center.y, extents.y), Dequantize(packed >> 32, center.z, extents.z));
+	}
 }
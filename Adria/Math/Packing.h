@@ -15,4 +15,16 @@ namespace adria
 	Uint64 PackFourFloatsToUint64(Float x, Float y, Float z, Float w);
 
 	Uint32 PackTwoUint16ToUint32(Uint16 value1, Uint16 value2);
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed);
+
+	//Octahedral encodings of unit vectors, these match EncodeNormal16x2, DecodeNormal16x2 and DecodeTangent16x15 in Packing.hlsli
+	Uint32 PackNormalOctahedron16x2(Vector3 const& normal);
+	Vector3 UnpackNormalOctahedron16x2(Uint32 packed);
+	//The bitangent sign in w is stored in the lowest bit, which leaves 15 bits for the second component
+	Uint32 PackTangentOctahedron16x15(Vector4 const& tangent);
+	Vector4 UnpackTangentOctahedron16x15(Uint32 packed);
+
+	//Positions as signed normalized 16 bit components relative to a box, the fourth component is zero
+	Uint64 PackPositionSnorm16x4(Vector3 const& position, Vector3 const& center, Vector3 const& extents);
+	Vector3 UnpackPositionSnorm16x4(Uint64 packed, Vector3 const& center, Vector3 const& extents);
 }
\ No newline at end of file
@@ -8,7 +8,9 @@
 #include "Graphics/GfxTracyProfiler.h"
 #include "Utilities/StringUtil.h"
 #include "Utilities/FilesUtil.h"
+#include "Utilities/ThreadPool.h"
 #include "Core/Paths.h"
+#include "Core/ConsoleManager.h"
 #include "Logging/Logger.h"
 #include "pix3.h"
 
@@ -21,6 +23,87 @@
 namespace adria
 {
 	extern Bool dump_render_graph = false;
+#if RG_MULTITHREADED
+	static TAutoConsoleVariable<Bool> MultithreadedExecution("r.RenderGraph.Multithreaded", false, "Record independent passes of a dependency level in parallel on worker threads");
+#endif
+	static TAutoConsoleVariable<Bool> CompileCache("r.RenderGraph.CompileCache", true, "Reuse compiled render graphs across frames when the pass structure does not change");
+	static TAutoConsoleVariable<Bool> AsyncCompute("r.RenderGraph.AsyncCompute", true, "Execute ComputeAsync passes on the compute queue, otherwise they are executed on the graphics queue");
+	static TAutoConsoleVariable<Bool> SplitBarriers("r.RenderGraph.SplitBarriers", true, "Split transitions of resources that stay idle for at least one dependency level into begin and end barriers");
+	static TAutoConsoleVariable<Bool> TransientAliasing("r.RenderGraph.TransientAliasing", true, "Place transient resources with non-overlapping lifetimes in shared heap memory");
+
+	namespace
+	{
+		constexpr Uint64 MixHash(Uint64 x)
+		{
+			x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+			x ^= x >> 27; x *= 0x94d049bb133111ebull;
+			x ^= x >> 31;
+			return x;
+		}
+
+		//signatures are filled in place, the vectors keep their capacity from the previous frame
+		template<typename ResourceId>
+		void GetResourceSetSignature(RenderGraphResourceSet<ResourceId> const& resource_set, std::vector<Uint64>& signature)
+		{
+			signature.clear();
+			for (ResourceId const& id : resource_set) signature.push_back(id.id);
+		}
+
+		//sorted by id, unordered_map iteration order is not part of the graph structure
+		template<typename ResourceId>
+		void GetResourceStateSignature(std::unordered_map<ResourceId, GfxResourceState> const& resource_state_map, std::vector<std::pair<Uint64, GfxResourceState>>& signature)
+		{
+			signature.clear();
+			for (auto const& [id, state] : resource_state_map) signature.emplace_back(id.id, state);
+			std::sort(signature.begin(), signature.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+		}
+
+		void HashIds(HashState& hash, std::vector<Uint64> const& ids)
+		{
+			hash.Combine(ids.size());
+			for (Uint64 id : ids) hash.Combine(MixHash(id));
+		}
+
+		void HashStates(HashState& hash, std::vector<std::pair<Uint64, GfxResourceState>> const& states)
+		{
+			hash.Combine(states.size());
+			for (auto const& [id, state] : states)
+			{
+				hash.Combine(MixHash(id));
+				hash.Combine((Uint64)state);
+			}
+		}
+
+		GfxHeapType GetTransientHeapType(GfxTextureDesc const& desc)
+		{
+			return HasAnyFlag(desc.bind_flags, GfxBindFlag::RenderTarget | GfxBindFlag::DepthStencil) ? GfxHeapType::RenderTargetTextures : GfxHeapType::NonRenderTargetTextures;
+		}
+
+		//only the parts of the desc that affect the size and the placement restrictions of the resource
+		Uint64 HashTransientDesc(GfxTextureDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine((Uint64)desc.type);
+			hash.Combine(desc.width);
+			hash.Combine(desc.height);
+			hash.Combine(desc.depth);
+			hash.Combine(desc.array_size);
+			hash.Combine(desc.mip_levels);
+			hash.Combine(desc.sample_count);
+			hash.Combine((Uint64)desc.bind_flags);
+			hash.Combine((Uint64)desc.misc_flags);
+			hash.Combine((Uint64)desc.format);
+			return hash;
+		}
+		Uint64 HashTransientDesc(GfxBufferDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine(desc.size);
+			hash.Combine((Uint64)desc.bind_flags);
+			hash.Combine((Uint64)desc.misc_flags);
+			return hash;
+		}
+	}
 
 	RGTextureId RenderGraph::DeclareTexture(RGResourceName name, RGTextureDesc const& desc)
 	{
@@ -118,19 +201,57 @@ namespace adria
 
 	void RenderGraph::Build()
 	{
-		BuildAdjacencyLists();
-		TopologicalSort();
-		BuildDependencyLevels();
-		CullPasses();
-		CalculateResourcesLifetime();
-		for (auto& dependency_level : dependency_levels) dependency_level.Setup();
+		Bool const use_compile_cache = compile_cache && CompileCache.Get();
+		Uint64 structural_hash = 0;
+		cached_graph = nullptr;
+		if (use_compile_cache)
+		{
+			compile_cache->Tick();
+			ComputeSignature(compile_cache->GetSignatureScratch());
+			structural_hash = ComputeStructuralHash(compile_cache->GetSignatureScratch());
+			cached_graph = compile_cache->Find(structural_hash, compile_cache->GetSignatureScratch());
+		}
+
+		if (cached_graph)
+		{
+			LoadCompiledGraph(*cached_graph);
+		}
+		else
+		{
+			BuildAdjacencyLists();
+			TopologicalSort();
+			BuildDependencyLevels();
+			CullPasses();
+			CalculateResourcesLifetime();
+			for (auto& dependency_level : dependency_levels) dependency_level.Setup();
+
+			RGCompiledGraph new_compiled_graph{};
+			StoreCompiledGraph(new_compiled_graph);
+			ScheduleAsyncCompute(new_compiled_graph.dependency_levels);
+			barrier_plan = BuildBarrierPlan(new_compiled_graph.dependency_levels, async_compute_schedule, textures.size(), buffers.size());
+			if (use_compile_cache)
+			{
+				new_compiled_graph.async_compute_schedule = async_compute_schedule;
+				new_compiled_graph.barrier_plan = barrier_plan;
+				new_compiled_graph.signature = compile_cache->GetSignatureScratch();
+				cached_graph = compile_cache->Insert(structural_hash, std::move(new_compiled_graph));
+			}
+		}
+		CreateImportedResourcesViews();
 		if (dump_render_graph) Dump("rendergraph.gv");
 	}
 
 	void RenderGraph::Execute()
 	{
+		async_compute = AsyncCompute.Get() && !async_compute_schedule.Empty();
+		async_compute_fence_values.assign(dependency_levels.size(), 0);
+		split_barriers = SplitBarriers.Get();
+		PlaceTransientResources();
 #if RG_MULTITHREADED
-		Execute_Multithreaded();
+		//levels recorded in batches switch command lists, the two halves of a split barrier could end up on different ones
+		if (MultithreadedExecution.Get()) split_barriers = false;
+		if (MultithreadedExecution.Get()) Execute_Multithreaded();
+		else Execute_Singlethreaded();
 #else
 		Execute_Singlethreaded();
 #endif
@@ -140,113 +261,239 @@ namespace adria
 	{
 		pool.Tick();
 
-		GfxCommandList* cmd_list = gfx->GetCommandList();
+		GfxCommandList* cmd_list = gfx->GetLatestCommandList(GfxCommandListType::Graphics);
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			auto& dependency_level = dependency_levels[i];
+			cmd_list = SyncAsyncCompute(i, cmd_list);
+			BeginDependencyLevel(i, cmd_list);
+			cmd_list = ExecuteAsyncCompute(i, cmd_list);
+			dependency_level.Execute(gfx, cmd_list);
+			EndDependencyLevel(i, cmd_list);
+		}
+		SyncAsyncCompute(dependency_levels.size(), cmd_list);
+	}
+
+	void RenderGraph::Execute_Multithreaded()
+	{
+		pool.Tick();
+
+		GfxCommandList* cmd_list = gfx->GetLatestCommandList(GfxCommandListType::Graphics);
+		std::vector<GfxCommandList*> cmd_lists;
 		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
 		{
 			auto& dependency_level = dependency_levels[i];
-			for (auto tex_id : dependency_level.texture_creates)
+			cmd_list = SyncAsyncCompute(i, cmd_list);
+			BeginDependencyLevel(i, cmd_list);
+			cmd_list = ExecuteAsyncCompute(i, cmd_list);
+
+			Uint64 const batch_count = dependency_level.GetRecordingBatchCount();
+			if (batch_count <= 1)
 			{
-				RGTexture* rg_texture = GetRGTexture(tex_id);
-				rg_texture->resource = pool.AllocateTexture(rg_texture->desc);
-				CreateTextureViews(tex_id);
-				rg_texture->SetName();
+				dependency_level.Execute(gfx, cmd_list);
 			}
-			for (auto buf_id : dependency_level.buffer_creates)
+			else
 			{
-				RGBuffer* rg_buffer = GetRGBuffer(buf_id);
-				rg_buffer->resource = pool.AllocateBuffer(rg_buffer->desc);
-				CreateBufferViews(buf_id);
-				rg_buffer->SetName();
+				//the first batch continues on the command list holding this level's barriers, the rest get new ones. 
+				//Command lists are allocated in submission order so the queue sees the passes in the same order as the single threaded path
+				cmd_lists.resize(batch_count);
+				cmd_lists[0] = cmd_list;
+				for (Uint64 j = 1; j < batch_count; ++j) cmd_lists[j] = gfx->AllocateCommandList(GfxCommandListType::Graphics);
+				dependency_level.Execute(gfx, cmd_lists);
+				cmd_list = cmd_lists.back();
 			}
-			for (auto const& [tex_id, state] : dependency_level.texture_state_map)
+			EndDependencyLevel(i, cmd_list);
+		}
+		SyncAsyncCompute(dependency_levels.size(), cmd_list);
+	}
+
+	void RenderGraph::BeginDependencyLevel(Uint64 level_index, GfxCommandList* cmd_list)
+	{
+		auto& dependency_level = dependency_levels[level_index];
+		for (auto tex_id : dependency_level.texture_creates)
+		{
+			RGTexture* rg_texture = GetRGTexture(tex_id);
+			if (IsAliasedTexture(tex_id))
 			{
-				RGTexture* rg_texture = GetRGTexture(tex_id);
-				GfxTexture* texture = rg_texture->resource;
-				if (dependency_level.texture_creates.contains(tex_id))
-				{
-					if (!HasAllFlags(texture->GetDesc().initial_state, state))
-					{
-						cmd_list->TextureBarrier(*texture, texture->GetDesc().initial_state, state);
-					}
-					continue;
-				}
-				Bool found = false;
-				for (Int32 j = (Int32)i - 1; j >= 0; --j)
-				{
-					auto& prev_dependency_level = dependency_levels[j];
-					if (prev_dependency_level.texture_state_map.contains(tex_id))
-					{
-						GfxResourceState prev_state = prev_dependency_level.texture_state_map[tex_id];
-						if (prev_state != state) cmd_list->TextureBarrier(*texture, prev_state, state);
-						found = true;
-						break;
-					}
-				}
-				if (!found && rg_texture->imported)
-				{
-					GfxResourceState prev_state = rg_texture->desc.initial_state;
-					if (prev_state != state) cmd_list->TextureBarrier(*texture, prev_state, state);
-				}
+				//legacy barriers can only discard render targets and depth stencils in their writable state.
+				//The placed texture gets its own desc, the declared desc stays untouched for the compile cache signature and the pool lookups
+				GfxTextureDesc placed_desc = rg_texture->desc;
+				if (HasAnyFlag(placed_desc.bind_flags, GfxBindFlag::RenderTarget)) placed_desc.initial_state = GfxResourceState::RTV;
+				else if (HasAnyFlag(placed_desc.bind_flags, GfxBindFlag::DepthStencil)) placed_desc.initial_state = GfxResourceState::DSV;
+				rg_texture->resource = pool.AllocateAliasedTexture(placed_desc, GetTransientHeapType(placed_desc), transient_layout.heap_offsets[tex_id.id]);
 			}
-			for (auto const& [buf_id, state] : dependency_level.buffer_state_map)
+			else
 			{
-				RGBuffer* rg_buffer = GetRGBuffer(buf_id);
-				GfxBuffer* buffer = rg_buffer->resource;
-				if (dependency_level.buffer_creates.contains(buf_id))
-				{
-					if (state != GfxResourceState::Common)
-					{
-						cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
-					}
-					continue;
-				}
-				Bool found = false;
-				for (Int32 j = (Int32)i - 1; j >= 0; --j)
-				{
-					auto& prev_dependency_level = dependency_levels[j];
-					if (prev_dependency_level.buffer_state_map.contains(buf_id))
-					{
-						GfxResourceState prev_state = prev_dependency_level.buffer_state_map[buf_id];
-						if (prev_state != state) cmd_list->BufferBarrier(*buffer, prev_state, state);
-						found = true;
-						break;
-					}
-				}
-				if (!found && rg_buffer->imported)
-				{
-					if (GfxResourceState::Common != state) cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
-				}
+				rg_texture->resource = pool.AllocateTexture(rg_texture->desc, rg_texture->pool_handle);
 			}
-
-			cmd_list->FlushBarriers();
-			dependency_level.Execute(gfx, cmd_list);
-
-			for (RGTextureId tex_id : dependency_level.texture_destroys)
+			CreateTextureViews(tex_id);
+			rg_texture->SetName();
+		}
+		for (auto buf_id : dependency_level.buffer_creates)
+		{
+			RGBuffer* rg_buffer = GetRGBuffer(buf_id);
+			if (IsAliasedBuffer(buf_id))
 			{
-				RGTexture* rg_texture = GetRGTexture(tex_id);
-				GfxTexture* texture = rg_texture->resource;
-				GfxResourceState initial_state = texture->GetDesc().initial_state;
-				ADRIA_ASSERT(dependency_level.texture_state_map.contains(tex_id));
-				GfxResourceState state = dependency_level.texture_state_map[tex_id];
-				if (initial_state != state) cmd_list->TextureBarrier(*texture, state, initial_state);
-				if (!rg_texture->imported) pool.ReleaseTexture(rg_texture->resource);
+				rg_buffer->resource = pool.AllocateAliasedBuffer(rg_buffer->desc, transient_layout.heap_offsets[textures.size() + buf_id.id]);
 			}
-			for (RGBufferId buf_id : dependency_level.buffer_destroys)
+			else
 			{
-				RGBuffer* rg_buffer = GetRGBuffer(buf_id);
-				GfxBuffer* buffer = rg_buffer->resource;
-				ADRIA_ASSERT(dependency_level.buffer_state_map.contains(buf_id));
-				GfxResourceState state = dependency_level.buffer_state_map[buf_id];
-				if(state != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, state, GfxResourceState::Common);
-				if (!rg_buffer->imported) pool.ReleaseBuffer(rg_buffer->resource);
+				rg_buffer->resource = pool.AllocateBuffer(rg_buffer->desc, rg_buffer->pool_handle);
 			}
-			cmd_list->FlushBarriers();
+			CreateBufferViews(buf_id);
+			rg_buffer->SetName();
 		}
+		RGLevelBarriers const& level_barriers = barrier_plan.levels[level_index];
+		for (RGTextureBarrier const& barrier : level_barriers.texture_barriers)
+		{
+			RGTexture* rg_texture = GetRGTexture(barrier.id);
+			GfxTexture* texture = rg_texture->resource;
+			switch (barrier.type)
+			{
+			case RGBarrierType::Create:
+			{
+				GfxResourceState const initial_state = texture->GetDesc().initial_state;
+				if (IsAliasedTexture(barrier.id)) cmd_list->TextureAliasingBarrier(*texture, initial_state, barrier.after);
+				else if (!HasAllFlags(initial_state, barrier.after)) cmd_list->TextureBarrier(*texture, initial_state, barrier.after);
+			}
+			break;
+			case RGBarrierType::Import:
+			{
+				GfxResourceState const initial_state = rg_texture->desc.initial_state;
+				if (rg_texture->imported && initial_state != barrier.after) cmd_list->TextureBarrier(*texture, initial_state, barrier.after);
+			}
+			break;
+			case RGBarrierType::SplitEnd:
+				if (split_barriers) cmd_list->TextureBarrierEnd(*texture, barrier.before, barrier.after);
+				else cmd_list->TextureBarrier(*texture, barrier.before, barrier.after);
+				break;
+			case RGBarrierType::Transition:
+			default:
+				cmd_list->TextureBarrier(*texture, barrier.before, barrier.after);
+			}
+		}
+		for (RGBufferBarrier const& barrier : level_barriers.buffer_barriers)
+		{
+			RGBuffer* rg_buffer = GetRGBuffer(barrier.id);
+			GfxBuffer* buffer = rg_buffer->resource;
+			switch (barrier.type)
+			{
+			case RGBarrierType::Create:
+				if (IsAliasedBuffer(barrier.id)) cmd_list->BufferAliasingBarrier(*buffer, GfxResourceState::Common, barrier.after);
+				else if (barrier.after != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, barrier.after);
+				break;
+			case RGBarrierType::Import:
+				if (rg_buffer->imported && barrier.after != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, barrier.after);
+				break;
+			case RGBarrierType::SplitEnd:
+				if (split_barriers) cmd_list->BufferBarrierEnd(*buffer, barrier.before, barrier.after);
+				else cmd_list->BufferBarrier(*buffer, barrier.before, barrier.after);
+				break;
+			case RGBarrierType::Transition:
+			default:
+				cmd_list->BufferBarrier(*buffer, barrier.before, barrier.after);
+			}
+		}
+		cmd_list->FlushBarriers();
 	}
 
-	void RenderGraph::Execute_Multithreaded()
+	void RenderGraph::EndDependencyLevel(Uint64 level_index, GfxCommandList* cmd_list)
 	{
-		ADRIA_ASSERT_MSG(false, "Not implemented!");
+		auto& dependency_level = dependency_levels[level_index];
+		if (split_barriers)
+		{
+			RGLevelBarriers const& level_barriers = barrier_plan.levels[level_index];
+			for (RGTextureBarrier const& barrier : level_barriers.texture_split_barriers) cmd_list->TextureBarrierBegin(*GetTexture(barrier.id), barrier.before, barrier.after);
+			for (RGBufferBarrier const& barrier : level_barriers.buffer_split_barriers) cmd_list->BufferBarrierBegin(*GetBuffer(barrier.id), barrier.before, barrier.after);
+		}
+		Bool const defer_destroys = async_compute && async_compute_schedule.HasAsyncCompute(level_index);
+		for (RGTextureId tex_id : dependency_level.texture_destroys)
+		{
+			if (defer_destroys && async_compute_schedule.deferred_texture_destroys[level_index].Contains(tex_id)) continue;
+			ADRIA_ASSERT(dependency_level.texture_state_map.contains(tex_id));
+			DestroyTexture(tex_id, dependency_level.texture_state_map[tex_id], cmd_list);
+		}
+		for (RGBufferId buf_id : dependency_level.buffer_destroys)
+		{
+			if (defer_destroys && async_compute_schedule.deferred_buffer_destroys[level_index].Contains(buf_id)) continue;
+			ADRIA_ASSERT(dependency_level.buffer_state_map.contains(buf_id));
+			DestroyBuffer(buf_id, dependency_level.buffer_state_map[buf_id], cmd_list);
+		}
+		cmd_list->FlushBarriers();
+	}
+
+	void RenderGraph::DestroyTexture(RGTextureId tex_id, GfxResourceState state, GfxCommandList* cmd_list)
+	{
+		RGTexture* rg_texture = GetRGTexture(tex_id);
+		GfxTexture* texture = rg_texture->resource;
+		GfxResourceState initial_state = texture->GetDesc().initial_state;
+		if (initial_state != state) cmd_list->TextureBarrier(*texture, state, initial_state);
+		if (!rg_texture->imported && !IsAliasedTexture(tex_id)) pool.ReleaseTexture(rg_texture->pool_handle);
+	}
+
+	void RenderGraph::DestroyBuffer(RGBufferId buf_id, GfxResourceState state, GfxCommandList* cmd_list)
+	{
+		RGBuffer* rg_buffer = GetRGBuffer(buf_id);
+		GfxBuffer* buffer = rg_buffer->resource;
+		if (state != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, state, GfxResourceState::Common);
+		if (!rg_buffer->imported && !IsAliasedBuffer(buf_id)) pool.ReleaseBuffer(rg_buffer->pool_handle);
+	}
+
+	Bool RenderGraph::IsAliasedTexture(RGTextureId tex_id) const
+	{
+		return transient_aliasing && transient_layout.heap_offsets[tex_id.id] != RGTransientLayout::invalid_offset;
+	}
+
+	Bool RenderGraph::IsAliasedBuffer(RGBufferId buf_id) const
+	{
+		return transient_aliasing && transient_layout.heap_offsets[textures.size() + buf_id.id] != RGTransientLayout::invalid_offset;
+	}
+
+	Bool RenderGraph::IsAsyncComputePass(RenderGraphPassBase const* pass) const
+	{
+		return async_compute && async_compute_schedule.pass_queues[pass->id] == RGQueueType::Compute;
+	}
+
+	GfxCommandList* RenderGraph::ExecuteAsyncCompute(Uint64 level_index, GfxCommandList* cmd_list)
+	{
+		if (!async_compute || !async_compute_schedule.HasAsyncCompute(level_index)) return cmd_list;
+
+		//the barriers of this level were recorded on the graphics queue, the compute queue starts once they are done
+		Uint64 const graphics_fence_value = gfx->IncrementGraphicsFenceValue();
+		cmd_list->Signal(gfx->GetGraphicsFence(), graphics_fence_value);
+
+		GfxCommandList* compute_cmd_list = gfx->AllocateCommandList(GfxCommandListType::Compute);
+		compute_cmd_list->Wait(gfx->GetGraphicsFence(), graphics_fence_value);
+		dependency_levels[level_index].ExecuteAsyncCompute(gfx, compute_cmd_list);
+		async_compute_fence_values[level_index] = gfx->IncrementAsyncComputeFenceValue();
+		compute_cmd_list->Signal(gfx->GetAsyncComputeFence(), async_compute_fence_values[level_index]);
+
+		return gfx->AllocateCommandList(GfxCommandListType::Graphics);
+	}
+
+	GfxCommandList* RenderGraph::SyncAsyncCompute(Uint64 level_index, GfxCommandList* cmd_list)
+	{
+		if (!async_compute) return cmd_list;
+
+		Uint64 async_compute_fence_value = 0;
+		for (Uint64 i = 0; i < level_index; ++i)
+		{
+			if (async_compute_schedule.sync_levels[i] == level_index) async_compute_fence_value = std::max(async_compute_fence_value, async_compute_fence_values[i]);
+		}
+		if (async_compute_fence_value == 0) return cmd_list;
+
+		GfxCommandList* sync_cmd_list = gfx->AllocateCommandList(GfxCommandListType::Graphics);
+		sync_cmd_list->Wait(gfx->GetAsyncComputeFence(), async_compute_fence_value);
+		for (Uint64 i = 0; i < level_index; ++i)
+		{
+			if (async_compute_schedule.sync_levels[i] != level_index) continue;
+
+			auto& dependency_level = dependency_levels[i];
+			for (RGTextureId tex_id : async_compute_schedule.deferred_texture_destroys[i]) DestroyTexture(tex_id, dependency_level.texture_state_map[tex_id], sync_cmd_list);
+			for (RGBufferId buf_id : async_compute_schedule.deferred_buffer_destroys[i]) DestroyBuffer(buf_id, dependency_level.buffer_state_map[buf_id], sync_cmd_list);
+		}
+		sync_cmd_list->FlushBarriers();
+		return sync_cmd_list;
 	}
 
 	void RenderGraph::AddExportBufferCopyPass(RGResourceName export_buffer, GfxBuffer* buffer)
@@ -290,34 +537,43 @@ namespace adria
 
 	void RenderGraph::BuildAdjacencyLists()
 	{
+		//Single sweep over the passes. Every resource keeps the writers that subsequent readers have to depend on.
+		//A pass that both reads and writes a resource already depends on all of them, so it becomes the only pending writer.
+		//This emits a subset of the all-pairs edges with the same reachability, which keeps dependency levels unchanged.
+		static constexpr Uint64 NO_EDGE = Uint64(-1);
+
 		adjacency_lists.resize(passes.size());
+		std::vector<std::vector<Uint64>> texture_pending_writers(textures.size());
+		std::vector<std::vector<Uint64>> buffer_pending_writers(buffers.size());
+		std::vector<Uint64> last_edge_target(passes.size(), NO_EDGE);
+
+		auto AddEdges = [&](std::vector<Uint64> const& writers, Uint64 reader)
+		{
+			for (Uint64 writer : writers)
+			{
+				if (last_edge_target[writer] == reader) continue;
+				last_edge_target[writer] = reader;
+				adjacency_lists[writer].push_back(reader);
+			}
+		};
+
 		for (Uint64 i = 0; i < passes.size(); ++i)
 		{
 			auto& pass = passes[i];
-			std::vector<Uint64>& pass_adjacency_list = adjacency_lists[i];
-			for (Uint64 j = i + 1; j < passes.size(); ++j)
-			{
-				auto& other_pass = passes[j];
-				Bool depends = false;
-				for (auto other_node_read : other_pass->texture_reads)
-				{
-					if (pass->texture_writes.find(other_node_read) != pass->texture_writes.end())
-					{
-						pass_adjacency_list.push_back(j);
-						depends = true;
-						break;
-					}
-				}
-				if (depends) continue;
+			for (RGTextureId id : pass->texture_reads) AddEdges(texture_pending_writers[id.id], i);
+			for (RGBufferId id : pass->buffer_reads) AddEdges(buffer_pending_writers[id.id], i);
 
-				for (auto other_node_read : other_pass->buffer_reads)
-				{
-					if (pass->buffer_writes.find(other_node_read) != pass->buffer_writes.end())
-					{
-						pass_adjacency_list.push_back(j);
-						break;
-					}
-				}
+			for (RGTextureId id : pass->texture_writes)
+			{
+				std::vector<Uint64>& writers = texture_pending_writers[id.id];
+				if (pass->texture_reads.Contains(id)) writers.clear();
+				writers.push_back(i);
+			}
+			for (RGBufferId id : pass->buffer_writes)
+			{
+				std::vector<Uint64>& writers = buffer_pending_writers[id.id];
+				if (pass->buffer_reads.Contains(id)) writers.clear();
+				writers.push_back(i);
 			}
 		}
 	}
@@ -357,7 +613,7 @@ namespace adria
 	{
 		for (auto& pass : passes)
 		{
-			pass->ref_count = pass->texture_writes.size() + pass->buffer_writes.size();
+			pass->ref_count = pass->texture_writes.Size() + pass->buffer_writes.Size();
 			for (auto id : pass->texture_reads)
 			{
 				auto* consumed = GetRGTexture(id);
@@ -445,16 +701,283 @@ namespace adria
 
 		for (Uint64 i = 0; i < textures.size(); ++i)
 		{
-			if (textures[i]->last_used_by != nullptr) textures[i]->last_used_by->texture_destroys.insert(RGTextureId(i));
+			if (textures[i]->last_used_by != nullptr) textures[i]->last_used_by->texture_destroys.Insert(RGTextureId(i));
+		}
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			if (buffers[i]->last_used_by != nullptr) buffers[i]->last_used_by->buffer_destroys.Insert(RGBufferId(i));
+		}
+	}
+
+	void RenderGraph::ScheduleAsyncCompute(std::span<RGCompiledLevel const> compiled_levels)
+	{
+		std::vector<RGScheduledPass> scheduled_passes(passes.size());
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RenderGraphPassBase const* pass = passes[i].get();
+			RGScheduledPass& scheduled_pass = scheduled_passes[i];
+			scheduled_pass.async_compute = pass->type == RGPassType::ComputeAsync && !pass->IsCulled();
+			if (!scheduled_pass.async_compute) continue;
+
+			for (auto const& [tex_id, state] : pass->texture_state_map) scheduled_pass.textures.push_back(tex_id);
+			for (auto const& [buf_id, state] : pass->buffer_state_map) scheduled_pass.buffers.push_back(buf_id);
+		}
+		async_compute_schedule = BuildAsyncComputeSchedule(compiled_levels, scheduled_passes);
+	}
+
+	void RenderGraph::PlaceTransientResources()
+	{
+		transient_aliasing = TransientAliasing.Get();
+		if (!transient_aliasing) return;
+
+		//transient resources are laid out as textures followed by buffers
+		Uint64 const texture_count = textures.size();
+		std::vector<RGTransientResource> transient_resources(texture_count + buffers.size());
+		std::vector<Bool> is_transient(transient_resources.size(), false);
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			auto const& dependency_level = dependency_levels[i];
+			for (RGTextureId tex_id : dependency_level.texture_creates)
+			{
+				RGTexture const* rg_texture = GetRGTexture(tex_id);
+				if (rg_texture->imported || rg_texture->desc.heap_type != GfxResourceUsage::Default) continue;
+				is_transient[tex_id.id] = true;
+				transient_resources[tex_id.id].first_level = i;
+				transient_resources[tex_id.id].last_level = dependency_levels.size();
+			}
+			for (RGBufferId buf_id : dependency_level.buffer_creates)
+			{
+				RGBuffer const* rg_buffer = GetRGBuffer(buf_id);
+				if (rg_buffer->imported || rg_buffer->desc.resource_usage != GfxResourceUsage::Default) continue;
+				if (HasAnyFlag(rg_buffer->desc.misc_flags, GfxBufferMiscFlag::AccelStruct)) continue;
+				is_transient[texture_count + buf_id.id] = true;
+				transient_resources[texture_count + buf_id.id].first_level = i;
+				transient_resources[texture_count + buf_id.id].last_level = dependency_levels.size();
+			}
+		}
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			auto const& dependency_level = dependency_levels[i];
+			for (RGTextureId tex_id : dependency_level.texture_destroys) transient_resources[tex_id.id].last_level = i;
+			for (RGBufferId buf_id : dependency_level.buffer_destroys) transient_resources[texture_count + buf_id.id].last_level = i;
+		}
+		//destroys deferred to the sync level keep the memory alive while the compute queue may still use it
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			if (!async_compute_schedule.HasAsyncCompute(i)) continue;
+			Uint64 const sync_level = async_compute_schedule.sync_levels[i];
+			for (RGTextureId tex_id : async_compute_schedule.deferred_texture_destroys[i]) transient_resources[tex_id.id].last_level = sync_level;
+			for (RGBufferId buf_id : async_compute_schedule.deferred_buffer_destroys[i]) transient_resources[texture_count + buf_id.id].last_level = sync_level;
+		}
+
+		//the layout only depends on the lifetimes and descs, both are covered by the signature the compiled graph was matched with
+		if (cached_graph && cached_graph->transient_layout)
+		{
+			transient_layout = *cached_graph->transient_layout;
+			pool.ReserveTransientHeaps(transient_layout.heap_sizes);
+			return;
+		}
+
+		for (Uint64 i = 0; i < transient_resources.size(); ++i)
+		{
+			if (!is_transient[i]) continue;
+			RGTransientResource& transient_resource = transient_resources[i];
+			GfxAllocationInfo allocation_info{};
+			if (i < texture_count)
+			{
+				GfxTextureDesc const& desc = textures[i]->desc;
+				allocation_info = pool.GetAllocationInfo(desc);
+				transient_resource.heap_type = GetTransientHeapType(desc);
+			}
+			else
+			{
+				allocation_info = pool.GetAllocationInfo(buffers[i - texture_count]->desc);
+				transient_resource.heap_type = GfxHeapType::Buffers;
+			}
+			transient_resource.size = allocation_info.size;
+			transient_resource.alignment = allocation_info.alignment;
+		}
+		transient_layout = BuildTransientLayout(transient_resources);
+		pool.ReserveTransientHeaps(transient_layout.heap_sizes);
+
+		if (cached_graph)
+		{
+			cached_graph->transient_layout = transient_layout;
+			ADRIA_LOG(INFO, "[RenderGraph] %s", TransientLayoutToString(transient_layout).c_str());
+		}
+	}
+
+	void RenderGraph::CreateImportedResourcesViews()
+	{
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
 			if (textures[i]->imported) CreateTextureViews(RGTextureId(i));
 		}
 		for (Uint64 i = 0; i < buffers.size(); ++i)
 		{
-			if (buffers[i]->last_used_by != nullptr) buffers[i]->last_used_by->buffer_destroys.insert(RGBufferId(i));
 			if (buffers[i]->imported) CreateBufferViews(RGBufferId(i));
 		}
 	}
 
+	void RenderGraph::ComputeSignature(RGSignature& signature) const
+	{
+		signature.passes.resize(passes.size());
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RenderGraphPassBase const* pass = passes[i].get();
+			RenderGraphPassSignature& pass_signature = signature.passes[i];
+			pass_signature.name = pass->name;
+			pass_signature.type = (Uint64)pass->type;
+			pass_signature.flags = (Uint64)pass->flags;
+			GetResourceSetSignature(pass->texture_creates, pass_signature.texture_creates);
+			GetResourceSetSignature(pass->texture_reads, pass_signature.texture_reads);
+			GetResourceSetSignature(pass->texture_writes, pass_signature.texture_writes);
+			GetResourceStateSignature(pass->texture_state_map, pass_signature.texture_states);
+			GetResourceSetSignature(pass->buffer_creates, pass_signature.buffer_creates);
+			GetResourceSetSignature(pass->buffer_reads, pass_signature.buffer_reads);
+			GetResourceSetSignature(pass->buffer_writes, pass_signature.buffer_writes);
+			GetResourceStateSignature(pass->buffer_state_map, pass_signature.buffer_states);
+		}
+
+		signature.textures.resize(textures.size());
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			signature.textures[i].imported = textures[i]->imported;
+			signature.textures[i].desc = textures[i]->desc;
+		}
+		for (auto const& [name, id] : texture_name_id_map) signature.textures[id.id].name = name.hashed_name;
+
+		signature.buffers.resize(buffers.size());
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			signature.buffers[i].imported = buffers[i]->imported;
+			signature.buffers[i].desc = buffers[i]->desc;
+		}
+		for (auto const& [name, id] : buffer_name_id_map) signature.buffers[id.id].name = name.hashed_name;
+	}
+
+	Uint64 RenderGraph::ComputeStructuralHash(RGSignature const& signature)
+	{
+		HashState hash{};
+		hash.Combine(signature.passes.size());
+		for (RenderGraphPassSignature const& pass : signature.passes)
+		{
+			hash.Combine(pass.name);
+			hash.Combine(pass.type);
+			hash.Combine(pass.flags);
+			HashIds(hash, pass.texture_creates);
+			HashIds(hash, pass.texture_reads);
+			HashIds(hash, pass.texture_writes);
+			HashStates(hash, pass.texture_states);
+			HashIds(hash, pass.buffer_creates);
+			HashIds(hash, pass.buffer_reads);
+			HashIds(hash, pass.buffer_writes);
+			HashStates(hash, pass.buffer_states);
+		}
+		hash.Combine(signature.textures.size());
+		for (auto const& texture : signature.textures)
+		{
+			hash.Combine(texture.name);
+			hash.Combine(texture.imported);
+			hash.Combine(HashTransientDesc(texture.desc));
+		}
+		hash.Combine(signature.buffers.size());
+		for (auto const& buffer : signature.buffers)
+		{
+			hash.Combine(buffer.name);
+			hash.Combine(buffer.imported);
+			hash.Combine(HashTransientDesc(buffer.desc));
+		}
+		return hash;
+	}
+
+	void RenderGraph::StoreCompiledGraph(RGCompiledGraph& compiled_graph) const
+	{
+		compiled_graph.adjacency_lists = adjacency_lists;
+		compiled_graph.topologically_sorted_passes = topologically_sorted_passes;
+
+		compiled_graph.dependency_levels.resize(dependency_levels.size());
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			DependencyLevel const& dependency_level = dependency_levels[i];
+			RGCompiledLevel& compiled_level = compiled_graph.dependency_levels[i];
+			compiled_level.passes.reserve(dependency_level.passes.size());
+			for (RenderGraphPassBase* pass : dependency_level.passes) compiled_level.passes.push_back(pass->id);
+			compiled_level.texture_creates = dependency_level.texture_creates;
+			compiled_level.texture_destroys = dependency_level.texture_destroys;
+			compiled_level.texture_state_map = dependency_level.texture_state_map;
+			compiled_level.buffer_creates = dependency_level.buffer_creates;
+			compiled_level.buffer_destroys = dependency_level.buffer_destroys;
+			compiled_level.buffer_state_map = dependency_level.buffer_state_map;
+		}
+
+		compiled_graph.pass_ref_counts.resize(passes.size());
+		for (Uint64 i = 0; i < passes.size(); ++i) compiled_graph.pass_ref_counts[i] = passes[i]->ref_count;
+
+		compiled_graph.texture_ref_counts.resize(textures.size());
+		compiled_graph.texture_last_users.resize(textures.size());
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			RGTexture const* rg_texture = textures[i].get();
+			compiled_graph.texture_ref_counts[i] = rg_texture->ref_count;
+			compiled_graph.texture_last_users[i] = rg_texture->last_used_by ? rg_texture->last_used_by->id : RGCompiledGraph::invalid_pass;
+		}
+		compiled_graph.buffer_ref_counts.resize(buffers.size());
+		compiled_graph.buffer_last_users.resize(buffers.size());
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			RGBuffer const* rg_buffer = buffers[i].get();
+			compiled_graph.buffer_ref_counts[i] = rg_buffer->ref_count;
+			compiled_graph.buffer_last_users[i] = rg_buffer->last_used_by ? rg_buffer->last_used_by->id : RGCompiledGraph::invalid_pass;
+		}
+	}
+
+	void RenderGraph::LoadCompiledGraph(RGCompiledGraph const& compiled_graph)
+	{
+		adjacency_lists = compiled_graph.adjacency_lists;
+		topologically_sorted_passes = compiled_graph.topologically_sorted_passes;
+		async_compute_schedule = compiled_graph.async_compute_schedule;
+		barrier_plan = compiled_graph.barrier_plan;
+
+		for (Uint64 i = 0; i < passes.size(); ++i) passes[i]->ref_count = compiled_graph.pass_ref_counts[i];
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			RGTexture* rg_texture = textures[i].get();
+			rg_texture->ref_count = compiled_graph.texture_ref_counts[i];
+			Uint64 last_user = compiled_graph.texture_last_users[i];
+			if (last_user != RGCompiledGraph::invalid_pass)
+			{
+				rg_texture->last_used_by = passes[last_user].get();
+				rg_texture->last_used_by->texture_destroys.Insert(RGTextureId(i));
+			}
+		}
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			RGBuffer* rg_buffer = buffers[i].get();
+			rg_buffer->ref_count = compiled_graph.buffer_ref_counts[i];
+			Uint64 last_user = compiled_graph.buffer_last_users[i];
+			if (last_user != RGCompiledGraph::invalid_pass)
+			{
+				rg_buffer->last_used_by = passes[last_user].get();
+				rg_buffer->last_used_by->buffer_destroys.Insert(RGBufferId(i));
+			}
+		}
+
+		dependency_levels.resize(compiled_graph.dependency_levels.size(), DependencyLevel(*this));
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			RGCompiledLevel const& compiled_level = compiled_graph.dependency_levels[i];
+			DependencyLevel& dependency_level = dependency_levels[i];
+			for (Uint64 pass_idx : compiled_level.passes) dependency_level.AddPass(passes[pass_idx].get());
+			dependency_level.texture_creates = compiled_level.texture_creates;
+			dependency_level.texture_destroys = compiled_level.texture_destroys;
+			dependency_level.texture_state_map = compiled_level.texture_state_map;
+			dependency_level.buffer_creates = compiled_level.buffer_creates;
+			dependency_level.buffer_destroys = compiled_level.buffer_destroys;
+			dependency_level.buffer_state_map = compiled_level.buffer_state_map;
+		}
+	}
+
 	void RenderGraph::DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& topologically_sorted_passes)
 	{
 		visited[i] = true;
@@ -854,42 +1377,42 @@ namespace adria
 	GfxDescriptor RenderGraph::GetRenderTarget(RGRenderTargetId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_view_map.at(tex_id);
 		return views[res_id.GetViewId()].first;
 	}
 
 	GfxDescriptor RenderGraph::GetDepthStencil(RGDepthStencilId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_view_map.at(tex_id);
 		return views[res_id.GetViewId()].first;
 	}
 
 	GfxDescriptor RenderGraph::GetReadOnlyTexture(RGTextureReadOnlyId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_view_map.at(tex_id);
 		return views[res_id.GetViewId()].first;
 	}
 
 	GfxDescriptor RenderGraph::GetReadWriteTexture(RGTextureReadWriteId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_view_map.at(tex_id);
 		return views[res_id.GetViewId()].first;
 	}
 
 	GfxDescriptor RenderGraph::GetReadOnlyBuffer(RGBufferReadOnlyId res_id) const
 	{
 		RGBufferId buf_id = res_id.GetResourceId();
-		auto const& views = buffer_view_map[buf_id];
+		auto const& views = buffer_view_map.at(buf_id);
 		return views[res_id.GetViewId()].first;
 	}
 
 	GfxDescriptor RenderGraph::GetReadWriteBuffer(RGBufferReadWriteId res_id) const
 	{
 		RGBufferId buf_id = res_id.GetResourceId();
-		auto const& views = buffer_view_map[buf_id];
+		auto const& views = buffer_view_map.at(buf_id);
 		return views[res_id.GetViewId()].first;
 	}
 
@@ -928,175 +1451,229 @@ namespace adria
 	{
 		for (auto& pass : passes)
 		{
-			if (pass->IsCulled()) continue;
-			RenderGraphContext rg_resources(rg, *pass);
-			if (pass->type == RGPassType::Graphics)
+			if (pass->IsCulled() || rg.IsAsyncComputePass(pass)) continue;
+			ExecutePass(pass, cmd_list);
+		}
+	}
+
+	void RenderGraph::DependencyLevel::ExecuteAsyncCompute(GfxDevice* gfx, GfxCommandList* cmd_list)
+	{
+		for (auto& pass : passes)
+		{
+			if (pass->IsCulled() || !rg.IsAsyncComputePass(pass)) continue;
+			ExecutePass(pass, cmd_list);
+		}
+	}
+
+	void RenderGraph::DependencyLevel::Execute(GfxDevice* gfx, std::span<GfxCommandList*> const& cmd_lists)
+	{
+		ExecuteBatched(cmd_lists.size(), [&](RenderGraphPassBase* pass, Uint64 batch_index) { ExecutePass(pass, cmd_lists[batch_index]); });
+	}
+
+	void RenderGraph::DependencyLevel::ExecuteBatched(Uint64 batch_count, std::function<void(RenderGraphPassBase*, Uint64)> const& record_pass) const
+	{
+		std::vector<RenderGraphPassBase*> active_passes;
+		active_passes.reserve(passes.size());
+		for (auto& pass : passes)
+		{
+			if (!pass->IsCulled() && !rg.IsAsyncComputePass(pass)) active_passes.push_back(pass);
+		}
+
+		//contiguous batches keep the recording order of the passes identical to the single threaded path
+		auto RecordBatch = [&](Uint64 batch_index)
+		{
+			Uint64 const batch_begin = (active_passes.size() * batch_index) / batch_count;
+			Uint64 const batch_end = (active_passes.size() * (batch_index + 1)) / batch_count;
+			for (Uint64 i = batch_begin; i < batch_end; ++i) record_pass(active_passes[i], batch_index);
+		};
+
+		g_ThreadPool.ParallelFor(batch_count, 1, [&](Uint64 batch_begin, Uint64 batch_end)
+		{
+			for (Uint64 batch_index = batch_begin; batch_index < batch_end; ++batch_index) RecordBatch(batch_index);
+		});
+	}
+
+	Uint64 RenderGraph::DependencyLevel::GetRecordingBatchCount() const
+	{
+		Uint64 active_pass_count = 0;
+		for (auto const& pass : passes)
+		{
+			if (!pass->IsCulled() && !rg.IsAsyncComputePass(pass)) ++active_pass_count;
+		}
+		return std::clamp<Uint64>(active_pass_count / MIN_PASSES_PER_BATCH, 1, g_ThreadPool.GetThreadCount());
+	}
+
+	void RenderGraph::DependencyLevel::ExecutePass(RenderGraphPassBase* pass, GfxCommandList* cmd_list)
+	{
+		RenderGraphContext rg_resources(rg, *pass);
+		if (pass->type == RGPassType::Graphics)
+		{
+			GfxRenderPassDesc render_pass_desc{};
+			render_pass_desc.flags = GfxRenderPassFlagBit_None;
+			render_pass_desc.rtv_attachments.reserve(pass->render_targets_info.size());
+			for (auto const& render_target_info : pass->render_targets_info)
 			{
-				GfxRenderPassDesc render_pass_desc{};
-				render_pass_desc.flags = GfxRenderPassFlagBit_None;
-				render_pass_desc.rtv_attachments.reserve(pass->render_targets_info.size());
-				for (auto const& render_target_info : pass->render_targets_info)
+				GfxColorAttachmentDesc rtv_desc{};
+
+				RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
+				RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
+				SplitAccessOp(render_target_info.render_target_access, load_access, store_access);
+
+				switch (load_access)
 				{
-					GfxColorAttachmentDesc rtv_desc{};
-
-					RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
-					RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
-					SplitAccessOp(render_target_info.render_target_access, load_access, store_access);
-
-					switch (load_access)
-					{
-					case RGLoadAccessOp::Clear:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Clear;
-						break;
-					case RGLoadAccessOp::Discard:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Discard;
-						break;
-					case RGLoadAccessOp::Preserve:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Preserve;
-						break;
-					case RGLoadAccessOp::NoAccess:
-						rtv_desc.beginning_access = GfxLoadAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
-					}
-
-					switch (store_access)
-					{
-					case RGStoreAccessOp::Resolve:
-						rtv_desc.ending_access = GfxStoreAccessOp::Resolve;
-						break;
-					case RGStoreAccessOp::Discard:
-						rtv_desc.ending_access = GfxStoreAccessOp::Discard;
-						break;
-					case RGStoreAccessOp::Preserve:
-						rtv_desc.ending_access = GfxStoreAccessOp::Preserve;
-						break;
-					case RGStoreAccessOp::NoAccess:
-						rtv_desc.ending_access = GfxStoreAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
-					}
-
-					RGTextureId rt_texture = render_target_info.render_target_handle.GetResourceId();
-					GfxTexture* texture = rg.GetTexture(rt_texture);
-
-					GfxTextureDesc const& desc = texture->GetDesc();
-					GfxClearValue const& clear_value = desc.clear_value;
-					if (clear_value.active_member != GfxClearValue::GfxActiveMember::None)
-					{
-						ADRIA_ASSERT_MSG(clear_value.active_member == GfxClearValue::GfxActiveMember::Color, "Invalid Clear Value for Render Target");
-						rtv_desc.clear_value = desc.clear_value;
-						rtv_desc.clear_value.format = desc.format;
-					}
-					else if(rtv_desc.beginning_access == GfxLoadAccessOp::Clear)
-					{
-						rtv_desc.clear_value.format = desc.format;
-						rtv_desc.clear_value = GfxClearValue(0.0f, 0.0f, 0.0f, 0.0f);
-					}
-
-					rtv_desc.cpu_handle = rg.GetRenderTarget(render_target_info.render_target_handle);
-					render_pass_desc.rtv_attachments.push_back(rtv_desc);
+				case RGLoadAccessOp::Clear:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Clear;
+					break;
+				case RGLoadAccessOp::Discard:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Discard;
+					break;
+				case RGLoadAccessOp::Preserve:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Preserve;
+					break;
+				case RGLoadAccessOp::NoAccess:
+					rtv_desc.beginning_access = GfxLoadAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
+				}
+
+				switch (store_access)
+				{
+				case RGStoreAccessOp::Resolve:
+					rtv_desc.ending_access = GfxStoreAccessOp::Resolve;
+					break;
+				case RGStoreAccessOp::Discard:
+					rtv_desc.ending_access = GfxStoreAccessOp::Discard;
+					break;
+				case RGStoreAccessOp::Preserve:
+					rtv_desc.ending_access = GfxStoreAccessOp::Preserve;
+					break;
+				case RGStoreAccessOp::NoAccess:
+					rtv_desc.ending_access = GfxStoreAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
 				}
 
-				if (pass->depth_stencil.has_value())
+				RGTextureId rt_texture = render_target_info.render_target_handle.GetResourceId();
+				GfxTexture* texture = rg.GetTexture(rt_texture);
+
+				GfxTextureDesc const& desc = texture->GetDesc();
+				GfxClearValue const& clear_value = desc.clear_value;
+				if (clear_value.active_member != GfxClearValue::GfxActiveMember::None)
+				{
+					ADRIA_ASSERT_MSG(clear_value.active_member == GfxClearValue::GfxActiveMember::Color, "Invalid Clear Value for Render Target");
+					rtv_desc.clear_value = desc.clear_value;
+					rtv_desc.clear_value.format = desc.format;
+				}
+				else if(rtv_desc.beginning_access == GfxLoadAccessOp::Clear)
 				{
-					auto const& depth_stencil_info = pass->depth_stencil.value();
-					if (depth_stencil_info.depth_read_only)
-					{
-						render_pass_desc.flags |= GfxRenderPassFlagBit_ReadOnlyDepth;
-					}
-					
-					GfxDepthAttachmentDesc dsv_desc{};
-					RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
-					RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
-					SplitAccessOp(depth_stencil_info.depth_access, load_access, store_access);
-
-					switch (load_access)
-					{
-					case RGLoadAccessOp::Clear:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Clear;
-						break;
-					case RGLoadAccessOp::Discard:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Discard;
-						break;
-					case RGLoadAccessOp::Preserve:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Preserve;
-						break;
-					case RGLoadAccessOp::NoAccess:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
-					}
-
-					switch (store_access)
-					{
-					case RGStoreAccessOp::Resolve:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Resolve;
-						break;
-					case RGStoreAccessOp::Discard:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Discard;
-						break;
-					case RGStoreAccessOp::Preserve:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Preserve;
-						break;
-					case RGStoreAccessOp::NoAccess:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
-					}
-
-					RGTextureId ds_texture = depth_stencil_info.depth_stencil_handle.GetResourceId();
-					GfxTexture* texture = rg.GetTexture(ds_texture);
-
-					GfxTextureDesc const& desc = texture->GetDesc();
-					if (desc.clear_value.active_member != GfxClearValue::GfxActiveMember::None)
-					{
-						ADRIA_ASSERT_MSG(desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil, "Invalid Clear Value for Depth Stencil");
-						dsv_desc.clear_value = desc.clear_value;
-						dsv_desc.clear_value.format = desc.format;
-					}
-					else if (dsv_desc.depth_beginning_access == GfxLoadAccessOp::Clear)
-					{
-						dsv_desc.clear_value.format = desc.format;
-						dsv_desc.clear_value = GfxClearValue(0.0f, 0);
-					}
-
-					dsv_desc.cpu_handle = rg.GetDepthStencil(depth_stencil_info.depth_stencil_handle);
-
-					//todo add stencil
-					render_pass_desc.dsv_attachment = dsv_desc;
+					rtv_desc.clear_value.format = desc.format;
+					rtv_desc.clear_value = GfxClearValue(0.0f, 0.0f, 0.0f, 0.0f);
 				}
-				ADRIA_ASSERT_MSG((pass->viewport_width != 0 && pass->viewport_height != 0), "Viewport Width/Height is 0! The call to builder.SetViewport is probably missing...");
-				render_pass_desc.width = pass->viewport_width;
-				render_pass_desc.height = pass->viewport_height;
-				render_pass_desc.legacy = pass->UseLegacyRenderPasses();
-
-				PIXScopedEvent(cmd_list->GetNative(), PIX_COLOR_DEFAULT, pass->name.c_str());
-				AdriaGfxProfileScope(cmd_list, pass->name.c_str());
-				TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
-				cmd_list->SetContext(GfxCommandList::Context::Graphics);
-				cmd_list->BeginRenderPass(render_pass_desc);
-				pass->Execute(rg_resources,cmd_list);
-				cmd_list->EndRenderPass();
+
+				rtv_desc.cpu_handle = rg.GetRenderTarget(render_target_info.render_target_handle);
+				render_pass_desc.rtv_attachments.push_back(rtv_desc);
 			}
-			else
+
+			if (pass->depth_stencil.has_value())
 			{
-				PIXScopedEvent(cmd_list->GetNative(), PIX_COLOR_DEFAULT, pass->name.c_str());
-				AdriaGfxProfileScope(cmd_list, pass->name.c_str());
-				TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
-				cmd_list->SetContext(GfxCommandList::Context::Compute);
-				pass->Execute(rg_resources, cmd_list);
+				auto const& depth_stencil_info = pass->depth_stencil.value();
+				if (depth_stencil_info.depth_read_only)
+				{
+					render_pass_desc.flags |= GfxRenderPassFlagBit_ReadOnlyDepth;
+				}
+				
+				GfxDepthAttachmentDesc dsv_desc{};
+				RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
+				RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
+				SplitAccessOp(depth_stencil_info.depth_access, load_access, store_access);
+
+				switch (load_access)
+				{
+				case RGLoadAccessOp::Clear:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Clear;
+					break;
+				case RGLoadAccessOp::Discard:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Discard;
+					break;
+				case RGLoadAccessOp::Preserve:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Preserve;
+					break;
+				case RGLoadAccessOp::NoAccess:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
+				}
+
+				switch (store_access)
+				{
+				case RGStoreAccessOp::Resolve:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Resolve;
+					break;
+				case RGStoreAccessOp::Discard:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Discard;
+					break;
+				case RGStoreAccessOp::Preserve:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Preserve;
+					break;
+				case RGStoreAccessOp::NoAccess:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
+				}
+
+				RGTextureId ds_texture = depth_stencil_info.depth_stencil_handle.GetResourceId();
+				GfxTexture* texture = rg.GetTexture(ds_texture);
+
+				GfxTextureDesc const& desc = texture->GetDesc();
+				if (desc.clear_value.active_member != GfxClearValue::GfxActiveMember::None)
+				{
+					ADRIA_ASSERT_MSG(desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil, "Invalid Clear Value for Depth Stencil");
+					dsv_desc.clear_value = desc.clear_value;
+					dsv_desc.clear_value.format = desc.format;
+				}
+				else if (dsv_desc.depth_beginning_access == GfxLoadAccessOp::Clear)
+				{
+					dsv_desc.clear_value.format = desc.format;
+					dsv_desc.clear_value = GfxClearValue(0.0f, 0);
+				}
+
+				dsv_desc.cpu_handle = rg.GetDepthStencil(depth_stencil_info.depth_stencil_handle);
+
+				//todo add stencil
+				render_pass_desc.dsv_attachment = dsv_desc;
 			}
+			ADRIA_ASSERT_MSG((pass->viewport_width != 0 && pass->viewport_height != 0), "Viewport Width/Height is 0! The call to builder.SetViewport is probably missing...");
+			render_pass_desc.width = pass->viewport_width;
+			render_pass_desc.height = pass->viewport_height;
+			render_pass_desc.legacy = pass->UseLegacyRenderPasses();
+
+			PIXScopedEvent(cmd_list->GetNative(), PIX_COLOR_DEFAULT, pass->name.c_str());
+			AdriaGfxProfileScope(cmd_list, pass->name.c_str());
+			TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
+			cmd_list->SetContext(GfxCommandList::Context::Graphics);
+			cmd_list->BeginRenderPass(render_pass_desc);
+			pass->Execute(rg_resources,cmd_list);
+			cmd_list->EndRenderPass();
+		}
+		else if (rg.IsAsyncComputePass(pass))
+		{
+			//profiler scopes are resolved against graphics queue timestamps
+			PIXScopedEvent(cmd_list->GetNative(), PIX_COLOR_DEFAULT, pass->name.c_str());
+			cmd_list->SetContext(GfxCommandList::Context::Compute);
+			pass->Execute(rg_resources, cmd_list);
+		}
+		else
+		{
+			PIXScopedEvent(cmd_list->GetNative(), PIX_COLOR_DEFAULT, pass->name.c_str());
+			AdriaGfxProfileScope(cmd_list, pass->name.c_str());
+			TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
+			cmd_list->SetContext(GfxCommandList::Context::Compute);
+			pass->Execute(rg_resources, cmd_list);
 		}
-	}
-
-	void RenderGraph::DependencyLevel::Execute(GfxDevice* gfx, std::span<GfxCommandList*> const& cmd_lists)
-	{
-		ADRIA_ASSERT_MSG(false, "Not yet implemented");
 	}
 
 	void RenderGraph::Dump(Char const* graph_file_name)
@@ -1114,6 +1691,7 @@ namespace adria
 				struct
 				{
 					Char const* executed{ "orange" };
+					Char const* async_compute{ "gold" };
 					Char const* culled{ "lightgray" };
 				} pass;
 				struct
@@ -1188,7 +1766,8 @@ namespace adria
 				graphviz.declarations += std::format("P{} ", pass->id);
 				std::string label = std::format("<{}<br/> type: {}<br/> refs: {}<br/> culled: {}>", pass->name, RGPassTypeToString(pass->type), pass->ref_count, pass->IsCulled() ? "Yes" : "No");
 				graphviz.declarations += std::format("[shape=\"ellipse\", style=\"rounded,filled\",fillcolor={}, label={}] \n",
-					                                  pass->IsCulled() ?  style.color.pass.culled : style.color.pass.executed, label);
+					                                  pass->IsCulled() ?  style.color.pass.culled : 
+					                                  async_compute_schedule.pass_queues[pass->id] == RGQueueType::Compute ? style.color.pass.async_compute : style.color.pass.executed, label);
 
 				std::string read_dependencies = "{"; 
 				std::string write_dependencies = "{";
@@ -1210,7 +1789,7 @@ namespace adria
 				for (auto const& buffer_write : pass->buffer_writes)
 				{
 					RGBuffer* buffer = GetRGBuffer(buffer_write);
-					if (!pass->buffer_creates.contains(buffer_write)) buffer->version++;
+					if (!pass->buffer_creates.Contains(buffer_write)) buffer->version++;
 					DeclareBuffer(buffer);
 					write_dependencies += std::format("B{}_{},", buffer->id, buffer->version);
 				}
@@ -1218,7 +1797,7 @@ namespace adria
 				for (auto const& texture_write : pass->texture_writes)
 				{
 					RGTexture* texture = GetRGTexture(texture_write);
-					if (!pass->texture_creates.contains(texture_write)) texture->version++;
+					if (!pass->texture_creates.Contains(texture_write)) texture->version++;
 					DeclareTexture(texture);
 					write_dependencies += std::format("T{}_{},", texture->id, texture->version);
 				}
@@ -1302,6 +1881,15 @@ namespace adria
 			}
 			render_graph_data += "\n";
 		}
+		render_graph_data += "\nAsync compute schedule: \n";
+		render_graph_data += AsyncComputeScheduleToString(async_compute_schedule);
+		render_graph_data += "\nBarrier plan: \n";
+		render_graph_data += BarrierPlanToString(barrier_plan);
+		if (transient_aliasing)
+		{
+			render_graph_data += "\nTransient aliasing: \n";
+			render_graph_data += TransientLayoutToString(transient_layout);
+		}
 		render_graph_data += "\nTextures: \n";
 		for (Uint64 i = 0; i < textures.size(); ++i)
 		{
@@ -3,6 +3,7 @@
 #include "RenderGraphBlackboard.h"
 #include "RenderGraphBuilder.h"
 #include "RenderGraphResourcePool.h"
+#include "RenderGraphCompileCache.h"
 #include "Graphics/GfxDevice.h"
 
 namespace adria
@@ -11,10 +12,14 @@ namespace adria
 	{
 		friend class RenderGraphBuilder;
 		friend class RenderGraphContext;
+		friend class RenderGraphValidation;
 
 		class DependencyLevel
 		{
 			friend RenderGraph;
+			friend class RenderGraphValidation;
+			static constexpr Uint64 MIN_PASSES_PER_BATCH = 2;
+
 		public:
 
 			explicit DependencyLevel(RenderGraph& rg) : rg(rg) {}
@@ -22,6 +27,10 @@ namespace adria
 			void Setup();
 			void Execute(GfxDevice* gfx, GfxCommandList* cmd_list);
 			void Execute(GfxDevice* gfx, std::span<GfxCommandList*> const& cmd_lists);
+			//Splits the active passes into batch_count contiguous batches and records the batches in parallel on the thread pool
+			void ExecuteBatched(Uint64 batch_count, std::function<void(RenderGraphPassBase*, Uint64)> const& record_pass) const;
+			void ExecuteAsyncCompute(GfxDevice* gfx, GfxCommandList* cmd_list);
+			Uint64 GetRecordingBatchCount() const;
 
 		private:
 			RenderGraph& rg;
@@ -37,11 +46,14 @@ namespace adria
 			std::unordered_set<RGBufferId> buffer_writes;
 			std::unordered_set<RGBufferId> buffer_destroys;
 			std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
+
+		private:
+			void ExecutePass(RenderGraphPassBase* pass, GfxCommandList* cmd_list);
 		};
 
 	public:
 
-		RenderGraph(RGResourcePool& pool) : pool(pool), gfx(pool.GetDevice()) {}
+		RenderGraph(RGResourcePool& pool, RGCompileCache* compile_cache = nullptr) : pool(pool), compile_cache(compile_cache), gfx(pool.GetDevice()) {}
 		ADRIA_NONCOPYABLE(RenderGraph)
 		ADRIA_DEFAULT_MOVABLE(RenderGraph)
 		~RenderGraph();
@@ -73,6 +85,7 @@ namespace adria
 
 	private:
 		RGResourcePool& pool;
+		RGCompileCache* compile_cache;
 		GfxDevice* gfx;
 		RGBlackboard blackboard;
 
@@ -84,6 +97,17 @@ namespace adria
 		std::vector<Uint64> topologically_sorted_passes;
 		std::vector<DependencyLevel> dependency_levels;
 
+		RGAsyncComputeSchedule async_compute_schedule;
+		std::vector<Uint64> async_compute_fence_values;
+		Bool async_compute = false;
+
+		RGCompiledGraph* cached_graph = nullptr;
+		RGBarrierPlan barrier_plan;
+		Bool split_barriers = false;
+
+		RGTransientLayout transient_layout;
+		Bool transient_aliasing = false;
+
 		std::unordered_map<RGResourceName, RGTextureId> texture_name_id_map;
 		std::unordered_map<RGResourceName, RGBufferId>  buffer_name_id_map;
 		std::unordered_map<RGBufferReadWriteId, RGBufferId> buffer_uav_counter_map;
@@ -101,6 +125,14 @@ namespace adria
 		void BuildDependencyLevels();
 		void CullPasses();
 		void CalculateResourcesLifetime();
+		void CreateImportedResourcesViews();
+		void ScheduleAsyncCompute(std::span<RGCompiledLevel const> compiled_levels);
+		void PlaceTransientResources();
+
+		void ComputeSignature(RGSignature& signature) const;
+		static Uint64 ComputeStructuralHash(RGSignature const& signature);
+		void StoreCompiledGraph(RGCompiledGraph& compiled_graph) const;
+		void LoadCompiledGraph(RGCompiledGraph const& compiled_graph);
 		void DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& sort);
 		
 		RGTextureId DeclareTexture(RGResourceName name, RGTextureDesc const& desc);
@@ -164,6 +196,17 @@ namespace adria
 		void CreateBufferViews(RGBufferId);
 		void Execute_Singlethreaded();
 		void Execute_Multithreaded();
+		void BeginDependencyLevel(Uint64 level_index, GfxCommandList* cmd_list);
+		void EndDependencyLevel(Uint64 level_index, GfxCommandList* cmd_list);
+		void DestroyTexture(RGTextureId tex_id, GfxResourceState state, GfxCommandList* cmd_list);
+		void DestroyBuffer(RGBufferId buf_id, GfxResourceState state, GfxCommandList* cmd_list);
+
+		Bool IsAliasedTexture(RGTextureId tex_id) const;
+		Bool IsAliasedBuffer(RGBufferId buf_id) const;
+
+		Bool IsAsyncComputePass(RenderGraphPassBase const* pass) const;
+		GfxCommandList* ExecuteAsyncCompute(Uint64 level_index, GfxCommandList* cmd_list);
+		GfxCommandList* SyncAsyncCompute(Uint64 level_index, GfxCommandList* cmd_list);
 
 		void AddExportBufferCopyPass(RGResourceName export_buffer, GfxBuffer* buffer);
 		void AddExportTextureCopyPass(RGResourceName export_texture, GfxTexture* texture);
@@ -0,0 +1,101 @@
+#include <format>
+#include "RenderGraphAsyncCompute.h"
+#include "RenderGraphCompileCache.h"
+
+namespace adria
+{
+	namespace
+	{
+		//states a compute queue cannot access a resource in, they only exist on the graphics queue
+		GfxResourceState const GraphicsOnlyStates = GfxResourceState::Present | GfxResourceState::RTV | GfxResourceState::AllDSV |
+													   GfxResourceState::PixelSRV | GfxResourceState::ShadingRate | GfxResourceState::IndexBuffer;
+
+		//barriers of a level are merged over all of its passes, graphics passes sharing a resource with an async pass can add graphics only states
+		Bool UsesGraphicsOnlyStates(RGCompiledLevel const& dependency_level, RGScheduledPass const& pass)
+		{
+			auto IsGraphicsOnly = [](auto const& state_map, auto id)
+			{
+				auto it = state_map.find(id);
+				return it != state_map.end() && HasAnyFlag(it->second, GraphicsOnlyStates);
+			};
+			return std::any_of(pass.textures.begin(), pass.textures.end(), [&](RGTextureId id) { return IsGraphicsOnly(dependency_level.texture_state_map, id); })
+				|| std::any_of(pass.buffers.begin(), pass.buffers.end(), [&](RGBufferId id) { return IsGraphicsOnly(dependency_level.buffer_state_map, id); });
+		}
+	}
+
+	RGAsyncComputeSchedule BuildAsyncComputeSchedule(std::span<RGCompiledLevel const> dependency_levels, std::span<RGScheduledPass const> passes)
+	{
+		RGAsyncComputeSchedule schedule{};
+		schedule.pass_queues.resize(passes.size(), RGQueueType::Graphics);
+		schedule.sync_levels.resize(dependency_levels.size(), RGAsyncComputeSchedule::invalid_level);
+		schedule.deferred_texture_destroys.resize(dependency_levels.size());
+		schedule.deferred_buffer_destroys.resize(dependency_levels.size());
+
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			RGCompiledLevel const& dependency_level = dependency_levels[i];
+			Bool has_async_passes = false;
+			RGTextureSet async_textures;
+			RGBufferSet async_buffers;
+			for (Uint64 pass_idx : dependency_level.passes)
+			{
+				RGScheduledPass const& pass = passes[pass_idx];
+				if (!pass.async_compute || UsesGraphicsOnlyStates(dependency_level, pass)) continue;
+
+				has_async_passes = true;
+				schedule.pass_queues[pass_idx] = RGQueueType::Compute;
+				for (RGTextureId tex_id : pass.textures) async_textures.Insert(tex_id);
+				for (RGBufferId buf_id : pass.buffers) async_buffers.Insert(buf_id);
+			}
+			if (!has_async_passes) continue;
+
+			Uint64 sync_level = i + 1;
+			for (; sync_level < dependency_levels.size(); ++sync_level)
+			{
+				RGCompiledLevel const& next_level = dependency_levels[sync_level];
+				Bool const touches_texture = std::any_of(async_textures.begin(), async_textures.end(), [&](RGTextureId id) { return next_level.texture_state_map.contains(id); });
+				Bool const touches_buffer = std::any_of(async_buffers.begin(), async_buffers.end(), [&](RGBufferId id) { return next_level.buffer_state_map.contains(id); });
+				if (touches_texture || touches_buffer) break;
+			}
+			schedule.sync_levels[i] = sync_level;
+
+			for (RGTextureId tex_id : dependency_level.texture_destroys)
+			{
+				if (async_textures.Contains(tex_id)) schedule.deferred_texture_destroys[i].Insert(tex_id);
+			}
+			for (RGBufferId buf_id : dependency_level.buffer_destroys)
+			{
+				if (async_buffers.Contains(buf_id)) schedule.deferred_buffer_destroys[i].Insert(buf_id);
+			}
+		}
+		return schedule;
+	}
+
+	std::string AsyncComputeScheduleToString(RGAsyncComputeSchedule const& schedule)
+	{
+		std::string schedule_data = "Pass queues: \n";
+		for (Uint64 i = 0; i < schedule.pass_queues.size(); ++i)
+		{
+			if (schedule.pass_queues[i] == RGQueueType::Compute) schedule_data += std::format("Pass {}: Compute\n", i);
+		}
+
+		schedule_data += "\nSync points: \n";
+		for (Uint64 i = 0; i < schedule.sync_levels.size(); ++i)
+		{
+			if (!schedule.HasAsyncCompute(i)) continue;
+
+			Uint64 const sync_level = schedule.sync_levels[i];
+			if (sync_level == schedule.sync_levels.size()) schedule_data += std::format("Dependency level {}: graphics waits at the end of the graph", i);
+			else schedule_data += std::format("Dependency level {}: graphics waits at dependency level {}", i, sync_level);
+
+			if (!schedule.deferred_texture_destroys[i].Empty() || !schedule.deferred_buffer_destroys[i].Empty())
+			{
+				schedule_data += ", deferred destroys:";
+				for (RGTextureId tex_id : schedule.deferred_texture_destroys[i]) schedule_data += std::format(" T{}", tex_id.id);
+				for (RGBufferId buf_id : schedule.deferred_buffer_destroys[i]) schedule_data += std::format(" B{}", buf_id.id);
+			}
+			schedule_data += "\n";
+		}
+		return schedule_data;
+	}
+}
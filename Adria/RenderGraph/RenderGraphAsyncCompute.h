@@ -0,0 +1,53 @@
+#pragma once
+#include <span>
+#include <string>
+#include "RenderGraphResourceId.h"
+
+namespace adria
+{
+	struct RenderGraphCompiledLevel;
+
+	enum class RGQueueType : Uint8
+	{
+		Graphics,
+		Compute
+	};
+
+	struct RenderGraphScheduledPass
+	{
+		Bool async_compute = false;
+		std::vector<RGTextureId> textures;
+		std::vector<RGBufferId> buffers;
+	};
+	using RGScheduledPass = RenderGraphScheduledPass;
+
+	//Result of scheduling ComputeAsync passes on the compute queue. For a dependency level with async compute passes, the graphics queue
+	//signals after the barriers of that level and the compute queue waits for it before recording them. The graphics queue then waits
+	//for the compute queue at the start of the sync level, the first later level that touches any resource used by those passes.
+	//All barriers stay on the graphics queue, so resources cross the queue boundary only at these sync points.
+	//An async pass whose resources are in a graphics only state during its level, because of other passes in the level, stays on the graphics queue.
+	struct RenderGraphAsyncComputeSchedule
+	{
+		inline static constexpr Uint64 invalid_level = Uint64(-1);
+
+		std::vector<RGQueueType> pass_queues;
+		//invalid_level for levels without async compute passes, level count when the wait happens at the end of the graph
+		std::vector<Uint64> sync_levels;
+		//destroys of resources used on the compute queue, they are executed at the sync level instead of the level they belong to
+		std::vector<RGTextureSet> deferred_texture_destroys;
+		std::vector<RGBufferSet> deferred_buffer_destroys;
+
+		Bool HasAsyncCompute(Uint64 level) const
+		{
+			return sync_levels[level] != invalid_level;
+		}
+		Bool Empty() const
+		{
+			return std::all_of(sync_levels.begin(), sync_levels.end(), [](Uint64 sync_level) { return sync_level == invalid_level; });
+		}
+	};
+	using RGAsyncComputeSchedule = RenderGraphAsyncComputeSchedule;
+
+	RGAsyncComputeSchedule BuildAsyncComputeSchedule(std::span<RenderGraphCompiledLevel const> dependency_levels, std::span<RGScheduledPass const> passes);
+	std::string AsyncComputeScheduleToString(RGAsyncComputeSchedule const& schedule);
+}
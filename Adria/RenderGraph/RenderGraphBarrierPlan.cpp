@@ -0,0 +1,122 @@
+#include <format>
+#include "RenderGraphBarrierPlan.h"
+#include "RenderGraphCompileCache.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 invalid_level = Uint64(-1);
+
+		struct ResourceUse
+		{
+			Uint64 level = invalid_level;
+			GfxResourceState state = GfxResourceState::Common;
+		};
+
+		template<typename ResourceId>
+		void PlanLevelBarriers(
+			Uint64 level_index,
+			std::unordered_set<ResourceId> const& creates,
+			std::unordered_map<ResourceId, GfxResourceState> const& state_map,
+			std::vector<ResourceUse>& last_uses,
+			RGAsyncComputeSchedule const& async_compute_schedule,
+			std::vector<Uint64> const& command_list_breaks,
+			RGBarrierPlan& barrier_plan,
+			std::vector<RenderGraphPlannedBarrier<ResourceId>> RGLevelBarriers::* barriers,
+			std::vector<RenderGraphPlannedBarrier<ResourceId>> RGLevelBarriers::* split_barriers)
+		{
+			std::vector<RenderGraphPlannedBarrier<ResourceId>>& level_barriers = barrier_plan.levels[level_index].*barriers;
+			for (auto const& [id, state] : state_map)
+			{
+				ResourceUse& last_use = last_uses[id.id];
+				if (creates.contains(id))
+				{
+					level_barriers.push_back({ id, GfxResourceState::Common, state, RGBarrierType::Create });
+				}
+				else if (last_use.level == invalid_level)
+				{
+					level_barriers.push_back({ id, GfxResourceState::Common, state, RGBarrierType::Import });
+				}
+				else if (last_use.state != state)
+				{
+					Bool const can_split = last_use.level + 1 < level_index && command_list_breaks[level_index] == command_list_breaks[last_use.level]
+						&& !async_compute_schedule.HasAsyncCompute(last_use.level);
+					if (can_split)
+					{
+						(barrier_plan.levels[last_use.level].*split_barriers).push_back({ id, last_use.state, state, RGBarrierType::SplitBegin });
+						level_barriers.push_back({ id, last_use.state, state, RGBarrierType::SplitEnd });
+					}
+					else
+					{
+						level_barriers.push_back({ id, last_use.state, state, RGBarrierType::Transition });
+					}
+				}
+				last_use.level = level_index;
+				last_use.state = state;
+			}
+			std::sort(level_barriers.begin(), level_barriers.end(), [](auto const& a, auto const& b) { return a.id.id < b.id.id; });
+		}
+
+		template<typename ResourceId>
+		void AppendBarriers(std::string& plan_data, Char const* prefix, std::vector<RenderGraphPlannedBarrier<ResourceId>> const& barriers)
+		{
+			static constexpr Char const* barrier_type_names[] = { "Transition", "Create", "Import", "SplitBegin", "SplitEnd" };
+			for (auto const& barrier : barriers)
+			{
+				plan_data += std::format("{}{}: {} {} -> {}\n", prefix, barrier.id.id, barrier_type_names[(Uint64)barrier.type],
+					ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+		}
+	}
+
+	RGBarrierPlan BuildBarrierPlan(std::span<RGCompiledLevel const> dependency_levels, RGAsyncComputeSchedule const& async_compute_schedule, Uint64 texture_count, Uint64 buffer_count)
+	{
+		RGBarrierPlan barrier_plan{};
+		barrier_plan.levels.resize(dependency_levels.size());
+
+		//async compute switches to a new graphics command list while executing a level with async passes and before a sync level.
+		//command_list_breaks[i] counts the switches before the barriers of level i, split barriers must not cross them
+		std::vector<Bool> sync_levels(dependency_levels.size(), false);
+		for (Uint64 sync_level : async_compute_schedule.sync_levels)
+		{
+			if (sync_level < sync_levels.size()) sync_levels[sync_level] = true;
+		}
+		std::vector<Uint64> command_list_breaks(dependency_levels.size(), 0);
+		for (Uint64 i = 0; i + 1 < dependency_levels.size(); ++i)
+		{
+			command_list_breaks[i + 1] = command_list_breaks[i] + async_compute_schedule.HasAsyncCompute(i) + sync_levels[i + 1];
+		}
+
+		std::vector<ResourceUse> texture_last_uses(texture_count);
+		std::vector<ResourceUse> buffer_last_uses(buffer_count);
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			RGCompiledLevel const& dependency_level = dependency_levels[i];
+			PlanLevelBarriers(i, dependency_level.texture_creates, dependency_level.texture_state_map, texture_last_uses,
+				async_compute_schedule, command_list_breaks, barrier_plan, &RGLevelBarriers::texture_barriers, &RGLevelBarriers::texture_split_barriers);
+			PlanLevelBarriers(i, dependency_level.buffer_creates, dependency_level.buffer_state_map, buffer_last_uses,
+				async_compute_schedule, command_list_breaks, barrier_plan, &RGLevelBarriers::buffer_barriers, &RGLevelBarriers::buffer_split_barriers);
+		}
+		return barrier_plan;
+	}
+
+	std::string BarrierPlanToString(RGBarrierPlan const& barrier_plan)
+	{
+		std::string plan_data;
+		for (Uint64 i = 0; i < barrier_plan.levels.size(); ++i)
+		{
+			RGLevelBarriers const& level_barriers = barrier_plan.levels[i];
+			plan_data += std::format("Dependency level {}: \n", i);
+			AppendBarriers(plan_data, "Texture ", level_barriers.texture_barriers);
+			AppendBarriers(plan_data, "Buffer ", level_barriers.buffer_barriers);
+			if (!level_barriers.texture_split_barriers.empty() || !level_barriers.buffer_split_barriers.empty())
+			{
+				plan_data += "After the passes: \n";
+				AppendBarriers(plan_data, "Texture ", level_barriers.texture_split_barriers);
+				AppendBarriers(plan_data, "Buffer ", level_barriers.buffer_split_barriers);
+			}
+		}
+		return plan_data;
+	}
+}
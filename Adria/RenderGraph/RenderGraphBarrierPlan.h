@@ -0,0 +1,57 @@
+#pragma once
+#include <span>
+#include <string>
+#include "RenderGraphResourceId.h"
+#include "Graphics/GfxResourceCommon.h"
+
+namespace adria
+{
+	struct RenderGraphCompiledLevel;
+	struct RenderGraphAsyncComputeSchedule;
+
+	enum class RGBarrierType : Uint8
+	{
+		Transition,
+		Create,		//first use of a created resource, the state before depends on the allocated resource
+		Import,		//first use of an imported resource, the state before is the initial state of the imported resource
+		SplitBegin,
+		SplitEnd
+	};
+
+	template<typename ResourceId>
+	struct RenderGraphPlannedBarrier
+	{
+		ResourceId id;
+		GfxResourceState before;
+		GfxResourceState after;
+		RGBarrierType type;
+	};
+	using RGTextureBarrier = RenderGraphPlannedBarrier<RGTextureId>;
+	using RGBufferBarrier = RenderGraphPlannedBarrier<RGBufferId>;
+
+	struct RenderGraphLevelBarriers
+	{
+		//recorded before the passes of the level
+		std::vector<RGTextureBarrier> texture_barriers;
+		std::vector<RGBufferBarrier> buffer_barriers;
+		//recorded after the passes of the level, only split begin barriers
+		std::vector<RGTextureBarrier> texture_split_barriers;
+		std::vector<RGBufferBarrier> buffer_split_barriers;
+	};
+	using RGLevelBarriers = RenderGraphLevelBarriers;
+
+	//Transition table of a compiled graph, built by sweeping the dependency levels once while tracking the last state of every resource.
+	//When a resource is idle for at least one dependency level between two uses, the transition is split: it begins after the level
+	//of the previous use and ends before the level of the next one. Both halves have to be recorded on the same command list, so transitions
+	//are not split across levels where async compute switches command lists. Levels with async compute passes never begin split barriers
+	//since the compute queue may still be using their resources.
+	struct RenderGraphBarrierPlan
+	{
+		std::vector<RGLevelBarriers> levels;
+	};
+	using RGBarrierPlan = RenderGraphBarrierPlan;
+
+	RGBarrierPlan BuildBarrierPlan(std::span<RenderGraphCompiledLevel const> dependency_levels, RenderGraphAsyncComputeSchedule const& async_compute_schedule,
+		Uint64 texture_count, Uint64 buffer_count);
+	std::string BarrierPlanToString(RGBarrierPlan const& barrier_plan);
+}
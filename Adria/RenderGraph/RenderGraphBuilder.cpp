@@ -29,32 +29,32 @@ namespace adria
 
 	void RenderGraphBuilder::DeclareTexture(RGResourceName name, RGTextureDesc const& desc)
 	{
-		rg_pass.texture_creates.insert(rg.DeclareTexture(name, desc));
+		rg_pass.texture_creates.Insert(rg.DeclareTexture(name, desc));
 	}
 
 	void RenderGraphBuilder::DeclareBuffer(RGResourceName name, RGBufferDesc const& desc)
 	{
-		rg_pass.buffer_creates.insert(rg.DeclareBuffer(name, desc));
+		rg_pass.buffer_creates.Insert(rg.DeclareBuffer(name, desc));
 	}
 
 	void RenderGraphBuilder::DummyWriteTexture(RGResourceName name)
 	{
-		rg_pass.texture_writes.insert(rg.GetTextureId(name));
+		rg_pass.texture_writes.Insert(rg.GetTextureId(name));
 	}
 
 	void RenderGraphBuilder::DummyReadTexture(RGResourceName name)
 	{
-		rg_pass.texture_reads.insert(rg.GetTextureId(name));
+		rg_pass.texture_reads.Insert(rg.GetTextureId(name));
 	}
 
 	void RenderGraphBuilder::DummyReadBuffer(RGResourceName name)
 	{
-		rg_pass.buffer_reads.insert(rg.GetBufferId(name));
+		rg_pass.buffer_reads.Insert(rg.GetBufferId(name));
 	}
 
 	void RenderGraphBuilder::DummyWriteBuffer(RGResourceName name)
 	{
-		rg_pass.buffer_writes.insert(rg.GetBufferId(name));
+		rg_pass.buffer_writes.Insert(rg.GetBufferId(name));
 	}
 
 	RGTextureCopySrcId RenderGraphBuilder::ReadCopySrcTexture(RGResourceName name)
@@ -62,7 +62,7 @@ namespace adria
 		RGTextureCopySrcId copy_src_id = rg.ReadCopySrcTexture(name);
 		RGTextureId res_id(copy_src_id);
 		rg_pass.texture_state_map[res_id] = GfxResourceState::CopySrc;
-		rg_pass.texture_reads.insert(res_id);
+		rg_pass.texture_reads.Insert(res_id);
 		return copy_src_id;
 	}
 
@@ -71,11 +71,11 @@ namespace adria
 		RGTextureCopyDstId copy_dst_id = rg.WriteCopyDstTexture(name);
 		RGTextureId res_id(copy_dst_id);
 		rg_pass.texture_state_map[res_id] = GfxResourceState::CopyDst;
-		if (!rg_pass.texture_creates.contains(res_id))
+		if (!rg_pass.texture_creates.Contains(res_id))
 		{
 			DummyReadTexture(name);
 		}
-		rg_pass.texture_writes.insert(res_id);
+		rg_pass.texture_writes.Insert(res_id);
 		auto* texture = rg.GetRGTexture(res_id);
 		if (texture->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return copy_dst_id;
@@ -108,7 +108,7 @@ namespace adria
 			rg_pass.texture_state_map[res_id] = GfxResourceState::ComputeSRV;
 		}
 		
-		rg_pass.texture_reads.insert(res_id);
+		rg_pass.texture_reads.Insert(res_id);
 		return read_only_id;
 	}
 
@@ -118,11 +118,11 @@ namespace adria
 		RGTextureReadWriteId read_write_id = rg.WriteTexture(name, desc);
 		RGTextureId res_id = read_write_id.GetResourceId();
 		rg_pass.texture_state_map[res_id] = GfxResourceState::ComputeUAV;
-		if (!rg_pass.texture_creates.contains(res_id))
+		if (!rg_pass.texture_creates.Contains(res_id))
 		{
 			DummyReadTexture(name);
 		}
-		rg_pass.texture_writes.insert(res_id);
+		rg_pass.texture_writes.Insert(res_id);
 		auto* texture = rg.GetRGTexture(res_id);
 		if (texture->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return read_write_id;
@@ -135,11 +135,11 @@ namespace adria
 		RGTextureId res_id = render_target_id.GetResourceId();
 		rg_pass.texture_state_map[res_id] = GfxResourceState::RTV;
 		rg_pass.render_targets_info.push_back(RenderGraphPassBase::RenderTargetInfo{ .render_target_handle = render_target_id, .render_target_access = load_store_op });
-		if (!rg_pass.texture_creates.contains(res_id))
+		if (!rg_pass.texture_creates.Contains(res_id))
 		{
 			DummyReadTexture(name);
 		}
-		rg_pass.texture_writes.insert(res_id);
+		rg_pass.texture_writes.Insert(res_id);
 		auto* rg_texture = rg.GetRGTexture(res_id);
 		if (rg_texture->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return render_target_id;
@@ -152,11 +152,11 @@ namespace adria
 		RGTextureId res_id = depth_stencil_id.GetResourceId();
 		rg_pass.texture_state_map[res_id] = GfxResourceState::DSV;
 		rg_pass.depth_stencil = RenderGraphPassBase::DepthStencilInfo{ .depth_stencil_handle = depth_stencil_id, .depth_access = load_store_op,.stencil_access = stencil_load_store_op, .depth_read_only = false };
-		if (!rg_pass.texture_creates.contains(res_id))
+		if (!rg_pass.texture_creates.Contains(res_id))
 		{
 			DummyReadTexture(name);
 		}
-		rg_pass.texture_writes.insert(res_id);
+		rg_pass.texture_writes.Insert(res_id);
 		auto* rg_texture = rg.GetRGTexture(res_id);
 		if (rg_texture->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return depth_stencil_id;
@@ -170,7 +170,7 @@ namespace adria
 
 		rg_pass.depth_stencil = RenderGraphPassBase::DepthStencilInfo{ .depth_stencil_handle = depth_stencil_id, .depth_access = load_store_op,.stencil_access = stencil_load_store_op, .depth_read_only = true };
 		auto* rg_texture = rg.GetRGTexture(res_id);
-		rg_pass.texture_reads.insert(res_id);
+		rg_pass.texture_reads.Insert(res_id);
 
 		if (rg_texture->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		rg_pass.texture_state_map[res_id] = GfxResourceState::DSV_ReadOnly;
@@ -182,7 +182,7 @@ namespace adria
 		RGBufferCopySrcId copy_src_id = rg.ReadCopySrcBuffer(name);
 		RGBufferId res_id(copy_src_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::CopySrc;
-		rg_pass.buffer_reads.insert(res_id);
+		rg_pass.buffer_reads.Insert(res_id);
 		return copy_src_id;
 	}
 
@@ -191,11 +191,11 @@ namespace adria
 		RGBufferCopyDstId copy_dst_id = rg.WriteCopyDstBuffer(name);
 		RGBufferId res_id(copy_dst_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::CopyDst;
-		if (!rg_pass.buffer_creates.contains(res_id))
+		if (!rg_pass.buffer_creates.Contains(res_id))
 		{
 			DummyReadBuffer(name);
 		}
-		rg_pass.buffer_writes.insert(res_id);
+		rg_pass.buffer_writes.Insert(res_id);
 		auto* buffer = rg.GetRGBuffer(res_id);
 		if (buffer->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return copy_dst_id;
@@ -206,7 +206,7 @@ namespace adria
 		RGBufferIndirectArgsId indirect_args_id = rg.ReadIndirectArgsBuffer(name);
 		RGBufferId res_id(indirect_args_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::IndirectArgs;
-		rg_pass.buffer_reads.insert(res_id);
+		rg_pass.buffer_reads.Insert(res_id);
 		return indirect_args_id;
 	}
 
@@ -215,7 +215,7 @@ namespace adria
 		RGBufferIndexId index_buf_id = rg.ReadVertexBuffer(name);
 		RGBufferId res_id(index_buf_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::IndexBuffer;
-		rg_pass.buffer_reads.insert(res_id);
+		rg_pass.buffer_reads.Insert(res_id);
 		return index_buf_id;
 	}
 
@@ -247,7 +247,7 @@ namespace adria
 		{
 			rg_pass.buffer_state_map[res_id] = GfxResourceState::ComputeSRV;
 		}
-		rg_pass.buffer_reads.insert(res_id);
+		rg_pass.buffer_reads.Insert(res_id);
 		return read_only_id;
 	}
 
@@ -257,11 +257,11 @@ namespace adria
 		RGBufferReadWriteId read_write_id = rg.WriteBuffer(name, desc);
 		RGBufferId res_id = read_write_id.GetResourceId();
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::ComputeUAV;
-		if (!rg_pass.buffer_creates.contains(res_id))
+		if (!rg_pass.buffer_creates.Contains(res_id))
 		{
 			DummyReadBuffer(name);
 		}
-		rg_pass.buffer_writes.insert(res_id);
+		rg_pass.buffer_writes.Insert(res_id);
 		auto* buffer = rg.GetRGBuffer(res_id);
 		if (buffer->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return read_write_id;
@@ -278,12 +278,12 @@ namespace adria
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::ComputeUAV;
 		rg_pass.buffer_state_map[counter_id] = GfxResourceState::ComputeUAV;
 		DummyWriteBuffer(counter_name);
-		if (!rg_pass.buffer_creates.contains(res_id))
+		if (!rg_pass.buffer_creates.Contains(res_id))
 		{
 			DummyReadBuffer(name);
 			DummyReadBuffer(counter_name);
 		}
-		rg_pass.buffer_writes.insert(res_id);
+		rg_pass.buffer_writes.Insert(res_id);
 		auto* buffer = rg.GetRGBuffer(res_id);
 		if (buffer->imported) rg_pass.flags |= RGPassFlags::ForceNoCull;
 		return read_write_id;
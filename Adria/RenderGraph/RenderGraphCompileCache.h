@@ -0,0 +1,141 @@
+#pragma once
+#include <unordered_map>
+#include "RenderGraphResourceId.h"
+#include "Graphics/GfxTexture.h"
+#include "Graphics/GfxBuffer.h"
+#include "RenderGraphAsyncCompute.h"
+#include "RenderGraphTransientAliasing.h"
+#include "RenderGraphBarrierPlan.h"
+
+namespace adria
+{
+	struct RenderGraphCompiledLevel
+	{
+		std::vector<Uint64> passes;
+		std::unordered_set<RGTextureId> texture_creates;
+		std::unordered_set<RGTextureId> texture_destroys;
+		std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
+		std::unordered_set<RGBufferId> buffer_creates;
+		std::unordered_set<RGBufferId> buffer_destroys;
+		std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
+	};
+	using RGCompiledLevel = RenderGraphCompiledLevel;
+
+	//Everything a compiled graph depends on. It is compared on every cache hit, the structural hash alone only picks the candidate
+	struct RenderGraphPassSignature
+	{
+		std::string name;
+		Uint64 type = 0;
+		Uint64 flags = 0;
+		std::vector<Uint64> texture_creates;
+		std::vector<Uint64> texture_reads;
+		std::vector<Uint64> texture_writes;
+		std::vector<std::pair<Uint64, GfxResourceState>> texture_states;
+		std::vector<Uint64> buffer_creates;
+		std::vector<Uint64> buffer_reads;
+		std::vector<Uint64> buffer_writes;
+		std::vector<std::pair<Uint64, GfxResourceState>> buffer_states;
+
+		Bool operator==(RenderGraphPassSignature const&) const = default;
+	};
+
+	template<typename ResourceDesc>
+	struct RenderGraphResourceSignature
+	{
+		Uint64 name = 0;
+		Bool imported = false;
+		ResourceDesc desc{};
+
+		Bool operator==(RenderGraphResourceSignature const&) const = default;
+	};
+
+	struct RenderGraphSignature
+	{
+		std::vector<RenderGraphPassSignature> passes;
+		std::vector<RenderGraphResourceSignature<GfxTextureDesc>> textures;
+		std::vector<RenderGraphResourceSignature<GfxBufferDesc>> buffers;
+
+		Bool operator==(RenderGraphSignature const&) const = default;
+	};
+	using RGSignature = RenderGraphSignature;
+
+	struct RenderGraphCompiledGraph
+	{
+		inline static constexpr Uint64 invalid_pass = Uint64(-1);
+
+		RGSignature signature;
+
+		std::vector<std::vector<Uint64>> adjacency_lists;
+		std::vector<Uint64> topologically_sorted_passes;
+		std::vector<RenderGraphCompiledLevel> dependency_levels;
+		RGAsyncComputeSchedule async_compute_schedule;
+		//placed by the first execution, the descs it depends on are part of the signature
+		std::optional<RGTransientLayout> transient_layout;
+		RGBarrierPlan barrier_plan;
+
+		std::vector<Uint64> pass_ref_counts;
+		std::vector<Uint64> texture_ref_counts;
+		std::vector<Uint64> buffer_ref_counts;
+		std::vector<Uint64> texture_last_users;
+		std::vector<Uint64> buffer_last_users;
+
+		Uint64 last_used_frame = 0;
+	};
+	using RGCompiledGraph = RenderGraphCompiledGraph;
+
+	//Keeps compiled render graphs keyed by the structural hash of their passes, so that frames which declare the same passes
+	//with the same resources, reads and writes can skip adjacency building, sorting, culling and lifetime calculation
+	class RenderGraphCompileCache
+	{
+		static constexpr Uint64 MAX_UNUSED_FRAMES = 120;
+
+	public:
+		RenderGraphCompileCache() = default;
+		ADRIA_NONCOPYABLE(RenderGraphCompileCache)
+
+		void Tick()
+		{
+			for (auto it = compiled_graphs.begin(); it != compiled_graphs.end();)
+			{
+				if (it->second.last_used_frame + MAX_UNUSED_FRAMES < frame_index) it = compiled_graphs.erase(it);
+				else ++it;
+			}
+			++frame_index;
+		}
+
+		//Signature storage reused by every frame, so computing the signature of an unchanged graph does not allocate
+		RGSignature& GetSignatureScratch() { return signature_scratch; }
+
+		RGCompiledGraph* Find(Uint64 hash, RGSignature const& signature)
+		{
+			auto it = compiled_graphs.find(hash);
+			if (it == compiled_graphs.end()) return nullptr;
+
+			RGCompiledGraph& compiled_graph = it->second;
+			if (compiled_graph.signature != signature) return nullptr;
+			compiled_graph.last_used_frame = frame_index;
+			return &compiled_graph;
+		}
+
+		RGCompiledGraph* Insert(Uint64 hash, RGCompiledGraph&& compiled_graph)
+		{
+			compiled_graph.last_used_frame = frame_index;
+			RGCompiledGraph& inserted_graph = compiled_graphs[hash];
+			inserted_graph = std::move(compiled_graph);
+			return &inserted_graph;
+		}
+
+		void Clear()
+		{
+			compiled_graphs.clear();
+		}
+
+		Uint64 Size() const { return compiled_graphs.size(); }
+
+	private:
+		std::unordered_map<Uint64, RGCompiledGraph> compiled_graphs;
+		RGSignature signature_scratch;
+		Uint64 frame_index = 0;
+	};
+	using RGCompileCache = RenderGraphCompileCache;
+}
\ No newline at end of file
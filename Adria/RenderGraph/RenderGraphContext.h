@@ -3,6 +3,7 @@
 #include "Graphics/GfxTexture.h"
 #include "Graphics/GfxCommandList.h"
 #include "RenderGraphResourceId.h"
+#include "RenderGraphResourcePool.h"
 #include "RenderGraphBlackboard.h"
 #if RG_DEBUG
 #include "Utilities/StringUtil.h"
@@ -46,6 +47,7 @@ namespace adria
 		RenderGraphPassBase* writer = nullptr;
 		RenderGraphPassBase* last_used_by = nullptr;
 		Char const* name = "";
+		RGPoolHandle pool_handle;
 	};
 	using RGResource = RenderGraphResource;
 
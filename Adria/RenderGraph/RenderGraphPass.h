@@ -78,6 +78,7 @@ namespace adria
 	{
 		friend RenderGraph;
 		friend RenderGraphBuilder;
+		friend class RenderGraphValidation;
 
 		struct RenderTargetInfo
 		{
@@ -115,16 +116,16 @@ namespace adria
 		RGPassFlags flags = RGPassFlags::None;
 		Uint64 id;
 
-		std::unordered_set<RGTextureId> texture_creates;
-		std::unordered_set<RGTextureId> texture_reads;
-		std::unordered_set<RGTextureId> texture_writes;
-		std::unordered_set<RGTextureId> texture_destroys;
+		RGTextureSet texture_creates;
+		RGTextureSet texture_reads;
+		RGTextureSet texture_writes;
+		RGTextureSet texture_destroys;
 		std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
 		
-		std::unordered_set<RGBufferId> buffer_creates;
-		std::unordered_set<RGBufferId> buffer_reads;
-		std::unordered_set<RGBufferId> buffer_writes;
-		std::unordered_set<RGBufferId> buffer_destroys;
+		RGBufferSet buffer_creates;
+		RGBufferSet buffer_reads;
+		RGBufferSet buffer_writes;
+		RGBufferSet buffer_destroys;
 		std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
 
 		std::vector<RenderTargetInfo> render_targets_info;
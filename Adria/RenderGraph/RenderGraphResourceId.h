@@ -1,5 +1,6 @@
 #pragma once
 #include <compare>
+#include <algorithm>
 
 namespace adria
 {
@@ -46,6 +47,39 @@ namespace adria
 	using RGBufferId = TypedRenderGraphResourceId<RGResourceType::Buffer>;
 	using RGTextureId = TypedRenderGraphResourceId<RGResourceType::Texture>;
 
+	//Passes touch only a handful of resources, a sorted vector beats hashing for both lookups and iteration
+	template<typename ResourceId>
+	class RenderGraphResourceSet
+	{
+	public:
+		using const_iterator = typename std::vector<ResourceId>::const_iterator;
+
+		Bool Insert(ResourceId const& id)
+		{
+			auto it = std::lower_bound(ids.begin(), ids.end(), id);
+			if (it != ids.end() && *it == id) return false;
+			ids.insert(it, id);
+			return true;
+		}
+
+		Bool Contains(ResourceId const& id) const
+		{
+			return std::binary_search(ids.begin(), ids.end(), id);
+		}
+
+		Uint64 Size() const { return ids.size(); }
+		Bool Empty() const { return ids.empty(); }
+		void Clear() { ids.clear(); }
+
+		const_iterator begin() const { return ids.begin(); }
+		const_iterator end() const { return ids.end(); }
+
+	private:
+		std::vector<ResourceId> ids;
+	};
+	using RGTextureSet = RenderGraphResourceSet<RGTextureId>;
+	using RGBufferSet = RenderGraphResourceSet<RGBufferId>;
+
 	template<RGResourceMode Mode>
 	struct RenderGraphTextureModeId : RGTextureId
 	{
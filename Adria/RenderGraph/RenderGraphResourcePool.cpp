@@ -0,0 +1,418 @@
+#include <filesystem>
+#include "RenderGraphResourcePool.h"
+#include "Core/Paths.h"
+#include "Core/ConsoleManager.h"
+#include "Logging/Logger.h"
+#include "Utilities/HashUtil.h"
+
+namespace adria
+{
+	static TAutoConsoleVariable<int> PoolMaxIdleFrames("r.RenderGraph.PoolMaxIdleFrames", 4, "Number of frames an unused pooled render graph resource is kept alive");
+	static TAutoConsoleVariable<int> PoolBudget("r.RenderGraph.PoolBudget", 0, "Memory budget of the render graph resource pool in MB, idle resources are evicted oldest first when it is exceeded. 0 - no budget");
+	static TAutoConsoleVariable<int> PoolTraceFrames("r.RenderGraph.PoolTraceFrames", 0, "Captures the render graph resource pool calls of the given number of frames into a trace that -rgpooltrace replays");
+
+	namespace
+	{
+		//IsCompatible allows pooled textures with a superset of bind and misc flags, those stay out of the bucket hash
+		Uint64 HashPoolBucket(GfxTextureDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine((Uint64)desc.type);
+			hash.Combine(desc.width);
+			hash.Combine(desc.height);
+			hash.Combine(desc.array_size);
+			hash.Combine(desc.sample_count);
+			hash.Combine((Uint64)desc.heap_type);
+			hash.Combine((Uint64)desc.format);
+			return hash;
+		}
+		Uint64 HashPoolBucket(GfxBufferDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine(desc.size);
+			hash.Combine((Uint64)desc.resource_usage);
+			hash.Combine((Uint64)desc.bind_flags);
+			hash.Combine((Uint64)desc.misc_flags);
+			hash.Combine(desc.stride);
+			hash.Combine((Uint64)desc.format);
+			return hash;
+		}
+		Uint64 HashPlacedBucket(Uint64 desc_hash, GfxHeapType heap_type, Uint64 heap_offset)
+		{
+			HashState hash{};
+			hash.Combine(desc_hash);
+			hash.Combine((Uint64)heap_type);
+			hash.Combine(heap_offset);
+			return hash;
+		}
+
+		template<typename SlotT>
+		Uint32 AcquireSlot(std::vector<SlotT>& slots, std::vector<Uint32>& free_slots)
+		{
+			if (!free_slots.empty())
+			{
+				Uint32 const slot = free_slots.back();
+				free_slots.pop_back();
+				return slot;
+			}
+			slots.emplace_back();
+			return (Uint32)slots.size() - 1;
+		}
+
+		void RemoveFromBucket(std::unordered_map<Uint64, std::vector<Uint32>>& buckets, Uint64 bucket, Uint32 slot)
+		{
+			auto it = buckets.find(bucket);
+			if (it == buckets.end()) return;
+			std::vector<Uint32>& bucket_slots = it->second;
+			auto slot_it = std::find(bucket_slots.begin(), bucket_slots.end(), slot);
+			if (slot_it == bucket_slots.end()) return;
+			*slot_it = bucket_slots.back();
+			bucket_slots.pop_back();
+			if (bucket_slots.empty()) buckets.erase(it);
+		}
+
+		template<typename CachedInfo, typename ResourceDesc, typename QueryFunc>
+		GfxAllocationInfo FindOrQueryAllocationInfo(std::vector<CachedInfo>& bucket, ResourceDesc const& desc, Uint64 frame_index, QueryFunc&& query)
+		{
+			for (auto& cached : bucket)
+			{
+				if (cached.desc != desc) continue;
+				cached.last_used_frame = frame_index;
+				return cached.allocation_info;
+			}
+			bucket.push_back(CachedInfo{ desc, query(), frame_index });
+			return bucket.back().allocation_info;
+		}
+
+		std::string GetPoolTracePath()
+		{
+			return paths::RenderGraphDir + "resource_pool_trace.bin";
+		}
+
+		template<typename CachedInfoMap>
+		void EvictAllocationInfos(CachedInfoMap& allocation_infos, Uint64 max_idle_frames, Uint64 frame_index)
+		{
+			for (auto it = allocation_infos.begin(); it != allocation_infos.end();)
+			{
+				std::erase_if(it->second, [&](auto const& cached) { return cached.last_used_frame + max_idle_frames < frame_index; });
+				if (it->second.empty()) it = allocation_infos.erase(it);
+				else ++it;
+			}
+		}
+	}
+
+	Bool SaveRenderGraphPoolTrace(std::string const& trace_path, std::vector<RGPoolTraceEvent> const& trace)
+	{
+		std::ofstream os(trace_path, std::ios::binary);
+		if (!os) return false;
+		cereal::BinaryOutputArchive archive(os);
+		archive((Uint64)trace.size());
+		archive(cereal::binary_data(trace.data(), trace.size() * sizeof(RGPoolTraceEvent)));
+		return os.good();
+	}
+
+	Bool LoadRenderGraphPoolTrace(std::string const& trace_path, std::vector<RGPoolTraceEvent>& trace)
+	{
+		std::ifstream is(trace_path, std::ios::binary);
+		if (!is) return false;
+		try
+		{
+			cereal::BinaryInputArchive archive(is);
+			Uint64 event_count = 0;
+			archive(event_count);
+			trace.resize(event_count);
+			archive(cereal::binary_data(trace.data(), trace.size() * sizeof(RGPoolTraceEvent)));
+		}
+		catch (cereal::Exception const&)
+		{
+			trace.clear();
+			return false;
+		}
+		return true;
+	}
+
+	RenderGraphResourcePool::RenderGraphResourcePool(GfxDevice* device) : device(device)
+	{
+		if (device)
+		{
+			PoolTraceFrames->AddOnChanged(ConsoleVariableDelegate::CreateLambda([this](IConsoleVariable* cvar) { BeginTraceCapture((Uint64)std::max(cvar->GetInt(), 0)); }));
+		}
+	}
+
+	void RenderGraphResourcePool::Tick()
+	{
+		RecordTraceEvent(RGPoolTraceEventType::Tick, RGPoolHandle::invalid_slot);
+		if (trace_frames_left > 0 && --trace_frames_left == 0)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(paths::RenderGraphDir, error);
+			if (SaveRenderGraphPoolTrace(GetPoolTracePath(), trace)) ADRIA_LOG(INFO, "Render graph resource pool trace with %llu events saved to %s", trace.size(), GetPoolTracePath().c_str());
+			else ADRIA_LOG(WARNING, "Failed to save render graph resource pool trace to %s", GetPoolTracePath().c_str());
+			trace.clear();
+		}
+		//every transient resource is released by the end of the frame, so a capture started here never sees a release without its allocation
+		if (trace_frames_requested > 0)
+		{
+			trace.clear();
+			trace_frames_left = std::exchange(trace_frames_requested, 0);
+		}
+
+		Uint64 const max_idle_frames = (Uint64)std::max(PoolMaxIdleFrames.Get(), 0);
+		Uint64 const budget = (Uint64)std::max(PoolBudget.Get(), 0) * 1024 * 1024;
+
+		struct IdleResource
+		{
+			Uint64 last_used_frame;
+			Uint32 slot;
+			Bool texture;
+		};
+		std::vector<IdleResource> idle_resources;
+		for (auto const& [bucket, slots] : idle_textures)
+		{
+			for (Uint32 slot : slots) idle_resources.push_back(IdleResource{ texture_slots[slot].last_used_frame, slot, true });
+		}
+		for (auto const& [bucket, slots] : idle_buffers)
+		{
+			for (Uint32 slot : slots) idle_resources.push_back(IdleResource{ buffer_slots[slot].last_used_frame, slot, false });
+		}
+		std::sort(idle_resources.begin(), idle_resources.end(), [](IdleResource const& a, IdleResource const& b) { return a.last_used_frame < b.last_used_frame; });
+
+		for (IdleResource const& idle_resource : idle_resources)
+		{
+			Bool const too_old = idle_resource.last_used_frame + max_idle_frames < frame_index;
+			Bool const over_budget = budget > 0 && pooled_memory > budget;
+			if (!too_old && !over_budget) break;
+
+			if (idle_resource.texture) EvictTexture(idle_resource.slot);
+			else EvictBuffer(idle_resource.slot);
+		}
+
+		for (auto it = placed_textures.begin(); it != placed_textures.end();)
+		{
+			std::erase_if(it->second, [&](PlacedTexture const& placed) { return placed.last_used_frame + max_idle_frames < frame_index; });
+			if (it->second.empty()) it = placed_textures.erase(it);
+			else ++it;
+		}
+		for (auto it = placed_buffers.begin(); it != placed_buffers.end();)
+		{
+			std::erase_if(it->second, [&](PlacedBuffer const& placed) { return placed.last_used_frame + max_idle_frames < frame_index; });
+			if (it->second.empty()) it = placed_buffers.erase(it);
+			else ++it;
+		}
+		EvictAllocationInfos(texture_allocation_infos, max_idle_frames, frame_index);
+		EvictAllocationInfos(buffer_allocation_infos, max_idle_frames, frame_index);
+		++frame_index;
+	}
+
+	GfxTexture* RenderGraphResourcePool::AllocateTexture(GfxTextureDesc const& desc, RGPoolHandle& handle)
+	{
+		Uint64 const bucket = HashPoolBucket(desc);
+		if (auto it = idle_textures.find(bucket); it != idle_textures.end())
+		{
+			std::vector<Uint32>& bucket_slots = it->second;
+			for (Uint64 i = 0; i < bucket_slots.size(); ++i)
+			{
+				PooledTexture& pooled_texture = texture_slots[bucket_slots[i]];
+				if (!pooled_texture.desc.IsCompatible(desc)) continue;
+
+				handle.slot = bucket_slots[i];
+				bucket_slots[i] = bucket_slots.back();
+				bucket_slots.pop_back();
+				if (bucket_slots.empty()) idle_textures.erase(it);
+
+				pooled_texture.last_used_frame = frame_index;
+				pooled_texture.active = true;
+				RecordTraceEvent(RGPoolTraceEventType::AllocateTexture, handle.slot, pooled_texture.size, desc);
+				return pooled_texture.texture.get();
+			}
+		}
+
+		handle.slot = AcquireSlot(texture_slots, free_texture_slots);
+		PooledTexture& pooled_texture = texture_slots[handle.slot];
+		pooled_texture.texture = device ? std::make_unique<GfxTexture>(device, desc) : nullptr;
+		pooled_texture.desc = desc;
+		pooled_texture.bucket = bucket;
+		pooled_texture.size = GetAllocationInfo(desc).size;
+		pooled_texture.last_used_frame = frame_index;
+		pooled_texture.active = true;
+		pooled_memory += pooled_texture.size;
+		RecordTraceEvent(RGPoolTraceEventType::AllocateTexture, handle.slot, pooled_texture.size, desc);
+		return pooled_texture.texture.get();
+	}
+
+	void RenderGraphResourcePool::ReleaseTexture(RGPoolHandle handle)
+	{
+		ADRIA_ASSERT(handle.IsValid() && handle.slot < texture_slots.size());
+		PooledTexture& pooled_texture = texture_slots[handle.slot];
+		ADRIA_ASSERT(pooled_texture.active);
+		pooled_texture.active = false;
+		pooled_texture.last_used_frame = frame_index;
+		idle_textures[pooled_texture.bucket].push_back(handle.slot);
+		RecordTraceEvent(RGPoolTraceEventType::ReleaseTexture, handle.slot);
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AllocateBuffer(GfxBufferDesc const& desc, RGPoolHandle& handle)
+	{
+		Uint64 const bucket = HashPoolBucket(desc);
+		if (auto it = idle_buffers.find(bucket); it != idle_buffers.end())
+		{
+			std::vector<Uint32>& bucket_slots = it->second;
+			for (Uint64 i = 0; i < bucket_slots.size(); ++i)
+			{
+				PooledBuffer& pooled_buffer = buffer_slots[bucket_slots[i]];
+				if (pooled_buffer.desc != desc) continue;
+
+				handle.slot = bucket_slots[i];
+				bucket_slots[i] = bucket_slots.back();
+				bucket_slots.pop_back();
+				if (bucket_slots.empty()) idle_buffers.erase(it);
+
+				pooled_buffer.last_used_frame = frame_index;
+				pooled_buffer.active = true;
+				RecordTraceEvent(RGPoolTraceEventType::AllocateBuffer, handle.slot, pooled_buffer.size, {}, desc);
+				return pooled_buffer.buffer.get();
+			}
+		}
+
+		handle.slot = AcquireSlot(buffer_slots, free_buffer_slots);
+		PooledBuffer& pooled_buffer = buffer_slots[handle.slot];
+		pooled_buffer.buffer = device ? std::make_unique<GfxBuffer>(device, desc) : nullptr;
+		pooled_buffer.desc = desc;
+		pooled_buffer.bucket = bucket;
+		pooled_buffer.size = desc.size;
+		pooled_buffer.last_used_frame = frame_index;
+		pooled_buffer.active = true;
+		pooled_memory += pooled_buffer.size;
+		RecordTraceEvent(RGPoolTraceEventType::AllocateBuffer, handle.slot, pooled_buffer.size, {}, desc);
+		return pooled_buffer.buffer.get();
+	}
+
+	void RenderGraphResourcePool::ReleaseBuffer(RGPoolHandle handle)
+	{
+		ADRIA_ASSERT(handle.IsValid() && handle.slot < buffer_slots.size());
+		PooledBuffer& pooled_buffer = buffer_slots[handle.slot];
+		ADRIA_ASSERT(pooled_buffer.active);
+		pooled_buffer.active = false;
+		pooled_buffer.last_used_frame = frame_index;
+		idle_buffers[pooled_buffer.bucket].push_back(handle.slot);
+		RecordTraceEvent(RGPoolTraceEventType::ReleaseBuffer, handle.slot);
+	}
+
+	void RenderGraphResourcePool::ReserveTransientHeaps(std::array<Uint64, HEAP_TYPE_COUNT> const& heap_sizes)
+	{
+		for (Uint64 i = 0; i < HEAP_TYPE_COUNT; ++i)
+		{
+			if (heap_sizes[i] == 0) continue;
+			if (transient_heaps[i] && transient_heaps[i]->GetDesc().size >= heap_sizes[i]) continue;
+
+			//the placed resources go to the release queue before the old heap does, which also defers freeing its memory,
+			//so both outlive the frames in flight and the resources are released first
+			GfxHeapType const heap_type = (GfxHeapType)i;
+			if (heap_type == GfxHeapType::Buffers)
+			{
+				placed_buffers.clear();
+			}
+			else
+			{
+				for (auto& [bucket, textures] : placed_textures)
+				{
+					std::erase_if(textures, [heap_type](PlacedTexture const& placed) { return placed.heap_type == heap_type; });
+				}
+			}
+
+			GfxHeapDesc heap_desc{};
+			heap_desc.type = heap_type;
+			heap_desc.size = heap_sizes[i];
+			transient_heaps[i] = std::make_unique<GfxHeap>(device, heap_desc);
+		}
+	}
+
+	Uint64 RenderGraphResourcePool::GetTransientHeapSize(GfxHeapType heap_type) const
+	{
+		auto const& heap = transient_heaps[(Uint64)heap_type];
+		return heap ? heap->GetDesc().size : 0;
+	}
+
+	GfxTexture* RenderGraphResourcePool::AllocateAliasedTexture(GfxTextureDesc const& desc, GfxHeapType heap_type, Uint64 heap_offset)
+	{
+		std::vector<PlacedTexture>& bucket = placed_textures[HashPlacedBucket(HashPoolBucket(desc), heap_type, heap_offset)];
+		for (PlacedTexture& placed : bucket)
+		{
+			if (placed.heap_type == heap_type && placed.heap_offset == heap_offset && placed.desc == desc)
+			{
+				placed.last_used_frame = frame_index;
+				return placed.texture.get();
+			}
+		}
+		GfxHeap const& heap = *transient_heaps[(Uint64)heap_type];
+		auto& texture = bucket.emplace_back(PlacedTexture{ std::make_unique<GfxTexture>(device, desc, heap, heap_offset), desc, heap_type, heap_offset, frame_index }).texture;
+		return texture.get();
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AllocateAliasedBuffer(GfxBufferDesc const& desc, Uint64 heap_offset)
+	{
+		std::vector<PlacedBuffer>& bucket = placed_buffers[HashPlacedBucket(HashPoolBucket(desc), GfxHeapType::Buffers, heap_offset)];
+		for (PlacedBuffer& placed : bucket)
+		{
+			if (placed.heap_offset == heap_offset && placed.desc == desc)
+			{
+				placed.last_used_frame = frame_index;
+				return placed.buffer.get();
+			}
+		}
+		GfxHeap const& heap = *transient_heaps[(Uint64)GfxHeapType::Buffers];
+		auto& buffer = bucket.emplace_back(PlacedBuffer{ std::make_unique<GfxBuffer>(device, desc, heap, heap_offset), desc, heap_offset, frame_index }).buffer;
+		return buffer.get();
+	}
+
+	GfxAllocationInfo RenderGraphResourcePool::GetAllocationInfo(GfxTextureDesc const& desc)
+	{
+		return FindOrQueryAllocationInfo(texture_allocation_infos[HashPoolBucket(desc)], desc, frame_index, [&]() { return GfxTexture::GetAllocationInfo(device, desc); });
+	}
+
+	GfxAllocationInfo RenderGraphResourcePool::GetAllocationInfo(GfxBufferDesc const& desc)
+	{
+		return FindOrQueryAllocationInfo(buffer_allocation_infos[HashPoolBucket(desc)], desc, frame_index, [&]() { return GfxBuffer::GetAllocationInfo(device, desc); });
+	}
+
+	void RenderGraphResourcePool::EvictTexture(Uint32 slot)
+	{
+		PooledTexture& pooled_texture = texture_slots[slot];
+		ADRIA_ASSERT(!pooled_texture.active);
+		RemoveFromBucket(idle_textures, pooled_texture.bucket, slot);
+		pooled_memory -= pooled_texture.size;
+		pooled_texture.texture.reset();
+		free_texture_slots.push_back(slot);
+	}
+
+	void RenderGraphResourcePool::EvictBuffer(Uint32 slot)
+	{
+		PooledBuffer& pooled_buffer = buffer_slots[slot];
+		ADRIA_ASSERT(!pooled_buffer.active);
+		RemoveFromBucket(idle_buffers, pooled_buffer.bucket, slot);
+		pooled_memory -= pooled_buffer.size;
+		pooled_buffer.buffer.reset();
+		free_buffer_slots.push_back(slot);
+	}
+
+	void RenderGraphResourcePool::BeginTraceCapture(Uint64 frame_count)
+	{
+		trace_frames_requested = frame_count;
+	}
+
+	void RenderGraphResourcePool::RecordTraceEvent(RGPoolTraceEventType type, Uint32 slot, Uint64 size, GfxTextureDesc const& texture_desc, GfxBufferDesc const& buffer_desc)
+	{
+		if (trace_frames_left == 0) return;
+		trace.push_back(RGPoolTraceEvent{ type, slot, size, texture_desc, buffer_desc });
+	}
+
+	void RenderGraphResourcePool::SeedAllocationInfo(GfxTextureDesc const& desc, Uint64 size)
+	{
+		FindOrQueryAllocationInfo(texture_allocation_infos[HashPoolBucket(desc)], desc, frame_index, [size]() { return GfxAllocationInfo{ .size = size }; });
+	}
+
+	void RenderGraphResourcePool::SeedAllocationInfo(GfxBufferDesc const& desc, Uint64 size)
+	{
+		FindOrQueryAllocationInfo(buffer_allocation_infos[HashPoolBucket(desc)], desc, frame_index, [size]() { return GfxAllocationInfo{ .size = size }; });
+	}
+}
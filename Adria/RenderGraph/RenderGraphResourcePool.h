@@ -1,102 +1,159 @@
 #pragma once
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxTexture.h"
+#include "Graphics/GfxHeap.h"
 
 namespace adria
 {
+	struct RenderGraphPoolHandle
+	{
+		static constexpr Uint32 invalid_slot = Uint32(-1);
+		Uint32 slot = invalid_slot;
+		Bool IsValid() const { return slot != invalid_slot; }
+	};
+	using RGPoolHandle = RenderGraphPoolHandle;
+
+	enum class RenderGraphPoolTraceEventType : Uint8
+	{
+		AllocateTexture,
+		ReleaseTexture,
+		AllocateBuffer,
+		ReleaseBuffer,
+		Tick
+	};
+
+	//One pool call, slot is the handle slot handed out or released and size is the allocation size of newly requested resources
+	struct RenderGraphPoolTraceEvent
+	{
+		RenderGraphPoolTraceEventType type;
+		Uint32 slot;
+		Uint64 size;
+		GfxTextureDesc texture_desc;
+		GfxBufferDesc buffer_desc;
+	};
+	using RGPoolTraceEvent = RenderGraphPoolTraceEvent;
+
+	Bool SaveRenderGraphPoolTrace(std::string const& trace_path, std::vector<RGPoolTraceEvent> const& trace);
+	Bool LoadRenderGraphPoolTrace(std::string const& trace_path, std::vector<RGPoolTraceEvent>& trace);
+
+	//Pooled resources are bucketed by a hash of their desc. Each bucket keeps a free list of slots that are not in use this frame,
+	//so allocation only looks at compatible candidates and release through the handle is O(1).
+	//Idle resources are evicted once they exceed the frame age limit or, oldest first, while the pool is over its memory budget.
+	//A pool without a device only does the bookkeeping, the trace replay uses it to check the pool headless.
 	class RenderGraphResourcePool
 	{
+		friend class RenderGraphValidation;
+
 		struct PooledTexture
 		{
 			std::unique_ptr<GfxTexture> texture;
+			GfxTextureDesc desc;
+			Uint64 bucket;
+			Uint64 size;
 			Uint64 last_used_frame;
+			Bool active;
 		};
 
 		struct PooledBuffer
 		{
 			std::unique_ptr<GfxBuffer> buffer;
+			GfxBufferDesc desc;
+			Uint64 bucket;
+			Uint64 size;
 			Uint64 last_used_frame;
+			Bool active;
 		};
 
-	public:
-		explicit RenderGraphResourcePool(GfxDevice* device) : device(device) {}
-
-		void Tick()
-		{
-			for (Uint64 i = 0; i < texture_pool.size();)
-			{
-				PooledTexture& resource = texture_pool[i].first;
-				Bool active = texture_pool[i].second;
-				if (!active && resource.last_used_frame + 4 < frame_index)
-				{
-					std::swap(texture_pool[i], texture_pool.back());
-					texture_pool.pop_back();
-				}
-				else ++i;
-			}
-			++frame_index;
-		}
-
-		GfxTexture* AllocateTexture(GfxTextureDesc const& desc)
+		//placed resources are only reused for the exact desc at the exact heap offset they were created for
+		struct PlacedTexture
 		{
-			for (auto& [pool_texture, active] : texture_pool)
-			{
-				if (!active && pool_texture.texture->GetDesc().IsCompatible(desc))
-				{
-					pool_texture.last_used_frame = frame_index;
-					active = true;
-					return pool_texture.texture.get();
-				}
-			}
-			auto& texture = texture_pool.emplace_back(std::pair{ PooledTexture{ std::make_unique<GfxTexture>(device, desc), frame_index}, true }).first.texture;
-			return texture.get();
-		}
-		void ReleaseTexture(GfxTexture* texture)
-		{
-			for (auto& [pooled_texture, active] : texture_pool)
-			{
-				auto& texture_ptr = pooled_texture.texture;
-				if (active && texture_ptr.get() == texture)
-				{
-					active = false;
-				}
-			}
-		}
-
-		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc)
+			std::unique_ptr<GfxTexture> texture;
+			GfxTextureDesc desc;
+			GfxHeapType heap_type;
+			Uint64 heap_offset;
+			Uint64 last_used_frame;
+		};
+
+		struct PlacedBuffer
 		{
-			for (auto& [pool_buffer, active] : buffer_pool)
-			{
-				if (!active && pool_buffer.buffer->GetDesc() == desc)
-				{
-					pool_buffer.last_used_frame = frame_index;
-					active = true;
-					return pool_buffer.buffer.get();
-				}
-			}
-			auto& buffer = buffer_pool.emplace_back(std::pair{ PooledBuffer{ std::make_unique<GfxBuffer>(device, desc), frame_index}, true }).first.buffer;
-			return buffer.get();
-		}
-		void ReleaseBuffer(GfxBuffer* buffer)
+			std::unique_ptr<GfxBuffer> buffer;
+			GfxBufferDesc desc;
+			Uint64 heap_offset;
+			Uint64 last_used_frame;
+		};
+
+		template<typename ResourceDesc>
+		struct CachedAllocationInfo
 		{
-			for (auto& [pooled_buffer, active] : buffer_pool)
-			{
-				auto& buffer_ptr = pooled_buffer.buffer;
-				if (active && buffer_ptr.get() == buffer)
-				{
-					active = false;
-				}
-			}
-		}
+			ResourceDesc desc;
+			GfxAllocationInfo allocation_info;
+			Uint64 last_used_frame;
+		};
+
+		static constexpr Uint64 HEAP_TYPE_COUNT = (Uint64)GfxHeapType::Count;
+
+	public:
+		explicit RenderGraphResourcePool(GfxDevice* device);
+
+		void Tick();
+
+		GfxTexture* AllocateTexture(GfxTextureDesc const& desc, RGPoolHandle& handle);
+		void ReleaseTexture(RGPoolHandle handle);
+
+		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc, RGPoolHandle& handle);
+		void ReleaseBuffer(RGPoolHandle handle);
+
+		//Makes sure the transient heap of each type is at least as big as requested. A heap that is too small is recreated,
+		//which also drops every placed resource living in it.
+		void ReserveTransientHeaps(std::array<Uint64, HEAP_TYPE_COUNT> const& heap_sizes);
+		Uint64 GetTransientHeapSize(GfxHeapType heap_type) const;
+
+		GfxTexture* AllocateAliasedTexture(GfxTextureDesc const& desc, GfxHeapType heap_type, Uint64 heap_offset);
+		GfxBuffer* AllocateAliasedBuffer(GfxBufferDesc const& desc, Uint64 heap_offset);
 
+		//Size and alignment of a resource only depend on its desc, the device is queried once per desc
+		GfxAllocationInfo GetAllocationInfo(GfxTextureDesc const& desc);
+		GfxAllocationInfo GetAllocationInfo(GfxBufferDesc const& desc);
+
+		Uint64 GetPooledMemory() const { return pooled_memory; }
 		GfxDevice* GetDevice() const { return device; }
 
 	private:
 		GfxDevice* device = nullptr;
 		Uint64 frame_index = 0;
-		std::vector<std::pair<PooledTexture, Bool>> texture_pool;
-		std::vector<std::pair<PooledBuffer, Bool>>  buffer_pool;
+		Uint64 pooled_memory = 0;
+
+		std::vector<PooledTexture> texture_slots;
+		std::vector<Uint32> free_texture_slots;
+		std::unordered_map<Uint64, std::vector<Uint32>> idle_textures;
+
+		std::vector<PooledBuffer> buffer_slots;
+		std::vector<Uint32> free_buffer_slots;
+		std::unordered_map<Uint64, std::vector<Uint32>> idle_buffers;
+
+		std::array<std::unique_ptr<GfxHeap>, HEAP_TYPE_COUNT> transient_heaps;
+		std::unordered_map<Uint64, std::vector<PlacedTexture>> placed_textures;
+		std::unordered_map<Uint64, std::vector<PlacedBuffer>>  placed_buffers;
+
+		std::unordered_map<Uint64, std::vector<CachedAllocationInfo<GfxTextureDesc>>> texture_allocation_infos;
+		std::unordered_map<Uint64, std::vector<CachedAllocationInfo<GfxBufferDesc>>>  buffer_allocation_infos;
+
+		Uint64 trace_frames_requested = 0;
+		Uint64 trace_frames_left = 0;
+		std::vector<RGPoolTraceEvent> trace;
+
+	private:
+		void EvictTexture(Uint32 slot);
+		void EvictBuffer(Uint32 slot);
+
+		//the capture starts and ends on a frame boundary and is saved once frame_count frames have been recorded
+		void BeginTraceCapture(Uint64 frame_count);
+		void RecordTraceEvent(RGPoolTraceEventType type, Uint32 slot, Uint64 size = 0, GfxTextureDesc const& texture_desc = {}, GfxBufferDesc const& buffer_desc = {});
+
+		//the trace replay has no device to query, it seeds the allocation sizes recorded in the trace
+		void SeedAllocationInfo(GfxTextureDesc const& desc, Uint64 size);
+		void SeedAllocationInfo(GfxBufferDesc const& desc, Uint64 size);
 	};
 	using RGResourcePool = RenderGraphResourcePool;
 
-}
\ No newline at end of file
+}
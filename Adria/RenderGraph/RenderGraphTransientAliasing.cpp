@@ -0,0 +1,65 @@
+#include <format>
+#include "RenderGraphTransientAliasing.h"
+#include "Utilities/AllocatorUtil.h"
+
+namespace adria
+{
+	RGTransientLayout BuildTransientLayout(std::span<RGTransientResource const> resources)
+	{
+		RGTransientLayout layout{};
+		layout.heap_offsets.resize(resources.size(), RGTransientLayout::invalid_offset);
+
+		std::vector<Uint64> sorted_resources(resources.size());
+		for (Uint64 i = 0; i < resources.size(); ++i) sorted_resources[i] = i;
+		std::stable_sort(sorted_resources.begin(), sorted_resources.end(), [&](Uint64 a, Uint64 b) { return resources[a].size > resources[b].size; });
+
+		std::array<std::vector<Uint64>, RGTransientLayout::HEAP_TYPE_COUNT> placed_resources;
+		std::vector<std::pair<Uint64, Uint64>> occupied_ranges;
+		for (Uint64 resource_idx : sorted_resources)
+		{
+			RGTransientResource const& resource = resources[resource_idx];
+			if (resource.size == 0) continue;
+			layout.unaliased_size += resource.size;
+
+			std::vector<Uint64>& heap_resources = placed_resources[(Uint64)resource.heap_type];
+			occupied_ranges.clear();
+			for (Uint64 placed_idx : heap_resources)
+			{
+				RGTransientResource const& placed = resources[placed_idx];
+				if (placed.first_level <= resource.last_level && resource.first_level <= placed.last_level)
+				{
+					Uint64 const placed_offset = layout.heap_offsets[placed_idx];
+					occupied_ranges.emplace_back(placed_offset, placed_offset + placed.size);
+				}
+			}
+			std::sort(occupied_ranges.begin(), occupied_ranges.end());
+
+			Uint64 offset = 0;
+			for (auto const& [range_begin, range_end] : occupied_ranges)
+			{
+				if (offset + resource.size <= range_begin) break;
+				offset = std::max(offset, Align(range_end, resource.alignment));
+			}
+
+			layout.heap_offsets[resource_idx] = offset;
+			heap_resources.push_back(resource_idx);
+			Uint64& heap_size = layout.heap_sizes[(Uint64)resource.heap_type];
+			heap_size = std::max(heap_size, offset + resource.size);
+		}
+		return layout;
+	}
+
+	std::string TransientLayoutToString(RGTransientLayout const& layout)
+	{
+		static constexpr Char const* heap_type_names[] = { "Buffers", "Render Target Textures", "Non Render Target Textures" };
+		static_assert(std::size(heap_type_names) == RGTransientLayout::HEAP_TYPE_COUNT);
+
+		std::string layout_data = std::format("Transient memory: {:.2f} MB without aliasing, {:.2f} MB with aliasing\n",
+			layout.unaliased_size / (1024.0 * 1024.0), layout.AliasedSize() / (1024.0 * 1024.0));
+		for (Uint64 i = 0; i < RGTransientLayout::HEAP_TYPE_COUNT; ++i)
+		{
+			layout_data += std::format("{} heap: {:.2f} MB\n", heap_type_names[i], layout.heap_sizes[i] / (1024.0 * 1024.0));
+		}
+		return layout_data;
+	}
+}
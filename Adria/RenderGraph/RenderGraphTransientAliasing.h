@@ -0,0 +1,42 @@
+#pragma once
+#include <array>
+#include <span>
+#include <string>
+#include "Graphics/GfxHeap.h"
+
+namespace adria
+{
+	struct RenderGraphTransientResource
+	{
+		Uint64 size = 0;
+		Uint64 alignment = 0;
+		GfxHeapType heap_type = GfxHeapType::Buffers;
+		//inclusive range of dependency levels during which the memory of the resource must stay untouched
+		Uint64 first_level = 0;
+		Uint64 last_level = 0;
+	};
+	using RGTransientResource = RenderGraphTransientResource;
+
+	//Placement of transient resources inside one heap per heap type. Resources whose lifetimes do not overlap can share memory,
+	//each one is placed at the lowest aligned offset that does not collide with an already placed resource alive at the same time.
+	struct RenderGraphTransientLayout
+	{
+		inline static constexpr Uint64 invalid_offset = Uint64(-1);
+		static constexpr Uint64 HEAP_TYPE_COUNT = (Uint64)GfxHeapType::Count;
+
+		std::vector<Uint64> heap_offsets;
+		std::array<Uint64, HEAP_TYPE_COUNT> heap_sizes{};
+		Uint64 unaliased_size = 0;
+
+		Uint64 AliasedSize() const
+		{
+			Uint64 aliased_size = 0;
+			for (Uint64 heap_size : heap_sizes) aliased_size += heap_size;
+			return aliased_size;
+		}
+	};
+	using RGTransientLayout = RenderGraphTransientLayout;
+
+	RGTransientLayout BuildTransientLayout(std::span<RGTransientResource const> resources);
+	std::string TransientLayoutToString(RGTransientLayout const& layout);
+}
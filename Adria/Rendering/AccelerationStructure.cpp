@@ -28,13 +28,15 @@ namespace adria
 			GfxRayTracingGeometry& rt_geometry = rt_geometries.emplace_back();
 			rt_geometry.vertex_buffer = geometry_buffer;
 			rt_geometry.vertex_buffer_offset = submesh.positions_offset;
-			rt_geometry.vertex_format = GfxFormat::R32G32B32_FLOAT;
+			//compressed positions are built in their normalized box, the instance transform maps the box back
+			Bool const compressed = submesh.vertex_format == MeshVertexFormat::Compressed;
+			rt_geometry.vertex_format = compressed ? GfxFormat::R16G16B16A16_SNORM : GfxFormat::R32G32B32_FLOAT;
 			rt_geometry.vertex_stride = GetGfxFormatStride(rt_geometry.vertex_format);
 			rt_geometry.vertex_count = submesh.vertices_count;
 
 			rt_geometry.index_buffer = geometry_buffer;
-			rt_geometry.index_buffer_offset = submesh.indices_offset;
-			rt_geometry.index_count = submesh.indices_count;
+			rt_geometry.index_buffer_offset = submesh.lods[0].indices_offset;
+			rt_geometry.index_count = submesh.lods[0].indices_count;
 			rt_geometry.index_format = GfxFormat::R32_UINT;
 			rt_geometry.opaque = material.alpha_mode == MaterialAlphaMode::Opaque;
 
@@ -42,7 +44,8 @@ namespace adria
 			rt_instance.flags = GfxRayTracingInstanceFlag_None;
 			rt_instance.instance_id = instance_id++; //#todo temporary
 			rt_instance.instance_mask = 0xff;
-			const auto T = XMMatrixTranspose(instance.world_transform);
+			Matrix const dequantization = compressed ? Matrix::CreateScale(submesh.bounding_box.Extents) * Matrix::CreateTranslation(submesh.bounding_box.Center) : Matrix::Identity;
+			const auto T = XMMatrixTranspose(dequantization * instance.world_transform);
 			memcpy(rt_instance.transform, &T, sizeof(T));
 		}
 	}
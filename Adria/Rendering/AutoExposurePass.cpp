@@ -76,7 +76,7 @@ namespace adria
 								.scene_idx = descriptor_index, .histogram_idx = descriptor_index + 1 };
 				cmd_list->SetRootConstants(1, constants);
 				cmd_list->Dispatch(DivideAndRoundUp(width, 16), DivideAndRoundUp(height, 16), 1);
-			}, RGPassType::Compute, RGPassFlags::None);
+			}, RGPassType::ComputeAsync, RGPassFlags::None);
 
 		rg.ImportTexture(RG_NAME(AverageLuminance), luminance_texture.get());
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Components.h"
 #include "Graphics/GfxCommandList.h"
 
@@ -17,5 +18,30 @@ namespace adria
 		}
 		else cmd_list->Draw(submesh.vertex_count, submesh.instance_count, submesh.start_vertex_location, submesh.start_instance_location);
 	}
+
+	Uint32 SelectSubMeshLOD(SubMeshGPU const& submesh, Float world_scale, Float distance, Float projection_scale, Float max_pixel_error)
+	{
+		Float const pixels_per_unit = world_scale * projection_scale / std::max(distance, 1e-4f);
+		Uint32 lod = 0;
+		while (lod + 1 < submesh.lod_count && submesh.lods[lod + 1].error * pixels_per_unit <= max_pixel_error) ++lod;
+		return lod;
+	}
+
+	Uint32 SelectBatchLOD(Batch const& batch, Vector3 const& view_position, Bool orthographic, Float projection_scale, Float max_pixel_error)
+	{
+		Matrix const& world = batch.world_transform;
+		Float const world_scale = std::sqrt(std::max({ Vector3(world._11, world._12, world._13).LengthSquared(),
+													   Vector3(world._21, world._22, world._23).LengthSquared(),
+													   Vector3(world._31, world._32, world._33).LengthSquared() }));
+		if (orthographic) return SelectSubMeshLOD(*batch.submesh, world_scale, 1.0f, projection_scale, max_pixel_error);
+
+		//distance to the closest point of the bounds, zero when the view is inside them
+		Vector3 const box_center(batch.bounding_box.Center);
+		Vector3 const box_extents(batch.bounding_box.Extents);
+		Vector3 closest_point;
+		view_position.Clamp(box_center - box_extents, box_center + box_extents, closest_point);
+		Float const distance = Vector3::Distance(view_position, closest_point);
+		return SelectSubMeshLOD(*batch.submesh, world_scale, distance, projection_scale, max_pixel_error);
+	}
 }
 
@@ -149,23 +149,43 @@ namespace adria
 	struct COMPONENT Ocean {};
 	struct COMPONENT Deferred {};
 
-	struct SubMeshGPU
+	//Compressed vertices store positions as snorm16 relative to the submesh bounding box,
+	//octahedral 16 bit normals and tangents and half precision UVs, 20 bytes per vertex instead of 48
+	enum class MeshVertexFormat : Uint32
 	{
-		Uint64 buffer_address;
+		Full,
+		Compressed
+	};
 
+	inline constexpr Uint32 SUBMESH_MAX_LODS = 4;
+	struct SubMeshLOD
+	{
 		Uint32 indices_offset;
 		Uint32 indices_count;
+
+		Uint32 meshlet_offset;
+		Uint32 meshlet_vertices_offset;
+		Uint32 meshlet_triangles_offset;
+		Uint32 meshlet_count;
+
+		//object space deviation from the base LOD, zero for the base LOD
+		Float error;
+	};
+
+	struct SubMeshGPU
+	{
+		Uint64 buffer_address;
 		Uint32 vertices_count;
+		MeshVertexFormat vertex_format;
 
 		Uint32 positions_offset;
 		Uint32 uvs_offset;
 		Uint32 normals_offset;
 		Uint32 tangents_offset;
 
-		Uint32 meshlet_offset;
-		Uint32 meshlet_vertices_offset;
-		Uint32 meshlet_triangles_offset;
-		Uint32 meshlet_count;
+		//every LOD indexes the same vertex streams, lods[0] is the full detail mesh
+		SubMeshLOD lods[SUBMESH_MAX_LODS];
+		Uint32 lod_count;
 
 		Uint32 material_index;
 		DirectX::BoundingBox bounding_box;
@@ -194,8 +214,14 @@ namespace adria
 		BoundingBox bounding_box;
 
 		Bool camera_visibility = true;
+		Uint32 lod = 0;
 
 	};
 
+	//Picks the coarsest LOD whose error, scaled to world space and projected at the given distance, stays under max_pixel_error pixels.
+	//projection_scale is the number of pixels one world unit covers at a distance of one unit.
+	Uint32 SelectSubMeshLOD(SubMeshGPU const& submesh, Float world_scale, Float distance, Float projection_scale, Float max_pixel_error);
+	//Picks the LOD of a batch seen from view_position, orthographic views project the error the same at every distance
+	Uint32 SelectBatchLOD(Batch const& batch, Vector3 const& view_position, Bool orthographic, Float projection_scale, Float max_pixel_error);
 	void Draw(SubMesh const& submesh, GfxCommandList* cmd_list, Bool override_topology = false, GfxPrimitiveTopology new_topology = GfxPrimitiveTopology::Undefined);
 }
\ No newline at end of file
@@ -243,7 +243,7 @@ namespace adria
 				cmd_list->SetRootConstants(1, parameters);
 				cmd_list->Dispatch(num_probes_flat, 1, 1);
 				cmd_list->TextureBarrier(ctx.GetTexture(*data.irradiance), GfxResourceState::ComputeUAV, GfxResourceState::ComputeUAV);
-			}, RGPassType::Compute);
+			}, RGPassType::ComputeAsync);
 
 		struct DDGIUpdateDistancePassData
 		{
@@ -296,7 +296,7 @@ namespace adria
 				cmd_list->SetRootConstants(1, parameters);
 				cmd_list->Dispatch(num_probes_flat, 1, 1);
 				cmd_list->TextureBarrier(ctx.GetTexture(*data.distance), GfxResourceState::ComputeUAV, GfxResourceState::ComputeUAV);
-			}, RGPassType::Compute);
+			}, RGPassType::ComputeAsync);
 
 		rg.ExportTexture(RG_NAME(DDGIIrradiance), ddgi_volume.irradiance_history.get());
 		rg.ExportTexture(RG_NAME(DDGIDistance), ddgi_volume.distance_history.get());
@@ -1,5 +1,6 @@
 #include <map>
 #include "GBufferPass.h"
+#include "GBufferPermutations.h"
 #include "ShaderStructs.h"
 #include "Components.h"
 #include "BlackboardData.h"
@@ -15,7 +16,6 @@ using namespace DirectX;
 
 namespace adria
 {
-
 	GBufferPass::GBufferPass(entt::registry& reg, GfxDevice* gfx, Uint32 w, Uint32 h) :
 		reg{ reg }, gfx{ gfx }, width{ w }, height{ h }
 	{
@@ -60,22 +60,6 @@ namespace adria
 				GfxDevice* gfx = cmd_list->GetDevice();
 				
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
-				auto GetPSO = [this](MaterialAlphaMode alpha_mode)
-				{
-					using enum GfxShaderStage;
-					if (raining)
-					{
-						gbuffer_psos->AddDefine<PS>("RAIN", "1");
-					}
-					switch (alpha_mode)
-					{
-					case MaterialAlphaMode::Opaque: break;
-					case MaterialAlphaMode::Mask:   gbuffer_psos->AddDefine<PS>("MASK", "1"); break;
-					case MaterialAlphaMode::Blend:  gbuffer_psos->SetCullMode(GfxCullMode::None); break;
-					}
-					return gbuffer_psos->Get();
-				};
-
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 
 				GfxShadingRateInfo const& vrs = gfx->GetVRSInfo();
@@ -88,7 +72,7 @@ namespace adria
 					Batch& batch = batch_view.get<Batch>(batch_entity);
 					if (!batch.camera_visibility) continue;
 
-					GfxPipelineState* pso = GetPSO(batch.alpha_mode);
+					GfxPipelineState* pso = gbuffer_psos->Get(GetGBufferPermutationKey(batch.alpha_mode, raining));
 					cmd_list->SetPipelineState(pso);
 
 					struct GBufferConstants
@@ -97,10 +81,11 @@ namespace adria
 					} constants { .instance_id = batch.instance_id };
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					SubMeshLOD const& lod = batch.submesh->lods[batch.lod];
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + lod.indices_offset, lod.indices_count);
 					cmd_list->SetTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
-					cmd_list->DrawIndexed(batch.submesh->indices_count);
+					cmd_list->DrawIndexed(lod.indices_count);
 				}
 
 				cmd_list->EndVRS(vrs);
@@ -130,7 +115,6 @@ namespace adria
 		gbuffer_pso_desc.dsv_format = GfxFormat::D32_FLOAT;
 
 		gbuffer_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gbuffer_pso_desc);
+		gbuffer_psos->AddPermutations(GBUFFER_PERMUTATION_COUNT, SetupGBufferPermutation<GfxGraphicsPipelineStatePermutations>);
 	}
-
 }
-
@@ -32,4 +32,5 @@ namespace adria
 	private:
 		void CreatePSOs();
 	};
-}
\ No newline at end of file
+
+}
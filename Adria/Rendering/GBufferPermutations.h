@@ -0,0 +1,33 @@
+#pragma once
+#include "Components.h"
+#include "Graphics/GfxShaderEnums.h"
+#include "Graphics/GfxStates.h"
+
+namespace adria
+{
+	inline constexpr Uint32 GBUFFER_PERMUTATION_RAIN = 0x1;
+	inline constexpr Uint32 GBUFFER_PERMUTATION_ALPHA_MODE_SHIFT = 1;
+	inline constexpr Uint32 GBUFFER_PERMUTATION_COUNT = 3 << GBUFFER_PERMUTATION_ALPHA_MODE_SHIFT;
+
+	constexpr Uint32 GetGBufferPermutationKey(MaterialAlphaMode alpha_mode, Bool raining)
+	{
+		return ((Uint32)alpha_mode << GBUFFER_PERMUTATION_ALPHA_MODE_SHIFT) | (raining ? GBUFFER_PERMUTATION_RAIN : 0);
+	}
+
+	//Applies the defines and states of one GBuffer permutation, PSOPermutations is a GfxPipelineStatePermutations of any pipeline state type
+	template<typename PSOPermutations>
+	void SetupGBufferPermutation(PSOPermutations& psos, Uint32 permutation_key)
+	{
+		using enum GfxShaderStage;
+		if (permutation_key & GBUFFER_PERMUTATION_RAIN)
+		{
+			psos.template AddDefine<PS>("RAIN", "1");
+		}
+		switch ((MaterialAlphaMode)(permutation_key >> GBUFFER_PERMUTATION_ALPHA_MODE_SHIFT))
+		{
+		case MaterialAlphaMode::Opaque: break;
+		case MaterialAlphaMode::Mask:   psos.template AddDefine<PS>("MASK", "1"); break;
+		case MaterialAlphaMode::Blend:  psos.SetCullMode(GfxCullMode::None); break;
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <immintrin.h>
+#include "cgltf.h"
+
+namespace adria
+{
+	//Returns the first element of the accessor when its data can be read in bulk, sparse and unbacked accessors take the per element path
+	inline Uint8 const* GetAccessorData(cgltf_accessor const* accessor)
+	{
+		if (accessor->is_sparse || !accessor->buffer_view) return nullptr;
+		Uint8 const* data = cgltf_buffer_view_data(accessor->buffer_view);
+		return data ? data + accessor->offset : nullptr;
+	}
+
+	//Decodes the indices of the accessor widened to 32 bits
+	inline void DecodeIndices(cgltf_accessor const* accessor, Uint32* indices)
+	{
+		Uint64 const count = accessor->count;
+		Uint8 const* data = GetAccessorData(accessor);
+		Uint64 const component_size = cgltf_component_size(accessor->component_type);
+		if (!data || accessor->stride != component_size)
+		{
+			for (Uint64 i = 0; i < count; ++i) indices[i] = (Uint32)cgltf_accessor_read_index(accessor, i);
+			return;
+		}
+
+		Uint64 i = 0;
+		__m128i const zero = _mm_setzero_si128();
+		switch (accessor->component_type)
+		{
+		case cgltf_component_type_r_32u:
+			memcpy(indices, data, count * sizeof(Uint32));
+			return;
+		case cgltf_component_type_r_16u:
+		{
+			Uint16 const* src = reinterpret_cast<Uint16 const*>(data);
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i), _mm_unpacklo_epi16(v, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 4), _mm_unpackhi_epi16(v, zero));
+			}
+			for (; i < count; ++i) indices[i] = src[i];
+			return;
+		}
+		case cgltf_component_type_r_8u:
+		{
+			Uint8 const* src = data;
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+				__m128i const lo = _mm_unpacklo_epi8(v, zero);
+				__m128i const hi = _mm_unpackhi_epi8(v, zero);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i), _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 4), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 8), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 12), _mm_unpackhi_epi16(hi, zero));
+			}
+			for (; i < count; ++i) indices[i] = src[i];
+			return;
+		}
+		default:
+			for (; i < count; ++i) indices[i] = (Uint32)cgltf_accessor_read_index(accessor, i);
+		}
+	}
+
+	//Widens normalized unsigned components to floats, dividing like cgltf does so both paths give the same values
+	template<typename ComponentT>
+	void DecodeNormalizedComponents(ComponentT const* src, Float* dst, Uint64 count)
+	{
+		constexpr Float max_value = (Float)std::numeric_limits<ComponentT>::max();
+		__m128 const scale = _mm_set1_ps(max_value);
+		__m128i const zero = _mm_setzero_si128();
+		Uint64 i = 0;
+		if constexpr (sizeof(ComponentT) == 2)
+		{
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+				_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+				_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+			}
+		}
+		else
+		{
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i const v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(src + i)), zero);
+				_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+				_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+			}
+		}
+		for (; i < count; ++i) dst[i] = src[i] / max_value;
+	}
+
+	//Decodes the accessor into a stream of T, a float vector type, float and normalized layouts are read in bulk
+	template<typename T>
+	void DecodeAttribute(cgltf_accessor const* accessor, T* stream)
+	{
+		constexpr Uint64 component_count = sizeof(T) / sizeof(Float);
+		Uint64 const count = accessor->count;
+		Uint8 const* data = GetAccessorData(accessor);
+		Float* dst = reinterpret_cast<Float*>(stream);
+		if (data && cgltf_num_components(accessor->type) == component_count)
+		{
+			Uint64 const element_size = cgltf_calc_size(accessor->type, accessor->component_type);
+			if (accessor->component_type == cgltf_component_type_r_32f)
+			{
+				if (accessor->stride == element_size)
+				{
+					memcpy(dst, data, count * element_size);
+				}
+				else
+				{
+					for (Uint64 i = 0; i < count; ++i) memcpy(dst + i * component_count, data + i * accessor->stride, sizeof(T));
+				}
+				return;
+			}
+			//quantized attributes, mostly texture coordinates
+			if (accessor->normalized && accessor->stride == element_size)
+			{
+				if (accessor->component_type == cgltf_component_type_r_16u)
+				{
+					DecodeNormalizedComponents(reinterpret_cast<Uint16 const*>(data), dst, count * component_count);
+					return;
+				}
+				if (accessor->component_type == cgltf_component_type_r_8u)
+				{
+					DecodeNormalizedComponents(data, dst, count * component_count);
+					return;
+				}
+			}
+		}
+		for (Uint64 i = 0; i < count; ++i) cgltf_accessor_read_float(accessor, i, dst + i * component_count, component_count);
+	}
+}
@@ -0,0 +1,1107 @@
+#define CGLTF_IMPLEMENTATION
+#include <bcrypt.h>
+#include <filesystem>
+#include <format>
+#include <numeric>
+#include <immintrin.h>
+#include "cgltf.h"
+#include "meshoptimizer.h"
+#include "ModelCache.h"
+#include "GLTFAccessors.h"
+#include "SceneLoader.h"
+#include "SceneConfig.h"
+#include "Meshlet.h"
+#include "Core/Paths.h"
+#include "Logging/Logger.h"
+#include "Math/BoundingVolumeUtil.h"
+#include "Math/Packing.h"
+#include "Utilities/AllocatorUtil.h"
+#include "Utilities/StringUtil.h"
+#include "Utilities/FilesUtil.h"
+#include "Utilities/HashUtil.h"
+#include "Utilities/Timer.h"
+#include "Utilities/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		struct CookedModelHeader
+		{
+			//bump when the cooked structs or the import change
+			static constexpr Uint32 MAGIC = 0x4D4B4441; //ADKM
+			static constexpr Uint32 VERSION = 3;
+
+			Uint32 magic;
+			Uint32 version;
+			Uint32 submesh_stride;
+			Uint32 material_stride;
+			//parameters the model was cooked with, checked against the requested ones in case two names collide
+			Uint32 flags;
+			Uint32 lod_count;
+			Float  lod_error;
+			Uint32 submesh_count;
+			Uint32 material_count;
+			Uint32 instance_count;
+			Uint32 light_count;
+			Uint32 dependency_count;
+			//SHA-256 of the model file followed by the buffer files it references
+			Uint8  source_hash[32];
+			//total size and combined last write times of the same files, the source is only hashed when the write times differ
+			Uint64 source_size;
+			Uint64 source_write_time;
+
+			Uint64 file_size;
+			Uint64 submeshes_offset;
+			Uint64 materials_offset;
+			Uint64 instances_offset;
+			Uint64 lights_offset;
+			Uint64 dependencies_offset;
+			Uint64 strings_offset;
+			Uint64 strings_size;
+			Uint64 geometry_offset;
+			Uint64 geometry_size;
+		};
+
+		enum CookedModelFlag : Uint32
+		{
+			CookedModelFlag_TriangleCCW = 1 << 0,
+			CookedModelFlag_ForceMaskAlpha = 1 << 1,
+			CookedModelFlag_CompressedVertices = 1 << 2
+		};
+
+		//largest deviation of decoded vertices, positions in model units and directions in degrees
+		struct VertexCompressionError
+		{
+			Float position = 0.0f;
+			Float normal = 0.0f;
+			Float tangent = 0.0f;
+			Float uv = 0.0f;
+
+			void Merge(VertexCompressionError const& other)
+			{
+				position = std::max(position, other.position);
+				normal = std::max(normal, other.normal);
+				tangent = std::max(tangent, other.tangent);
+				uv = std::max(uv, other.uv);
+			}
+		};
+
+		struct MeshLODData
+		{
+			std::vector<Uint32>			 indices;
+			std::vector<Meshlet>		 meshlets;
+			std::vector<Uint32>			 meshlet_vertices;
+			std::vector<MeshletTriangle> meshlet_triangles;
+			Float error = 0.0f;
+		};
+
+		struct MeshData
+		{
+			DirectX::BoundingBox bounding_box;
+			Int32 material_index = -1;
+			GfxPrimitiveTopology topology = GfxPrimitiveTopology::TriangleList;
+
+			std::vector<Vector3> positions_stream;
+			std::vector<Vector3> normals_stream;
+			std::vector<Vector4> tangents_stream;
+			std::vector<Vector2> uvs_stream;
+			//written instead of the streams above when the model uses the compressed vertex format
+			std::vector<Uint64> compressed_positions_stream;
+			std::vector<Uint32> compressed_normals_stream;
+			std::vector<Uint32> compressed_tangents_stream;
+			std::vector<Uint32> compressed_uvs_stream;
+			VertexCompressionError compression_error;
+			//lods[0] holds the indices read from the primitive, simplified LODs are added while processing
+			std::vector<MeshLODData> lods;
+		};
+
+		Uint32 GetCookedModelFlags(ModelParameters const& params)
+		{
+			Uint32 flags = 0;
+			if (params.triangle_ccw) flags |= CookedModelFlag_TriangleCCW;
+			if (params.force_mask_alpha_usage) flags |= CookedModelFlag_ForceMaskAlpha;
+			if (params.compress_vertices) flags |= CookedModelFlag_CompressedVertices;
+			return flags;
+		}
+
+		constexpr Uint64 GetVertexStride(MeshVertexFormat vertex_format)
+		{
+			if (vertex_format == MeshVertexFormat::Compressed) return sizeof(Uint64) + 3 * sizeof(Uint32);
+			return 2 * sizeof(Vector3) + sizeof(Vector4) + sizeof(Vector2);
+		}
+
+		Float GetAngleInDegrees(Vector3 const& a, Vector3 const& b)
+		{
+			return DirectX::XMConvertToDegrees(std::atan2(a.Cross(b).Length(), a.Dot(b)));
+		}
+
+		//every parameter that changes the cooked data is part of the name, scenes loading the same model with different parameters get their own file
+		std::string GetCookedModelPath(ModelParameters const& params)
+		{
+			std::string const cooked_model_key = std::format("{}|{:x}|{}|{}", NormalizePath(params.model_path), GetCookedModelFlags(params), params.lod_count, params.lod_error);
+			Uint64 const cooked_model_hash = crc64(cooked_model_key.c_str(), cooked_model_key.size());
+			return paths::ModelCacheDir + GetFilenameWithoutExtension(params.model_path) + std::format("_{:016x}.cooked", cooked_model_hash);
+		}
+
+		Uint32 AddString(std::vector<Char>& strings, std::string_view string)
+		{
+			Uint32 const offset = (Uint32)strings.size();
+			strings.insert(strings.end(), string.begin(), string.end());
+			strings.push_back('\0');
+			return offset;
+		}
+
+		template<typename T>
+		Uint64 AppendSection(std::vector<Uint8>& cooked_data, T const* items, Uint64 count)
+		{
+			Uint64 const offset = Align(cooked_data.size(), 16);
+			cooked_data.resize(offset + count * sizeof(T));
+			if (count > 0) memcpy(cooked_data.data() + offset, items, count * sizeof(T));
+			return offset;
+		}
+
+		Bool HashFile(BCRYPT_HASH_HANDLE hash, std::string const& file_path)
+		{
+			std::ifstream file(file_path, std::ios::binary);
+			if (!file) return false;
+
+			std::vector<Char> chunk(4 << 20);
+			while (file)
+			{
+				file.read(chunk.data(), chunk.size());
+				Uint64 const read_size = (Uint64)file.gcount();
+				if (read_size > 0 && !BCRYPT_SUCCESS(BCryptHashData(hash, (PUCHAR)chunk.data(), (ULONG)read_size, 0))) return false;
+			}
+			return file.eof();
+		}
+
+		Bool HashModelSource(std::string const& model_path, std::vector<std::string> const& dependencies, Uint8 (&digest)[32])
+		{
+			BCRYPT_HASH_HANDLE hash = nullptr;
+			if (!BCRYPT_SUCCESS(BCryptCreateHash(BCRYPT_SHA256_ALG_HANDLE, &hash, nullptr, 0, nullptr, 0, 0))) return false;
+
+			Bool success = HashFile(hash, model_path);
+			for (std::string const& dependency : dependencies)
+			{
+				success = success && HashFile(hash, dependency);
+			}
+			success = success && BCRYPT_SUCCESS(BCryptFinishHash(hash, digest, sizeof(digest), 0));
+			BCryptDestroyHash(hash);
+			return success;
+		}
+
+		struct ModelSourceStamp
+		{
+			Uint64 size = 0;
+			Uint64 write_time = 0;
+		};
+
+		Bool GetModelSourceStamp(std::string const& model_path, std::vector<std::string> const& dependencies, ModelSourceStamp& stamp)
+		{
+			HashState write_time;
+			stamp.size = 0;
+			auto AddFile = [&](std::string const& file_path)
+			{
+				std::error_code error;
+				Uint64 const file_size = fs::file_size(file_path, error);
+				if (error) return false;
+				auto const last_write_time = fs::last_write_time(file_path, error);
+				if (error) return false;
+				stamp.size += file_size;
+				write_time.Combine((Uint64)last_write_time.time_since_epoch().count());
+				return true;
+			};
+			if (!AddFile(model_path)) return false;
+			for (std::string const& dependency : dependencies)
+			{
+				if (!AddFile(dependency)) return false;
+			}
+			stamp.write_time = write_time;
+			return true;
+		}
+
+		//the source is only hashed when its write times changed, source_touched is set when they did but the content did not,
+		//the caller then updates the stamp with UpdateCookedModelSourceStamp so later loads skip hashing again
+		Bool IsCookedModelValid(Uint8 const* cooked_data, Uint64 cooked_size, ModelParameters const& params, ModelSourceStamp& source_stamp, Bool& source_touched)
+		{
+			source_touched = false;
+			if (cooked_size < sizeof(CookedModelHeader)) return false;
+			CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(cooked_data);
+			if (header.magic != CookedModelHeader::MAGIC || header.version != CookedModelHeader::VERSION) return false;
+			if (header.submesh_stride != sizeof(SubMeshGPU) || header.material_stride != sizeof(CookedMaterial)) return false;
+			if (header.flags != GetCookedModelFlags(params) || header.file_size != cooked_size) return false;
+			if (header.lod_count != params.lod_count || header.lod_error != params.lod_error) return false;
+
+			auto IsSectionValid = [cooked_size](Uint64 offset, Uint64 size) { return offset <= cooked_size && size <= cooked_size - offset; };
+			if (!IsSectionValid(header.submeshes_offset, (Uint64)header.submesh_count * sizeof(SubMeshGPU)) ||
+				!IsSectionValid(header.materials_offset, (Uint64)header.material_count * sizeof(CookedMaterial)) ||
+				!IsSectionValid(header.instances_offset, (Uint64)header.instance_count * sizeof(CookedInstance)) ||
+				!IsSectionValid(header.lights_offset, (Uint64)header.light_count * sizeof(CookedLight)) ||
+				!IsSectionValid(header.dependencies_offset, (Uint64)header.dependency_count * sizeof(Uint32)) ||
+				!IsSectionValid(header.strings_offset, header.strings_size) ||
+				!IsSectionValid(header.geometry_offset, header.geometry_size))
+			{
+				return false;
+			}
+			Char const* strings = reinterpret_cast<Char const*>(cooked_data + header.strings_offset);
+			if (header.strings_size > 0 && strings[header.strings_size - 1] != '\0') return false;
+
+			std::vector<std::string> dependencies(header.dependency_count);
+			Uint32 const* dependency_names = reinterpret_cast<Uint32 const*>(cooked_data + header.dependencies_offset);
+			for (Uint32 i = 0; i < header.dependency_count; ++i)
+			{
+				if (dependency_names[i] >= header.strings_size) return false;
+				dependencies[i] = strings + dependency_names[i];
+			}
+
+			if (!GetModelSourceStamp(params.model_path, dependencies, source_stamp) || source_stamp.size != header.source_size) return false;
+			if (source_stamp.write_time == header.source_write_time) return true;
+
+			Uint8 source_hash[32];
+			if (!HashModelSource(params.model_path, dependencies, source_hash) || memcmp(source_hash, header.source_hash, sizeof(source_hash)) != 0) return false;
+			source_touched = true;
+			return true;
+		}
+
+		Bool UpdateCookedModelSourceStamp(std::string const& cooked_model_path, ModelSourceStamp const& source_stamp)
+		{
+			std::fstream file(cooked_model_path, std::ios::binary | std::ios::in | std::ios::out);
+			if (!file) return false;
+			file.seekp(offsetof(CookedModelHeader, source_size));
+			file.write(reinterpret_cast<Char const*>(&source_stamp.size), sizeof(source_stamp.size));
+			file.seekp(offsetof(CookedModelHeader, source_write_time));
+			file.write(reinterpret_cast<Char const*>(&source_stamp.write_time), sizeof(source_stamp.write_time));
+			return file.good();
+		}
+
+		Bool WriteCookedModel(std::string const& cooked_model_path, std::vector<Uint8> const& cooked_data)
+		{
+			std::error_code error;
+			fs::create_directories(paths::ModelCacheDir, error);
+
+			std::string const temp_cooked_model_path = cooked_model_path + ".tmp";
+			{
+				std::ofstream os(temp_cooked_model_path, std::ios::binary);
+				if (!os) return false;
+				os.write(reinterpret_cast<Char const*>(cooked_data.data()), cooked_data.size());
+				if (!os.good()) return false;
+			}
+			return MoveFileExA(temp_cooked_model_path.c_str(), cooked_model_path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+		}
+
+		void CookMaterials(cgltf_data const* gltf_data, ModelParameters const& params, std::vector<CookedMaterial>& cooked_materials, std::vector<Char>& strings)
+		{
+			cooked_materials.reserve(gltf_data->materials_count);
+			for (Uint32 i = 0; i < gltf_data->materials_count; ++i)
+			{
+				cgltf_material const& gltf_material = gltf_data->materials[i];
+				CookedMaterial& cooked_material = cooked_materials.emplace_back();
+				std::fill(std::begin(cooked_material.texture_names), std::end(cooked_material.texture_names), INVALID_COOKED_STRING);
+
+				Material& material = cooked_material.material;
+				material.alpha_cutoff = (Float)gltf_material.alpha_cutoff;
+				material.double_sided = gltf_material.double_sided;
+				material.emissive_factor = (Float)gltf_material.emissive_factor[0];
+
+				if (params.force_mask_alpha_usage)
+				{
+					material.alpha_mode = MaterialAlphaMode::Mask;
+				}
+				if (gltf_material.alpha_mode == cgltf_alpha_mode_opaque)
+				{
+					material.alpha_mode = MaterialAlphaMode::Opaque;
+				}
+				else if (gltf_material.alpha_mode == cgltf_alpha_mode_blend)
+				{
+					material.alpha_mode = MaterialAlphaMode::Blend;
+				}
+				else if (gltf_material.alpha_mode == cgltf_alpha_mode_mask)
+				{
+					material.alpha_mode = MaterialAlphaMode::Mask;
+				}
+
+				auto GetImageURI = [&gltf_data](cgltf_texture* texture)
+				{
+					if (texture->extensions_count > 0)
+					{
+						if (strcmp(texture->extensions[0].name, "MSFT_texture_dds") == 0)
+						{
+							std::string extension_data(texture->extensions[0].data);
+							std::vector<std::string> tokens = SplitString(extension_data, ':');
+							Int image_index = std::stoi(tokens[1]);
+							return gltf_data->images[image_index].uri;
+						}
+						return texture->image->uri;
+					}
+					return texture->image->uri;
+				};
+				//the texture itself is loaded when the cooked model is loaded, until then the slot holds the default
+				auto SetTexture = [&](cgltf_texture* texture, CookedTextureSlot slot, TextureHandle& handle, TextureHandle default_handle)
+				{
+					if (texture)
+					{
+						cooked_material.texture_names[slot] = AddString(strings, GetImageURI(texture));
+					}
+					handle = default_handle;
+				};
+				if (gltf_material.has_pbr_metallic_roughness)
+				{
+					cgltf_pbr_metallic_roughness pbr_metallic_roughness = gltf_material.pbr_metallic_roughness;
+					material.albedo_color[0] = (Float)pbr_metallic_roughness.base_color_factor[0];
+					material.albedo_color[1] = (Float)pbr_metallic_roughness.base_color_factor[1];
+					material.albedo_color[2] = (Float)pbr_metallic_roughness.base_color_factor[2];
+					material.metallic_factor = (Float)pbr_metallic_roughness.metallic_factor;
+					material.roughness_factor = (Float)pbr_metallic_roughness.roughness_factor;
+					SetTexture(pbr_metallic_roughness.base_color_texture.texture, CookedTextureSlot_Albedo, material.albedo_texture, DEFAULT_WHITE_TEXTURE_HANDLE);
+					SetTexture(pbr_metallic_roughness.metallic_roughness_texture.texture, CookedTextureSlot_MetallicRoughness, material.metallic_roughness_texture, DEFAULT_METALLIC_ROUGHNESS_TEXTURE_HANDLE);
+				}
+				else if (gltf_material.has_pbr_specular_glossiness)
+				{
+					cgltf_pbr_specular_glossiness pbr_specular_glossiness = gltf_material.pbr_specular_glossiness;
+					SetTexture(pbr_specular_glossiness.diffuse_texture.texture, CookedTextureSlot_Albedo, material.albedo_texture, DEFAULT_WHITE_TEXTURE_HANDLE);
+					material.roughness_factor = 1.0f - gltf_material.pbr_specular_glossiness.glossiness_factor;
+					material.albedo_color[0] = gltf_material.pbr_specular_glossiness.diffuse_factor[0];
+					material.albedo_color[1] = gltf_material.pbr_specular_glossiness.diffuse_factor[1];
+					material.albedo_color[2] = gltf_material.pbr_specular_glossiness.diffuse_factor[2];
+				}
+
+				//shading extensions
+				material.extension = ShadingExtension::None;
+				if (gltf_material.has_anisotropy)
+				{
+					material.extension = ShadingExtension::Anisotropy;
+					SetTexture(gltf_material.anisotropy.anisotropy_texture.texture, CookedTextureSlot_Anisotropy, material.anisotropy_texture, INVALID_TEXTURE_HANDLE);
+					material.anisotropy_strength = gltf_material.anisotropy.anisotropy_strength;
+					material.anisotropy_rotation = gltf_material.anisotropy.anisotropy_rotation;
+				}
+				if (gltf_material.has_clearcoat)
+				{
+					material.extension = ShadingExtension::ClearCoat;
+					SetTexture(gltf_material.clearcoat.clearcoat_texture.texture, CookedTextureSlot_ClearCoat, material.clear_coat_texture, DEFAULT_BLACK_TEXTURE_HANDLE);
+					SetTexture(gltf_material.clearcoat.clearcoat_roughness_texture.texture, CookedTextureSlot_ClearCoatRoughness, material.clear_coat_roughness_texture, DEFAULT_BLACK_TEXTURE_HANDLE);
+					SetTexture(gltf_material.clearcoat.clearcoat_normal_texture.texture, CookedTextureSlot_ClearCoatNormal, material.clear_coat_normal_texture, DEFAULT_NORMAL_TEXTURE_HANDLE);
+					material.clear_coat = gltf_material.clearcoat.clearcoat_factor;
+					material.clear_coat_roughness = gltf_material.clearcoat.clearcoat_roughness_factor;
+				}
+
+				SetTexture(gltf_material.normal_texture.texture, CookedTextureSlot_Normal, material.normal_texture, DEFAULT_NORMAL_TEXTURE_HANDLE);
+				SetTexture(gltf_material.emissive_texture.texture, CookedTextureSlot_Emissive, material.emissive_texture, DEFAULT_BLACK_TEXTURE_HANDLE);
+			}
+		}
+
+		//swaps the last two indices of every triangle, four triangles are three registers
+		void FlipTriangleWinding(Uint32* indices, Uint64 count)
+		{
+			Uint64 i = 0;
+			for (; i + 12 <= count; i += 12)
+			{
+				__m128 const a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(indices + i)));
+				__m128 const b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(indices + i + 4)));
+				__m128 const c = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(indices + i + 8)));
+
+				//a b c = [0 1 2 3] [4 5 6 7] [8 9 10 11] -> [0 2 1 3] [5 4 6 8] [7 9 11 10]
+				__m128 const b_tail = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2));
+				__m128 const c_head = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 3, 3));
+				__m128 const out_a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 2, 0));
+				__m128 const out_b = _mm_shuffle_ps(b, b_tail, _MM_SHUFFLE(2, 0, 0, 1));
+				__m128 const out_c = _mm_shuffle_ps(c_head, c, _MM_SHUFFLE(2, 3, 2, 0));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i), _mm_castps_si128(out_a));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 4), _mm_castps_si128(out_b));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i + 8), _mm_castps_si128(out_c));
+			}
+			for (; i + 3 <= count; i += 3) std::swap(indices[i + 1], indices[i + 2]);
+		}
+
+		void ReadMeshData(cgltf_data const* gltf_data, ModelParameters const& params, std::vector<MeshData>& mesh_datas, std::unordered_map<cgltf_mesh const*, std::vector<Int32>>& mesh_primitives_map)
+		{
+			Int32 primitive_count = 0;
+			for (Uint32 i = 0; i < gltf_data->meshes_count; ++i)
+			{
+				cgltf_mesh const& gltf_mesh = gltf_data->meshes[i];
+				std::vector<Int32>& primitives = mesh_primitives_map[&gltf_mesh];
+				for (Uint32 j = 0; j < gltf_mesh.primitives_count; ++j)
+				{
+					auto const& gltf_primitive = gltf_mesh.primitives[j];
+					ADRIA_ASSERT(gltf_primitive.indices->count >= 0);
+
+					MeshData& mesh_data = mesh_datas.emplace_back();
+					mesh_data.material_index = (Int32)(gltf_primitive.material - gltf_data->materials);
+					std::vector<Uint32>& indices = mesh_data.lods.emplace_back().indices;
+					indices.resize(gltf_primitive.indices->count);
+					DecodeIndices(gltf_primitive.indices, indices.data());
+					if (params.triangle_ccw) FlipTriangleWinding(indices.data(), indices.size());
+
+					switch (gltf_primitive.type)
+					{
+					case cgltf_primitive_type_points:
+						mesh_data.topology = GfxPrimitiveTopology::PointList;
+						break;
+					case cgltf_primitive_type_lines:
+						mesh_data.topology = GfxPrimitiveTopology::LineList;
+						break;
+					case cgltf_primitive_type_line_strip:
+						mesh_data.topology = GfxPrimitiveTopology::LineStrip;
+						break;
+					case cgltf_primitive_type_triangles:
+						mesh_data.topology = GfxPrimitiveTopology::TriangleList;
+						break;
+					case cgltf_primitive_type_triangle_strip:
+						mesh_data.topology = GfxPrimitiveTopology::TriangleStrip;
+						break;
+					default:
+						ADRIA_ASSERT(false);
+					}
+
+					for (Uint32 k = 0; k < gltf_primitive.attributes_count; ++k)
+					{
+						cgltf_attribute const& gltf_attribute = gltf_primitive.attributes[k];
+						std::string const& attr_name = gltf_attribute.name;
+
+						auto ReadAttributeData = [&]<typename T>(std::vector<T>& stream, const Char* stream_name)
+						{
+							if (!attr_name.compare(stream_name))
+							{
+								stream.resize(gltf_attribute.data->count);
+								DecodeAttribute(gltf_attribute.data, stream.data());
+							}
+						};
+						ReadAttributeData(mesh_data.positions_stream, "POSITION");
+						ReadAttributeData(mesh_data.normals_stream, "NORMAL");
+						ReadAttributeData(mesh_data.tangents_stream, "TANGENT");
+						ReadAttributeData(mesh_data.uvs_stream, "TEXCOORD_0");
+					}
+					primitives.push_back(primitive_count++);
+				}
+			}
+		}
+
+		//reused by every primitive a worker processes during one import
+		struct MeshProcessingScratch
+		{
+			std::vector<Uint32> remap;
+			std::vector<Uint32> simplified_indices;
+			std::vector<Uint32> sloppy_indices;
+			std::vector<Uint32> meshlet_vertices;
+			std::vector<Uchar> meshlet_triangles;
+			std::vector<meshopt_Meshlet> meshlets;
+		};
+
+		void BuildMeshlets(MeshLODData& lod, std::vector<Vector3> const& positions_stream, MeshProcessingScratch& scratch)
+		{
+			Uint64 const vertex_count = positions_stream.size();
+			Uint64 const max_meshlets = meshopt_buildMeshletsBound(lod.indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+			std::vector<Uint32>& meshlet_vertices = scratch.meshlet_vertices;
+			std::vector<Uchar>& meshlet_triangles = scratch.meshlet_triangles;
+			std::vector<meshopt_Meshlet>& meshlets = scratch.meshlets;
+			meshlet_vertices.resize(max_meshlets * MESHLET_MAX_VERTICES);
+			meshlet_triangles.resize(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
+			meshlets.resize(max_meshlets);
+
+			Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+				lod.indices.data(), lod.indices.size(), &positions_stream[0].x, vertex_count, sizeof(Vector3),
+				MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
+
+			meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
+			meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+			meshlets.resize(meshlet_count);
+
+			lod.meshlets.resize(meshlet_count);
+			lod.meshlet_vertices.assign(meshlet_vertices.begin(), meshlet_vertices.begin() + last.vertex_offset + last.vertex_count);
+			lod.meshlet_triangles.resize(meshlet_triangles.size() / 3);
+
+			Uint32 triangle_offset = 0;
+			for (Uint64 i = 0; i < meshlet_count; ++i)
+			{
+				meshopt_Meshlet const& m = meshlets[i];
+				meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&lod.meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
+					m.triangle_count, reinterpret_cast<Float const*>(positions_stream.data()), vertex_count, sizeof(Vector3));
+
+				Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
+				for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
+				{
+					MeshletTriangle& tri = lod.meshlet_triangles[triangle_idx + triangle_offset];
+					tri.V0 = *src_triangles++;
+					tri.V1 = *src_triangles++;
+					tri.V2 = *src_triangles++;
+				}
+
+				Meshlet& meshlet = lod.meshlets[i];
+				std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
+
+				meshlet.radius = meshopt_bounds.radius;
+				meshlet.vertex_count = m.vertex_count;
+				meshlet.triangle_count = m.triangle_count;
+				meshlet.vertex_offset = m.vertex_offset;
+				meshlet.triangle_offset = triangle_offset;
+				triangle_offset += m.triangle_count;
+
+			}
+			lod.meshlet_triangles.resize(triangle_offset);
+		}
+
+		//every LOD is simplified from the base LOD and targets half the triangles of the previous one while indexing the same vertices,
+		//primitives the topology preserving simplifier cannot reduce enough, e.g. because of many attribute seams, fall back to sloppy simplification
+		void SimplifyMeshData(MeshData& mesh_data, ModelParameters const& params, MeshProcessingScratch& scratch)
+		{
+			if (mesh_data.topology != GfxPrimitiveTopology::TriangleList) return;
+
+			Float const* positions = &mesh_data.positions_stream[0].x;
+			Uint64 const vertex_count = mesh_data.positions_stream.size();
+			Float const error_scale = meshopt_simplifyScale(positions, vertex_count, sizeof(Vector3));
+			std::vector<Uint32>& simplified_indices = scratch.simplified_indices;
+			std::vector<Uint32>& sloppy_indices = scratch.sloppy_indices;
+			for (Uint32 lod_index = 1; lod_index < std::min(params.lod_count, SUBMESH_MAX_LODS); ++lod_index)
+			{
+				std::vector<Uint32> const& base_indices = mesh_data.lods[0].indices;
+				Uint64 const previous_index_count = mesh_data.lods.back().indices.size();
+				Float const previous_error = mesh_data.lods.back().error;
+				Uint64 const target_index_count = (base_indices.size() >> lod_index) / 3 * 3;
+				Float const target_error = params.lod_error * lod_index;
+
+				simplified_indices.resize(base_indices.size());
+				Float result_error = 0.0f;
+				Uint64 index_count = meshopt_simplify(simplified_indices.data(), base_indices.data(), base_indices.size(), positions, vertex_count, sizeof(Vector3),
+					target_index_count, target_error, 0, &result_error);
+				if (index_count > target_index_count + target_index_count / 2)
+				{
+					sloppy_indices.resize(base_indices.size());
+					Float sloppy_error = 0.0f;
+					Uint64 const sloppy_index_count = meshopt_simplifySloppy(sloppy_indices.data(), base_indices.data(), base_indices.size(), positions, vertex_count, sizeof(Vector3),
+						target_index_count, target_error, &sloppy_error);
+					if (sloppy_index_count > 0 && sloppy_index_count < index_count)
+					{
+						std::swap(simplified_indices, sloppy_indices);
+						index_count = sloppy_index_count;
+						result_error = sloppy_error;
+					}
+				}
+				//LODs that barely reduce the previous one are not worth their memory and the chain cannot get further within the error
+				if (index_count == 0 || index_count * 10 > previous_index_count * 9) break;
+
+				MeshLODData& lod = mesh_data.lods.emplace_back();
+				lod.indices.assign(simplified_indices.begin(), simplified_indices.begin() + index_count);
+				lod.error = std::max(result_error * error_scale, previous_error);
+				meshopt_optimizeVertexCache(lod.indices.data(), lod.indices.data(), lod.indices.size(), vertex_count);
+			}
+		}
+
+		//the bounding box is grown on flat axes first, it is the quantization box and ray tracing needs an invertible dequantization
+		void CompressVertexStreams(MeshData& mesh_data)
+		{
+			Vector3 extents(mesh_data.bounding_box.Extents);
+			Float const min_extent = std::max(std::max({ extents.x, extents.y, extents.z }) * 1e-3f, 1e-4f);
+			extents = Vector3::Max(extents, Vector3(min_extent));
+			mesh_data.bounding_box.Extents = extents;
+			Vector3 const center(mesh_data.bounding_box.Center);
+
+			Uint64 const vertex_count = mesh_data.positions_stream.size();
+			mesh_data.compressed_positions_stream.resize(vertex_count);
+			mesh_data.compressed_normals_stream.resize(vertex_count);
+			mesh_data.compressed_tangents_stream.resize(vertex_count);
+			mesh_data.compressed_uvs_stream.resize(vertex_count);
+
+			VertexCompressionError& error = mesh_data.compression_error;
+			for (Uint64 i = 0; i < vertex_count; ++i)
+			{
+				Vector3 const& position = mesh_data.positions_stream[i];
+				mesh_data.compressed_positions_stream[i] = PackPositionSnorm16x4(position, center, extents);
+				Vector3 const position_error = UnpackPositionSnorm16x4(mesh_data.compressed_positions_stream[i], center, extents) - position;
+				error.position = std::max({ error.position, std::abs(position_error.x), std::abs(position_error.y), std::abs(position_error.z) });
+
+				Vector3 normal = mesh_data.normals_stream[i];
+				normal.Normalize();
+				mesh_data.compressed_normals_stream[i] = PackNormalOctahedron16x2(normal);
+				if (normal != Vector3::Zero)
+				{
+					error.normal = std::max(error.normal, GetAngleInDegrees(normal, UnpackNormalOctahedron16x2(mesh_data.compressed_normals_stream[i])));
+				}
+
+				Vector4 const& tangent = mesh_data.tangents_stream[i];
+				Vector3 tangent_direction(tangent.x, tangent.y, tangent.z);
+				tangent_direction.Normalize();
+				mesh_data.compressed_tangents_stream[i] = PackTangentOctahedron16x15(Vector4(tangent_direction.x, tangent_direction.y, tangent_direction.z, tangent.w));
+				if (tangent_direction != Vector3::Zero)
+				{
+					Vector4 const decoded_tangent = UnpackTangentOctahedron16x15(mesh_data.compressed_tangents_stream[i]);
+					error.tangent = std::max(error.tangent, GetAngleInDegrees(tangent_direction, Vector3(decoded_tangent.x, decoded_tangent.y, decoded_tangent.z)));
+				}
+
+				Vector2 const& uv = mesh_data.uvs_stream[i];
+				mesh_data.compressed_uvs_stream[i] = PackTwoFloatsToUint32(uv.x, uv.y);
+				Vector2 const uv_error = UnpackTwoFloatsFromUint32(mesh_data.compressed_uvs_stream[i]) - uv;
+				error.uv = std::max({ error.uv, std::abs(uv_error.x), std::abs(uv_error.y) });
+			}
+		}
+
+		void ProcessMeshData(MeshData& mesh_data, ModelParameters const& params, MeshProcessingScratch& scratch)
+		{
+			Uint64 vertex_count = mesh_data.positions_stream.size();
+			std::vector<Uint32>& indices = mesh_data.lods[0].indices;
+
+			Bool has_tangents = !mesh_data.tangents_stream.empty();
+			if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
+			if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
+			if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
+
+			if (!has_tangents)
+			{
+				ComputeTangentFrame(indices.data(), indices.size(), mesh_data.positions_stream.data(),
+					mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
+			}
+
+			meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertex_count);
+			meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
+			std::vector<Uint32>& remap = scratch.remap;
+			remap.resize(vertex_count);
+			meshopt_optimizeVertexFetchRemap(&remap[0], indices.data(), indices.size(), vertex_count);
+			meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
+
+			SimplifyMeshData(mesh_data, params, scratch);
+			for (MeshLODData& lod : mesh_data.lods) BuildMeshlets(lod, mesh_data.positions_stream, scratch);
+			mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
+			if (params.compress_vertices) CompressVertexStreams(mesh_data);
+		}
+
+		Bool CookModel_GLTF(ModelParameters const& params, std::vector<Uint8>& cooked_data)
+		{
+			Timer timer;
+			cgltf_options options{};
+			cgltf_data* gltf_data = nullptr;
+			cgltf_result result = cgltf_parse_file(&options, params.model_path.c_str(), &gltf_data);
+			if (result != cgltf_result_success)
+			{
+				ADRIA_LOG(WARNING, "GLTF - Failed to load '%s'", params.model_path.c_str());
+				return false;
+			}
+			result = cgltf_load_buffers(&options, gltf_data, params.model_path.c_str());
+			if (result != cgltf_result_success)
+			{
+				ADRIA_LOG(WARNING, "GLTF - Failed to load buffers '%s'", params.model_path.c_str());
+				cgltf_free(gltf_data);
+				return false;
+			}
+
+			std::vector<Char> strings;
+			std::vector<CookedMaterial> cooked_materials;
+			CookMaterials(gltf_data, params, cooked_materials, strings);
+
+			std::unordered_map<cgltf_mesh const*, std::vector<Int32>> mesh_primitives_map; //mesh -> vector of primitive indices
+			std::vector<MeshData> mesh_datas{};
+			ReadMeshData(gltf_data, params, mesh_datas, mesh_primitives_map);
+
+			//primitives are independent until their streams are copied, every worker keeps one scratch for the primitives it takes
+			//and the largest primitives are taken first so a big one does not end up last on a single thread
+			std::vector<Uint64> processing_order(mesh_datas.size());
+			std::iota(processing_order.begin(), processing_order.end(), 0);
+			std::stable_sort(processing_order.begin(), processing_order.end(), [&mesh_datas](Uint64 lhs, Uint64 rhs)
+				{
+					return mesh_datas[lhs].lods[0].indices.size() > mesh_datas[rhs].lods[0].indices.size();
+				});
+			std::atomic<Uint64> next_mesh_data = 0;
+			g_ThreadPool.ParallelFor(g_ThreadPool.GetThreadCount(), 1, [&](Uint64, Uint64)
+				{
+					MeshProcessingScratch scratch{};
+					for (Uint64 i = next_mesh_data++; i < processing_order.size(); i = next_mesh_data++)
+					{
+						ProcessMeshData(mesh_datas[processing_order[i]], params, scratch);
+					}
+				});
+
+			//offsets are a prefix sum over the primitives in glTF order, so the cooked model does not depend on the thread count
+			Uint64 total_buffer_size = 0;
+			auto AllocateStream = [&total_buffer_size]<typename T>(std::vector<T> const& stream)
+			{
+				Uint32 const offset = (Uint32)total_buffer_size;
+				total_buffer_size += Align(stream.size() * sizeof(T), 16);
+				return offset;
+			};
+
+			std::vector<SubMeshGPU> submeshes(mesh_datas.size());
+			for (Uint64 i = 0; i < mesh_datas.size(); ++i)
+			{
+				MeshData const& mesh_data = mesh_datas[i];
+				SubMeshGPU& submesh = submeshes[i];
+				submesh.buffer_address = 0;
+
+				submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
+				submesh.vertex_format = params.compress_vertices ? MeshVertexFormat::Compressed : MeshVertexFormat::Full;
+				if (params.compress_vertices)
+				{
+					submesh.positions_offset = AllocateStream(mesh_data.compressed_positions_stream);
+					submesh.uvs_offset = AllocateStream(mesh_data.compressed_uvs_stream);
+					submesh.normals_offset = AllocateStream(mesh_data.compressed_normals_stream);
+					submesh.tangents_offset = AllocateStream(mesh_data.compressed_tangents_stream);
+				}
+				else
+				{
+					submesh.positions_offset = AllocateStream(mesh_data.positions_stream);
+					submesh.uvs_offset = AllocateStream(mesh_data.uvs_stream);
+					submesh.normals_offset = AllocateStream(mesh_data.normals_stream);
+					submesh.tangents_offset = AllocateStream(mesh_data.tangents_stream);
+				}
+
+				//the indices and meshlets of every LOD follow the vertex streams they share
+				submesh.lod_count = (Uint32)mesh_data.lods.size();
+				for (Uint32 lod_index = 0; lod_index < submesh.lod_count; ++lod_index)
+				{
+					MeshLODData const& lod_data = mesh_data.lods[lod_index];
+					SubMeshLOD& lod = submesh.lods[lod_index];
+					lod.indices_offset = AllocateStream(lod_data.indices);
+					lod.indices_count = (Uint32)lod_data.indices.size();
+					lod.meshlet_offset = AllocateStream(lod_data.meshlets);
+					lod.meshlet_vertices_offset = AllocateStream(lod_data.meshlet_vertices);
+					lod.meshlet_triangles_offset = AllocateStream(lod_data.meshlet_triangles);
+					lod.meshlet_count = (Uint32)lod_data.meshlets.size();
+					lod.error = lod_data.error;
+				}
+
+				submesh.bounding_box = mesh_data.bounding_box;
+				submesh.topology = mesh_data.topology;
+				submesh.material_index = mesh_data.material_index;
+			}
+
+			if (params.compress_vertices)
+			{
+				VertexCompressionError compression_error{};
+				for (MeshData const& mesh_data : mesh_datas) compression_error.Merge(mesh_data.compression_error);
+				ADRIA_LOG(INFO, "GLTF Model %s vertex compression error: position %f, normal %.4f deg, tangent %.4f deg, uv %f", params.model_path.c_str(),
+					compression_error.position, compression_error.normal, compression_error.tangent, compression_error.uv);
+			}
+
+			std::vector<Uint8> geometry(total_buffer_size);
+			g_ThreadPool.ParallelFor(mesh_datas.size(), 1, [&](Uint64 begin, Uint64 end)
+				{
+					auto CopyData = [&geometry]<typename T>(std::vector<T> const& _data, Uint32 offset)
+					{
+						if (!_data.empty()) memcpy(geometry.data() + offset, _data.data(), _data.size() * sizeof(T));
+					};
+					for (Uint64 i = begin; i < end; ++i)
+					{
+						MeshData const& mesh_data = mesh_datas[i];
+						SubMeshGPU const& submesh = submeshes[i];
+						if (submesh.vertex_format == MeshVertexFormat::Compressed)
+						{
+							CopyData(mesh_data.compressed_positions_stream, submesh.positions_offset);
+							CopyData(mesh_data.compressed_uvs_stream, submesh.uvs_offset);
+							CopyData(mesh_data.compressed_normals_stream, submesh.normals_offset);
+							CopyData(mesh_data.compressed_tangents_stream, submesh.tangents_offset);
+						}
+						else
+						{
+							CopyData(mesh_data.positions_stream, submesh.positions_offset);
+							CopyData(mesh_data.uvs_stream, submesh.uvs_offset);
+							CopyData(mesh_data.normals_stream, submesh.normals_offset);
+							CopyData(mesh_data.tangents_stream, submesh.tangents_offset);
+						}
+						for (Uint32 lod_index = 0; lod_index < submesh.lod_count; ++lod_index)
+						{
+							MeshLODData const& lod_data = mesh_data.lods[lod_index];
+							SubMeshLOD const& lod = submesh.lods[lod_index];
+							CopyData(lod_data.indices, lod.indices_offset);
+							CopyData(lod_data.meshlets, lod.meshlet_offset);
+							CopyData(lod_data.meshlet_vertices, lod.meshlet_vertices_offset);
+							CopyData(lod_data.meshlet_triangles, lod.meshlet_triangles_offset);
+						}
+					}
+				});
+
+			std::vector<CookedInstance> instances;
+			std::vector<CookedLight> lights;
+			for (Uint64 i = 0; i < gltf_data->nodes_count; ++i)
+			{
+				cgltf_node const& gltf_node = gltf_data->nodes[i];
+
+				Matrix local_to_world;
+				cgltf_node_transform_world(&gltf_node, &local_to_world.m[0][0]);
+
+				if (gltf_node.mesh)
+				{
+					for (Int32 primitive : mesh_primitives_map[gltf_node.mesh])
+					{
+						CookedInstance& instance = instances.emplace_back();
+						instance.local_to_world = local_to_world;
+						instance.submesh_index = primitive;
+					}
+				}
+
+				if (gltf_node.light)
+				{
+					cgltf_light const& gltf_light = *gltf_node.light;
+					CookedLight light{};
+					light.local_to_world = local_to_world;
+					switch (gltf_light.type)
+					{
+					case cgltf_light_type_directional:
+						light.type = LightType::Directional;
+						break;
+					case cgltf_light_type_point:
+						light.type = LightType::Point;
+						break;
+					case cgltf_light_type_spot:
+						light.type = LightType::Spot;
+						break;
+					default:
+						continue;
+					}
+					memcpy(light.color, gltf_light.color, sizeof(light.color));
+					light.intensity = gltf_light.intensity;
+					light.range = gltf_light.range;
+					light.inner_cone_angle = gltf_light.spot_inner_cone_angle;
+					light.outer_cone_angle = gltf_light.spot_outer_cone_angle;
+					lights.push_back(light);
+				}
+			}
+
+			//buffers stored next to the model are part of the source hash
+			std::vector<std::string> dependencies;
+			std::vector<Uint32> dependency_names;
+			for (Uint64 i = 0; i < gltf_data->buffers_count; ++i)
+			{
+				cgltf_buffer const& gltf_buffer = gltf_data->buffers[i];
+				if (!gltf_buffer.uri || strncmp(gltf_buffer.uri, "data:", 5) == 0) continue;
+
+				std::string uri = gltf_buffer.uri;
+				uri.resize(cgltf_decode_uri(uri.data()));
+				std::string const& dependency = dependencies.emplace_back((fs::path(params.model_path).parent_path() / uri).string());
+				dependency_names.push_back(AddString(strings, dependency));
+			}
+			cgltf_free(gltf_data);
+
+			CookedModelHeader header{};
+			header.magic = CookedModelHeader::MAGIC;
+			header.version = CookedModelHeader::VERSION;
+			header.submesh_stride = sizeof(SubMeshGPU);
+			header.material_stride = sizeof(CookedMaterial);
+			header.flags = GetCookedModelFlags(params);
+			header.submesh_count = (Uint32)submeshes.size();
+			header.material_count = (Uint32)cooked_materials.size();
+			header.instance_count = (Uint32)instances.size();
+			header.light_count = (Uint32)lights.size();
+			header.dependency_count = (Uint32)dependency_names.size();
+			header.lod_count = params.lod_count;
+			header.lod_error = params.lod_error;
+			//the stamp is taken first, a source that changes while it is hashed is hashed again on the next load
+			ModelSourceStamp source_stamp{};
+			if (!GetModelSourceStamp(params.model_path, dependencies, source_stamp) || !HashModelSource(params.model_path, dependencies, header.source_hash))
+			{
+				ADRIA_LOG(WARNING, "GLTF - Failed to hash '%s'", params.model_path.c_str());
+				return false;
+			}
+			header.source_size = source_stamp.size;
+			header.source_write_time = source_stamp.write_time;
+
+			cooked_data.clear();
+			cooked_data.resize(sizeof(CookedModelHeader));
+			header.submeshes_offset = AppendSection(cooked_data, submeshes.data(), submeshes.size());
+			header.materials_offset = AppendSection(cooked_data, cooked_materials.data(), cooked_materials.size());
+			header.instances_offset = AppendSection(cooked_data, instances.data(), instances.size());
+			header.lights_offset = AppendSection(cooked_data, lights.data(), lights.size());
+			header.dependencies_offset = AppendSection(cooked_data, dependency_names.data(), dependency_names.size());
+			header.strings_offset = AppendSection(cooked_data, strings.data(), strings.size());
+			header.strings_size = strings.size();
+			header.geometry_offset = AppendSection(cooked_data, geometry.data(), geometry.size());
+			header.geometry_size = geometry.size();
+			header.file_size = cooked_data.size();
+			memcpy(cooked_data.data(), &header, sizeof(header));
+
+			ADRIA_LOG(INFO, "GLTF Model %s cooked in %.2f s", params.model_path.c_str(), timer.ElapsedInSeconds());
+			return true;
+		}
+	}
+
+	struct CookedModel::MappedFile
+	{
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+		Uint8 const* view = nullptr;
+		Uint64 size = 0;
+
+		~MappedFile()
+		{
+			if (view) UnmapViewOfFile(view);
+			if (mapping) CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		}
+
+		Bool Open(std::string const& path)
+		{
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER file_size{};
+			if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) return false;
+			size = (Uint64)file_size.QuadPart;
+
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) return false;
+			view = static_cast<Uint8 const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			return view != nullptr;
+		}
+	};
+
+	CookedModel::CookedModel() = default;
+	CookedModel::~CookedModel() = default;
+
+	Bool CookedModel::Load(ModelParameters const& params)
+	{
+		std::string const cooked_model_path = GetCookedModelPath(params);
+		ModelSourceStamp source_stamp{};
+		Bool source_touched = false;
+		mapped_file = std::make_unique<MappedFile>();
+		if (mapped_file->Open(cooked_model_path) && IsCookedModelValid(mapped_file->view, mapped_file->size, params, source_stamp, source_touched))
+		{
+			if (source_touched)
+			{
+				//the mapping has to be closed before the stamp can be written
+				mapped_file = std::make_unique<MappedFile>();
+				if (!UpdateCookedModelSourceStamp(cooked_model_path, source_stamp)) ADRIA_LOG(WARNING, "Failed to update cooked model '%s'", cooked_model_path.c_str());
+				if (!mapped_file->Open(cooked_model_path)) return false;
+			}
+			data = mapped_file->view;
+			return true;
+		}
+		//the mapping has to be closed before the stale cooked model can be replaced
+		mapped_file.reset();
+
+		if (!CookModel_GLTF(params, cooked_data)) return false;
+		if (!WriteCookedModel(cooked_model_path, cooked_data))
+		{
+			ADRIA_LOG(WARNING, "Failed to write cooked model '%s'", cooked_model_path.c_str());
+		}
+		data = cooked_data.data();
+		return true;
+	}
+
+	std::span<SubMeshGPU const> CookedModel::GetSubMeshes() const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return std::span(reinterpret_cast<SubMeshGPU const*>(data + header.submeshes_offset), header.submesh_count);
+	}
+
+	std::span<CookedMaterial const> CookedModel::GetMaterials() const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return std::span(reinterpret_cast<CookedMaterial const*>(data + header.materials_offset), header.material_count);
+	}
+
+	std::span<CookedInstance const> CookedModel::GetInstances() const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return std::span(reinterpret_cast<CookedInstance const*>(data + header.instances_offset), header.instance_count);
+	}
+
+	std::span<CookedLight const> CookedModel::GetLights() const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return std::span(reinterpret_cast<CookedLight const*>(data + header.lights_offset), header.light_count);
+	}
+
+	std::span<Uint8 const> CookedModel::GetGeometry() const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return std::span(data + header.geometry_offset, header.geometry_size);
+	}
+
+	Char const* CookedModel::GetString(Uint32 offset) const
+	{
+		CookedModelHeader const& header = *reinterpret_cast<CookedModelHeader const*>(data);
+		return reinterpret_cast<Char const*>(data + header.strings_offset) + offset;
+	}
+
+	Bool CookModel(ModelParameters const& params)
+	{
+		std::string const cooked_model_path = GetCookedModelPath(params);
+		ModelSourceStamp source_stamp{};
+		Bool source_touched = false;
+		Bool cooked_model_valid = false;
+		{
+			CookedModel::MappedFile mapped_file;
+			cooked_model_valid = mapped_file.Open(cooked_model_path) && IsCookedModelValid(mapped_file.view, mapped_file.size, params, source_stamp, source_touched);
+		}
+		if (cooked_model_valid)
+		{
+			if (source_touched && !UpdateCookedModelSourceStamp(cooked_model_path, source_stamp)) ADRIA_LOG(WARNING, "Failed to update cooked model '%s'", cooked_model_path.c_str());
+			return true;
+		}
+
+		std::vector<Uint8> cooked_data;
+		if (!CookModel_GLTF(params, cooked_data)) return false;
+		if (!WriteCookedModel(cooked_model_path, cooked_data))
+		{
+			ADRIA_LOG(WARNING, "Failed to write cooked model '%s'", cooked_model_path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	Bool ImportModel(ModelParameters const& params, std::vector<Uint8>& cooked_data)
+	{
+		return CookModel_GLTF(params, cooked_data);
+	}
+
+	Bool CookSceneModels()
+	{
+		Bool success = true;
+		std::error_code error;
+		for (auto const& entry : fs::directory_iterator(paths::ScenesDir, error))
+		{
+			if (entry.path().extension() != ".json") continue;
+
+			SceneConfig scene_config{};
+			if (!ParseSceneConfig(entry.path().string(), scene_config, false))
+			{
+				success = false;
+				continue;
+			}
+			//triangles every instance of the scene draws at each LOD, instances without that LOD count their coarsest one
+			Uint64 lod_triangles[SUBMESH_MAX_LODS] = {};
+			Uint64 geometry_size = 0;
+			Uint64 vertex_streams_size = 0;
+			Uint64 full_vertex_streams_size = 0;
+			for (ModelParameters const& model_params : scene_config.scene_models)
+			{
+				//Load cooks stale models itself, so every model is validated once
+				CookedModel cooked_model;
+				if (!cooked_model.Load(model_params))
+				{
+					success = false;
+					continue;
+				}
+				std::span<SubMeshGPU const> submeshes = cooked_model.GetSubMeshes();
+				for (SubMeshGPU const& submesh : submeshes)
+				{
+					vertex_streams_size += submesh.vertices_count * GetVertexStride(submesh.vertex_format);
+					full_vertex_streams_size += submesh.vertices_count * GetVertexStride(MeshVertexFormat::Full);
+				}
+				geometry_size += cooked_model.GetGeometry().size();
+				for (CookedInstance const& instance : cooked_model.GetInstances())
+				{
+					SubMeshGPU const& submesh = submeshes[instance.submesh_index];
+					for (Uint32 lod_index = 0; lod_index < SUBMESH_MAX_LODS; ++lod_index)
+					{
+						lod_triangles[lod_index] += submesh.lods[std::min(lod_index, submesh.lod_count - 1)].indices_count / 3;
+					}
+				}
+			}
+
+			std::string lod_report = std::format("LOD0 {} triangles", lod_triangles[0]);
+			for (Uint32 lod_index = 1; lod_index < SUBMESH_MAX_LODS; ++lod_index)
+			{
+				Float const reduction = lod_triangles[0] > 0 ? 100.0f * (1.0f - (Float)lod_triangles[lod_index] / lod_triangles[0]) : 0.0f;
+				lod_report += std::format(", LOD{} {} (-{:.1f}%)", lod_index, lod_triangles[lod_index], reduction);
+			}
+			ADRIA_LOG(INFO, "Cooked models of scene %s: %s", entry.path().filename().string().c_str(), lod_report.c_str());
+			ADRIA_LOG(INFO, "Geometry memory of scene %s: %.2f MB, vertex streams %.2f MB, %.2f MB with full vertices", entry.path().filename().string().c_str(),
+				geometry_size / 1048576.0f, vertex_streams_size / 1048576.0f, full_vertex_streams_size / 1048576.0f);
+		}
+		return success && !error;
+	}
+}
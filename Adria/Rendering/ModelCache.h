@@ -0,0 +1,85 @@
+#pragma once
+#include <span>
+#include "Components.h"
+
+namespace adria
+{
+	struct ModelParameters;
+
+	enum CookedTextureSlot : Uint8
+	{
+		CookedTextureSlot_Albedo,
+		CookedTextureSlot_MetallicRoughness,
+		CookedTextureSlot_Normal,
+		CookedTextureSlot_Emissive,
+		CookedTextureSlot_Anisotropy,
+		CookedTextureSlot_ClearCoat,
+		CookedTextureSlot_ClearCoatRoughness,
+		CookedTextureSlot_ClearCoatNormal,
+		CookedTextureSlot_Count
+	};
+
+	inline constexpr Uint32 INVALID_COOKED_STRING = Uint32(-1);
+
+	struct CookedMaterial
+	{
+		//texture handles hold the defaults for slots without a texture
+		Material material;
+		//offsets into the string table of texture paths relative to the textures path of the model
+		Uint32 texture_names[CookedTextureSlot_Count];
+	};
+
+	struct CookedInstance
+	{
+		Matrix local_to_world;
+		Uint32 submesh_index;
+	};
+
+	struct CookedLight
+	{
+		Matrix local_to_world;
+		LightType type;
+		Float color[3];
+		Float intensity;
+		Float range;
+		Float inner_cone_angle;
+		Float outer_cone_angle;
+	};
+
+	//Result of importing a glTF model: geometry streams already in the SubMeshGPU layout, materials, instances and lights.
+	//Cooked models are written to the model cache directory and memory mapped by later loads while the source is unchanged,
+	//the source is only hashed when its size matches but its write times do not.
+	class CookedModel
+	{
+		friend Bool CookModel(ModelParameters const&);
+		struct MappedFile;
+
+	public:
+		CookedModel();
+		ADRIA_NONCOPYABLE_NONMOVABLE(CookedModel)
+		~CookedModel();
+
+		//Maps the cached model, the model is cooked and written to the cache first if it is missing or stale
+		Bool Load(ModelParameters const& params);
+
+		std::span<SubMeshGPU const> GetSubMeshes() const;
+		std::span<CookedMaterial const> GetMaterials() const;
+		std::span<CookedInstance const> GetInstances() const;
+		std::span<CookedLight const> GetLights() const;
+		std::span<Uint8 const> GetGeometry() const;
+		Char const* GetString(Uint32 offset) const;
+
+	private:
+		std::unique_ptr<MappedFile> mapped_file;
+		std::vector<Uint8> cooked_data;
+		Uint8 const* data = nullptr;
+	};
+
+	//Cooks the model if its cached version is missing or stale
+	Bool CookModel(ModelParameters const& params);
+	//Imports the model into cooked_data without reading or writing the model cache
+	Bool ImportModel(ModelParameters const& params, std::vector<Uint8>& cooked_data);
+	//Cooks the models of every scene in the scenes directory and logs the triangles per LOD and the geometry memory of each scene,
+	//used by the -cookscenes command line option
+	Bool CookSceneModels();
+}
@@ -81,7 +81,7 @@ namespace adria
 					cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 					cmd_list->SetRootConstants(1, constants);
 					cmd_list->Dispatch(FFT_RESOLUTION / 16, FFT_RESOLUTION / 16, 1);
-				}, RGPassType::Compute, RGPassFlags::None);
+				}, RGPassType::ComputeAsync, RGPassFlags::None);
 		}
 
 		struct PhasePassData
@@ -119,7 +119,7 @@ namespace adria
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 				cmd_list->SetRootConstants(1, constants);
 				cmd_list->Dispatch(FFT_RESOLUTION / 16, FFT_RESOLUTION / 16, 1);
-			}, RGPassType::Compute, RGPassFlags::None);
+			}, RGPassType::ComputeAsync, RGPassFlags::None);
 		pong_phase = !pong_phase;
 
 		struct SpectrumPassData
@@ -163,7 +163,7 @@ namespace adria
 				cmd_list->SetRootConstants(1, constants);
 				cmd_list->Dispatch(FFT_RESOLUTION / 16, FFT_RESOLUTION / 16, 1);
 
-			}, RGPassType::Compute, RGPassFlags::None);
+			}, RGPassType::ComputeAsync, RGPassFlags::None);
 
 		struct FFTConstants
 		{
@@ -209,7 +209,7 @@ namespace adria
 					cmd_list->SetRootConstants(1, fft_constants);
 					cmd_list->Dispatch(FFT_RESOLUTION, 1, 1);
 
-				}, RGPassType::Compute, RGPassFlags::None);
+				}, RGPassType::ComputeAsync, RGPassFlags::None);
 			pong_spectrum = !pong_spectrum;
 		}
 
@@ -249,7 +249,7 @@ namespace adria
 					cmd_list->SetRootConstants(1, fft_constants);
 					cmd_list->Dispatch(FFT_RESOLUTION, 1, 1);
 
-				}, RGPassType::Compute, RGPassFlags::None);
+				}, RGPassType::ComputeAsync, RGPassFlags::None);
 			pong_spectrum = !pong_spectrum;
 		}
 
@@ -295,7 +295,7 @@ namespace adria
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 				cmd_list->SetRootConstants(1, constants);
 				cmd_list->Dispatch(FFT_RESOLUTION / 16, FFT_RESOLUTION / 16, 1);
-			}, RGPassType::Compute, RGPassFlags::None);
+			}, RGPassType::ComputeAsync, RGPassFlags::None);
 
 		struct OceanDrawPassData
 		{
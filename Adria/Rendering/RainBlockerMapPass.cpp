@@ -85,10 +85,10 @@ namespace adria
 					} constants{ .instance_id = batch.instance_id };
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->lods[0].indices_offset, batch.submesh->lods[0].indices_count);
 					cmd_list->SetTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
-					cmd_list->DrawIndexed(batch.submesh->indices_count);
+					cmd_list->DrawIndexed(batch.submesh->lods[0].indices_count);
 				}
 
 			}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
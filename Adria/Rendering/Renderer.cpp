@@ -17,6 +17,7 @@
 #include "Graphics/GfxTracyProfiler.h"
 #include "RenderGraph/RenderGraph.h"
 #include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
 #include "Utilities/Random.h"
 #include "Utilities/ImageWrite.h"
 #include "Math/Constants.h"
@@ -32,11 +33,17 @@ namespace adria
 {
 	static TAutoConsoleVariable<int>  LightingPath("r.LightingPath", 0, "0 - Deferred, 1 - Tiled Deferred, 2 - Clustered Deferred, 3 - Path Tracing");
 	static TAutoConsoleVariable<int>  VolumetricPath("r.VolumetricPath", 1, "0 - None, 1 - 2D Raymarching, 2 - Fog Volume");
+	static TAutoConsoleVariable<Bool> ParallelSceneUpdate("r.ParallelSceneUpdate", true, "Split scene buffer packing and culling into chunks processed on the thread pool");
+	static TAutoConsoleVariable<Bool> MeshLODs("r.MeshLODs", true, "Select the LOD of visible meshes by their projected simplification error");
+	static TAutoConsoleVariable<Float> MeshLODPixelError("r.MeshLODs.PixelError", 1.0f, "Largest simplification error in pixels a selected mesh LOD may project to");
+
+	//culling chunks must be multiples of 64 so that each chunk owns whole visibility mask words
+	static constexpr Uint64 CULLED_BOXES_PER_CHUNK = 1024;
 
 	Renderer::Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height) : reg(reg), gfx(gfx), resource_pool(gfx),
 		accel_structure(gfx), camera(nullptr), display_width(width), display_height(height), render_width(width), render_height(height),
 		backbuffer_count(gfx->GetBackbufferCount()), backbuffer_index(gfx->GetBackbufferIndex()), final_texture(nullptr),
-		frame_cbuffer(gfx, backbuffer_count), gpu_driven_renderer(reg, gfx, width, height),
+		frame_cbuffer(gfx, backbuffer_count), scene_instances(reg), gpu_driven_renderer(reg, gfx, width, height),
 		gbuffer_pass(reg, gfx, width, height),
 		sky_pass(reg, gfx, width, height), deferred_lighting_pass(gfx, width, height), 
 		volumetric_lighting_pass(gfx, width, height), volumetric_fog_pass(gfx, reg, width, height),
@@ -57,6 +64,7 @@ namespace adria
 		postprocessor.AddRenderResolutionChangedCallback(RenderResolutionChangedDelegate::CreateMember(&Renderer::OnRenderResolutionChanged, *this));
 		shadow_renderer.GetShadowTextureRenderedEvent().AddMember(&DeferredLightingPass::OnShadowTextureRendered, deferred_lighting_pass);
 		shadow_renderer.GetShadowTextureRenderedEvent().AddMember(&VolumetricLightingPass::OnShadowTextureRendered, volumetric_lighting_pass);
+		shadow_renderer.SetInstanceBounds(&scene_instances.GetInstanceBounds());
 
 		rain_pass.GetRainEvent().AddMember(&PostProcessor::OnRainEvent, postprocessor);
 		rain_pass.GetRainEvent().AddMember(&GPUDrivenGBufferPass::OnRainEvent, gpu_driven_renderer);
@@ -99,13 +107,18 @@ namespace adria
 	void Renderer::Update(Float dt)
 	{
 		shadow_renderer.SetupShadows(camera);
+		Timer<> cpu_timer;
 		UpdateSceneBuffers();
+		scene_buffers_cpu_time = cpu_timer.MarkInSeconds() * 1000.0f;
 		UpdateFrameConstants(dt);
+		cpu_timer.Mark();
 		CameraFrustumCulling();
+		shadow_renderer.CullShadowCasters(ParallelSceneUpdate.Get());
+		culling_cpu_time = cpu_timer.MarkInSeconds() * 1000.0f;
 	}
 	void Renderer::Render()
 	{
-		RenderGraph render_graph(resource_pool);
+		RenderGraph render_graph(resource_pool, &compile_cache);
 		RGBlackboard& rg_blackboard = render_graph.GetBlackboard();
 		FrameBlackboardData frame_data{};
 		{
@@ -247,8 +260,6 @@ namespace adria
 	void Renderer::UpdateSceneBuffers()
 	{
 		volumetric_lights = 0;
-		for (auto e : reg.view<Batch>()) reg.destroy(e);
-		reg.clear<Batch>();
 
 		std::vector<LightGPU> hlsl_lights{};
 		Uint32 light_index = 0;
@@ -277,105 +288,50 @@ namespace adria
 			if (light.volumetric) ++volumetric_lights;
 		}
 
-		std::vector<MeshGPU> meshes;
-		std::vector<InstanceGPU> instances;
-		std::vector<MaterialGPU> materials;
-		Uint32 instanceID = 0;
+		scene_instances.Update(ParallelSceneUpdate.Get());
 
-		for (auto mesh_entity : reg.view<Mesh>())
+		//online descriptors live for a single frame, so mesh buffer indices are patched every frame
+		std::vector<MeshGPU>& meshes_gpu = scene_instances.GetMeshes();
+		for (auto const& [mesh_entity, mesh_range] : scene_instances.GetMeshRanges())
 		{
 			Mesh& mesh = reg.get<Mesh>(mesh_entity);
-
 			GfxBuffer* mesh_buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
 			GfxDescriptor mesh_buffer_srv = g_GeometryBufferCache.GetGeometryBufferSRV(mesh.geometry_buffer_handle);
 			GfxDescriptor mesh_buffer_online_srv = gfx->AllocateDescriptorsGPU();
 			gfx->CopyDescriptors(1, mesh_buffer_online_srv, mesh_buffer_srv);
-
-			for (auto const& instance : mesh.instances)
-			{
-				SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
-				Material& material = mesh.materials[submesh.material_index];
-
-				submesh.buffer_address = mesh_buffer->GetGpuAddress();
-
-				entt::entity batch_entity = reg.create();
-				Batch& batch = reg.emplace<Batch>(batch_entity);
-				batch.instance_id = instanceID;
-				batch.alpha_mode = material.alpha_mode;
-				batch.submesh = &submesh;
-				batch.world_transform = instance.world_transform;
-				submesh.bounding_box.Transform(batch.bounding_box, batch.world_transform);
-
-				InstanceGPU& instance_gpu = instances.emplace_back();
-				instance_gpu.instance_id = instanceID;
-				instance_gpu.material_idx = static_cast<Uint32>(materials.size() + submesh.material_index);
-				instance_gpu.mesh_index = static_cast<Uint32>(meshes.size() + instance.submesh_index);
-				instance_gpu.world_matrix = instance.world_transform;
-				instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, instance.world_transform);
-				instance_gpu.bb_origin = submesh.bounding_box.Center;
-				instance_gpu.bb_extents = submesh.bounding_box.Extents;
-
-				++instanceID;
-			}
-			for (auto const& submesh : mesh.submeshes)
+			for (Uint64 i = 0; i < mesh.submeshes.size(); ++i)
 			{
-				MeshGPU& mesh_gpu = meshes.emplace_back();
-				mesh_gpu.buffer_idx = mesh_buffer_online_srv.GetIndex();
-				mesh_gpu.indices_offset = submesh.indices_offset;
-				mesh_gpu.positions_offset = submesh.positions_offset;
-				mesh_gpu.normals_offset = submesh.normals_offset;
-				mesh_gpu.tangents_offset = submesh.tangents_offset;
-				mesh_gpu.uvs_offset = submesh.uvs_offset;
-
-				mesh_gpu.meshlet_offset = submesh.meshlet_offset;
-				mesh_gpu.meshlet_vertices_offset = submesh.meshlet_vertices_offset;
-				mesh_gpu.meshlet_triangles_offset = submesh.meshlet_triangles_offset;
-				mesh_gpu.meshlet_count = submesh.meshlet_count;
-			}
-
-			for (auto const& material : mesh.materials)
-			{
-				MaterialGPU& material_gpu = materials.emplace_back();
-				material_gpu.shading_extension = (Uint32)material.extension;
-				material_gpu.albedo_color = Vector3(material.albedo_color);
-				material_gpu.albedo_idx = (Uint32)material.albedo_texture;
-				material_gpu.roughness_metallic_idx = (Uint32)material.metallic_roughness_texture;
-				material_gpu.metallic_factor = material.metallic_factor;
-				material_gpu.roughness_factor = material.roughness_factor;
-
-				material_gpu.normal_idx = (Uint32)material.normal_texture;
-				material_gpu.emissive_idx = (Uint32)material.emissive_texture;
-				material_gpu.emissive_factor = material.emissive_factor;
-				material_gpu.alpha_cutoff = material.alpha_cutoff;
-
-				material_gpu.anisotropy_idx = material.anisotropy_texture == INVALID_TEXTURE_HANDLE ? -1 : material.anisotropy_texture;
-				material_gpu.anisotropy_strength = material.anisotropy_strength;
-				material_gpu.anisotropy_rotation = material.anisotropy_rotation;
-
-				material_gpu.clear_coat_idx = (Uint32)material.clear_coat_texture;
-				material_gpu.clear_coat_roughness_idx = (Uint32)material.clear_coat_roughness_texture;
-				material_gpu.clear_coat_normal_idx = (Uint32)material.clear_coat_normal_texture;
-				material_gpu.clear_coat = material.clear_coat;
-				material_gpu.clear_coat_roughness = material.clear_coat_roughness;
+				mesh.submeshes[i].buffer_address = mesh_buffer->GetGpuAddress();
+				meshes_gpu[mesh_range.mesh_offset + i].buffer_idx = mesh_buffer_online_srv.GetIndex();
 			}
 		}
 
-		auto CopyBuffer = [&]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer)
+		auto CopyBuffer = [&]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer, Bool full_update = true)
 		{
-			if (data.empty()) return;
+			if (data.empty()) return true;
 			if (!scene_buffer.buffer || scene_buffer.buffer->GetCount() < data.size())
 			{
 				scene_buffer.buffer = gfx->CreateBuffer(StructuredBufferDesc<T>(data.size(), false, true));
 				scene_buffer.buffer_srv = gfx->CreateBufferSRV(scene_buffer.buffer.get());
+				full_update = true;
 			}
-			scene_buffer.buffer->Update(data.data(), data.size() * sizeof(T));
+			if (full_update) scene_buffer.buffer->Update(data.data(), data.size() * sizeof(T));
 			scene_buffer.buffer_srv_gpu = gfx->AllocateDescriptorsGPU();
 			gfx->CopyDescriptors(1, scene_buffer.buffer_srv_gpu, scene_buffer.buffer_srv);
+			return full_update;
 		};
+		std::vector<InstanceGPU> const& instances_gpu = scene_instances.GetInstances();
 		CopyBuffer(hlsl_lights, scene_buffers[SceneBuffer_Light]);
-		CopyBuffer(meshes, scene_buffers[SceneBuffer_Mesh]);
-		CopyBuffer(instances, scene_buffers[SceneBuffer_Instance]);
-		CopyBuffer(materials, scene_buffers[SceneBuffer_Material]);
+		CopyBuffer(meshes_gpu, scene_buffers[SceneBuffer_Mesh]);
+		CopyBuffer(scene_instances.GetMaterials(), scene_buffers[SceneBuffer_Material], scene_instances.MaterialsChanged());
+		if (!CopyBuffer(instances_gpu, scene_buffers[SceneBuffer_Instance], scene_instances.WasRebuilt()))
+		{
+			GfxBuffer* instance_buffer = scene_buffers[SceneBuffer_Instance].buffer.get();
+			for (auto const& [instance_offset, instance_count] : scene_instances.GetDirtyInstanceRanges())
+			{
+				instance_buffer->Update(&instances_gpu[instance_offset], instance_count * sizeof(InstanceGPU), instance_offset * sizeof(InstanceGPU));
+			}
+		}
 	}
 
 	void Renderer::UpdateFrameConstants(Float dt)
@@ -453,15 +409,28 @@ namespace adria
 	}
 	void Renderer::CameraFrustumCulling()
 	{
-		BoundingFrustum camera_frustum = camera->Frustum();
-		auto batch_view = reg.view<Batch>();
-		auto light_view = reg.view<Light>();
-		for (auto e : batch_view)
+		CullingPlanes const camera_planes = CullingPlanes::FromFrustum(camera->Frustum());
+		BoundingBoxStreams const& instance_bounds = scene_instances.GetInstanceBounds();
+		std::vector<entt::entity> const& batch_entities = scene_instances.GetBatchEntities();
+		Uint64 const instance_count = instance_bounds.Size();
+		camera_visibility_mask.resize((instance_count + 63) / 64);
+		auto& batch_storage = reg.storage<Batch>();
+
+		Bool const select_lods = MeshLODs.Get();
+		Float const max_pixel_error = MeshLODPixelError.Get();
+		Float const projection_scale = camera->Proj()._22 * render_height * 0.5f;
+		Vector3 const camera_position = camera->Position();
+
+		g_ThreadPool.ParallelFor(instance_count, ParallelSceneUpdate.Get() ? CULLED_BOXES_PER_CHUNK : instance_count, [&](Uint64 begin, Uint64 end)
 		{
-			Batch& batch = batch_view.get<Batch>(e);
-			auto& aabb = batch.bounding_box;
-			batch.camera_visibility = camera_frustum.Intersects(aabb);
-		}
+			CullBoundingBoxes(camera_planes, instance_bounds, begin, end - begin, camera_visibility_mask);
+			for (Uint64 instance_id = begin; instance_id < end; ++instance_id)
+			{
+				Batch& batch = batch_storage.get(batch_entities[instance_id]);
+				batch.camera_visibility = IsVisible(camera_visibility_mask, instance_id);
+				batch.lod = batch.camera_visibility && select_lods ? SelectBatchLOD(batch, camera_position, false, projection_scale, max_pixel_error) : 0;
+			}
+		});
 	}
 
 	void Renderer::Render_Deferred(RenderGraph& render_graph)
@@ -597,6 +566,15 @@ namespace adria
 						ImGui::SliderFloat("Wind Speed", &wind_speed, 0.0f, 32.0f);
 						ImGui::TreePop();
 					}
+					if (ImGui::TreeNode("CPU Timings"))
+					{
+						static Bool parallel_scene_update = ParallelSceneUpdate.Get();
+						if (ImGui::Checkbox("Parallel Scene Update", &parallel_scene_update)) ParallelSceneUpdate->Set(parallel_scene_update);
+						ImGui::Text("Threads: %llu", g_ThreadPool.GetThreadCount());
+						ImGui::Text("Scene Buffers: %.3f ms", scene_buffers_cpu_time);
+						ImGui::Text("Culling: %.3f ms", culling_cpu_time);
+						ImGui::TreePop();
+					}
 				}, GUICommandGroup_Renderer);
 		}
 		postprocessor.GUI();
@@ -669,6 +647,4 @@ namespace adria
 
 		take_screenshot = false;
 	}
-
 }
-
@@ -21,9 +21,12 @@
 #include "ShadowRenderer.h"
 #include "PathTracingPass.h"
 #include "RendererOutputPass.h"
+#include "SceneInstances.h"
 #include "Graphics/GfxShaderCompiler.h"
 #include "Graphics/GfxConstantBuffer.h"
 #include "RenderGraph/RenderGraphResourcePool.h"
+#include "RenderGraph/RenderGraphCompileCache.h"
+#include "Math/FrustumCulling.h"
 
 namespace adria
 {
@@ -82,6 +85,7 @@ namespace adria
 		entt::registry& reg;
 		GfxDevice* gfx;
 		RGResourcePool resource_pool;
+		RGCompileCache compile_cache;
 
 		Camera const* camera;
 		Vector2 camera_jitter;
@@ -115,6 +119,12 @@ namespace adria
 		};
 		std::array<SceneBuffer, SceneBuffer_Count> scene_buffers;
 
+		//batches and instance bounds are shared with the shadow renderer for culling
+		SceneInstances scene_instances;
+		std::vector<Uint64> camera_visibility_mask;
+		Float scene_buffers_cpu_time = 0.0f;
+		Float culling_cpu_time = 0.0f;
+
 		//passes
 		GBufferPass  gbuffer_pass;
 		GPUDrivenGBufferPass gpu_driven_renderer;
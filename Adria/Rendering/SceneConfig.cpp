@@ -61,7 +61,14 @@ namespace adria
 			model_params.Find<Bool>("force_alpha_mask", force_mask);
 			Bool load_model_lights = false;
 			model_params.Find<Bool>("load_model_lights", load_model_lights);
-			config.scene_models.emplace_back(path, tex_path, transform, triangle_ccw, force_mask, load_model_lights);
+			Bool compress_vertices = false;
+			model_params.Find<Bool>("compress_vertices", compress_vertices);
+			Uint32 lod_count = SUBMESH_MAX_LODS;
+			model_params.Find<Uint32>("lod_count", lod_count);
+			lod_count = std::clamp(lod_count, 1u, SUBMESH_MAX_LODS);
+			Float lod_error = 0.01f;
+			model_params.Find<Float>("lod_error", lod_error);
+			config.scene_models.emplace_back(path, tex_path, transform, triangle_ccw, force_mask, load_model_lights, compress_vertices, lod_count, lod_error);
 		}
 
 		for (auto&& light_json : lights)
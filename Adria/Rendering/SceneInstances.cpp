@@ -0,0 +1,188 @@
+#include "SceneInstances.h"
+#include "Components.h"
+#include "Utilities/ThreadPool.h"
+
+using namespace DirectX;
+
+namespace adria
+{
+	//instances and materials packed by one thread pool task
+	static constexpr Uint64 INSTANCES_PER_CHUNK = 256;
+	static constexpr Uint64 MATERIALS_PER_CHUNK = 64;
+
+	void PackSceneInstance(Mesh& mesh, SubMeshInstance const& instance, Uint32 instance_id, Uint32 mesh_offset, Uint32 material_offset, Batch& batch, InstanceGPU& instance_gpu)
+	{
+		SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
+		Material const& material = mesh.materials[submesh.material_index];
+
+		batch.instance_id = instance_id;
+		batch.alpha_mode = material.alpha_mode;
+		batch.submesh = &submesh;
+		batch.world_transform = instance.world_transform;
+		submesh.bounding_box.Transform(batch.bounding_box, batch.world_transform);
+
+		instance_gpu.instance_id = instance_id;
+		instance_gpu.material_idx = material_offset + submesh.material_index;
+		instance_gpu.mesh_index = mesh_offset + instance.submesh_index;
+		instance_gpu.world_matrix = instance.world_transform;
+		instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, instance.world_transform);
+		instance_gpu.bb_origin = submesh.bounding_box.Center;
+		instance_gpu.bb_extents = submesh.bounding_box.Extents;
+	}
+
+	SceneInstances::SceneInstances(entt::registry& reg) : reg(reg)
+	{
+		reg.on_construct<Mesh>().connect<&SceneInstances::OnMeshConstructedOrDestroyed>(*this);
+		reg.on_destroy<Mesh>().connect<&SceneInstances::OnMeshConstructedOrDestroyed>(*this);
+		reg.on_update<Mesh>().connect<&SceneInstances::OnMeshUpdated>(*this);
+	}
+
+	SceneInstances::~SceneInstances()
+	{
+		reg.on_construct<Mesh>().disconnect(*this);
+		reg.on_destroy<Mesh>().disconnect(*this);
+		reg.on_update<Mesh>().disconnect(*this);
+	}
+
+	void SceneInstances::Update(Bool parallel)
+	{
+		rebuilt = meshes_dirty;
+		materials_changed = meshes_dirty || !dirty_meshes.empty();
+		dirty_instance_ranges.clear();
+		if (!rebuilt)
+		{
+			for (entt::entity mesh_entity : dirty_meshes)
+			{
+				if (!PackMesh(mesh_entity, parallel))
+				{
+					rebuilt = true;
+					break;
+				}
+			}
+		}
+		if (rebuilt) Rebuild(parallel);
+		dirty_meshes.clear();
+	}
+
+	void SceneInstances::Rebuild(Bool parallel)
+	{
+		for (auto e : reg.view<Batch>()) reg.destroy(e);
+		reg.clear<Batch>();
+		mesh_ranges.clear();
+		batch_entities.clear();
+
+		Uint32 instance_count = 0, mesh_count = 0, material_count = 0;
+		for (auto mesh_entity : reg.view<Mesh>())
+		{
+			Mesh const& mesh = reg.get<Mesh>(mesh_entity);
+			MeshRange& mesh_range = mesh_ranges[mesh_entity];
+			mesh_range.instance_offset = instance_count;
+			mesh_range.instance_count = (Uint32)mesh.instances.size();
+			mesh_range.mesh_offset = mesh_count;
+			mesh_range.mesh_count = (Uint32)mesh.submeshes.size();
+			mesh_range.material_offset = material_count;
+			mesh_range.material_count = (Uint32)mesh.materials.size();
+			instance_count += mesh_range.instance_count;
+			mesh_count += mesh_range.mesh_count;
+			material_count += mesh_range.material_count;
+		}
+		//batches are created up front, instance packing only fills existing components and can run on worker threads
+		batch_entities.resize(instance_count);
+		reg.create(batch_entities.begin(), batch_entities.end());
+		reg.insert<Batch>(batch_entities.begin(), batch_entities.end());
+		instances_gpu.assign(instance_count, InstanceGPU{});
+		meshes_gpu.assign(mesh_count, MeshGPU{});
+		materials_gpu.assign(material_count, MaterialGPU{});
+		instance_bounds.Resize(instance_count);
+
+		for (auto mesh_entity : reg.view<Mesh>()) PackMesh(mesh_entity, parallel);
+		//the whole instance buffer is uploaded after a rebuild
+		dirty_instance_ranges.clear();
+		meshes_dirty = false;
+	}
+
+	Bool SceneInstances::PackMesh(entt::entity mesh_entity, Bool parallel)
+	{
+		auto mesh_range_it = mesh_ranges.find(mesh_entity);
+		if (mesh_range_it == mesh_ranges.end() || !reg.all_of<Mesh>(mesh_entity)) return false;
+		MeshRange const& mesh_range = mesh_range_it->second;
+
+		Mesh& mesh = reg.get<Mesh>(mesh_entity);
+		//a patch that changes the number of instances, submeshes or materials moves every range after this mesh
+		if (mesh.instances.size() != mesh_range.instance_count || mesh.submeshes.size() != mesh_range.mesh_count || mesh.materials.size() != mesh_range.material_count) return false;
+
+		auto& batch_storage = reg.storage<Batch>();
+		g_ThreadPool.ParallelFor(mesh.instances.size(), parallel ? INSTANCES_PER_CHUNK : mesh.instances.size(), [&](Uint64 begin, Uint64 end)
+		{
+			for (Uint64 i = begin; i < end; ++i)
+			{
+				Uint32 const instance_id = mesh_range.instance_offset + (Uint32)i;
+				Batch& batch = batch_storage.get(batch_entities[instance_id]);
+				PackSceneInstance(mesh, mesh.instances[i], instance_id, mesh_range.mesh_offset, mesh_range.material_offset, batch, instances_gpu[instance_id]);
+				instance_bounds.Set(instance_id, batch.bounding_box);
+			}
+		});
+		if (!mesh.instances.empty()) dirty_instance_ranges.emplace_back(mesh_range.instance_offset, (Uint32)mesh.instances.size());
+
+		for (Uint32 i = 0; i < mesh.submeshes.size(); ++i)
+		{
+			SubMeshGPU const& submesh = mesh.submeshes[i];
+			MeshGPU& mesh_gpu = meshes_gpu[mesh_range.mesh_offset + i];
+			mesh_gpu.indices_offset = submesh.lods[0].indices_offset;
+			mesh_gpu.positions_offset = submesh.positions_offset;
+			mesh_gpu.normals_offset = submesh.normals_offset;
+			mesh_gpu.tangents_offset = submesh.tangents_offset;
+			mesh_gpu.uvs_offset = submesh.uvs_offset;
+			mesh_gpu.vertex_format = (Uint32)submesh.vertex_format;
+			mesh_gpu.position_bias = submesh.bounding_box.Center;
+			mesh_gpu.position_scale = submesh.bounding_box.Extents;
+
+			//the GPU driven path culls meshlets of the base LOD
+			mesh_gpu.meshlet_offset = submesh.lods[0].meshlet_offset;
+			mesh_gpu.meshlet_vertices_offset = submesh.lods[0].meshlet_vertices_offset;
+			mesh_gpu.meshlet_triangles_offset = submesh.lods[0].meshlet_triangles_offset;
+			mesh_gpu.meshlet_count = submesh.lods[0].meshlet_count;
+		}
+
+		g_ThreadPool.ParallelFor(mesh.materials.size(), parallel ? MATERIALS_PER_CHUNK : mesh.materials.size(), [&](Uint64 begin, Uint64 end)
+		{
+			for (Uint64 i = begin; i < end; ++i)
+			{
+				Material const& material = mesh.materials[i];
+				MaterialGPU& material_gpu = materials_gpu[mesh_range.material_offset + i];
+				material_gpu.shading_extension = (Uint32)material.extension;
+				material_gpu.albedo_color = Vector3(material.albedo_color);
+				material_gpu.albedo_idx = (Uint32)material.albedo_texture;
+				material_gpu.roughness_metallic_idx = (Uint32)material.metallic_roughness_texture;
+				material_gpu.metallic_factor = material.metallic_factor;
+				material_gpu.roughness_factor = material.roughness_factor;
+
+				material_gpu.normal_idx = (Uint32)material.normal_texture;
+				material_gpu.emissive_idx = (Uint32)material.emissive_texture;
+				material_gpu.emissive_factor = material.emissive_factor;
+				material_gpu.alpha_cutoff = material.alpha_cutoff;
+
+				material_gpu.anisotropy_idx = material.anisotropy_texture == INVALID_TEXTURE_HANDLE ? -1 : material.anisotropy_texture;
+				material_gpu.anisotropy_strength = material.anisotropy_strength;
+				material_gpu.anisotropy_rotation = material.anisotropy_rotation;
+
+				material_gpu.clear_coat_idx = (Uint32)material.clear_coat_texture;
+				material_gpu.clear_coat_roughness_idx = (Uint32)material.clear_coat_roughness_texture;
+				material_gpu.clear_coat_normal_idx = (Uint32)material.clear_coat_normal_texture;
+				material_gpu.clear_coat = material.clear_coat;
+				material_gpu.clear_coat_roughness = material.clear_coat_roughness;
+			}
+		});
+		return true;
+	}
+
+	void SceneInstances::OnMeshConstructedOrDestroyed(entt::registry&, entt::entity)
+	{
+		meshes_dirty = true;
+	}
+
+	void SceneInstances::OnMeshUpdated(entt::registry&, entt::entity mesh_entity)
+	{
+		dirty_meshes.insert(mesh_entity);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "ShaderStructs.h"
+#include "Math/FrustumCulling.h"
+
+namespace adria
+{
+	struct Mesh;
+	struct SubMeshInstance;
+	struct Batch;
+
+	void PackSceneInstance(Mesh& mesh, SubMeshInstance const& instance, Uint32 instance_id, Uint32 mesh_offset, Uint32 material_offset, Batch& batch, InstanceGPU& instance_gpu);
+
+	//Batches and packed GPU data of every Mesh in the registry, kept across frames. Everything is packed again when a Mesh is added or removed,
+	//a Mesh changed through reg.patch or reg.replace is packed on its own, so edits of mesh instances and materials have to go through them
+	class SceneInstances
+	{
+	public:
+		struct MeshRange
+		{
+			Uint32 instance_offset;
+			Uint32 instance_count;
+			Uint32 mesh_offset;
+			Uint32 mesh_count;
+			Uint32 material_offset;
+			Uint32 material_count;
+		};
+
+	public:
+		explicit SceneInstances(entt::registry& reg);
+		ADRIA_NONCOPYABLE_NONMOVABLE(SceneInstances)
+		~SceneInstances();
+
+		//Packs the meshes changed since the last update, parallel splits the packing into chunks processed on the thread pool
+		void Update(Bool parallel);
+
+		//Set when the last update packed every instance, otherwise only the dirty instance ranges changed
+		Bool WasRebuilt() const { return rebuilt; }
+		Bool MaterialsChanged() const { return materials_changed; }
+		//Offsets and counts of the instances packed by the last update
+		std::vector<std::pair<Uint32, Uint32>> const& GetDirtyInstanceRanges() const { return dirty_instance_ranges; }
+
+		std::unordered_map<entt::entity, MeshRange> const& GetMeshRanges() const { return mesh_ranges; }
+		std::vector<entt::entity> const& GetBatchEntities() const { return batch_entities; }
+		std::vector<InstanceGPU> const& GetInstances() const { return instances_gpu; }
+		std::vector<MeshGPU>& GetMeshes() { return meshes_gpu; }
+		std::vector<MaterialGPU> const& GetMaterials() const { return materials_gpu; }
+		//World space instance bounds indexed by instance id
+		BoundingBoxStreams const& GetInstanceBounds() const { return instance_bounds; }
+
+	private:
+		entt::registry& reg;
+		std::unordered_map<entt::entity, MeshRange> mesh_ranges;
+		std::vector<entt::entity> batch_entities;
+		std::vector<InstanceGPU> instances_gpu;
+		std::vector<MeshGPU> meshes_gpu;
+		std::vector<MaterialGPU> materials_gpu;
+		BoundingBoxStreams instance_bounds;
+		std::unordered_set<entt::entity> dirty_meshes;
+		std::vector<std::pair<Uint32, Uint32>> dirty_instance_ranges;
+		Bool meshes_dirty = true;
+		Bool rebuilt = false;
+		Bool materials_changed = false;
+
+	private:
+		void Rebuild(Bool parallel);
+		Bool PackMesh(entt::entity mesh_entity, Bool parallel);
+		void OnMeshConstructedOrDestroyed(entt::registry&, entt::entity);
+		void OnMeshUpdated(entt::registry&, entt::entity mesh_entity);
+	};
+}
@@ -1,12 +1,9 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 #define TINYOBJLOADER_USE_MAPBOX_EARCUT
-#define CGLTF_IMPLEMENTATION
 #include "tiny_obj_loader.h"
-#include "cgltf.h"
-#include "meshoptimizer.h"
 #include "SceneLoader.h"
 #include "Components.h"
-#include "Meshlet.h"
+#include "ModelCache.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxLinearDynamicAllocator.h"
 #include "Logging/Logger.h"
@@ -486,417 +483,89 @@ namespace adria
 
 	entt::entity SceneLoader::LoadModel_GLTF(ModelParameters const& params)
 	{
-		cgltf_options options{};
-		cgltf_data* gltf_data = nullptr;
-		cgltf_result result = cgltf_parse_file(&options, params.model_path.c_str(), &gltf_data);
-		if (result != cgltf_result_success)
-		{
-			ADRIA_LOG(WARNING, "GLTF - Failed to load '%s'", params.model_path.c_str());
-			return entt::null;
-		}
-		result = cgltf_load_buffers(&options, gltf_data, params.model_path.c_str());
-		if (result != cgltf_result_success)
-		{
-			ADRIA_LOG(WARNING, "GLTF - Failed to load buffers '%s'", params.model_path.c_str());
-			return entt::null;
-		}
+		CookedModel cooked_model;
+		if (!cooked_model.Load(params)) return entt::null;
 
 		std::string model_name = GetFilename(params.model_path);
 		entt::entity mesh_entity = reg.create();
 		Mesh mesh{};
 
-		mesh.materials.reserve(gltf_data->materials_count);
-		for (Uint32 i = 0; i < gltf_data->materials_count; ++i)
+		std::span<CookedMaterial const> cooked_materials = cooked_model.GetMaterials();
+		mesh.materials.reserve(cooked_materials.size());
+		for (CookedMaterial const& cooked_material : cooked_materials)
 		{
-			cgltf_material const& gltf_material = gltf_data->materials[i];
-			Material& material = mesh.materials.emplace_back();
-			material.alpha_cutoff = (Float)gltf_material.alpha_cutoff;
-			material.double_sided = gltf_material.double_sided;
-			material.emissive_factor = (Float)gltf_material.emissive_factor[0];
-
-			if (params.force_mask_alpha_usage)
-			{
-				material.alpha_mode = MaterialAlphaMode::Mask;
-			}
-			if (gltf_material.alpha_mode == cgltf_alpha_mode_opaque)
+			Material& material = mesh.materials.emplace_back(cooked_material.material);
+			auto LoadTexture = [&](CookedTextureSlot slot, TextureHandle& texture, Bool srgb)
 			{
-				material.alpha_mode = MaterialAlphaMode::Opaque;
-			}
-			else if (gltf_material.alpha_mode == cgltf_alpha_mode_blend)
-			{
-				material.alpha_mode = MaterialAlphaMode::Blend;
-			}
-			else if (gltf_material.alpha_mode == cgltf_alpha_mode_mask)
-			{
-				material.alpha_mode = MaterialAlphaMode::Mask;
-			}
-
-			auto GetImageURI = [&gltf_data](cgltf_texture* texture)
-			{
-				if (texture->extensions_count > 0)
-				{
-					if (strcmp(texture->extensions[0].name, "MSFT_texture_dds") == 0)
-					{
-						std::string extension_data(texture->extensions[0].data); 
-						std::vector<std::string> tokens = SplitString(extension_data, ':');
-						Int image_index = std::stoi(tokens[1]);
-						return gltf_data->images[image_index].uri;
-					}
-					return texture->image->uri;
-				}
-				return texture->image->uri;
-			};
-			auto GetTexture = [&](cgltf_texture* texture, bool srgb, TextureHandle default_handle)
-			{
-				if (texture)
+				if (cooked_material.texture_names[slot] != INVALID_COOKED_STRING)
 				{
-					std::string texbase = params.textures_path + GetImageURI(texture);
-					return g_TextureManager.LoadTexture(texbase, srgb);
+					std::string texture_path = params.textures_path + cooked_model.GetString(cooked_material.texture_names[slot]);
+					texture = g_TextureManager.LoadTexture(texture_path, srgb);
 				}
-				return default_handle;
 			};
-			if (gltf_material.has_pbr_metallic_roughness)
-			{
-				cgltf_pbr_metallic_roughness pbr_metallic_roughness = gltf_material.pbr_metallic_roughness;
-				material.albedo_color[0] = (Float)pbr_metallic_roughness.base_color_factor[0];
-				material.albedo_color[1] = (Float)pbr_metallic_roughness.base_color_factor[1];
-				material.albedo_color[2] = (Float)pbr_metallic_roughness.base_color_factor[2];
-				material.metallic_factor = (Float)pbr_metallic_roughness.metallic_factor;
-				material.roughness_factor = (Float)pbr_metallic_roughness.roughness_factor;
-				material.albedo_texture = GetTexture(pbr_metallic_roughness.base_color_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.metallic_roughness_texture = GetTexture(pbr_metallic_roughness.metallic_roughness_texture.texture, false, DEFAULT_METALLIC_ROUGHNESS_TEXTURE_HANDLE);
-			}
-			else if (gltf_material.has_pbr_specular_glossiness)
-			{
-				cgltf_pbr_specular_glossiness pbr_specular_glossiness = gltf_material.pbr_specular_glossiness;
-				material.albedo_texture = GetTexture(pbr_specular_glossiness.diffuse_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.roughness_factor = 1.0f - gltf_material.pbr_specular_glossiness.glossiness_factor;
-				material.albedo_color[0]= gltf_material.pbr_specular_glossiness.diffuse_factor[0];
-				material.albedo_color[1] = gltf_material.pbr_specular_glossiness.diffuse_factor[1];
-				material.albedo_color[2] = gltf_material.pbr_specular_glossiness.diffuse_factor[2];
-			}
-
-			//shading extensions
-			material.extension = ShadingExtension::None;
-			if (gltf_material.has_anisotropy)
-			{
-				material.extension = ShadingExtension::Anisotropy;
-				material.anisotropy_texture = GetTexture(gltf_material.anisotropy.anisotropy_texture.texture, true, INVALID_TEXTURE_HANDLE);
-				material.anisotropy_strength = gltf_material.anisotropy.anisotropy_strength;
-				material.anisotropy_rotation = gltf_material.anisotropy.anisotropy_rotation;
-			}
-			if (gltf_material.has_clearcoat)
-			{
-				material.extension = ShadingExtension::ClearCoat;
-				material.clear_coat_texture = GetTexture(gltf_material.clearcoat.clearcoat_texture.texture, false, DEFAULT_BLACK_TEXTURE_HANDLE);
-				material.clear_coat_roughness_texture = GetTexture(gltf_material.clearcoat.clearcoat_roughness_texture.texture, false, DEFAULT_BLACK_TEXTURE_HANDLE);
-				material.clear_coat_normal_texture = GetTexture(gltf_material.clearcoat.clearcoat_normal_texture.texture, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
-				material.clear_coat = gltf_material.clearcoat.clearcoat_factor;
-				material.clear_coat_roughness = gltf_material.clearcoat.clearcoat_roughness_factor;
-			}
-
-			if (cgltf_texture* texture = gltf_material.normal_texture.texture)
-			{
-				std::string texnormal = params.textures_path + GetImageURI(texture);
-				material.normal_texture = g_TextureManager.LoadTexture(texnormal, false);
-			}
-			else
-			{
-				material.normal_texture = DEFAULT_NORMAL_TEXTURE_HANDLE;
-			}
-
-			if (cgltf_texture* texture = gltf_material.emissive_texture.texture)
-			{
-				std::string texemissive = params.textures_path + GetImageURI(texture);
-				material.emissive_texture = g_TextureManager.LoadTexture(texemissive, true);
-			}
-			else
-			{
-				material.emissive_texture = DEFAULT_BLACK_TEXTURE_HANDLE;
-			}
-		}
-
-		std::unordered_map<cgltf_mesh const*, std::vector<Int32>> mesh_primitives_map; //mesh -> vector of primitive indices
-		Int32 primitive_count = 0;
-
-		struct MeshData
-		{
-			DirectX::BoundingBox bounding_box;
-			Int32 material_index = -1;
-			GfxPrimitiveTopology topology = GfxPrimitiveTopology::TriangleList;
-
-			std::vector<Vector3> positions_stream;
-			std::vector<Vector3> normals_stream;
-			std::vector<Vector4> tangents_stream;
-			std::vector<Vector2> uvs_stream;
-			std::vector<Uint32>   indices;
-
-			std::vector<Meshlet>		 meshlets;
-			std::vector<Uint32>			 meshlet_vertices;
-			std::vector<MeshletTriangle> meshlet_triangles;
-		};
-		std::vector<MeshData> mesh_datas{};
-		for (Uint32 i = 0; i < gltf_data->meshes_count; ++i)
-		{
-			cgltf_mesh const& gltf_mesh = gltf_data->meshes[i];
-			std::vector<Int32>& primitives = mesh_primitives_map[&gltf_mesh];
-			for (Uint32 j = 0; j < gltf_mesh.primitives_count; ++j)
-			{
-				auto const& gltf_primitive = gltf_mesh.primitives[j];
-				ADRIA_ASSERT(gltf_primitive.indices->count >= 0);
-
-				MeshData& mesh_data = mesh_datas.emplace_back();
-				mesh_data.material_index = (Int32)(gltf_primitive.material - gltf_data->materials);
-				mesh_data.indices.reserve(gltf_primitive.indices->count);
-				
-				Uint32 triangle_cw[] = { 0, 1, 2 };
-				Uint32 triangle_ccw[] = { 0, 2, 1 };
-				Uint32* order = params.triangle_ccw ? triangle_ccw : triangle_cw;
-				for (Uint64 i = 0; i < gltf_primitive.indices->count; i += 3)
-				{
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[0]));
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[1]));
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[2]));
-				}
-
-				switch (gltf_primitive.type)
-				{
-				case cgltf_primitive_type_points:
-					mesh_data.topology = GfxPrimitiveTopology::PointList;
-					break;
-				case cgltf_primitive_type_lines:
-					mesh_data.topology = GfxPrimitiveTopology::LineList;
-					break;
-				case cgltf_primitive_type_line_strip:
-					mesh_data.topology = GfxPrimitiveTopology::LineStrip;
-					break;
-				case cgltf_primitive_type_triangles:
-					mesh_data.topology = GfxPrimitiveTopology::TriangleList;
-					break;
-				case cgltf_primitive_type_triangle_strip:
-					mesh_data.topology = GfxPrimitiveTopology::TriangleStrip;
-					break;
-				default:
-					ADRIA_ASSERT(false);
-				}
-
-				for (Uint32 k = 0; k < gltf_primitive.attributes_count; ++k)
-				{
-					cgltf_attribute const& gltf_attribute = gltf_primitive.attributes[k];
-					std::string const& attr_name = gltf_attribute.name;
-
-					auto ReadAttributeData = [&]<typename T>(std::vector<T>& stream, const Char* stream_name)
-					{
-						if (!attr_name.compare(stream_name))
-						{
-							stream.resize(gltf_attribute.data->count);
-							for (Uint64 i = 0; i < gltf_attribute.data->count; ++i)
-							{
-								cgltf_accessor_read_float(gltf_attribute.data, i, &stream[i].x, sizeof(T) / sizeof(Float));
-							}
-						}
-					};
-					ReadAttributeData(mesh_data.positions_stream, "POSITION");
-					ReadAttributeData(mesh_data.normals_stream, "NORMAL");
-					ReadAttributeData(mesh_data.tangents_stream, "TANGENT");
-					ReadAttributeData(mesh_data.uvs_stream, "TEXCOORD_0");
-				}
-				primitives.push_back(primitive_count++);
-			}
-		}
-
-		Uint64 total_buffer_size = 0;
-		for (auto& mesh_data : mesh_datas)
-		{
-			std::vector<Uint32> const& indices = mesh_data.indices;
-			Uint64 vertex_count = mesh_data.positions_stream.size();
-
-			Bool has_tangents = !mesh_data.tangents_stream.empty();
-			if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
-			if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
-			if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
-
-			if (!has_tangents)
-			{
-				ComputeTangentFrame(mesh_data.indices.data(), mesh_data.indices.size(), mesh_data.positions_stream.data(),
-					mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
-			}
-
-			meshopt_optimizeVertexCache(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_optimizeOverdraw(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
-			std::vector<Uint32> remap(vertex_count);
-			meshopt_optimizeVertexFetchRemap(&remap[0], mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_remapIndexBuffer(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
-
-			Uint64 const max_meshlets = meshopt_buildMeshletsBound(mesh_data.indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
-			mesh_data.meshlets.resize(max_meshlets);
-			mesh_data.meshlet_vertices.resize(max_meshlets * MESHLET_MAX_VERTICES);
-
-			std::vector<Uchar> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
-			std::vector<meshopt_Meshlet> meshlets(max_meshlets);
-
-			Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), mesh_data.meshlet_vertices.data(), meshlet_triangles.data(),
-				mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, mesh_data.positions_stream.size(), sizeof(Vector3),
-				MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
-
-			meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
-			meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
-			meshlets.resize(meshlet_count);
-
-			mesh_data.meshlets.resize(meshlet_count);
-			mesh_data.meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
-			mesh_data.meshlet_triangles.resize(meshlet_triangles.size() / 3);
-
-			Uint32 triangle_offset = 0;
-			for (Uint64 i = 0; i < meshlet_count; ++i)
-			{
-				meshopt_Meshlet const& m = meshlets[i];
-				meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&mesh_data.meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
-					m.triangle_count, reinterpret_cast<Float const*>(mesh_data.positions_stream.data()), vertex_count, sizeof(Vector3));
-
-				Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
-				for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
-				{
-					MeshletTriangle& tri = mesh_data.meshlet_triangles[triangle_idx + triangle_offset];
-					tri.V0 = *src_triangles++;
-					tri.V1 = *src_triangles++;
-					tri.V2 = *src_triangles++;
-				}
-
-				Meshlet& meshlet = mesh_data.meshlets[i];
-				std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
-
-				meshlet.radius = meshopt_bounds.radius;
-				meshlet.vertex_count = m.vertex_count;
-				meshlet.triangle_count = m.triangle_count;
-				meshlet.vertex_offset = m.vertex_offset;
-				meshlet.triangle_offset = triangle_offset;
-				triangle_offset += m.triangle_count;
-
-			}
-			mesh_data.meshlet_triangles.resize(triangle_offset);
-
-			total_buffer_size += Align(mesh_data.indices.size() * sizeof(Uint32), 16);
-			total_buffer_size += Align(mesh_data.positions_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += Align(mesh_data.uvs_stream.size() * sizeof(Vector2), 16);
-			total_buffer_size += Align(mesh_data.normals_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += Align(mesh_data.tangents_stream.size() * sizeof(Vector4), 16);
-			total_buffer_size += Align(mesh_data.meshlets.size() * sizeof(Meshlet), 16);
-			total_buffer_size += Align(mesh_data.meshlet_vertices.size() * sizeof(Uint32), 16);
-			total_buffer_size += Align(mesh_data.meshlet_triangles.size() * sizeof(MeshletTriangle), 16);
-
-			mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
+			LoadTexture(CookedTextureSlot_Albedo, material.albedo_texture, true);
+			LoadTexture(CookedTextureSlot_MetallicRoughness, material.metallic_roughness_texture, false);
+			LoadTexture(CookedTextureSlot_Normal, material.normal_texture, false);
+			LoadTexture(CookedTextureSlot_Emissive, material.emissive_texture, true);
+			LoadTexture(CookedTextureSlot_Anisotropy, material.anisotropy_texture, true);
+			LoadTexture(CookedTextureSlot_ClearCoat, material.clear_coat_texture, false);
+			LoadTexture(CookedTextureSlot_ClearCoatRoughness, material.clear_coat_roughness_texture, false);
+			LoadTexture(CookedTextureSlot_ClearCoatNormal, material.clear_coat_normal_texture, false);
 		}
 
-		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(total_buffer_size, 16);
+		std::span<Uint8 const> geometry = cooked_model.GetGeometry();
+		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(geometry.size(), 16);
+		staging_buffer.Update(geometry.data(), geometry.size());
 
-		Uint32 current_offset = 0;
-		auto CopyData = [&staging_buffer, &current_offset]<typename T>(std::vector<T> const& _data)
-		{
-			Uint64 current_copy_size = _data.size() * sizeof(T);
-			staging_buffer.Update(_data.data(), current_copy_size, current_offset);
-			current_offset += (Uint32)Align(current_copy_size, 16);
-		};
+		std::span<SubMeshGPU const> submeshes = cooked_model.GetSubMeshes();
+		mesh.submeshes.assign(submeshes.begin(), submeshes.end());
+		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, geometry.size(), staging_buffer.offset);
 
-		mesh.submeshes.reserve(mesh_datas.size());
-		for (Uint64 i = 0; i < mesh_datas.size(); ++i)
+		std::span<CookedInstance const> cooked_instances = cooked_model.GetInstances();
+		mesh.instances.reserve(cooked_instances.size());
+		for (CookedInstance const& cooked_instance : cooked_instances)
 		{
-			auto const& mesh_data = mesh_datas[i];
-
-			SubMeshGPU& submesh = mesh.submeshes.emplace_back();
-
-			submesh.indices_offset = current_offset;
-			submesh.indices_count = (Uint32)mesh_data.indices.size();
-			CopyData(mesh_data.indices);
-
-			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
-			submesh.positions_offset = current_offset;
-			CopyData(mesh_data.positions_stream);
-
-			submesh.uvs_offset = current_offset;
-			CopyData(mesh_data.uvs_stream);
-
-			submesh.normals_offset = current_offset;
-			CopyData(mesh_data.normals_stream);
-
-			submesh.tangents_offset = current_offset;
-			CopyData(mesh_data.tangents_stream);
-
-			submesh.meshlet_offset = current_offset;
-			CopyData(mesh_data.meshlets);
-
-			submesh.meshlet_vertices_offset = current_offset;
-			CopyData(mesh_data.meshlet_vertices);
-
-			submesh.meshlet_triangles_offset = current_offset;
-			CopyData(mesh_data.meshlet_triangles);
-
-			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
-
-			submesh.bounding_box = mesh_data.bounding_box;
-			submesh.topology = mesh_data.topology;
-			submesh.material_index = mesh_data.material_index;
+			SubMeshInstance& instance = mesh.instances.emplace_back();
+			instance.submesh_index = cooked_instance.submesh_index;
+			instance.world_transform = cooked_instance.local_to_world * params.model_matrix;
+			instance.parent = mesh_entity;
 		}
-		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, total_buffer_size, staging_buffer.offset);
 
-		for (Uint64 i = 0; i < gltf_data->nodes_count; ++i)
+		if (params.load_model_lights)
 		{
-			cgltf_node const& gltf_node = gltf_data->nodes[i];
-
-			Matrix local_to_world;
-			cgltf_node_transform_world(&gltf_node, &local_to_world.m[0][0]);
-
-			if (gltf_node.mesh)
-			{
-				for (Int32 primitive : mesh_primitives_map[gltf_node.mesh])
-				{
-					SubMeshInstance& instance = mesh.instances.emplace_back();
-					instance.submesh_index = primitive;
-					instance.world_transform = local_to_world * params.model_matrix;
-					instance.parent = mesh_entity;
-				}
-			}
-
-			if (params.load_model_lights && gltf_node.light)
+			for (CookedLight const& cooked_light : cooked_model.GetLights())
 			{
-				cgltf_light const& gltf_light = *gltf_node.light;
-			
 				Vector3 translation, scale;
 				Quaternion rotation;
-				local_to_world.Decompose(scale, rotation,translation);
+				Matrix local_to_world = cooked_light.local_to_world;
+				local_to_world.Decompose(scale, rotation, translation);
 
 				LightParameters light_params{};
 				light_params.mesh_size = 150;
 				light_params.mesh_type = LightMesh::NoMesh;
-				light_params.light_data.color.x = gltf_light.color[0];
-				light_params.light_data.color.y = gltf_light.color[1];
-				light_params.light_data.color.z = gltf_light.color[2];
-				light_params.light_data.intensity = gltf_light.intensity;
-				light_params.light_data.inner_cosine = cos(gltf_light.spot_inner_cone_angle);
-				light_params.light_data.outer_cosine = cos(gltf_light.spot_outer_cone_angle);
-				light_params.light_data.range = gltf_light.range > 0 ? gltf_light.range : FLT_MAX;
+				light_params.light_data.color.x = cooked_light.color[0];
+				light_params.light_data.color.y = cooked_light.color[1];
+				light_params.light_data.color.z = cooked_light.color[2];
+				light_params.light_data.intensity = cooked_light.intensity;
+				light_params.light_data.inner_cosine = cos(cooked_light.inner_cone_angle);
+				light_params.light_data.outer_cosine = cos(cooked_light.outer_cone_angle);
+				light_params.light_data.range = cooked_light.range > 0 ? cooked_light.range : FLT_MAX;
 				light_params.light_data.position = Vector4(translation.x, translation.y, translation.z, 1.0f);
 				Vector3 forward(0.0f, 0.0f, -1.0f);
 				Vector3 direction = Vector3::Transform(forward, Matrix::CreateFromQuaternion(rotation));
 				light_params.light_data.direction = Vector4(direction.x, direction.y, direction.z, 0.0f);
+				light_params.light_data.type = cooked_light.type;
 
-				switch (gltf_light.type)
+				switch (cooked_light.type)
 				{
-				case cgltf_light_type_directional: 
-					light_params.light_data.type = LightType::Directional;
+				case LightType::Directional:
 					light_params.light_data.casts_shadows = true;
 					light_params.light_data.use_cascades = true;
 					break;
-				case cgltf_light_type_point:	   
-					light_params.light_data.type = LightType::Point;
+				case LightType::Point:
 					light_params.light_data.intensity /= 10;
 					break;
-				case cgltf_light_type_spot:		   
-					light_params.light_data.type = LightType::Spot;
+				case LightType::Spot:
 					light_params.light_data.intensity /= 100;
 					break;
 				}
@@ -916,7 +585,6 @@ namespace adria
 		if (gfx->GetCapabilities().SupportsRayTracing()) reg.emplace<RayTracing>(mesh_entity);
 
 		ADRIA_LOG(INFO, "GLTF Model %s successfully loaded!", params.model_path.c_str());
-		cgltf_free(gltf_data);
 		return mesh_entity;
 	}
 }
\ No newline at end of file
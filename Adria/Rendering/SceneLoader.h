@@ -25,6 +25,12 @@ namespace adria
 		Bool triangle_ccw = true;
 		Bool force_mask_alpha_usage = false;
 		Bool load_model_lights = false;
+		//stores the vertex streams in the compressed MeshVertexFormat
+		Bool compress_vertices = false;
+		//number of LODs including the base one, every LOD targets half the triangles of the previous one
+		Uint32 lod_count = SUBMESH_MAX_LODS;
+		//simplification error allowed per LOD step relative to the mesh extents, LOD i may deviate by i * lod_error
+		Float lod_error = 0.01f;
     };
     struct SkyboxParameters
     {
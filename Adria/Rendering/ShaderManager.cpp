@@ -1,4 +1,6 @@
 #include <set>
+#include <unordered_set>
+#include <condition_variable>
 #include "ShaderManager.h"
 #include "Core/Paths.h"
 #include "Core/ConsoleManager.h"
@@ -8,6 +10,7 @@
 #include "Logging/Logger.h"
 #include "Utilities/Timer.h"
 #include "Utilities/FileWatcher.h"
+#include "Utilities/ThreadPool.h"
 
 namespace fs = std::filesystem;
 
@@ -18,11 +21,112 @@ namespace adria
 
 	namespace
 	{
+		class ShaderCompileCounter
+		{
+			friend class ShaderCompileQueue;
+		public:
+			Bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+		private:
+			std::atomic<Uint32> pending = 0;
+		};
+
+		//Background compiles run on their own below normal priority threads instead of g_ThreadPool. ThreadPool::Wait executes
+		//any queued job, so a frame waiting on its own jobs could otherwise pick up a compile that takes hundreds of milliseconds.
+		class ShaderCompileQueue
+		{
+		public:
+			void Initialize(Uint32 thread_count)
+			{
+				done = false;
+				for (Uint32 i = 0; i < thread_count; ++i) threads.emplace_back(&ShaderCompileQueue::ThreadWork, this);
+			}
+			void Destroy()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					done = true;
+				}
+				job_cv.notify_all();
+				for (std::thread& thread : threads) thread.join();
+				threads.clear();
+			}
+
+			void Run(std::function<void()>&& job, ShaderCompileCounter& counter)
+			{
+				counter.pending.fetch_add(1, std::memory_order_relaxed);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					jobs.emplace(std::move(job), &counter);
+				}
+				job_cv.notify_one();
+			}
+			void Wait(ShaderCompileCounter const& counter)
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				counter_cv.wait(lock, [&counter]() { return counter.IsDone(); });
+			}
+
+		private:
+			std::vector<std::thread> threads;
+			std::queue<std::pair<std::function<void()>, ShaderCompileCounter*>> jobs;
+			std::mutex mutex;
+			std::condition_variable job_cv;
+			std::condition_variable counter_cv;
+			Bool done = false;
+
+		private:
+			void ThreadWork()
+			{
+				SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+				while (true)
+				{
+					std::pair<std::function<void()>, ShaderCompileCounter*> job;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						job_cv.wait(lock, [this]() { return done || !jobs.empty(); });
+						if (jobs.empty()) return;
+						job = std::move(jobs.front());
+						jobs.pop();
+					}
+					job.first();
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						job.second->pending.fetch_sub(1, std::memory_order_release);
+					}
+					counter_cv.notify_all();
+				}
+			}
+		};
+
 		std::unique_ptr<FileWatcher> file_watcher;
+		ShaderCompileQueue compile_queue;
+		//compile errors are only shown in a dialog on this thread, other threads log them and return the failure
+		std::thread::id main_thread_id;
 		ShaderRecompiledEvent shader_recompiled_event;
 		LibraryRecompiledEvent library_recompiled_event;
 		std::unordered_map<GfxShaderKey, GfxShader, GfxShaderKeyHash> shader_map;
-		std::unordered_map<fs::path, std::set<GfxShaderKey>> file_shader_map;
+		//maps every shader file to all keys that depend on it, include lists are transitive so this is the closure of the include graph
+		std::unordered_map<fs::path, std::unordered_set<GfxShaderKey, GfxShaderKeyHash>> file_shader_map;
+
+		//guards the shader maps and the precompile state below, compilation itself runs unlocked
+		std::mutex shader_map_mutex;
+		std::condition_variable shader_compiled_cv;
+		//shaders a precompile job was started for but did not pick up yet, GetGfxShader compiles those right away instead of waiting
+		std::unordered_set<GfxShaderKey, GfxShaderKeyHash> queued_shaders;
+		std::unordered_set<GfxShaderKey, GfxShaderKeyHash> compiling_shaders;
+		std::vector<GfxShaderKey> precompiled_shaders;
+		ShaderCompileCounter precompile_counter;
+		std::atomic<Uint32> precompile_total = 0;
+		std::atomic<Uint32> precompile_done = 0;
+
+		std::set<fs::path> changed_shader_files;
+		std::vector<std::pair<GfxShaderKey, GfxShaderCompileOutput>> recompiled_shaders;
+		//shaders that failed to recompile keep their previous bytecode, the errors are reported once per batch on the main thread
+		std::vector<std::pair<GfxShaderKey, std::string>> failed_shaders;
+		//set by the recompile jobs, lets HasRecompiledShaders check for results every frame without taking the lock
+		std::atomic<Bool> has_recompile_results = false;
+		ShaderCompileCounter recompile_counter;
 
 		inline GfxShaderCompilerFlags GetShaderCompilerFlags()
 		{
@@ -559,9 +663,9 @@ namespace adria
 			return SM_6_7;
 		}
 
-		void CompileShader(GfxShaderKey const& shader)
+		Bool CompileShader(GfxShaderKey const& shader, GfxShaderCompileOutput& output)
 		{
-			if (!shader.IsValid()) return;
+			if (!shader.IsValid()) return false;
 
 			GfxShaderDesc shader_desc{};
 			shader_desc.entry_point = GetEntryPoint(shader);
@@ -571,31 +675,167 @@ namespace adria
 			shader_desc.flags = GetShaderCompilerFlags();
 			shader_desc.defines = shader.GetDefines();
 
+			return GfxShaderCompiler::CompileShader(shader_desc, output);
+		}
+		//output.includes contains every file the shader depends on, directly or through other includes
+		void AddShader(GfxShaderKey const& shader, GfxShaderCompileOutput& output)
+		{
+			std::lock_guard<std::mutex> lock(shader_map_mutex);
+			shader_map[shader] = std::move(output.shader);
+			for (auto const& include : output.includes)
+			{
+				file_shader_map[fs::path(include)].insert(shader);
+			}
+		}
+		void BroadcastShaderCompiled(GfxShaderKey const& shader)
+		{
+			GetShaderStage(shader) == GfxShaderStage::LIB ? library_recompiled_event.Broadcast(shader) : shader_recompiled_event.Broadcast(shader);
+		}
+		//Compiles a shader that is needed right away. On the main thread errors are shown in a dialog until they are fixed
+		//or the dialog is canceled, other threads return the failure and the caller gets an empty shader.
+		void CompileRequiredShader(GfxShaderKey const& shader)
+		{
 			GfxShaderCompileOutput output;
-			Bool compile_result = GfxShaderCompiler::CompileShader(shader_desc, output);
-			ADRIA_ASSERT(compile_result);
+			Bool compile_result = CompileShader(shader, output);
+			while (!compile_result && std::this_thread::get_id() == main_thread_id)
+			{
+				std::string msg = "Click OK after you fixed the following errors: \n";
+				msg += output.errors;
+				if (MessageBoxA(NULL, msg.c_str(), NULL, MB_OKCANCEL) != IDOK) break;
+				compile_result = CompileShader(shader, output);
+			}
 			if (!compile_result) return;
+			AddShader(shader, output);
+			BroadcastShaderCompiled(shader);
+		}
 
-			shader_map[shader] = std::move(output.shader);
+		//Hot reload: changed files are collected until the running batch is done, the next batch recompiles every key that
+		//depends on any of them once. Results are swapped in together by SwapRecompiledShaders at a frame boundary.
+		void OnShaderFileChanged(std::string const& filename, FileStatus)
+		{
+			changed_shader_files.insert(fs::path(filename));
+		}
+		void StartShaderRecompile()
+		{
+			if (changed_shader_files.empty() || !recompile_counter.IsDone()) return;
 
-			file_shader_map[fs::path(shader_desc.file)].insert(shader);
-			for (auto const& include : output.includes)
+			std::unordered_set<GfxShaderKey, GfxShaderKeyHash> affected_shaders;
 			{
-				file_shader_map[fs::path(include)].insert(shader);
+				std::lock_guard<std::mutex> lock(shader_map_mutex);
+				for (fs::path const& file : changed_shader_files)
+				{
+					if (auto it = file_shader_map.find(file); it != file_shader_map.end()) affected_shaders.insert(it->second.begin(), it->second.end());
+				}
+			}
+			changed_shader_files.clear();
+			if (affected_shaders.empty()) return;
+
+			ADRIA_LOG(INFO, "Recompiling %llu shaders in the background", (Uint64)affected_shaders.size());
+			for (GfxShaderKey const& shader_key : affected_shaders)
+			{
+				compile_queue.Run([shader_key]()
+					{
+						GfxShaderCompileOutput output;
+						Bool const compiled = CompileShader(shader_key, output);
+						std::lock_guard<std::mutex> lock(shader_map_mutex);
+						if (compiled) recompiled_shaders.emplace_back(shader_key, std::move(output));
+						else failed_shaders.emplace_back(shader_key, std::move(output.errors));
+						has_recompile_results.store(true, std::memory_order_release);
+					}, recompile_counter);
 			}
-			shader_desc.stage == GfxShaderStage::LIB ? library_recompiled_event.Broadcast(shader) : shader_recompiled_event.Broadcast(shader);
 		}
-		void OnShaderFileChanged(std::string const& filename)
+
+		//Runs on the thread pool or the compile queue, shaders GetGfxShader took over in the meantime are skipped
+		void PrecompileShader(GfxShaderKey const& shader_key, Bool background)
 		{
-			for (GfxShaderKey const& shader_key : file_shader_map[fs::path(filename)])
+			Bool compile = false;
 			{
-				CompileShader(shader_key);
+				std::lock_guard<std::mutex> lock(shader_map_mutex);
+				compile = queued_shaders.erase(shader_key) > 0;
+				if (compile) compiling_shaders.insert(shader_key);
+			}
+			if (compile)
+			{
+				GfxShaderCompileOutput output;
+				Bool const compiled = CompileShader(shader_key, output);
+				if (compiled) AddShader(shader_key, output);
+				{
+					std::lock_guard<std::mutex> lock(shader_map_mutex);
+					compiling_shaders.erase(shader_key);
+					if (compiled && !background) precompiled_shaders.push_back(shader_key);
+				}
+				shader_compiled_cv.notify_all();
+			}
+
+			Uint32 const done = ++precompile_done;
+			Uint32 const total = precompile_total.load();
+			Uint32 const log_step = std::max(total / 10, 1u);
+			if (done % log_step == 0 || done == total) ADRIA_LOG(INFO, "Precompiling shaders: %u/%u", done, total);
+		}
+
+		//The manifest lists the shader keys the last run compiled, source file and entry point are stored to skip entries of renamed shaders.
+		//Only these are precompiled, without a manifest, e.g. on the first start, every shader is compiled with its defines on first use.
+		std::string GetShaderManifestPath()
+		{
+			return paths::ShaderCacheDir + "shader_manifest.bin";
+		}
+		std::vector<GfxShaderKey> LoadShaderManifest()
+		{
+			std::vector<GfxShaderKey> shader_keys;
+			std::ifstream is(GetShaderManifestPath(), std::ios::binary);
+			if (!is) return shader_keys;
+
+			try
+			{
+				cereal::BinaryInputArchive archive(is);
+				Uint64 entry_count = 0;
+				archive(entry_count);
+				for (Uint64 i = 0; i < entry_count; ++i)
+				{
+					Uint8 shader_id = 0;
+					std::string source, entry_point;
+					std::vector<std::string> defines;
+					archive(shader_id, source, entry_point, defines);
+					if (shader_id == ShaderID_Invalid || shader_id >= ShaderId_Count) continue;
+					if (GetShaderSource((ShaderID)shader_id) != source || GetEntryPoint((ShaderID)shader_id) != entry_point) continue;
+
+					GfxShaderKey shader_key((ShaderID)shader_id);
+					for (Uint64 j = 0; j + 1 < defines.size(); j += 2) shader_key.AddDefine(defines[j].c_str(), defines[j + 1].c_str());
+					shader_keys.push_back(shader_key);
+				}
+			}
+			catch (cereal::Exception const&)
+			{
+				ADRIA_LOG(WARNING, "Shader manifest is corrupted, shaders will be compiled on first use");
+				shader_keys.clear();
+			}
+			return shader_keys;
+		}
+		void SaveShaderManifest()
+		{
+			std::ofstream os(GetShaderManifestPath(), std::ios::binary);
+			cereal::BinaryOutputArchive archive(os);
+			Uint64 const entry_count = std::count_if(shader_map.begin(), shader_map.end(), [](auto const& entry) { return entry.second.GetSize() > 0; });
+			archive(entry_count);
+			for (auto const& [shader_key, shader] : shader_map)
+			{
+				if (shader.GetSize() == 0) continue;
+
+				std::vector<std::string> defines;
+				for (GfxShaderDefine const& define : shader_key.GetDefines())
+				{
+					defines.push_back(define.name);
+					defines.push_back(define.value);
+				}
+				archive((Uint8)shader_key.GetShaderID(), GetShaderSource(shader_key), GetEntryPoint(shader_key), defines);
 			}
 		}
 	}
 
 	void ShaderManager::Initialize(Bool shader_debug)
 	{
+		main_thread_id = std::this_thread::get_id();
+		compile_queue.Initialize(std::max(std::thread::hardware_concurrency(), 2u) - 1);
 		file_watcher = std::make_unique<FileWatcher>();
 		file_watcher->AddPathToWatch(paths::ShaderDir);
 		std::ignore = file_watcher->GetFileModifiedEvent().AddStatic(OnShaderFileChanged);
@@ -608,21 +848,131 @@ namespace adria
 	}
 	void ShaderManager::Destroy()
 	{
+		{
+			std::lock_guard<std::mutex> lock(shader_map_mutex);
+			queued_shaders.clear();
+		}
+		WaitForPrecompile();
+		compile_queue.Wait(recompile_counter);
+		compile_queue.Destroy();
+		recompiled_shaders.clear();
+		failed_shaders.clear();
+		has_recompile_results = false;
+		SaveShaderManifest();
 		file_watcher = nullptr;
 		shader_map.clear();
 	}
 	void ShaderManager::CheckIfShadersHaveChanged()
 	{
+		WaitForPrecompile();
 		file_watcher->CheckWatchedFiles();
+		StartShaderRecompile();
+	}
+	Bool ShaderManager::HasRecompiledShaders()
+	{
+		return recompile_counter.IsDone() && has_recompile_results.load(std::memory_order_acquire);
+	}
+	void ShaderManager::SwapRecompiledShaders()
+	{
+		if (!recompile_counter.IsDone()) return;
+
+		std::vector<std::pair<GfxShaderKey, GfxShaderCompileOutput>> shaders;
+		std::vector<std::pair<GfxShaderKey, std::string>> failures;
+		{
+			std::lock_guard<std::mutex> lock(shader_map_mutex);
+			shaders.swap(recompiled_shaders);
+			failures.swap(failed_shaders);
+			has_recompile_results = false;
+		}
+		for (auto& [shader_key, output] : shaders) AddShader(shader_key, output);
+		for (auto const& [shader_key, output] : shaders) BroadcastShaderCompiled(shader_key);
+		if (!failures.empty())
+		{
+			std::string msg = std::to_string(failures.size()) + " shaders failed to recompile and keep their previous version:\n";
+			for (auto const& [shader_key, errors] : failures)
+			{
+				msg += GetShaderSource(shader_key) + " (" + GetEntryPoint(shader_key) + "):\n" + errors + "\n";
+			}
+			ADRIA_LOG(ERROR, "%s", msg.c_str());
+			MessageBoxA(NULL, msg.c_str(), "Shader Recompilation", MB_OK | MB_ICONWARNING);
+		}
+		StartShaderRecompile();
+	}
+
+	void ShaderManager::PrecompileShaders(Bool background)
+	{
+		std::vector<GfxShaderKey> shader_keys = GetPrecompileShaderKeys();
+		{
+			std::lock_guard<std::mutex> lock(shader_map_mutex);
+			std::erase_if(shader_keys, [](GfxShaderKey const& shader_key) { return shader_map.contains(shader_key) || !queued_shaders.insert(shader_key).second; });
+		}
+		if (shader_keys.empty()) return;
+
+		precompile_total += (Uint32)shader_keys.size();
+		ADRIA_LOG(INFO, "Precompiling %llu shaders%s", (Uint64)shader_keys.size(), background ? " in the background" : "");
+		if (background)
+		{
+			for (GfxShaderKey const& shader_key : shader_keys)
+			{
+				compile_queue.Run([shader_key]() { PrecompileShader(shader_key, true); }, precompile_counter);
+			}
+			return;
+		}
+
+		Timer timer;
+		g_ThreadPool.ParallelFor(shader_keys.size(), 1, [&shader_keys](Uint64 begin, Uint64 end)
+			{
+				for (Uint64 i = begin; i < end; ++i) PrecompileShader(shader_keys[i], false);
+			});
+		ADRIA_LOG(INFO, "Shader precompilation took %f s", timer.ElapsedInSeconds());
+
+		//nothing uses these shaders yet, the broadcast only lets listeners like the Aftermath tracker see them
+		std::vector<GfxShaderKey> compiled_shaders;
+		{
+			std::lock_guard<std::mutex> lock(shader_map_mutex);
+			compiled_shaders.swap(precompiled_shaders);
+		}
+		for (GfxShaderKey const& shader_key : compiled_shaders) BroadcastShaderCompiled(shader_key);
+	}
+
+	void ShaderManager::WaitForPrecompile()
+	{
+		compile_queue.Wait(precompile_counter);
+	}
+
+	Float ShaderManager::GetPrecompileProgress()
+	{
+		Uint32 const total = precompile_total.load();
+		return total ? (Float)precompile_done.load() / total : 1.0f;
 	}
 
 	GfxShader const& ShaderManager::GetGfxShader(GfxShaderKey const& shader_key)
 	{
-		if (shader_map.contains(shader_key)) return shader_map[shader_key];
-		CompileShader(shader_key);
+		{
+			std::unique_lock<std::mutex> lock(shader_map_mutex);
+			queued_shaders.erase(shader_key);
+			shader_compiled_cv.wait(lock, [&shader_key]() { return !compiling_shaders.contains(shader_key); });
+			if (auto it = shader_map.find(shader_key); it != shader_map.end()) return it->second;
+			compiling_shaders.insert(shader_key);
+		}
+		CompileRequiredShader(shader_key);
+
+		std::lock_guard<std::mutex> lock(shader_map_mutex);
+		compiling_shaders.erase(shader_key);
+		shader_compiled_cv.notify_all();
 		return shader_map[shader_key];
 	}
 
+	std::vector<GfxShaderKey> ShaderManager::GetPrecompileShaderKeys()
+	{
+		return LoadShaderManifest();
+	}
+
+	Bool ShaderManager::CompileShaderToOutput(GfxShaderKey const& shader_key, GfxShaderCompileOutput& output)
+	{
+		return CompileShader(shader_key, output);
+	}
+
 	ShaderRecompiledEvent& ShaderManager::GetShaderRecompiledEvent()
 	{
 		return shader_recompiled_event;
@@ -632,4 +982,3 @@ namespace adria
 		return library_recompiled_event;
 	}
 }
-
@@ -6,6 +6,7 @@ namespace adria
 	class GfxDevice;
 	class GfxShader;
 	class GfxShaderKey;
+	struct GfxShaderCompileOutput;
 
 	enum ShaderID : Uint8
 	{
@@ -126,7 +127,22 @@ namespace adria
 	public:
 		static void Initialize(Bool shader_debug);
 		static void Destroy();
+		//Starts recompiling the shaders that depend on changed files on low priority threads
 		static void CheckIfShadersHaveChanged();
+		//Recompiled shaders are swapped in and broadcast together, call between frames once the GPU is idle.
+		//Shaders that failed to recompile keep their previous bytecode and their errors are reported once per batch.
+		static Bool HasRecompiledShaders();
+		static void SwapRecompiledShaders();
+
+		//Compiles the shaders listed in the manifest written by the last run, without a manifest nothing is precompiled.
+		//Blocking mode uses the thread pool. Background mode returns right away and compiles on low priority threads,
+		//GetGfxShader only waits for the shader it asks for and shaders compiled in the background are not broadcast.
+		static void PrecompileShaders(Bool background);
+		static void WaitForPrecompile();
+		static Float GetPrecompileProgress();
+		static std::vector<GfxShaderKey> GetPrecompileShaderKeys();
+		//Compiles a shader without adding it to the shader map, used to time compilation
+		static Bool CompileShaderToOutput(GfxShaderKey const& shader_key, GfxShaderCompileOutput& output);
 
 		static ShaderRecompiledEvent& GetShaderRecompiledEvent();
 		static LibraryRecompiledEvent& GetLibraryRecompiledEvent();
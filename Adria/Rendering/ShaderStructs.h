@@ -97,6 +97,11 @@ namespace adria
 		Uint32 meshlet_vertices_offset;
 		Uint32 meshlet_triangles_offset;
 		Uint32 meshlet_count;
+
+		//compressed positions are dequantized as position_bias + position * position_scale
+		Uint32  vertex_format;
+		Vector3 position_bias;
+		Vector3 position_scale;
 	};
 
 	struct MaterialGPU
@@ -11,14 +11,20 @@
 #include "Graphics/GfxReflection.h"
 #include "Graphics/GfxPipelineStatePermutations.h"
 #include "RenderGraph/RenderGraph.h"
+#include "Math/FrustumCulling.h"
 #include "Core/ConsoleManager.h"
+#include "Utilities/ThreadPool.h"
 
 using namespace DirectX;
 
 namespace adria
 {
+	static constexpr Uint64 CULLED_BOXES_PER_CHUNK = 1024;
+
 	static TAutoConsoleVariable<Float> CascadesSplitLambda("r.Shadows.CascadesSplitLambda", 0.5f, "Lambda used when calculating cascades split");
 	static TAutoConsoleVariable<Float> ShadowFarFactor("r.Shadows.FarFactor", 1.2f, "Far factor used to calculate projection matrices of directional light");
+	static TAutoConsoleVariable<Bool>  ShadowMeshLODs("r.Shadows.MeshLODs", true, "Select the LOD of shadow casters by their simplification error projected into each shadow map");
+	static TAutoConsoleVariable<Float> ShadowMeshLODTexelError("r.Shadows.MeshLODs.TexelError", 1.0f, "Largest simplification error in shadow map texels a selected shadow caster LOD may project to");
 
 	namespace
 	{
@@ -350,7 +356,14 @@ namespace adria
 			}
 		}
 
+		//the projections are square, texels per unit at a distance of one for perspective ones
+		auto AddLODView = [this](Matrix const& P, Uint32 shadow_map_size, Vector3 const& position, Bool orthographic)
+		{
+			lod_views.push_back(ShadowLODView{ .position = position, .texels_per_unit = P._22 * shadow_map_size * 0.5f, .orthographic = orthographic });
+		};
+
 		bounding_objects.clear();
+		lod_views.clear();
 		std::vector<Matrix> light_matrices;
 		light_matrices.reserve(light_matrices_count);
 		for (auto e : light_view)
@@ -372,6 +385,7 @@ namespace adria
 						{
 							auto const& [V, P] = LightViewProjection_Cascades(light, *camera, proj_matrices[i], SHADOW_CASCADE_MAP_SIZE, bounding_objects);
 							light_matrices.push_back(XMMatrixTranspose(V * P));
+							AddLODView(P, SHADOW_CASCADE_MAP_SIZE, Vector3::Zero, true);
 						}
 					}
 					else
@@ -379,6 +393,7 @@ namespace adria
 						AddShadowMaps(light, entt::to_integral(e));
 						auto const& [V, P] = LightViewProjection_Directional(light, *camera, SHADOW_MAP_SIZE, bounding_objects);
 						light_matrices.push_back(XMMatrixTranspose(V * P));
+						AddLODView(P, SHADOW_MAP_SIZE, Vector3::Zero, true);
 					}
 
 				}
@@ -389,6 +404,7 @@ namespace adria
 					{
 						auto const& [V, P] = LightViewProjection_Point(light, i, bounding_objects);
 						light_matrices.push_back(XMMatrixTranspose(V * P));
+						AddLODView(P, SHADOW_CUBE_SIZE, Vector3(light.position), false);
 					}
 				}
 				else if (light.type == LightType::Spot)
@@ -396,6 +412,7 @@ namespace adria
 					AddShadowMaps(light, entt::to_integral(e));
 					auto const& [V, P] = LightViewProjection_Spot(light, bounding_objects);
 					light_matrices.push_back(XMMatrixTranspose(V * P));
+					AddLODView(P, SHADOW_MAP_SIZE, Vector3(light.position), false);
 				}
 			}
 			else if (light.ray_traced_shadows)
@@ -403,7 +420,7 @@ namespace adria
 				AddShadowMask(light, entt::to_integral(e));
 			}
 		}
-		ADRIA_ASSERT(light_matrices.size() == bounding_objects.size());
+		ADRIA_ASSERT(light_matrices.size() == bounding_objects.size() && light_matrices.size() == lod_views.size());
 
 		if (light_matrices_buffer)
 		{
@@ -414,6 +431,36 @@ namespace adria
 		}
 	}
 
+	void ShadowRenderer::CullShadowCasters(Bool parallel)
+	{
+		ADRIA_ASSERT(instance_bounds != nullptr);
+		std::vector<CullingPlanes> culling_planes(bounding_objects.size());
+		for (Uint64 i = 0; i < bounding_objects.size(); ++i)
+		{
+			BoundingObject const& bounding_object = bounding_objects[i];
+			culling_planes[i] = bounding_object.type == BoundingObject::Box ? CullingPlanes::FromBox(bounding_object.GetBox()) : CullingPlanes::FromFrustum(bounding_object.GetFrustum());
+		}
+
+		Uint64 const instance_count = instance_bounds->Size();
+		shadow_visibility_masks.resize(bounding_objects.size());
+		for (std::vector<Uint64>& visibility_mask : shadow_visibility_masks) visibility_mask.resize((instance_count + 63) / 64);
+
+		//every task culls one chunk of instances against one light matrix, chunks cover whole mask words so tasks never share one
+		Uint64 const boxes_per_chunk = parallel ? CULLED_BOXES_PER_CHUNK : std::max<Uint64>(instance_count, 1);
+		Uint64 const chunks_per_matrix = (instance_count + boxes_per_chunk - 1) / boxes_per_chunk;
+		Uint64 const task_count = bounding_objects.size() * chunks_per_matrix;
+		g_ThreadPool.ParallelFor(task_count, parallel ? 1 : task_count, [&](Uint64 begin, Uint64 end)
+		{
+			for (Uint64 task = begin; task < end; ++task)
+			{
+				Uint64 const matrix_index = task / chunks_per_matrix;
+				Uint64 const first_box = (task % chunks_per_matrix) * boxes_per_chunk;
+				Uint64 const box_count = std::min(boxes_per_chunk, instance_count - first_box);
+				CullBoundingBoxes(culling_planes[matrix_index], *instance_bounds, first_box, box_count, shadow_visibility_masks[matrix_index]);
+			}
+		});
+	}
+
 	void ShadowRenderer::AddShadowMapPasses(RenderGraph& rg)
 	{
 		FrameBlackboardData const& frame_data = rg.GetBlackboard().Get<FrameBlackboardData>();
@@ -544,6 +591,11 @@ namespace adria
 		gfx_pso_desc.dsv_format = GfxFormat::D32_FLOAT;
 
 		shadow_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gfx_pso_desc);
+		//permutation key 1 is the alpha tested variant
+		shadow_psos->AddPermutations(2, [](GfxGraphicsPipelineStatePermutations& psos, Uint32 permutation_key)
+			{
+				if (permutation_key) psos.AddDefine("TRANSPARENT", "1");
+			});
 	}
 
 	void ShadowRenderer::ShadowMapPass_Common(GfxCommandList* cmd_list, LightType light_type, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset)
@@ -557,7 +609,10 @@ namespace adria
 			.light_index = (Uint32)light_index,
 			.matrix_offset = (Uint32)matrix_offset
 		};
-		auto view = reg.view<Batch>();
+		std::vector<Uint64> const& visibility_mask = shadow_visibility_masks[matrix_index + matrix_offset];
+		ShadowLODView const& lod_view = lod_views[matrix_index + matrix_offset];
+		Bool const select_lods = ShadowMeshLODs.Get();
+		Float const max_texel_error = ShadowMeshLODTexelError.Get();
 		std::vector<Batch*> masked_batches, opaque_batches;
 		for (auto batch_entity : reg.view<Batch>())
 		{
@@ -569,41 +624,24 @@ namespace adria
 		auto DrawBatch = [&](GfxCommandList* cmd_list, Bool masked_batch)
 		{
 			std::vector<Batch*>& batches = masked_batch ? masked_batches : opaque_batches;
-			if (masked_batch)
-			{
-				shadow_psos->AddDefine("TRANSPARENT", "1");
-			}
-			GfxPipelineState* pso = shadow_psos->Get();
+			GfxPipelineState* pso = shadow_psos->Get(masked_batch);
 			cmd_list->SetRootConstants(1, constants);
 			cmd_list->SetPipelineState(pso);
 			for (Batch* batch : batches)
 			{
-				Bool skip_batch = false;
-				switch (light_type)
-				{
-				case LightType::Directional:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Box);
-					skip_batch = !bounding_objects[matrix_index].GetBox().Intersects(batch->bounding_box);
-					break;
-				case LightType::Spot:
-				case LightType::Point:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Frustum);
-					skip_batch = !bounding_objects[matrix_index].GetFrustum().Intersects(batch->bounding_box);
-					break;
-				default:
-					ADRIA_ASSERT(false);
-				}
-				if (skip_batch) continue;
+				if (!IsVisible(visibility_mask, batch->instance_id)) continue;
 
 				struct ModelConstants
 				{
 					Uint32 instance_id;
 				} model_constants{ .instance_id = batch->instance_id };
 				cmd_list->SetRootCBV(2, model_constants);
-				GfxIndexBufferView ibv(batch->submesh->buffer_address + batch->submesh->indices_offset, batch->submesh->indices_count);
+				Uint32 const lod_index = select_lods ? SelectBatchLOD(*batch, lod_view.position, lod_view.orthographic, lod_view.texels_per_unit, max_texel_error) : 0;
+				SubMeshLOD const& lod = batch->submesh->lods[lod_index];
+				GfxIndexBufferView ibv(batch->submesh->buffer_address + lod.indices_offset, lod.indices_count);
 				cmd_list->SetTopology(batch->submesh->topology);
 				cmd_list->SetIndexBuffer(&ibv);
-				cmd_list->DrawIndexed(batch->submesh->indices_count);
+				cmd_list->DrawIndexed(lod.indices_count);
 			}
 		};
 
@@ -16,6 +16,7 @@ namespace adria
 	class RenderGraph;
 	class Camera;
 	struct FrameCBuffer;
+	struct BoundingBoxStreams;
 	enum class LightType : Int32;
 
 	struct BoundingObject
@@ -26,8 +27,8 @@ namespace adria
 			Frustum
 		} type = Box;
 
-		BoundingObject(BoundingBox const& box) : data(box) {}
-		BoundingObject(BoundingFrustum const& frustum) : data(frustum) {}
+		BoundingObject(BoundingBox const& box) : type(Box), data(box) {}
+		BoundingObject(BoundingFrustum const& frustum) : type(Frustum), data(frustum) {}
 
 		BoundingBox const& GetBox() const
 		{
@@ -50,6 +51,14 @@ namespace adria
 		static constexpr Uint32 SHADOW_CASCADE_MAP_SIZE = 1024;
 		static constexpr Uint32 SHADOW_CASCADE_COUNT = 4;
 
+		//Projects mesh LOD errors into texels of one shadow map, orthographic views use the same texel size at every distance
+		struct ShadowLODView
+		{
+			Vector3 position;
+			Float texels_per_unit;
+			Bool orthographic;
+		};
+
 	public:
 		ShadowRenderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height);
 		~ShadowRenderer();
@@ -64,11 +73,13 @@ namespace adria
 			}
 		}
 		void SetupShadows(Camera const* camera);
+		void CullShadowCasters(Bool parallel);
 
 		void AddShadowMapPasses(RenderGraph& rg);
 		void AddRayTracingShadowPasses(RenderGraph& rg);
 
 		void FillFrameCBuffer(FrameCBuffer& frame_cbuffer);
+		void SetInstanceBounds(BoundingBoxStreams const* bounds) { instance_bounds = bounds; }
 
 		ShadowTextureRenderedEvent& GetShadowTextureRenderedEvent() { return shadow_rendered_event; }
 
@@ -91,6 +102,9 @@ namespace adria
 		Int32						   light_matrices_gpu_index = -1;
 
 		std::vector<BoundingObject>						bounding_objects;
+		std::vector<ShadowLODView>						lod_views;
+		BoundingBoxStreams const*						instance_bounds = nullptr;
+		std::vector<std::vector<Uint64>>				shadow_visibility_masks;
 		std::array<Float, SHADOW_CASCADE_COUNT>		    split_distances{};
 
 		ShadowTextureRenderedEvent shadow_rendered_event;
@@ -91,7 +91,7 @@ namespace adria
 						cmd_list->SetRootConstants(1, constants);
 						Uint32 const dispatch = DivideAndRoundUp(resolution, 8);
 						cmd_list->Dispatch(dispatch, dispatch, dispatch);
-					}, RGPassType::Compute, RGPassFlags::None);
+					}, RGPassType::ComputeAsync, RGPassFlags::None);
 			}
 
 			for (Uint32 i = 0; i < cloud_detail_noise->GetDesc().mip_levels; ++i)
@@ -126,7 +126,7 @@ namespace adria
 						cmd_list->SetRootConstants(1, constants);
 						Uint32 const dispatch = DivideAndRoundUp(resolution, 8);
 						cmd_list->Dispatch(dispatch, dispatch, dispatch);
-					}, RGPassType::Compute, RGPassFlags::None);
+					}, RGPassType::ComputeAsync, RGPassFlags::None);
 			}
 
 			struct CloudTypePassData
@@ -158,7 +158,7 @@ namespace adria
 					cmd_list->SetRootConstants(1, constants);
 					Uint32 const dispatch = DivideAndRoundUp(resolution, 8);
 					cmd_list->Dispatch(dispatch, dispatch, dispatch);
-				}, RGPassType::Compute, RGPassFlags::None);
+				}, RGPassType::ComputeAsync, RGPassFlags::None);
 		}
 		else
 		{
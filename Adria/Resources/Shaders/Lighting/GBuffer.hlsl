@@ -35,10 +35,10 @@ VSToPS GBufferVS(uint vertexId : SV_VertexID)
     Instance instanceData = GetInstanceData(GBufferPassCB.instanceId);
     Mesh meshData = GetMeshData(instanceData.meshIndex);
 
-	float3 pos = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
-	float2 uv  = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, vertexId);
-	float3 nor = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, vertexId);
-	float4 tan = LoadMeshBuffer<float4>(meshData.bufferIdx, meshData.tangentsOffset, vertexId);
+	float3 pos = LoadMeshPosition(meshData, vertexId);
+	float2 uv  = LoadMeshUV(meshData, vertexId);
+	float3 nor = LoadMeshNormal(meshData, vertexId);
+	float4 tan = LoadMeshTangent(meshData, vertexId);
     
 	float4 posWS = mul(float4(pos, 1.0), instanceData.worldMatrix);
 	output.PositionWS = posWS.xyz;
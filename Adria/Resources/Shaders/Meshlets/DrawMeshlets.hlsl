@@ -27,10 +27,10 @@ struct MSToPS
 MSToPS GetVertex(Mesh mesh, Instance instance, uint vertexId)
 {
 	MSToPS output;
-	float3 pos = LoadMeshBuffer<float3>(mesh.bufferIdx,  mesh.positionsOffset, vertexId);
-	float2 uv  = LoadMeshBuffer<float2>(mesh.bufferIdx,  mesh.uvsOffset, vertexId);
-	float3 nor = LoadMeshBuffer<float3>(mesh.bufferIdx,  mesh.normalsOffset, vertexId);
-	float4 tan = LoadMeshBuffer<float4>(mesh.bufferIdx,  mesh.tangentsOffset, vertexId);
+	float3 pos = LoadMeshPosition(mesh, vertexId);
+	float2 uv  = LoadMeshUV(mesh, vertexId);
+	float3 nor = LoadMeshNormal(mesh, vertexId);
+	float4 tan = LoadMeshTangent(mesh, vertexId);
 	
 	float4 posWS = mul(float4(pos, 1.0), instance.worldMatrix);
 	output.PositionWS = posWS.xyz;
@@ -79,4 +79,11 @@ float3 DecodeNormal16x2(uint f)
     return DecodeNormalOctahedron(n * 2.0 - 1.0);
 }
 
+//octahedral tangent with 16 bits for x, 15 bits for y and the bitangent sign in the lowest bit
+float4 DecodeTangent16x15(uint f)
+{
+    float2 t = float2(f >> 16, (f >> 1) & 0x7fff) / float2(65535.0, 32767.0);
+    return float4(DecodeNormalOctahedron(t * 2.0 - 1.0), (f & 1) ? -1.0 : 1.0);
+}
+
 #endif
\ No newline at end of file
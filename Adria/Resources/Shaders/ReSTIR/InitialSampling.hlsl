@@ -57,8 +57,8 @@ void InitialSamplingCS( uint3 dispatchThreadID : SV_DispatchThreadID )
 
 		VertexData vertex = LoadVertexData(meshData, info.primitiveIndex, info.barycentricCoordinates);
         
-        float3 worldPosition = mul(vertex.pos, info.objectToWorldMatrix).xyz;
-        float3 worldNormal = normalize(mul(vertex.nor, (float3x3) transpose(info.worldToObjectMatrix)));
+        float3 worldPosition = mul(float4(vertex.pos, 1.0f), instanceData.worldMatrix).xyz;
+        float3 worldNormal = normalize(mul(vertex.nor, (float3x3) transpose(instanceData.inverseWorldMatrix)));
         float3 geometryNormal = normalize(worldNormal);
         float3 V = -ray.Direction;
         MaterialProperties matProperties = GetMaterialProperties(materialData, vertex.uv, 0);
@@ -1,6 +1,13 @@
 #ifndef _SCENE_
 #define _SCENE_
 #include "CommonResources.hlsli"
+#include "Packing.hlsli"
+
+enum MeshVertexFormat : uint
+{
+	MeshVertexFormat_Full,
+	MeshVertexFormat_Compressed
+};
 
 struct Mesh
 {
@@ -14,6 +21,10 @@ struct Mesh
 	uint meshletVerticesOffset;
 	uint meshletTrianglesOffset;
 	uint meshletCount;
+
+	MeshVertexFormat vertexFormat;
+	float3 positionBias;
+	float3 positionScale;
 };
 
 enum ShadingExtension : uint
@@ -88,6 +99,44 @@ T LoadMeshBuffer(uint bufferIdx, uint bufferOffset, uint vertexId)
 	return meshBuffer.Load<T>(bufferOffset + sizeof(T) * vertexId);
 }
 
+float3 LoadMeshPosition(Mesh meshData, uint vertexId)
+{
+	if (meshData.vertexFormat == MeshVertexFormat_Compressed)
+	{
+		uint2 packed = LoadMeshBuffer<uint2>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
+		int3 quantized = int3(packed.x << 16, packed.x, packed.y << 16) >> 16;
+		return meshData.positionBias + max(quantized / 32767.0f, -1.0f) * meshData.positionScale;
+	}
+	return LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
+}
+
+float2 LoadMeshUV(Mesh meshData, uint vertexId)
+{
+	if (meshData.vertexFormat == MeshVertexFormat_Compressed)
+	{
+		return UnpackHalf2(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.uvsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, vertexId);
+}
+
+float3 LoadMeshNormal(Mesh meshData, uint vertexId)
+{
+	if (meshData.vertexFormat == MeshVertexFormat_Compressed)
+	{
+		return DecodeNormal16x2(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.normalsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, vertexId);
+}
+
+float4 LoadMeshTangent(Mesh meshData, uint vertexId)
+{
+	if (meshData.vertexFormat == MeshVertexFormat_Compressed)
+	{
+		return DecodeTangent16x15(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.tangentsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float4>(meshData.bufferIdx, meshData.tangentsOffset, vertexId);
+}
+
 struct VertexData
 {
 	float3 pos;
@@ -110,19 +159,19 @@ VertexData LoadVertexData(Mesh meshData, uint triangleIndex, float2 barycentrics
 	uint i1 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 1);
 	uint i2 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 2);
 
-	float3 pos0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i0);
-	float3 pos1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i1);
-	float3 pos2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i2);
+	float3 pos0 = LoadMeshPosition(meshData, i0);
+	float3 pos1 = LoadMeshPosition(meshData, i1);
+	float3 pos2 = LoadMeshPosition(meshData, i2);
 	float3 pos = Interpolate(pos0, pos1, pos2, barycentrics);
 
-	float2 uv0 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i0);
-	float2 uv1 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i1);
-	float2 uv2 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i2);
+	float2 uv0 = LoadMeshUV(meshData, i0);
+	float2 uv1 = LoadMeshUV(meshData, i1);
+	float2 uv2 = LoadMeshUV(meshData, i2);
 	float2 uv = Interpolate(uv0, uv1, uv2, barycentrics);
 
-	float3 nor0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i0);
-	float3 nor1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i1);
-	float3 nor2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i2);
+	float3 nor0 = LoadMeshNormal(meshData, i0);
+	float3 nor1 = LoadMeshNormal(meshData, i1);
+	float3 nor2 = LoadMeshNormal(meshData, i2);
 	float3 nor = normalize(Interpolate(nor0, nor1, nor2, barycentrics));
 
 	VertexData vertex = (VertexData)0;
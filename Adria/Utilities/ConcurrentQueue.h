@@ -1,70 +1,146 @@
 #pragma once
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 namespace adria
 {
+	//Bounded lock-free multi-producer multi-consumer queue (Vyukov ring). Every cell carries a sequence number that tells
+	//producers and consumers whether it is free for the lap they are on, so Push and TryPop only need one CAS on the shared position.
+	//Producers never take a lock, they only wake consumers blocked in WaitPop when there are any.
+	template<typename T, Uint64 Capacity = 4096> requires ((Capacity & (Capacity - 1)) == 0) && std::is_default_constructible_v<T>
+	class ConcurrentQueue
+	{
+		static constexpr Uint64 MASK = Capacity - 1;
 
-    template<typename T>
-    class ConcurrentQueue
-    {
-    public:
+		struct Cell
+		{
+			std::atomic<Uint64> sequence;
+			T value;
+		};
 
-        ConcurrentQueue() = default;
-		ADRIA_NONCOPYABLE(ConcurrentQueue)
-		ADRIA_DEFAULT_MOVABLE(ConcurrentQueue)
-        ~ConcurrentQueue() = default;
+	public:
 
-        void Push(T const& value)
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            queue.push(value);
-            cond_variable.notify_one();
-        }
+		ConcurrentQueue() : cells(std::make_unique<Cell[]>(Capacity))
+		{
+			for (Uint64 i = 0; i < Capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		ADRIA_NONCOPYABLE_NONMOVABLE(ConcurrentQueue)
+		~ConcurrentQueue() = default;
 
-        void Push(T&& value)
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            queue.push(std::forward<T>(value));
-            cond_variable.notify_one();
-        }
+		//Returns false when the queue is full
+		template<typename U> requires std::is_assignable_v<T&, U&&>
+		Bool TryPush(U&& value)
+		{
+			Uint64 position = enqueue_position.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Cell& cell = cells[position & MASK];
+				Uint64 const sequence = cell.sequence.load(std::memory_order_acquire);
+				Int64 const difference = (Int64)sequence - (Int64)position;
+				if (difference == 0)
+				{
+					if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						cell.value = std::forward<U>(value);
+						cell.sequence.store(position + 1, std::memory_order_release);
+						WakeConsumer();
+						return true;
+					}
+				}
+				else if (difference < 0) return false;
+				else position = enqueue_position.load(std::memory_order_relaxed);
+			}
+		}
 
-        void WaitPop(T& value)
-        {
-            std::unique_lock<std::mutex> lock(mutex);
-            cond_variable.wait(lock, [this] {return !queue.empty(); });
-            value = std::move(queue.front());
-            queue.pop();
-        }
+		//Yields while the queue is full
+		void Push(T const& value)
+		{
+			while (!TryPush(value)) std::this_thread::yield();
+		}
 
-        Bool TryPop(T& value)
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            if (queue.empty()) return false;
+		void Push(T&& value)
+		{
+			while (!TryPush(std::move(value))) std::this_thread::yield();
+		}
 
-            value = std::move(queue.front());
-            queue.pop();
-            return true;
-        }
+		Bool TryPop(T& value)
+		{
+			Uint64 position = dequeue_position.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Cell& cell = cells[position & MASK];
+				Uint64 const sequence = cell.sequence.load(std::memory_order_acquire);
+				Int64 const difference = (Int64)sequence - (Int64)(position + 1);
+				if (difference == 0)
+				{
+					if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						value = std::move(cell.value);
+						cell.sequence.store(position + Capacity, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0) return false;
+				else position = dequeue_position.load(std::memory_order_relaxed);
+			}
+		}
 
-        Bool Empty() const
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            return queue.empty();
-        }
+		//Blocks until an element is available
+		void WaitPop(T& value)
+		{
+			while (!TryPop(value))
+			{
+				waiting_consumers.fetch_add(1, std::memory_order_seq_cst);
+				//pairs with the fence in WakeConsumer: either the producer sees this consumer waiting or the check below sees the pushed element
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				Uint32 const epoch = push_epoch.load(std::memory_order_seq_cst);
+				Bool const popped = TryPop(value);
+				if (!popped) push_epoch.wait(epoch, std::memory_order_seq_cst);
+				waiting_consumers.fetch_sub(1, std::memory_order_relaxed);
+				if (popped) return;
+			}
+		}
 
-        Uint64 Size() const
-        {
-            std::lock_guard<std::mutex> lock(mutex);
-            return queue.size();
-        }
+		//Wakes every consumer blocked in WaitPop without pushing, they go back to sleep unless the queue is not empty
+		void NotifyAll()
+		{
+			push_epoch.fetch_add(1, std::memory_order_seq_cst);
+			push_epoch.notify_all();
+		}
 
-    private:
-        std::queue<T> queue;
-        mutable std::mutex mutex;
-        std::condition_variable cond_variable;
-    };
+		Bool Empty() const
+		{
+			return Size() == 0;
+		}
 
+		//Approximate while other threads push or pop
+		Uint64 Size() const
+		{
+			Uint64 const dequeue = dequeue_position.load(std::memory_order_relaxed);
+			Uint64 const enqueue = enqueue_position.load(std::memory_order_relaxed);
+			return enqueue > dequeue ? enqueue - dequeue : 0;
+		}
 
+		static constexpr Uint64 GetCapacity() { return Capacity; }
+
+	private:
+		std::unique_ptr<Cell[]> cells;
+		alignas(64) std::atomic<Uint64> enqueue_position = 0;
+		alignas(64) std::atomic<Uint64> dequeue_position = 0;
+		alignas(64) std::atomic<Uint32> push_epoch = 0;
+		std::atomic<Uint32> waiting_consumers = 0;
+
+	private:
+		void WakeConsumer()
+		{
+			//pairs with the increment in WaitPop: either the consumer sees the pushed element or this sees the waiting consumer
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (waiting_consumers.load(std::memory_order_relaxed) > 0)
+			{
+				push_epoch.fetch_add(1, std::memory_order_seq_cst);
+				push_epoch.notify_one();
+			}
+		}
+	};
 }
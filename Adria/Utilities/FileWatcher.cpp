@@ -0,0 +1,241 @@
+#include "FileWatcher.h"
+#include "StringUtil.h"
+#include "Logging/Logger.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	struct FileWatcher::WatchedDirectory
+	{
+		std::string path;
+		Bool recursive = true;
+		HANDLE handle = INVALID_HANDLE_VALUE;
+		HANDLE stop_event = nullptr;
+		std::thread thread;
+		//set when notifications were lost or the directory cannot be watched, the next check compares write times instead
+		std::atomic<Bool> needs_poll = false;
+		std::atomic<Bool> polled = false;
+	};
+
+	FileWatcher::FileWatcher() = default;
+
+	FileWatcher::~FileWatcher()
+	{
+		for (std::unique_ptr<WatchedDirectory>& directory : watched_directories)
+		{
+			if (directory->thread.joinable())
+			{
+				SetEvent(directory->stop_event);
+				directory->thread.join();
+			}
+			if (directory->stop_event) CloseHandle(directory->stop_event);
+			if (directory->handle != INVALID_HANDLE_VALUE) CloseHandle(directory->handle);
+		}
+		file_modified_event.RemoveAll();
+	}
+
+	void FileWatcher::AddPathToWatch(std::string const& path, Bool recursive)
+	{
+		std::unique_ptr<WatchedDirectory>& directory = watched_directories.emplace_back(std::make_unique<WatchedDirectory>());
+		directory->path = path;
+		directory->recursive = recursive;
+		//the write times are only compared when the directory is polled, either as a fallback or after lost notifications
+		PollDirectory(*directory, true);
+
+		std::wstring const wide_path = ToWideString(path);
+		directory->handle = CreateFileW(wide_path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+										nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		directory->stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		if (directory->handle == INVALID_HANDLE_VALUE || !directory->stop_event)
+		{
+			directory->polled = true;
+			return;
+		}
+		directory->thread = std::thread(&FileWatcher::WatchDirectory, this, std::ref(*directory));
+	}
+
+	void FileWatcher::CheckWatchedFiles()
+	{
+		for (std::unique_ptr<WatchedDirectory> const& directory : watched_directories)
+		{
+			if (directory->polled || directory->needs_poll.exchange(false)) PollDirectory(*directory, false);
+		}
+
+		std::string file;
+		while (changed_files.TryPop(file)) pending_files.insert(std::move(file));
+		for (std::string const& pending_file : pending_files) ReportChangedFile(pending_file);
+		pending_files.clear();
+	}
+
+	void FileWatcher::WatchDirectory(WatchedDirectory& directory)
+	{
+		alignas(DWORD) Uint8 buffer[64 * 1024];
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		HANDLE const wait_handles[] = { overlapped.hEvent, directory.stop_event };
+		DWORD const notify_filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+
+		//files are queued once they did not change for DEBOUNCE_TIME, the wait times out when the oldest pending file settles
+		PendingChanges pending_changes;
+		auto GetWaitTimeout = [&pending_changes]() -> DWORD
+		{
+			if (pending_changes.empty()) return INFINITE;
+			auto const last_change = std::min_element(pending_changes.begin(), pending_changes.end(), [](auto const& a, auto const& b) { return a.second < b.second; })->second;
+			auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(last_change + DEBOUNCE_TIME - std::chrono::steady_clock::now());
+			return (DWORD)std::max<Int64>(remaining.count() + 1, 0);
+		};
+
+		while (overlapped.hEvent)
+		{
+			ResetEvent(overlapped.hEvent);
+			if (!ReadDirectoryChangesW(directory.handle, buffer, sizeof(buffer), directory.recursive, notify_filter, nullptr, &overlapped, nullptr))
+			{
+				directory.polled = true;
+				break;
+			}
+
+			DWORD bytes_returned = 0;
+			DWORD wait_result = WAIT_TIMEOUT;
+			while ((wait_result = WaitForMultipleObjects(ARRAYSIZE(wait_handles), wait_handles, FALSE, GetWaitTimeout())) == WAIT_TIMEOUT)
+			{
+				QueueSettledChanges(directory, pending_changes);
+			}
+			if (wait_result != WAIT_OBJECT_0)
+			{
+				CancelIo(directory.handle);
+				GetOverlappedResult(directory.handle, &overlapped, &bytes_returned, TRUE);
+				break;
+			}
+			//the notification buffer overflowed (bytes_returned is 0) or the read failed, changes since the last call are unknown
+			if (!GetOverlappedResult(directory.handle, &overlapped, &bytes_returned, FALSE) || bytes_returned == 0)
+			{
+				directory.needs_poll.store(true);
+				continue;
+			}
+
+			auto const now = std::chrono::steady_clock::now();
+			Uint8 const* notification_data = buffer;
+			while (true)
+			{
+				FILE_NOTIFY_INFORMATION const* notification = reinterpret_cast<FILE_NOTIFY_INFORMATION const*>(notification_data);
+				std::wstring const relative_path(notification->FileName, notification->FileName + notification->FileNameLength / sizeof(WCHAR));
+				fs::path const file_path = fs::path(directory.path) / relative_path;
+				std::error_code error;
+				switch (notification->Action)
+				{
+				case FILE_ACTION_ADDED:
+				case FILE_ACTION_MODIFIED:
+				case FILE_ACTION_RENAMED_NEW_NAME:
+					if (fs::is_regular_file(file_path, error))
+					{
+						pending_changes[file_path.string()] = now;
+					}
+					//directories that are added or moved in only report themselves, not the files inside them
+					else if (fs::is_directory(file_path, error) && notification->Action != FILE_ACTION_MODIFIED)
+					{
+						for (auto const& entry : fs::recursive_directory_iterator(file_path, error))
+						{
+							if (entry.is_regular_file(error)) pending_changes[entry.path().string()] = now;
+						}
+					}
+					break;
+				//the path is gone, ReportChangedFile finds out whether it was a file or a directory from the files it knows
+				case FILE_ACTION_REMOVED:
+				case FILE_ACTION_RENAMED_OLD_NAME:
+					pending_changes[file_path.string()] = now;
+					break;
+				}
+				if (notification->NextEntryOffset == 0) break;
+				notification_data += notification->NextEntryOffset;
+			}
+			QueueSettledChanges(directory, pending_changes);
+		}
+		if (overlapped.hEvent) CloseHandle(overlapped.hEvent);
+	}
+
+	void FileWatcher::QueueSettledChanges(WatchedDirectory& directory, PendingChanges& pending_changes)
+	{
+		auto const now = std::chrono::steady_clock::now();
+		for (auto it = pending_changes.begin(); it != pending_changes.end();)
+		{
+			if (now - it->second < DEBOUNCE_TIME)
+			{
+				++it;
+				continue;
+			}
+			if (!changed_files.TryPush(it->first)) directory.needs_poll.store(true);
+			it = pending_changes.erase(it);
+		}
+	}
+
+	void FileWatcher::PollDirectory(WatchedDirectory const& directory, Bool initial_scan)
+	{
+		std::unordered_set<std::string> existing_files;
+		auto CheckFile = [&](fs::directory_entry const& entry)
+		{
+			std::error_code error;
+			if (!entry.is_regular_file(error)) return;
+			auto const last_write_time = entry.last_write_time(error);
+			if (error) return;
+
+			std::string file = entry.path().string();
+			if (initial_scan)
+			{
+				files_map[file] = last_write_time;
+				return;
+			}
+			//ReportChangedFile updates files_map, new files are reported as created because they are not in it yet
+			if (auto it = files_map.find(file); it == files_map.end() || it->second != last_write_time) pending_files.insert(file);
+			existing_files.insert(std::move(file));
+		};
+
+		std::error_code error;
+		if (directory.recursive)
+		{
+			for (auto const& entry : fs::recursive_directory_iterator(directory.path, error)) CheckFile(entry);
+		}
+		else
+		{
+			for (auto const& entry : fs::directory_iterator(directory.path, error)) CheckFile(entry);
+		}
+		if (initial_scan) return;
+
+		std::string const directory_prefix = (fs::path(directory.path) / "").string();
+		for (auto const& [file, last_write_time] : files_map)
+		{
+			if (file.starts_with(directory_prefix) && !existing_files.contains(file)) pending_files.insert(file);
+		}
+	}
+
+	void FileWatcher::ReportChangedFile(std::string const& file)
+	{
+		std::error_code error;
+		if (fs::is_regular_file(file, error))
+		{
+			auto const last_write_time = fs::last_write_time(file, error);
+			if (error) return;
+			auto const [it, inserted] = files_map.insert_or_assign(file, last_write_time);
+			file_modified_event.Broadcast(file, inserted ? FileStatus::Created : FileStatus::Modified);
+			return;
+		}
+		if (files_map.erase(file))
+		{
+			file_modified_event.Broadcast(file, FileStatus::Deleted);
+			return;
+		}
+
+		//a removed or renamed directory only reports itself, every file that was in it is gone
+		std::string const directory_prefix = (fs::path(file) / "").string();
+		std::vector<std::string> deleted_files;
+		for (auto const& [known_file, last_write_time] : files_map)
+		{
+			if (known_file.starts_with(directory_prefix)) deleted_files.push_back(known_file);
+		}
+		for (std::string const& deleted_file : deleted_files)
+		{
+			files_map.erase(deleted_file);
+			file_modified_event.Broadcast(deleted_file, FileStatus::Deleted);
+		}
+	}
+}
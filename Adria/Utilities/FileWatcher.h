@@ -1,6 +1,8 @@
 #pragma once
 #include <filesystem>
+#include <chrono>
 #include "Utilities/Delegate.h"
+#include "Utilities/ConcurrentQueue.h"
 
 namespace adria
 {
@@ -11,51 +13,39 @@ namespace adria
 		Deleted
 	};
 
-	DECLARE_EVENT(FileModifiedEvent, FileWatcher, std::string const&)
+	DECLARE_EVENT(FileModifiedEvent, FileWatcher, std::string const&, FileStatus)
 
+	//Watches directories with ReadDirectoryChangesW on one thread per watched path. The watcher threads queue files once they
+	//stopped changing for DEBOUNCE_TIME and CheckWatchedFiles reports them, the status is decided by the file system at that point.
+	//Paths that cannot be watched that way fall back to comparing the last write time of every file on each check.
 	class FileWatcher
 	{
+		static constexpr std::chrono::milliseconds DEBOUNCE_TIME{ 100 };
+		struct WatchedDirectory;
+		using PendingChanges = std::unordered_map<std::string, std::chrono::steady_clock::time_point>;
+
 	public:
-		FileWatcher() = default;
-		~FileWatcher()
-		{
-			file_modified_event.RemoveAll();
-		}
-
-		void AddPathToWatch(std::string const& path, Bool recursive = true)
-		{
-			if (recursive)
-			{
-				for (auto& path : std::filesystem::recursive_directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-			else
-			{
-				for (auto& path : std::filesystem::directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-		}
-		void CheckWatchedFiles()
-		{
-			for (auto const& [file, ft] : files_map)
-			{
-				auto current_file_last_write_time = std::filesystem::last_write_time(file);
-				if (files_map[file] != current_file_last_write_time)
-				{
-					files_map[file] = current_file_last_write_time;
-					file_modified_event.Broadcast(file);
-				}
-			}
-		}
+		FileWatcher();
+		ADRIA_NONCOPYABLE_NONMOVABLE(FileWatcher)
+		~FileWatcher();
+
+		void AddPathToWatch(std::string const& path, Bool recursive = true);
+		//Reports files that were created, modified or deleted since the last check, files that are still being written to are reported once they settle
+		void CheckWatchedFiles();
 
 		FileModifiedEvent& GetFileModifiedEvent() { return file_modified_event; }
 
 	private:
+		std::vector<std::unique_ptr<WatchedDirectory>> watched_directories;
+		ConcurrentQueue<std::string, 1024> changed_files;
+		std::unordered_set<std::string> pending_files;
 		std::unordered_map<std::string, std::filesystem::file_time_type> files_map;
 		FileModifiedEvent file_modified_event;
+
+	private:
+		void WatchDirectory(WatchedDirectory& directory);
+		void QueueSettledChanges(WatchedDirectory& directory, PendingChanges& pending_changes);
+		void PollDirectory(WatchedDirectory const& directory, Bool initial_scan);
+		void ReportChangedFile(std::string const& file);
 	};
-}
\ No newline at end of file
+}
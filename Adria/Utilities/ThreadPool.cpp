@@ -0,0 +1,145 @@
+#include "ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 IDLE_SPIN_COUNT = 64;
+
+		thread_local Uint32 tls_thread_index = Uint32(-1);
+		thread_local Uint32 tls_steal_state = 0x9E3779B9u;
+
+		Uint32 NextStealIndex()
+		{
+			Uint32 x = tls_steal_state;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			tls_steal_state = x;
+			return x;
+		}
+	}
+
+	void ThreadPool::Initialize(Uint pool_size)
+	{
+		done = false;
+
+		static const Uint max_threads = std::thread::hardware_concurrency();
+		Uint const num_threads = pool_size == 0 ? max_threads - 1 : std::min(max_threads - 1, pool_size);
+		thread_contexts.resize(num_threads + 2);
+		for (std::unique_ptr<ThreadContext>& thread_context : thread_contexts) thread_context = std::make_unique<ThreadContext>();
+
+		tls_thread_index = 0;
+		threads.reserve(num_threads);
+		for (Uint i = 0; i < num_threads; ++i)
+		{
+			threads.emplace_back(&ThreadPool::ThreadWork, this, i + 1);
+		}
+	}
+
+	void ThreadPool::Destroy()
+	{
+		if (done.exchange(true))
+		{
+			return;
+		}
+
+		wake_epoch.fetch_add(1);
+		wake_epoch.notify_all();
+		for (Uint64 i = 0; i < threads.size(); ++i)
+		{
+			if (threads[i].joinable())  threads[i].join();
+		}
+	}
+
+	void ThreadPool::Wait(JobCounter const& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!TryExecuteJob()) std::this_thread::yield();
+		}
+	}
+
+	void ThreadPool::ThreadWork(Uint32 thread_index)
+	{
+		tls_thread_index = thread_index;
+		tls_steal_state ^= thread_index * 0x85EBCA6Bu;
+		while (!done.load(std::memory_order_relaxed))
+		{
+			if (TryExecuteJob()) continue;
+
+			Bool found_job = false;
+			for (Uint32 spin = 0; spin < IDLE_SPIN_COUNT && !found_job; ++spin)
+			{
+				std::this_thread::yield();
+				found_job = TryExecuteJob();
+			}
+			if (found_job) continue;
+
+			//a producer bumps the epoch after pushing, so either the job is visible to the last check or the wait returns
+			sleeping_threads.fetch_add(1);
+			Uint32 const epoch = wake_epoch.load();
+			if (!done && !TryExecuteJob()) wake_epoch.wait(epoch);
+			sleeping_threads.fetch_sub(1);
+		}
+	}
+
+	Bool ThreadPool::TryExecuteJob()
+	{
+		Uint32 const thread_index = GetThreadContextIndex();
+		Job* job = thread_index != GetExternalContextIndex() ? thread_contexts[thread_index]->deque.Pop() : nullptr;
+		if (!job) job = StealJob(thread_index);
+		if (!job) return false;
+
+		ExecuteJob(job);
+		return true;
+	}
+
+	void ThreadPool::ExecuteJob(Job* job)
+	{
+		Job::JobFunction function = job->function.load(std::memory_order_acquire);
+		JobCounter* counter = job->counter;
+		function(job->storage);
+		job->function.store(nullptr, std::memory_order_release);
+		if (counter) counter->value.fetch_sub(1, std::memory_order_release);
+	}
+
+	Job* ThreadPool::AllocateJob(Uint32 thread_index)
+	{
+		//slots are handed out round robin, busy slots belong to jobs that are still queued or running (possibly further up this stack)
+		ThreadContext& thread_context = *thread_contexts[thread_index];
+		for (Uint64 i = 0; i < JOB_ALLOCATION_PROBES; ++i)
+		{
+			Job* job = &thread_context.jobs[thread_context.next_job++ % JOBS_PER_THREAD];
+			if (job->function.load(std::memory_order_acquire) == nullptr) return job;
+		}
+		return nullptr;
+	}
+
+	void ThreadPool::PushJob(Uint32 thread_index, Job* job)
+	{
+		Bool const pushed = thread_contexts[thread_index]->deque.Push(job);
+		ADRIA_ASSERT(pushed);
+		wake_epoch.fetch_add(1);
+		if (sleeping_threads.load() > 0) wake_epoch.notify_one();
+	}
+
+	Job* ThreadPool::StealJob(Uint32 thread_index)
+	{
+		Uint32 const context_count = (Uint32)thread_contexts.size();
+		Uint32 const first_victim = NextStealIndex() % context_count;
+		for (Uint32 i = 0; i < context_count; ++i)
+		{
+			Uint32 const victim_index = (first_victim + i) % context_count;
+			if (victim_index == thread_index && victim_index != GetExternalContextIndex()) continue;
+			if (Job* job = thread_contexts[victim_index]->deque.Steal()) return job;
+		}
+		return nullptr;
+	}
+
+	Uint32 ThreadPool::GetThreadContextIndex() const
+	{
+		ADRIA_ASSERT(!thread_contexts.empty());
+		return tls_thread_index == INVALID_THREAD_INDEX ? GetExternalContextIndex() : tls_thread_index;
+	}
+}
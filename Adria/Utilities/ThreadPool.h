@@ -1,102 +1,164 @@
 #pragma once
 #include <thread>
 #include <future>
+#include <atomic>
 #include <type_traits>
-#include "ConcurrentQueue.h"
+#include "WorkStealingDeque.h"
 #include "Singleton.h"
 
 namespace adria
 {
+	//Counts jobs that have been started with it and not finished yet, ThreadPool::Wait returns once it reaches zero
+	class JobCounter
+	{
+		friend class ThreadPool;
+	public:
+		JobCounter() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(JobCounter)
+
+		Bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<Uint32> value = 0;
+	};
+
+	//Callables are stored inline in the job, so starting a job never allocates
+	struct alignas(64) Job
+	{
+		static constexpr Uint64 STORAGE_SIZE = 48;
+		using JobFunction = void(*)(void*);
+
+		std::atomic<JobFunction> function = nullptr;
+		JobCounter* counter = nullptr;
+		alignas(16) Uint8 storage[STORAGE_SIZE];
+	};
+
+	//Job system with one Chase-Lev deque per thread. Threads pop their own jobs in LIFO order and steal from other threads when they run out.
+	//The thread calling Initialize owns a deque too and executes jobs while it waits on a counter, jobs may start and wait on other jobs.
 	class ThreadPool : public Singleton<ThreadPool>
 	{
 		friend class Singleton<ThreadPool>;
+
+		static constexpr Uint64 JOBS_PER_THREAD = 4096;
+		static constexpr Uint64 JOB_ALLOCATION_PROBES = 16;
+		static constexpr Uint32 INVALID_THREAD_INDEX = Uint32(-1);
+
+		struct alignas(64) ThreadContext
+		{
+			WorkStealingDeque<Job*, JOBS_PER_THREAD> deque;
+			std::unique_ptr<Job[]> jobs = std::make_unique<Job[]>(JOBS_PER_THREAD);
+			Uint64 next_job = 0;
+		};
+
 	public:
 
 		ADRIA_NONCOPYABLE_NONMOVABLE(ThreadPool)
 		~ThreadPool() = default;
 
-		void Initialize(Uint pool_size = std::thread::hardware_concurrency() - 1)
-		{
-			done = false;
+		void Initialize(Uint pool_size = std::thread::hardware_concurrency() - 1);
+		void Destroy();
 
-			static const Uint max_threads = std::thread::hardware_concurrency();
-			Uint const num_threads = pool_size == 0 ? max_threads - 1 : std::min(max_threads - 1, pool_size);
-			threads.reserve(num_threads);
-			for (Uint i = 0; i < num_threads; ++i)
-			{
-				threads.emplace_back(std::bind(&ThreadPool::ThreadWork, this));
-			}
-		}
-		void Destroy()
+		template<typename F> requires std::is_invocable_v<F&>
+		void Run(F&& f, JobCounter* counter = nullptr)
 		{
-			if (done)
-			{
-				return;
-			}
+			using Callable = std::decay_t<F>;
+			static_assert(sizeof(Callable) <= Job::STORAGE_SIZE, "Job callable does not fit into the job storage, capture by reference instead");
+			static_assert(alignof(Callable) <= 16, "Job callable is over-aligned");
 
-			{
-				std::unique_lock<std::mutex> lk(cond_mutex);
-				done = true;
-				cond_var.notify_all();
-			}
+			Uint32 const thread_index = GetThreadContextIndex();
+			std::unique_lock<std::mutex> external_lock(external_mutex, std::defer_lock);
+			if (thread_index == GetExternalContextIndex()) external_lock.lock();
 
-			for (Uint i = 0; i < threads.size(); ++i)
+			Job* job = AllocateJob(thread_index);
+			if (!job)
 			{
-				if (threads[i].joinable())  threads[i].join();
+				//every nearby slot of this thread is taken, running the job right away is cheaper than waiting for one
+				if (external_lock.owns_lock()) external_lock.unlock();
+				f();
+				return;
 			}
+
+			if (counter) counter->value.fetch_add(1, std::memory_order_relaxed);
+			new (job->storage) Callable(std::forward<F>(f));
+			job->counter = counter;
+			job->function.store([](void* storage)
+				{
+					Callable& callable = *std::launder(reinterpret_cast<Callable*>(storage));
+					callable();
+					callable.~Callable();
+				}, std::memory_order_release);
+			PushJob(thread_index, job);
 		}
 
+		//Executes other jobs until the counter reaches zero
+		void Wait(JobCounter const& counter);
+
 		template<typename F, typename... Args>
-		auto Submit(F&& f, Args&&... args) 
+		auto Submit(F&& f, Args&&... args)
 		{
 			using ReturnType = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
 			auto bind_f = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
 			auto wrapped_task = std::make_shared<std::packaged_task<ReturnType()>>(bind_f);
 			std::future<ReturnType> result_future = wrapped_task->get_future();
-			auto void_task = [wrapped_task]() {(*wrapped_task)(); };
-			task_queue.Push(std::move(void_task));
-			cond_var.notify_one();
+			Run([wrapped_task]() { (*wrapped_task)(); });
 			return result_future;
 		}
 
+		//Splits [0, count) into chunks of chunk_size and calls f(chunk_begin, chunk_end) for each of them.
+		//Chunk boundaries only depend on count and chunk_size, so the result does not depend on the number of threads.
+		//The calling thread processes chunks as well and returns once every chunk is done, so it is safe to call from a job.
+		template<typename F> requires std::is_invocable_v<F&, Uint64, Uint64>
+		void ParallelFor(Uint64 count, Uint64 chunk_size, F&& f)
+		{
+			if (count == 0) return;
+			chunk_size = std::max<Uint64>(chunk_size, 1);
+			Uint64 const chunk_count = (count + chunk_size - 1) / chunk_size;
+			Uint64 const helper_count = std::min<Uint64>(chunk_count - 1, threads.size());
+			if (helper_count == 0)
+			{
+				for (Uint64 begin = 0; begin < count; begin += chunk_size) f(begin, std::min(begin + chunk_size, count));
+				return;
+			}
+
+			std::atomic<Uint64> next_chunk = 0;
+			auto RunChunks = [&]()
+			{
+				for (Uint64 chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++)
+				{
+					Uint64 const begin = chunk * chunk_size;
+					f(begin, std::min(begin + chunk_size, count));
+				}
+			};
+			JobCounter counter;
+			for (Uint64 i = 0; i < helper_count; ++i) Run(RunChunks, &counter);
+			RunChunks();
+			Wait(counter);
+		}
+
+		Uint64 GetThreadCount() const { return threads.size() + 1; }
+
 	private:
 		std::vector<std::thread> threads;
-		ConcurrentQueue<std::function<void()>> task_queue;
-		Bool done = false;
-		std::condition_variable cond_var;
-		std::mutex cond_mutex;
+		//one context per worker, one for the thread that called Initialize and a mutex guarded one shared by every other thread
+		std::vector<std::unique_ptr<ThreadContext>> thread_contexts;
+		std::mutex external_mutex;
+		std::atomic<Bool> done = false;
+		std::atomic<Uint32> wake_epoch = 0;
+		std::atomic<Uint32> sleeping_threads = 0;
 
 	private:
 		ThreadPool() = default;
 
-		void ThreadWork()
-		{
-			std::function <void()> task;
-			Bool pop_success;
+		void ThreadWork(Uint32 thread_index);
+		Bool TryExecuteJob();
+		void ExecuteJob(Job* job);
 
-			while (true)
-			{
-				{
-					std::unique_lock<std::mutex> lk(cond_mutex);
-					while (!done && task_queue.Empty()) cond_var.wait(lk);
-
-					if (done)
-					{
-						return;
-					}
-					else
-					{
-						pop_success = task_queue.TryPop(task);
-					}
-				}
+		Job* AllocateJob(Uint32 thread_index);
+		void PushJob(Uint32 thread_index, Job* job);
+		Job* StealJob(Uint32 thread_index);
 
-				if (pop_success)
-				{
-					task();
-					task = nullptr;
-				}
-			}
-		}
+		Uint32 GetThreadContextIndex() const;
+		Uint32 GetExternalContextIndex() const { return (Uint32)thread_contexts.size() - 1; }
 	};
 	#define g_ThreadPool ThreadPool::Get()
-}
\ No newline at end of file
+}
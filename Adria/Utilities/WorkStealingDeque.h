@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <array>
+
+namespace adria
+{
+	//Fixed capacity Chase-Lev deque. The owning thread pushes and pops at the bottom, other threads steal from the top.
+	//Push, Pop and Steal never block or allocate, Pop and Steal return nullptr when the deque is empty or the race for the last item is lost.
+	template<typename T, Uint64 Capacity> requires std::is_pointer_v<T> && ((Capacity & (Capacity - 1)) == 0)
+	class WorkStealingDeque
+	{
+		static constexpr Int64 MASK = Capacity - 1;
+
+	public:
+		WorkStealingDeque() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(WorkStealingDeque)
+
+		Bool Push(T item)
+		{
+			Int64 const b = bottom.load(std::memory_order_relaxed);
+			Int64 const t = top.load(std::memory_order_acquire);
+			if (b - t >= (Int64)Capacity) return false;
+
+			buffer[b & MASK].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		T Pop()
+		{
+			Int64 const b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Int64 t = top.load(std::memory_order_relaxed);
+			if (t > b)
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T item = buffer[b & MASK].load(std::memory_order_relaxed);
+			if (t == b)
+			{
+				//last item, race against stealers
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) item = nullptr;
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		T Steal()
+		{
+			Int64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Int64 const b = bottom.load(std::memory_order_acquire);
+			if (t >= b) return nullptr;
+
+			T item = buffer[t & MASK].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+			return item;
+		}
+
+		Bool Empty() const
+		{
+			return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+		}
+
+	private:
+		alignas(64) std::atomic<Int64> top = 0;
+		alignas(64) std::atomic<Int64> bottom = 0;
+		alignas(64) std::array<std::atomic<T>, Capacity> buffer{};
+	};
+}
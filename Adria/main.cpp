@@ -3,9 +3,12 @@
 #include "Core/Input.h"
 #include "Logging/FileLogger.h"
 #include "Logging/OutputDebugStringLogger.h"
+#include "Logging/BinaryLogDecoder.h"
 #include "Editor/Editor.h"
+#include "Rendering/ModelCache.h"
 #include "Utilities/MemoryDebugger.h"
 #include "Utilities/CLIParser.h"
+#include "Utilities/ThreadPool.h"
 
 using namespace adria;
 
@@ -24,21 +27,44 @@ int APIENTRY wWinMain(
 		cli_parser.AddArg(true, "-scene", "--scenefile");
 		cli_parser.AddArg(true, "-log", "--logfile");
 		cli_parser.AddArg(true, "-loglvl", "--loglevel");
+		cli_parser.AddArg(true, "-binlog", "--binarylogfile");
+		cli_parser.AddArg(true, "-binlogsize", "--binarylogsize");
+		cli_parser.AddArg(true, "-decodelog", "--decodebinarylog");
+		cli_parser.AddArg(false, "-cookscenes");
 		cli_parser.AddArg(false, "-max", "--maximize");
 		cli_parser.AddArg(false, "-vsync");
 		cli_parser.AddArg(false, "-debugdevice");
 		cli_parser.AddArg(false, "-shaderdebug");
+		cli_parser.AddArg(false, "-asyncshaders");
 		cli_parser.AddArg(false, "-dred");
 		cli_parser.AddArg(false, "-gpuvalidation");
 		cli_parser.AddArg(false, "-pix");
 		cli_parser.AddArg(false, "-aftermath");
     }
     CLIParseResult cli_result = cli_parser.Parse(lpCmdLine);
+
+	if (cli_result["-decodelog"])
+	{
+		std::string binary_log_path = cli_result["-decodelog"].AsString();
+		return DecodeBinaryLog(binary_log_path.c_str(), (binary_log_path + ".txt").c_str()) ? 0 : 1;
+	}
     
     std::string log_file = cli_result["-log"].AsStringOr("adria.log");
     LogLevel log_level = static_cast<LogLevel>(cli_result["-loglvl"].AsIntOr(0));
     g_Log.Register(new FileLogger(log_file.c_str(), log_level));
     g_Log.Register(new OutputDebugStringLogger(log_level));
+	if (cli_result["-binlog"])
+	{
+		Uint64 binary_log_size_mb = cli_result["-binlogsize"].AsIntOr(1024);
+		g_Log.EnableBinaryCapture(cli_result["-binlog"].AsString().c_str(), binary_log_size_mb << 20);
+	}
+	if (cli_result["-cookscenes"])
+	{
+		g_ThreadPool.Initialize();
+		Bool const success = CookSceneModels();
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
 
 	std::string title_str = cli_result["-title"].AsStringOr("Adria").c_str();
     WindowInit window_init{};
@@ -55,6 +81,7 @@ int APIENTRY wWinMain(
 	engine_init.gfx_options.vsync = cli_result["-vsync"];
 	engine_init.gfx_options.debug_device = cli_result["-debugdevice"];
 	engine_init.gfx_options.shader_debug = cli_result["-shaderdebug"];
+	engine_init.gfx_options.background_shader_precompile = cli_result["-asyncshaders"];
 	engine_init.gfx_options.dred = cli_result["-dred"];
 	engine_init.gfx_options.gpu_validation = cli_result["-gpuvalidation"];
 	engine_init.gfx_options.pix = cli_result["-pix"];
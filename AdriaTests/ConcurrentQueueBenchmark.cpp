@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <condition_variable>
+#include "ConcurrentQueueBenchmark.h"
+#include "Utilities/ConcurrentQueue.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		//every consumer stops after popping one of these, they are pushed once all producers are done
+		constexpr Uint64 STOP_ITEM = Uint64(-1);
+
+		//the queue before the lock-free ring: a std::queue behind a mutex, consumers wait on a condition variable
+		template<typename T>
+		class LockedQueue
+		{
+		public:
+			void Push(T const& value)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				queue.push(value);
+				cond_variable.notify_one();
+			}
+
+			void WaitPop(T& value)
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cond_variable.wait(lock, [this] { return !queue.empty(); });
+				value = std::move(queue.front());
+				queue.pop();
+			}
+
+		private:
+			std::queue<T> queue;
+			std::mutex mutex;
+			std::condition_variable cond_variable;
+		};
+
+		struct QueueStressResult
+		{
+			Float time;
+			Bool popped_once;
+		};
+
+		//producer p pushes the items [p * items_per_producer, (p + 1) * items_per_producer)
+		template<typename Queue>
+		QueueStressResult StressQueue(Queue& queue, Uint64 items_per_producer, Uint32 producer_count, Uint32 consumer_count)
+		{
+			std::vector<std::vector<Uint64>> popped_items(consumer_count);
+			std::vector<std::thread> producers, consumers;
+			Timer timer;
+			for (Uint32 c = 0; c < consumer_count; ++c)
+			{
+				consumers.emplace_back([&queue, &items = popped_items[c]]()
+				{
+					Uint64 item = 0;
+					while (true)
+					{
+						queue.WaitPop(item);
+						if (item == STOP_ITEM) return;
+						items.push_back(item);
+					}
+				});
+			}
+			for (Uint32 p = 0; p < producer_count; ++p)
+			{
+				producers.emplace_back([&queue, p, items_per_producer]()
+				{
+					for (Uint64 i = 0; i < items_per_producer; ++i) queue.Push(p * items_per_producer + i);
+				});
+			}
+			for (std::thread& producer : producers) producer.join();
+			for (Uint32 c = 0; c < consumer_count; ++c) queue.Push(STOP_ITEM);
+			for (std::thread& consumer : consumers) consumer.join();
+			Float const time = timer.ElapsedInSeconds();
+
+			Uint64 const item_count = items_per_producer * producer_count;
+			std::vector<Uint8> pop_counts(item_count, 0);
+			Bool popped_once = true;
+			for (std::vector<Uint64> const& items : popped_items)
+			{
+				for (Uint64 item : items)
+				{
+					if (item >= item_count || pop_counts[item]++ != 0) popped_once = false;
+				}
+			}
+			popped_once &= std::all_of(pop_counts.begin(), pop_counts.end(), [](Uint8 pop_count) { return pop_count == 1; });
+			return QueueStressResult{ time, popped_once };
+		}
+	}
+
+	Bool BenchmarkConcurrentQueue(Uint32 item_count, Uint32 producer_count, Uint32 consumer_count)
+	{
+		producer_count = std::max(producer_count, 1u);
+		consumer_count = std::max(consumer_count, 1u);
+		Uint64 const items_per_producer = std::max<Uint64>(item_count / producer_count, 1);
+		Uint64 const total_items = items_per_producer * producer_count;
+
+		auto lock_free_queue = std::make_unique<ConcurrentQueue<Uint64>>();
+		QueueStressResult const lock_free_result = StressQueue(*lock_free_queue, items_per_producer, producer_count, consumer_count);
+		LockedQueue<Uint64> locked_queue;
+		QueueStressResult const locked_result = StressQueue(locked_queue, items_per_producer, producer_count, consumer_count);
+
+		Bool const success = lock_free_result.popped_once && locked_result.popped_once;
+		ADRIA_LOG(INFO, "Concurrent queue benchmark: %llu items, %u producers, %u consumers, lock-free %.3f ms (%.2f M items/s), locked %.3f ms (%.2f M items/s), %s",
+			total_items, producer_count, consumer_count,
+			1000.0f * lock_free_result.time, total_items / (1e6f * lock_free_result.time),
+			1000.0f * locked_result.time, total_items / (1e6f * locked_result.time),
+			success ? "every item was popped once" : "items were lost or popped twice");
+		return success;
+	}
+}
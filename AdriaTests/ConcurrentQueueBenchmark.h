@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Pushes item_count items from producer_count threads and pops them on consumer_count threads blocked in WaitPop, once through
+	//ConcurrentQueue and once through a queue behind a mutex and a condition variable like the one it replaced. Logs the throughput of both
+	//and fails if an item is lost or popped twice, used by the -queuebenchmark command line option
+	Bool BenchmarkConcurrentQueue(Uint32 item_count, Uint32 producer_count, Uint32 consumer_count);
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include "FileWatcherBenchmark.h"
+#include "Utilities/FileWatcher.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		//the watcher before ReadDirectoryChangesW, every check compares the last write time of every known file
+		Uint64 PollWriteTimes(std::unordered_map<std::string, fs::file_time_type>& files_map)
+		{
+			Uint64 changed_count = 0;
+			for (auto& [file, last_write_time] : files_map)
+			{
+				std::error_code error;
+				auto const current_write_time = fs::last_write_time(file, error);
+				if (error || current_write_time == last_write_time) continue;
+				last_write_time = current_write_time;
+				++changed_count;
+			}
+			return changed_count;
+		}
+	}
+
+	Bool BenchmarkFileWatcher(Uint32 file_count)
+	{
+		file_count = std::max(file_count, 2u);
+		fs::path const directory = fs::temp_directory_path() / "AdriaFileWatcherBenchmark";
+		std::error_code error;
+		fs::remove_all(directory, error);
+		fs::create_directories(directory, error);
+		if (error)
+		{
+			ADRIA_LOG(ERROR, "File watcher benchmark could not create %s", directory.string().c_str());
+			return false;
+		}
+
+		//the files are spread over subdirectories like a shader tree
+		std::vector<std::string> files(file_count);
+		for (Uint32 i = 0; i < file_count; ++i)
+		{
+			fs::path const subdirectory = directory / ("Directory" + std::to_string(i % 64));
+			fs::create_directories(subdirectory, error);
+			files[i] = (subdirectory / ("File" + std::to_string(i) + ".hlsl")).string();
+			std::ofstream(files[i]) << "//file " << i << "\n";
+		}
+
+		Bool success = false;
+		{
+			FileWatcher file_watcher;
+			file_watcher.AddPathToWatch(directory.string());
+			std::unordered_map<std::string, FileStatus> reported_files;
+			std::ignore = file_watcher.GetFileModifiedEvent().AddLambda([&reported_files](std::string const& file, FileStatus status) { reported_files[file] = status; });
+
+			std::unordered_map<std::string, fs::file_time_type> polled_files;
+			for (std::string const& file : files) polled_files[file] = fs::last_write_time(file, error);
+
+			//checks without changes, the cost every hot reload check paid before
+			static constexpr Uint32 CHECK_COUNT = 16;
+			Timer timer;
+			for (Uint32 i = 0; i < CHECK_COUNT; ++i) PollWriteTimes(polled_files);
+			Float const poll_time = timer.MarkInSeconds() / CHECK_COUNT;
+			for (Uint32 i = 0; i < CHECK_COUNT; ++i) file_watcher.CheckWatchedFiles();
+			Float const watch_time = timer.MarkInSeconds() / CHECK_COUNT;
+
+			//a hundredth of the files is modified, deleted and created each
+			Uint32 const change_count = std::max(file_count / 100, 1u);
+			std::unordered_map<std::string, FileStatus> expected_files;
+			for (Uint32 i = 0; i < change_count; ++i)
+			{
+				std::string const& modified_file = files[(2 * i) % file_count];
+				std::ofstream(modified_file, std::ios::app) << "//modified\n";
+				expected_files[modified_file] = FileStatus::Modified;
+
+				std::string const& deleted_file = files[(2 * i + 1) % file_count];
+				fs::remove(deleted_file, error);
+				expected_files[deleted_file] = FileStatus::Deleted;
+
+				std::string const created_file = (directory / ("Created" + std::to_string(i) + ".hlsl")).string();
+				std::ofstream(created_file) << "//created\n";
+				expected_files[created_file] = FileStatus::Created;
+			}
+
+			timer.Mark();
+			while (reported_files.size() < expected_files.size() && timer.ElapsedInSeconds() < 5.0f)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				file_watcher.CheckWatchedFiles();
+			}
+			Float const report_time = timer.ElapsedInSeconds();
+
+			Uint64 const matching_count = std::count_if(expected_files.begin(), expected_files.end(), [&reported_files](auto const& expected)
+				{
+					auto it = reported_files.find(expected.first);
+					return it != reported_files.end() && it->second == expected.second;
+				});
+			success = matching_count == expected_files.size() && reported_files.size() == expected_files.size();
+			ADRIA_LOG(INFO, "File watcher benchmark: %u files, check without changes polling %.3f ms, watcher %.3f ms, %llu changes reported after %.1f ms, %llu/%llu with the expected status",
+				file_count, 1000.0f * poll_time, 1000.0f * watch_time, (Uint64)reported_files.size(), 1000.0f * report_time, matching_count, (Uint64)expected_files.size());
+		}
+		fs::remove_all(directory, error);
+		return success;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Creates file_count files in a temporary directory, compares checking them by last write time like the watcher before
+	//ReadDirectoryChangesW with CheckWatchedFiles and checks that modified, deleted and created files are reported with their status,
+	//used by the -filewatcherbenchmark command line option
+	Bool BenchmarkFileWatcher(Uint32 file_count);
+}
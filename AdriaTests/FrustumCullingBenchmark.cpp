@@ -0,0 +1,75 @@
+#include "FrustumCullingBenchmark.h"
+#include "Math/FrustumCulling.h"
+#include "Logging/Logger.h"
+#include "Utilities/Random.h"
+#include "Utilities/Timer.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct CullingBenchmarkResult
+		{
+			Float reference_time;
+			Float kernel_time;
+			Uint64 reference_visible;
+			Uint64 kernel_visible;
+			Uint64 missed;
+		};
+
+		//times the kernel against the DirectXCollision test it replaced, a box that test keeps but the kernel culls is an error
+		template<typename Volume>
+		CullingBenchmarkResult BenchmarkCulling(Volume const& volume, CullingPlanes const& culling_planes, std::vector<BoundingBox> const& boxes, BoundingBoxStreams const& box_streams, Uint32 iterations)
+		{
+			CullingBenchmarkResult result{};
+			std::vector<Bool> reference_visibility(boxes.size());
+			std::vector<Uint64> visibility_mask;
+			Timer timer;
+			for (Uint32 i = 0; i < iterations; ++i)
+			{
+				for (Uint64 j = 0; j < boxes.size(); ++j) reference_visibility[j] = volume.Intersects(boxes[j]);
+			}
+			result.reference_time = timer.MarkInSeconds() / iterations;
+			for (Uint32 i = 0; i < iterations; ++i) CullBoundingBoxes(culling_planes, box_streams, visibility_mask);
+			result.kernel_time = timer.MarkInSeconds() / iterations;
+
+			for (Uint64 j = 0; j < boxes.size(); ++j)
+			{
+				Bool const visible = IsVisible(visibility_mask, j);
+				if (reference_visibility[j]) ++result.reference_visible;
+				if (visible) ++result.kernel_visible;
+				if (reference_visibility[j] && !visible) ++result.missed;
+			}
+			return result;
+		}
+	}
+
+	Bool BenchmarkFrustumCulling(Uint32 box_count, Uint32 iterations)
+	{
+		iterations = std::max(iterations, 1u);
+		RealRandomGenerator<Float> random(0.0f, 1.0f, std::mt19937{ 0 });
+		std::vector<BoundingBox> boxes(box_count);
+		BoundingBoxStreams box_streams;
+		box_streams.Resize(box_count);
+		for (Uint32 i = 0; i < box_count; ++i)
+		{
+			Vector3 const center(1000.0f * random() - 500.0f, 1000.0f * random() - 500.0f, 1000.0f * random() - 500.0f);
+			Vector3 const extents(0.5f + 4.5f * random(), 0.5f + 4.5f * random(), 0.5f + 4.5f * random());
+			boxes[i] = BoundingBox(center, extents);
+			box_streams.Set(i, boxes[i]);
+		}
+
+		BoundingFrustum const frustum(DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f));
+		BoundingBox const shadow_box(Vector3(0.0f, 0.0f, 100.0f), Vector3(150.0f, 150.0f, 150.0f));
+		CullingBenchmarkResult const frustum_result = BenchmarkCulling(frustum, CullingPlanes::FromFrustum(frustum), boxes, box_streams, iterations);
+		CullingBenchmarkResult const box_result = BenchmarkCulling(shadow_box, CullingPlanes::FromBox(shadow_box), boxes, box_streams, iterations);
+
+		ADRIA_LOG(INFO, "Frustum culling benchmark: %u boxes, %u iterations, BoundingFrustum %.3f ms, kernel %.3f ms, %llu visible, %llu kept conservatively, %llu missed",
+			box_count, iterations, 1000.0f * frustum_result.reference_time, 1000.0f * frustum_result.kernel_time, frustum_result.reference_visible,
+			frustum_result.kernel_visible - (frustum_result.reference_visible - frustum_result.missed), frustum_result.missed);
+		ADRIA_LOG(INFO, "Shadow box culling benchmark: %u boxes, %u iterations, BoundingBox %.3f ms, kernel %.3f ms, %llu visible, %llu kept conservatively, %llu missed",
+			box_count, iterations, 1000.0f * box_result.reference_time, 1000.0f * box_result.kernel_time, box_result.reference_visible,
+			box_result.kernel_visible - (box_result.reference_visible - box_result.missed), box_result.missed);
+		return frustum_result.missed == 0 && box_result.missed == 0;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Culls random boxes against a camera frustum and a shadow box with the kernel and with DirectXCollision, logs both times
+	//and fails if the kernel culls a box DirectXCollision keeps, used by the -cullingbenchmark command line option
+	Bool BenchmarkFrustumCulling(Uint32 box_count, Uint32 iterations);
+}
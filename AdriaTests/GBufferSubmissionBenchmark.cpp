@@ -0,0 +1,148 @@
+#include <algorithm>
+#include "GBufferSubmissionBenchmark.h"
+#include "Rendering/GBufferPermutations.h"
+#include "Rendering/ShaderManager.h"
+#include "Graphics/GfxPipelineStatePermutations.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		//stands in for GfxGraphicsPipelineState so the permutations can be resolved without a device
+		class BenchmarkPipelineState
+		{
+		public:
+			BenchmarkPipelineState(GfxDevice*, GfxGraphicsPipelineStateDesc const&) {}
+		};
+	}
+
+	template<>
+	struct PSOTraits<BenchmarkPipelineState>
+	{
+		static constexpr GfxPipelineStateType PipelineStateType = GfxPipelineStateType::Graphics;
+		using PSODescType = GfxGraphicsPipelineStateDesc;
+		using PSODescHasher = GfxGraphicsPipelineStateDescHash;
+	};
+
+	namespace
+	{
+		using BenchmarkPipelineStatePermutations = GfxPipelineStatePermutations<BenchmarkPipelineState>;
+
+		struct BenchmarkBatch
+		{
+			MaterialAlphaMode alpha_mode;
+			Uint32 instance_id;
+			Uint32 indices_count;
+		};
+
+		//records the calls the GBuffer pass makes per batch, the recorded streams of both lookups are compared afterwards
+		class BenchmarkCommandList
+		{
+		public:
+			struct Draw
+			{
+				BenchmarkPipelineState* pso;
+				Uint32 instance_id;
+				Uint32 indices_count;
+			};
+
+			void SetPipelineState(BenchmarkPipelineState* _pso)
+			{
+				if (pso == _pso) return;
+				pso = _pso;
+				++pso_changes;
+			}
+			void SetRootConstants(Uint32 _instance_id)
+			{
+				instance_id = _instance_id;
+			}
+			void DrawIndexed(Uint32 indices_count)
+			{
+				draws.push_back(Draw{ .pso = pso, .instance_id = instance_id, .indices_count = indices_count });
+			}
+			void Reset()
+			{
+				draws.clear();
+				pso = nullptr;
+			}
+
+			std::vector<Draw> const& GetDraws() const { return draws; }
+			Uint64 GetPSOChanges() const { return pso_changes; }
+
+		private:
+			std::vector<Draw> draws;
+			BenchmarkPipelineState* pso = nullptr;
+			Uint32 instance_id = 0;
+			Uint64 pso_changes = 0;
+		};
+
+		template<typename GetPSO>
+		void SubmitBenchmarkBatches(std::vector<BenchmarkBatch> const& batches, BenchmarkCommandList& cmd_list, GetPSO&& get_pso)
+		{
+			cmd_list.Reset();
+			for (BenchmarkBatch const& batch : batches)
+			{
+				cmd_list.SetPipelineState(get_pso(batch.alpha_mode));
+				cmd_list.SetRootConstants(batch.instance_id);
+				cmd_list.DrawIndexed(batch.indices_count);
+			}
+		}
+	}
+
+	Bool BenchmarkGBufferSubmission(Uint32 batch_count, Uint32 frame_count)
+	{
+		frame_count = std::max(frame_count, 1u);
+
+		GfxGraphicsPipelineStateDesc gbuffer_pso_desc{};
+		gbuffer_pso_desc.VS = VS_GBuffer;
+		gbuffer_pso_desc.PS = PS_GBuffer;
+		gbuffer_pso_desc.num_render_targets = 4u;
+		BenchmarkPipelineStatePermutations gbuffer_psos(nullptr, gbuffer_pso_desc);
+		gbuffer_psos.AddPermutations(GBUFFER_PERMUTATION_COUNT, SetupGBufferPermutation<BenchmarkPipelineStatePermutations>);
+
+		//mostly opaque batches with some masked and blended ones, sorted by alpha mode like the pass sorts them
+		std::vector<BenchmarkBatch> batches(batch_count);
+		for (Uint32 i = 0; i < batch_count; ++i)
+		{
+			MaterialAlphaMode const alpha_mode = (i % 10 == 0) ? MaterialAlphaMode::Mask : (i % 25 == 1) ? MaterialAlphaMode::Blend : MaterialAlphaMode::Opaque;
+			batches[i] = BenchmarkBatch{ .alpha_mode = alpha_mode, .instance_id = i, .indices_count = 3 * (i % 512 + 1) };
+		}
+		std::stable_sort(batches.begin(), batches.end(), [](BenchmarkBatch const& lhs, BenchmarkBatch const& rhs) { return lhs.alpha_mode < rhs.alpha_mode; });
+
+		Timer timer;
+		BenchmarkCommandList hashed_cmd_list, table_cmd_list;
+		Float hashed_time = 0.0f, table_time = 0.0f;
+		Bool draws_match = true;
+		for (Uint32 frame = 0; frame < frame_count; ++frame)
+		{
+			Bool const raining = (frame & 1) != 0;
+
+			timer.Mark();
+			SubmitBenchmarkBatches(batches, hashed_cmd_list, [&](MaterialAlphaMode alpha_mode)
+				{
+					SetupGBufferPermutation(gbuffer_psos, GetGBufferPermutationKey(alpha_mode, raining));
+					return gbuffer_psos.Get();
+				});
+			hashed_time += timer.MarkInSeconds();
+			SubmitBenchmarkBatches(batches, table_cmd_list, [&](MaterialAlphaMode alpha_mode)
+				{
+					return gbuffer_psos.Get(GetGBufferPermutationKey(alpha_mode, raining));
+				});
+			table_time += timer.MarkInSeconds();
+
+			draws_match &= std::equal(hashed_cmd_list.GetDraws().begin(), hashed_cmd_list.GetDraws().end(), table_cmd_list.GetDraws().begin(), table_cmd_list.GetDraws().end(),
+				[](BenchmarkCommandList::Draw const& a, BenchmarkCommandList::Draw const& b)
+				{
+					return a.pso == b.pso && a.instance_id == b.instance_id && a.indices_count == b.indices_count;
+				});
+		}
+		draws_match &= hashed_cmd_list.GetPSOChanges() == table_cmd_list.GetPSOChanges();
+
+		ADRIA_LOG(INFO, "GBuffer submission benchmark: %u batches, %u frames, hashed permutations %.3f ms, permutation table %.3f ms per frame (%.1f ns per batch), %llu PSO changes, draws %s",
+			batch_count, frame_count, 1000.0f * hashed_time / frame_count, 1000.0f * table_time / frame_count,
+			batch_count ? 1e9f * table_time / ((Float)frame_count * batch_count) : 0.0f, table_cmd_list.GetPSOChanges(), draws_match ? "match" : "differ");
+		return draws_match;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Submits batch_count synthetic batches per frame to a mock command list, once resolving the GBuffer PSO permutation
+	//by hashing the desc like GfxPipelineStatePermutations::Get() and once through the permutation table,
+	//checks that both record the same draws and logs the submission times, used by the -gbuffersubmissionbenchmark command line option
+	Bool BenchmarkGBufferSubmission(Uint32 batch_count, Uint32 frame_count);
+}
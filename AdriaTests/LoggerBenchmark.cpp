@@ -0,0 +1,128 @@
+#include <chrono>
+#include <algorithm>
+#include "LoggerBenchmark.h"
+#include "Logging/Logger.h"
+#include "Logging/BinaryLogDecoder.h"
+#include "Core/Paths.h"
+
+namespace adria
+{
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		//more threads than a log manager has rings, they only get one each if the rings of exited threads are reused
+		constexpr Uint32 SHORT_LIVED_THREAD_COUNT = 512;
+		constexpr Char const* BINARY_LOG_FILE = "logbenchmark.binlog";
+
+		class CountingLogger : public ILogger
+		{
+		public:
+			explicit CountingLogger(Uint64& message_count) : message_count(message_count) {}
+			virtual void Log(LogLevel, Char const*, Char const*, Uint32) override { ++message_count; }
+
+		private:
+			Uint64& message_count;
+		};
+
+		struct LoggerBenchmarkResult
+		{
+			Float produce_time;
+			Float total_time;
+			Uint64 median_latency;
+			Uint64 p99_latency;
+			Uint64 max_latency;
+		};
+
+		//calls LogMessage(thread, message) from thread_count threads, then destroys the manager which drains every ring before the log thread exits
+		template<typename F>
+		LoggerBenchmarkResult RunLogThreads(std::unique_ptr<LogManager>& log_manager, Uint32 thread_count, Uint32 thread_message_count, F&& LogMessage)
+		{
+			std::vector<std::vector<Uint64>> latencies(thread_count, std::vector<Uint64>(thread_message_count));
+			Clock::time_point const start = Clock::now();
+			{
+				std::vector<std::jthread> producers;
+				for (Uint32 t = 0; t < thread_count; ++t)
+				{
+					producers.emplace_back([&, t]()
+					{
+						for (Uint32 i = 0; i < thread_message_count; ++i)
+						{
+							Clock::time_point const log_start = Clock::now();
+							LogMessage(t, i);
+							latencies[t][i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - log_start).count();
+						}
+					});
+				}
+			}
+			Float const produce_time = std::chrono::duration<Float>(Clock::now() - start).count();
+			log_manager.reset();
+			Float const total_time = std::chrono::duration<Float>(Clock::now() - start).count();
+
+			std::vector<Uint64> all_latencies;
+			for (std::vector<Uint64> const& thread_latencies : latencies) all_latencies.insert(all_latencies.end(), thread_latencies.begin(), thread_latencies.end());
+			std::sort(all_latencies.begin(), all_latencies.end());
+			auto Percentile = [&](Float p) { return all_latencies.empty() ? 0ull : all_latencies[(Uint64)(p * (all_latencies.size() - 1))]; };
+			return LoggerBenchmarkResult{ produce_time, total_time, Percentile(0.5f), Percentile(0.99f), Percentile(1.0f) };
+		}
+
+		Uint64 CountLines(std::string const& file)
+		{
+			std::ifstream input(file);
+			return std::count(std::istreambuf_iterator<Char>(input), std::istreambuf_iterator<Char>(), '\n');
+		}
+	}
+
+	Bool BenchmarkLogger(Uint32 message_count)
+	{
+		Uint32 const thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		Uint32 const thread_message_count = message_count / thread_count;
+		Uint64 const sent_count = (Uint64)thread_count * thread_message_count;
+
+		//the sink only counts, so the benchmark measures formatting, the rings and the log thread and not the file system
+		Uint64 received_count = 0;
+		auto log_manager = std::make_unique<LogManager>();
+		log_manager->Register(new CountingLogger(received_count));
+		LoggerBenchmarkResult const text_result = RunLogThreads(log_manager, thread_count, thread_message_count, [&](Uint32 t, Uint32 i)
+		{
+			log_manager->LogFormat(LogLevel::LOG_INFO, __FILE__, __LINE__, "Benchmark message %u from thread %u, value %f", i, t, i * 0.5f);
+		});
+
+		//short lived threads in waves of thread_count on a new manager, each one logs once and frees its ring on exit
+		Uint64 short_lived_received_count = 0;
+		log_manager = std::make_unique<LogManager>();
+		log_manager->Register(new CountingLogger(short_lived_received_count));
+		for (Uint32 t = 0; t < SHORT_LIVED_THREAD_COUNT; t += thread_count)
+		{
+			std::vector<std::jthread> short_lived_threads;
+			for (Uint32 i = t; i < std::min(t + thread_count, SHORT_LIVED_THREAD_COUNT); ++i)
+			{
+				short_lived_threads.emplace_back([&, i]() { log_manager->LogFormat(LogLevel::LOG_INFO, __FILE__, __LINE__, "Short lived thread %u", i); });
+			}
+		}
+		log_manager.reset();
+
+		//info messages only go to the capture while it is enabled, the same path ADRIA_LOG takes with a format id local to this manager
+		Uint64 binary_received_count = 0;
+		std::atomic<Uint32> format_id = 0;
+		log_manager = std::make_unique<LogManager>();
+		log_manager->Register(new CountingLogger(binary_received_count));
+		log_manager->EnableBinaryCapture(BINARY_LOG_FILE, sent_count * 64 + (1 << 20));
+		LoggerBenchmarkResult const binary_result = RunLogThreads(log_manager, thread_count, thread_message_count, [&](Uint32 t, Uint32 i)
+		{
+			log_manager->LogFormat(LogLevel::LOG_INFO, __FILE__, __LINE__, format_id, "Benchmark message %u from thread %u, value %f", i, t, i * 0.5f);
+		});
+		std::string const binary_log_path = paths::LogDir + BINARY_LOG_FILE;
+		Bool const decoded = DecodeBinaryLog(binary_log_path.c_str(), (binary_log_path + ".txt").c_str());
+		Uint64 const binary_decoded_count = decoded ? CountLines(binary_log_path + ".txt") : 0;
+
+		Bool const delivered = received_count == sent_count && short_lived_received_count == SHORT_LIVED_THREAD_COUNT;
+		Bool const captured = binary_decoded_count == sent_count && binary_received_count == 0;
+		ADRIA_LOG(INFO, "Logger benchmark: %llu messages from %u threads, %.0f messages/s produced, %.0f messages/s delivered, latency median %llu ns, p99 %llu ns, max %llu ns, %s",
+			sent_count, thread_count, sent_count / text_result.produce_time, sent_count / text_result.total_time, text_result.median_latency, text_result.p99_latency, text_result.max_latency,
+			delivered ? "every message delivered" : "messages are missing");
+		ADRIA_LOG(INFO, "Logger benchmark, binary capture: %.0f messages/s produced, latency median %llu ns, p99 %llu ns, max %llu ns, %llu of %llu messages decoded",
+			sent_count / binary_result.produce_time, binary_result.median_latency, binary_result.p99_latency, binary_result.max_latency, binary_decoded_count, sent_count);
+		return delivered && captured;
+	}
+}
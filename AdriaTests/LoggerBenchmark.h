@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Logs from several threads into a separate log manager with a counting sink and reports messages per second and the
+	//producer side latency of each call, then does the same with binary capture enabled and checks the decoded capture.
+	//Used by the -logbenchmark command line option
+	Bool BenchmarkLogger(Uint32 message_count);
+}
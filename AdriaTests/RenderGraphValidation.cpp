@@ -0,0 +1,591 @@
+#include <random>
+#include "RenderGraphValidation.h"
+#include "RenderGraph/RenderGraph.h"
+#include "Core/ConsoleManager.h"
+#include "Logging/Logger.h"
+#include "Utilities/Timer.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		//synthetic graphs have no imported resources, building them does not touch the device
+		Float TimeRenderGraphBuild(RGResourcePool& pool, RGCompileCache* compile_cache, Uint32 pass_count, Uint64 seed)
+		{
+			RenderGraph rg(pool, compile_cache);
+			AddSyntheticRenderGraphPasses(rg, pass_count, seed);
+			Timer timer;
+			rg.Build();
+			return timer.ElapsedInSeconds();
+		}
+
+		//passes are declared in execution order, so the pass index order is a topological order of any valid adjacency list
+		std::vector<std::vector<Uint64>> GetReachability(std::vector<std::vector<Uint64>> const& adjacency_lists)
+		{
+			Uint64 const pass_count = adjacency_lists.size();
+			Uint64 const word_count = (pass_count + 63) / 64;
+			std::vector<std::vector<Uint64>> reachability(pass_count, std::vector<Uint64>(word_count, 0));
+			for (Uint64 i = pass_count; i-- > 0;)
+			{
+				for (Uint64 j : adjacency_lists[i])
+				{
+					reachability[i][j / 64] |= 1ull << (j % 64);
+					for (Uint64 w = 0; w < word_count; ++w) reachability[i][w] |= reachability[j][w];
+				}
+			}
+			return reachability;
+		}
+
+		std::vector<Uint64> GetDependencyLevels(std::vector<std::vector<Uint64>> const& adjacency_lists)
+		{
+			std::vector<Uint64> levels(adjacency_lists.size(), 0);
+			for (Uint64 i = 0; i < adjacency_lists.size(); ++i)
+			{
+				for (Uint64 j : adjacency_lists[i]) levels[j] = std::max(levels[j], levels[i] + 1);
+			}
+			return levels;
+		}
+
+		Uint64 GetEdgeCount(std::vector<std::vector<Uint64>> const& adjacency_lists)
+		{
+			Uint64 edge_count = 0;
+			for (auto const& adjacency_list : adjacency_lists) edge_count += adjacency_list.size();
+			return edge_count;
+		}
+
+		Bool IsPoolCompatible(GfxTextureDesc const& pooled_desc, GfxTextureDesc const& desc) { return pooled_desc.IsCompatible(desc); }
+		Bool IsPoolCompatible(GfxBufferDesc const& pooled_desc, GfxBufferDesc const& desc) { return pooled_desc == desc; }
+
+		//the pool this replaced with the same eviction policy: one list per resource kind, scanned front to back on every allocation and release
+		template<typename ResourceDesc>
+		class LinearScanPool
+		{
+			struct PooledResource
+			{
+				Uint64 id;
+				ResourceDesc desc;
+				Uint64 size;
+				Uint64 last_used_frame;
+				Bool active;
+			};
+
+		public:
+			void Tick(Uint64 max_idle_frames)
+			{
+				std::erase_if(resources, [&](PooledResource const& resource) { return !resource.active && resource.last_used_frame + max_idle_frames < frame_index; });
+				++frame_index;
+			}
+
+			Uint64 Allocate(ResourceDesc const& desc, Uint64 size)
+			{
+				for (PooledResource& resource : resources)
+				{
+					if (resource.active || !IsPoolCompatible(resource.desc, desc)) continue;
+					resource.last_used_frame = frame_index;
+					resource.active = true;
+					return resource.id;
+				}
+				resources.push_back(PooledResource{ next_id, desc, size, frame_index, true });
+				return next_id++;
+			}
+
+			void Release(Uint64 id)
+			{
+				for (PooledResource& resource : resources)
+				{
+					if (!resource.active || resource.id != id) continue;
+					resource.active = false;
+					resource.last_used_frame = frame_index;
+				}
+			}
+
+			Uint64 GetCreatedCount() const { return next_id; }
+			Uint64 GetMemory() const
+			{
+				Uint64 memory = 0;
+				for (PooledResource const& resource : resources) memory += resource.size;
+				return memory;
+			}
+
+		private:
+			std::vector<PooledResource> resources;
+			Uint64 frame_index = 0;
+			Uint64 next_id = 0;
+		};
+
+		struct PoolReplayStats
+		{
+			Uint64 created_count = 0;
+			Uint64 peak_memory = 0;
+			Uint64 invalid_events = 0;
+			Float time = 0.0f;
+		};
+
+		PoolReplayStats ReplayPoolTraceOnLinearScanPool(std::vector<RGPoolTraceEvent> const& trace, Uint64 max_idle_frames)
+		{
+			LinearScanPool<GfxTextureDesc> texture_pool;
+			LinearScanPool<GfxBufferDesc> buffer_pool;
+			std::unordered_map<Uint32, Uint64> texture_ids, buffer_ids;
+			PoolReplayStats stats{};
+			Timer timer;
+			for (RGPoolTraceEvent const& event : trace)
+			{
+				switch (event.type)
+				{
+				case RGPoolTraceEventType::AllocateTexture:
+					texture_ids[event.slot] = texture_pool.Allocate(event.texture_desc, event.size);
+					break;
+				case RGPoolTraceEventType::AllocateBuffer:
+					buffer_ids[event.slot] = buffer_pool.Allocate(event.buffer_desc, event.size);
+					break;
+				case RGPoolTraceEventType::ReleaseTexture:
+					if (auto it = texture_ids.find(event.slot); it != texture_ids.end()) texture_pool.Release(it->second);
+					break;
+				case RGPoolTraceEventType::ReleaseBuffer:
+					if (auto it = buffer_ids.find(event.slot); it != buffer_ids.end()) buffer_pool.Release(it->second);
+					break;
+				case RGPoolTraceEventType::Tick:
+					stats.peak_memory = std::max(stats.peak_memory, texture_pool.GetMemory() + buffer_pool.GetMemory());
+					texture_pool.Tick(max_idle_frames);
+					buffer_pool.Tick(max_idle_frames);
+					break;
+				}
+			}
+			stats.time = timer.ElapsedInSeconds();
+			stats.peak_memory = std::max(stats.peak_memory, texture_pool.GetMemory() + buffer_pool.GetMemory());
+			stats.created_count = texture_pool.GetCreatedCount() + buffer_pool.GetCreatedCount();
+			return stats;
+		}
+
+		//the plan sorts the barriers of a level by id, the expected lists are written in the same order
+		Bool CheckBarrierPlan(Char const* graph_name, RGBarrierPlan const& barrier_plan, RGBarrierPlan const& expected_barrier_plan)
+		{
+			std::string const plan_data = BarrierPlanToString(barrier_plan);
+			std::string const expected_plan_data = BarrierPlanToString(expected_barrier_plan);
+			if (plan_data == expected_plan_data) return true;
+
+			ADRIA_LOG(ERROR, "Render graph barrier validation failed for the %s graph, expected:\n%s\nplanned:\n%s", graph_name, expected_plan_data.c_str(), plan_data.c_str());
+			return false;
+		}
+	}
+
+	void AddSyntheticRenderGraphPasses(RenderGraph& rg, Uint32 pass_count, Uint64 seed)
+	{
+		std::mt19937_64 random(seed);
+		auto RandomIndex = [&random](Uint64 count) { return std::uniform_int_distribution<Uint64>(0, count - 1)(random); };
+		auto RandomChance = [&random](Uint32 percent) { return std::uniform_int_distribution<Uint32>(0, 99)(random) < percent; };
+
+		Uint64 texture_count = 0;
+		Uint64 buffer_count = 0;
+		for (Uint32 i = 0; i < pass_count; ++i)
+		{
+			RGPassType const pass_type = RandomChance(25) ? RGPassType::Compute : RGPassType::Graphics;
+			RGPassFlags const pass_flags = RandomChance(10) ? RGPassFlags::ForceNoCull : RGPassFlags::None;
+			rg.AddPass<void>("Synthetic Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					//every pass produces something new so that later passes always have resources to depend on
+					if (texture_count == 0 || RandomChance(40))
+					{
+						RGResourceName const name = RG_NAME_IDX(SyntheticTexture, texture_count++);
+						builder.DeclareTexture(name, RGTextureDesc{ .width = 256, .height = 256, .format = GfxFormat::R8G8B8A8_UNORM });
+						std::ignore = builder.WriteTexture(name);
+					}
+					if (buffer_count == 0 || RandomChance(20))
+					{
+						RGResourceName const name = RG_NAME_IDX(SyntheticBuffer, buffer_count++);
+						builder.DeclareBuffer(name, RGBufferDesc{ .size = 4096, .stride = 4 });
+						std::ignore = builder.WriteBuffer(name);
+					}
+
+					Uint64 const read_count = RandomIndex(4);
+					for (Uint64 j = 0; j < read_count; ++j)
+					{
+						if (RandomChance(70)) std::ignore = builder.ReadTexture(RG_NAME_IDX(SyntheticTexture, RandomIndex(texture_count)));
+						else std::ignore = builder.ReadBuffer(RG_NAME_IDX(SyntheticBuffer, RandomIndex(buffer_count)));
+					}
+					//read-modify-write through views and blind writes that replace the previous contents
+					Uint64 const write_count = RandomIndex(3);
+					for (Uint64 j = 0; j < write_count; ++j)
+					{
+						Bool const blind_write = RandomChance(30);
+						if (RandomChance(70))
+						{
+							RGResourceName const name = RG_NAME_IDX(SyntheticTexture, RandomIndex(texture_count));
+							if (blind_write) builder.DummyWriteTexture(name);
+							else std::ignore = builder.WriteTexture(name);
+						}
+						else
+						{
+							RGResourceName const name = RG_NAME_IDX(SyntheticBuffer, RandomIndex(buffer_count));
+							if (blind_write) builder.DummyWriteBuffer(name);
+							else std::ignore = builder.WriteBuffer(name);
+						}
+					}
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, pass_type, pass_flags);
+		}
+	}
+
+	Bool BenchmarkRenderGraphCompile(Uint32 pass_count, Uint32 iterations)
+	{
+		RGResourcePool pool(nullptr);
+		RGCompileCache compile_cache;
+		iterations = std::max(iterations, 1u);
+
+		Float uncached_time = 0.0f;
+		Float cached_time = 0.0f;
+		Float const cache_miss_time = TimeRenderGraphBuild(pool, &compile_cache, pass_count, 0);
+		for (Uint32 i = 0; i < iterations; ++i)
+		{
+			uncached_time += TimeRenderGraphBuild(pool, nullptr, pass_count, 0);
+			cached_time += TimeRenderGraphBuild(pool, &compile_cache, pass_count, 0);
+		}
+		ADRIA_LOG(INFO, "Render graph compile benchmark: %u passes, %u iterations, uncached %.3f ms, cache miss %.3f ms, cache hit %.3f ms",
+			pass_count, iterations, 1000.0f * uncached_time / iterations, 1000.0f * cache_miss_time, 1000.0f * cached_time / iterations);
+		return compile_cache.Size() == 1;
+	}
+
+	//the checks look at compiler internals, both RenderGraph and RenderGraphPassBase befriend this class
+	class RenderGraphValidation
+	{
+	public:
+		static Bool ValidateDependencies(Uint32 graph_count, Uint32 pass_count);
+		static Bool ValidateRecording(Uint32 graph_count, Uint32 pass_count);
+		static Bool ValidateBarriers();
+		static Bool ValidatePoolTrace(std::string const& trace_path);
+
+	private:
+		static PoolReplayStats ReplayPoolTrace(std::vector<RGPoolTraceEvent> const& trace, Bool check_invariants);
+	};
+
+	Bool RenderGraphValidation::ValidateDependencies(Uint32 graph_count, Uint32 pass_count)
+	{
+		RGResourcePool pool(nullptr);
+		Uint32 failed_graphs = 0;
+		Uint64 sweep_edges = 0, all_pairs_edges = 0;
+		Float sweep_time = 0.0f, all_pairs_time = 0.0f;
+		for (Uint32 graph = 0; graph < graph_count; ++graph)
+		{
+			RenderGraph rg(pool);
+			AddSyntheticRenderGraphPasses(rg, pass_count, graph);
+
+			Timer timer;
+			rg.BuildAdjacencyLists();
+			sweep_time += timer.MarkInSeconds();
+
+			//the scheduler this replaced: every pass against every later pass, an edge for any read of a written resource
+			std::vector<std::vector<Uint64>> all_pairs_adjacency_lists(rg.passes.size());
+			for (Uint64 i = 0; i < rg.passes.size(); ++i)
+			{
+				RenderGraphPassBase const* pass = rg.passes[i].get();
+				for (Uint64 j = i + 1; j < rg.passes.size(); ++j)
+				{
+					RenderGraphPassBase const* other_pass = rg.passes[j].get();
+					Bool const depends = std::any_of(other_pass->texture_reads.begin(), other_pass->texture_reads.end(), [pass](RGTextureId id) { return pass->texture_writes.Contains(id); })
+									  || std::any_of(other_pass->buffer_reads.begin(), other_pass->buffer_reads.end(), [pass](RGBufferId id) { return pass->buffer_writes.Contains(id); });
+					if (depends) all_pairs_adjacency_lists[i].push_back(j);
+				}
+			}
+			all_pairs_time += timer.MarkInSeconds();
+
+			std::vector<std::vector<Uint64>> const& adjacency_lists = rg.adjacency_lists;
+			Bool edges_valid = true;
+			for (Uint64 i = 0; i < adjacency_lists.size(); ++i)
+			{
+				for (Uint64 j : adjacency_lists[i])
+				{
+					if (!std::binary_search(all_pairs_adjacency_lists[i].begin(), all_pairs_adjacency_lists[i].end(), j)) edges_valid = false;
+				}
+			}
+			Bool const reachability_valid = GetReachability(adjacency_lists) == GetReachability(all_pairs_adjacency_lists);
+			Bool const levels_valid = GetDependencyLevels(adjacency_lists) == GetDependencyLevels(all_pairs_adjacency_lists);
+			if (!edges_valid || !reachability_valid || !levels_valid)
+			{
+				ADRIA_LOG(ERROR, "Render graph dependency validation failed for graph %u: edges %s, reachability %s, dependency levels %s", graph,
+					edges_valid ? "match" : "differ", reachability_valid ? "match" : "differ", levels_valid ? "match" : "differ");
+				++failed_graphs;
+			}
+			sweep_edges += GetEdgeCount(adjacency_lists);
+			all_pairs_edges += GetEdgeCount(all_pairs_adjacency_lists);
+		}
+		ADRIA_LOG(INFO, "Render graph dependency validation: %u of %u graphs with %u passes match, %llu edges (all pairs %llu), %.3f ms (all pairs %.3f ms)",
+			graph_count - failed_graphs, graph_count, pass_count, sweep_edges, all_pairs_edges, 1000.0f * sweep_time, 1000.0f * all_pairs_time);
+		return failed_graphs == 0;
+	}
+
+	Bool RenderGraphValidation::ValidateRecording(Uint32 graph_count, Uint32 pass_count)
+	{
+		RGResourcePool pool(nullptr);
+		Uint32 failed_graphs = 0;
+		Uint64 batched_levels = 0, max_batch_count = 0;
+		for (Uint32 graph = 0; graph < graph_count; ++graph)
+		{
+			RenderGraph rg(pool);
+			AddSyntheticRenderGraphPasses(rg, pass_count, graph);
+			rg.Build();
+
+			//mock command lists only log the ids of the passes recorded into them
+			Bool recording_valid = true;
+			for (RenderGraph::DependencyLevel const& dependency_level : rg.dependency_levels)
+			{
+				std::vector<Uint64> expected_order;
+				for (RenderGraphPassBase const* pass : dependency_level.passes)
+				{
+					if (!pass->IsCulled()) expected_order.push_back(pass->id);
+				}
+
+				Uint64 const batch_count = dependency_level.GetRecordingBatchCount();
+				std::vector<std::vector<Uint64>> mock_cmd_lists(batch_count);
+				dependency_level.ExecuteBatched(batch_count, [&](RenderGraphPassBase* pass, Uint64 batch_index) { mock_cmd_lists[batch_index].push_back(pass->id); });
+
+				std::vector<Uint64> submitted_order;
+				for (std::vector<Uint64> const& mock_cmd_list : mock_cmd_lists)
+				{
+					if (batch_count > 1 && mock_cmd_list.empty()) recording_valid = false;
+					submitted_order.insert(submitted_order.end(), mock_cmd_list.begin(), mock_cmd_list.end());
+				}
+				if (submitted_order != expected_order || batch_count > g_ThreadPool.GetThreadCount()) recording_valid = false;
+
+				if (batch_count > 1) ++batched_levels;
+				max_batch_count = std::max(max_batch_count, batch_count);
+			}
+			if (!recording_valid)
+			{
+				ADRIA_LOG(ERROR, "Render graph recording validation failed for graph %u", graph);
+				++failed_graphs;
+			}
+		}
+		ADRIA_LOG(INFO, "Render graph recording validation: %u of %u graphs with %u passes match the single threaded order, %llu levels recorded in up to %llu batches on %llu threads",
+			graph_count - failed_graphs, graph_count, pass_count, batched_levels, max_batch_count, g_ThreadPool.GetThreadCount());
+		return failed_graphs == 0;
+	}
+
+	//every graph has the same shape: the first pass creates texture 0 and buffer 0, the second one reads buffer 0 and creates texture 1
+	//and the last one reads both textures, so texture 0 is idle during the second dependency level
+	Bool RenderGraphValidation::ValidateBarriers()
+	{
+		using enum GfxResourceState;
+		RGResourcePool pool(nullptr);
+		RGTextureDesc const texture_desc{ .width = 256, .height = 256, .mip_levels = 2, .format = GfxFormat::R8G8B8A8_UNORM };
+		RGBufferDesc const buffer_desc{ .size = 4096, .stride = 4 };
+		auto AddIdleTextureGraph = [&](RenderGraph& rg, RGPassType second_pass_type)
+		{
+			rg.AddPass<void>("Create Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					builder.DeclareTexture(RG_NAME(BarrierTexture0), texture_desc);
+					std::ignore = builder.WriteTexture(RG_NAME(BarrierTexture0));
+					builder.DeclareBuffer(RG_NAME(BarrierBuffer0), buffer_desc);
+					std::ignore = builder.WriteBuffer(RG_NAME(BarrierBuffer0));
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
+			rg.AddPass<void>("Second Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadBuffer(RG_NAME(BarrierBuffer0), ReadAccess_PixelShader);
+					builder.DeclareTexture(RG_NAME(BarrierTexture1), texture_desc);
+					std::ignore = builder.WriteTexture(RG_NAME(BarrierTexture1));
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, second_pass_type, RGPassFlags::ForceNoCull);
+			rg.AddPass<void>("Read Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadTexture(RG_NAME(BarrierTexture0), ReadAccess_PixelShader);
+					std::ignore = builder.ReadTexture(RG_NAME(BarrierTexture1), ReadAccess_PixelShader);
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
+		};
+
+		Uint32 failed_graphs = 0;
+		{
+			//texture 0 begins its transition after the first level and ends it before the last one
+			RenderGraph rg(pool);
+			AddIdleTextureGraph(rg, RGPassType::Graphics);
+			rg.Build();
+
+			RGBarrierPlan expected_barrier_plan{};
+			expected_barrier_plan.levels.resize(3);
+			expected_barrier_plan.levels[0].texture_barriers = { { RGTextureId(0), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[0].buffer_barriers = { { RGBufferId(0), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[0].texture_split_barriers = { { RGTextureId(0), ComputeUAV, PixelSRV, RGBarrierType::SplitBegin } };
+			expected_barrier_plan.levels[1].texture_barriers = { { RGTextureId(1), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[1].buffer_barriers = { { RGBufferId(0), ComputeUAV, PixelSRV, RGBarrierType::Transition } };
+			expected_barrier_plan.levels[2].texture_barriers = { { RGTextureId(0), ComputeUAV, PixelSRV, RGBarrierType::SplitEnd },
+																 { RGTextureId(1), ComputeUAV, PixelSRV, RGBarrierType::Transition } };
+			if (!CheckBarrierPlan("split barrier", rg.barrier_plan, expected_barrier_plan)) ++failed_graphs;
+		}
+		{
+			//the second level runs on the compute queue and the graphics queue switches command lists around it,
+			//so texture 0 is not split and the transitions out of the compute queue happen at the sync level
+			RenderGraph rg(pool);
+			AddIdleTextureGraph(rg, RGPassType::ComputeAsync);
+			rg.Build();
+
+			RGBarrierPlan expected_barrier_plan{};
+			expected_barrier_plan.levels.resize(3);
+			expected_barrier_plan.levels[0].texture_barriers = { { RGTextureId(0), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[0].buffer_barriers = { { RGBufferId(0), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[1].texture_barriers = { { RGTextureId(1), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[1].buffer_barriers = { { RGBufferId(0), ComputeUAV, ComputeSRV, RGBarrierType::Transition } };
+			expected_barrier_plan.levels[2].texture_barriers = { { RGTextureId(0), ComputeUAV, PixelSRV, RGBarrierType::Transition },
+																 { RGTextureId(1), ComputeUAV, PixelSRV, RGBarrierType::Transition } };
+			Bool const schedule_valid = rg.async_compute_schedule.pass_queues[1] == RGQueueType::Compute && rg.async_compute_schedule.sync_levels[1] == 2;
+			if (!schedule_valid) ADRIA_LOG(ERROR, "Render graph barrier validation failed for the cross queue graph, the second pass is not synchronized at the last level");
+			if (!CheckBarrierPlan("cross queue", rg.barrier_plan, expected_barrier_plan) || !schedule_valid) ++failed_graphs;
+		}
+		{
+			//two passes of one level read different mips of texture 0 with different states, the level transitions the whole texture once to both
+			RenderGraph rg(pool);
+			rg.AddPass<void>("Create Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					builder.DeclareTexture(RG_NAME(BarrierTexture0), texture_desc);
+					std::ignore = builder.WriteTexture(RG_NAME(BarrierTexture0));
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
+			rg.AddPass<void>("Pixel Read Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadTexture(RG_NAME(BarrierTexture0), ReadAccess_PixelShader, 0, 1);
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
+			rg.AddPass<void>("Compute Read Pass",
+				[&](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadTexture(RG_NAME(BarrierTexture0), ReadAccess_NonPixelShader, 1, 1);
+				},
+				[](RenderGraphContext&, GfxCommandList*) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+			rg.Build();
+
+			RGBarrierPlan expected_barrier_plan{};
+			expected_barrier_plan.levels.resize(2);
+			expected_barrier_plan.levels[0].texture_barriers = { { RGTextureId(0), Common, ComputeUAV, RGBarrierType::Create } };
+			expected_barrier_plan.levels[1].texture_barriers = { { RGTextureId(0), ComputeUAV, PixelSRV | ComputeSRV, RGBarrierType::Transition } };
+			if (!CheckBarrierPlan("merged read", rg.barrier_plan, expected_barrier_plan)) ++failed_graphs;
+		}
+		ADRIA_LOG(INFO, "Render graph barrier validation: %u of 3 graphs match the expected barriers", 3 - failed_graphs);
+		return failed_graphs == 0;
+	}
+
+	//trace slots belong to the captured pool, the replayed pool hands out its own
+	PoolReplayStats RenderGraphValidation::ReplayPoolTrace(std::vector<RGPoolTraceEvent> const& trace, Bool check_invariants)
+	{
+		RGResourcePool pool(nullptr);
+		std::unordered_map<Uint32, RGPoolHandle> texture_handles, buffer_handles;
+		std::unordered_set<Uint32> active_textures, active_buffers;
+		PoolReplayStats stats{};
+		Timer timer;
+		for (RGPoolTraceEvent const& event : trace)
+		{
+			Uint64 const pooled_memory = pool.GetPooledMemory();
+			switch (event.type)
+			{
+			case RGPoolTraceEventType::AllocateTexture:
+			{
+				pool.SeedAllocationInfo(event.texture_desc, event.size);
+				RGPoolHandle& handle = texture_handles[event.slot];
+				pool.AllocateTexture(event.texture_desc, handle);
+				if (check_invariants && (!active_textures.insert(handle.slot).second || !pool.texture_slots[handle.slot].desc.IsCompatible(event.texture_desc))) ++stats.invalid_events;
+			}
+			break;
+			case RGPoolTraceEventType::AllocateBuffer:
+			{
+				pool.SeedAllocationInfo(event.buffer_desc, event.size);
+				RGPoolHandle& handle = buffer_handles[event.slot];
+				pool.AllocateBuffer(event.buffer_desc, handle);
+				if (check_invariants && (!active_buffers.insert(handle.slot).second || pool.buffer_slots[handle.slot].desc != event.buffer_desc)) ++stats.invalid_events;
+			}
+			break;
+			case RGPoolTraceEventType::ReleaseTexture:
+				if (auto it = texture_handles.find(event.slot); it != texture_handles.end())
+				{
+					if (check_invariants) active_textures.erase(it->second.slot);
+					pool.ReleaseTexture(it->second);
+					texture_handles.erase(it);
+				}
+				else ++stats.invalid_events;
+				break;
+			case RGPoolTraceEventType::ReleaseBuffer:
+				if (auto it = buffer_handles.find(event.slot); it != buffer_handles.end())
+				{
+					if (check_invariants) active_buffers.erase(it->second.slot);
+					pool.ReleaseBuffer(it->second);
+					buffer_handles.erase(it);
+				}
+				else ++stats.invalid_events;
+				break;
+			case RGPoolTraceEventType::Tick:
+				pool.Tick();
+				break;
+			}
+			if (pool.GetPooledMemory() > pooled_memory) ++stats.created_count;
+			stats.peak_memory = std::max(stats.peak_memory, pool.GetPooledMemory());
+		}
+		stats.time = timer.ElapsedInSeconds();
+
+		if (check_invariants)
+		{
+			//the pooled memory has to match the resources that were neither evicted nor handed back to the free slot lists
+			std::unordered_set<Uint32> const free_texture_slots(pool.free_texture_slots.begin(), pool.free_texture_slots.end());
+			std::unordered_set<Uint32> const free_buffer_slots(pool.free_buffer_slots.begin(), pool.free_buffer_slots.end());
+			Uint64 live_memory = 0;
+			for (Uint32 slot = 0; slot < pool.texture_slots.size(); ++slot)
+			{
+				if (!free_texture_slots.contains(slot)) live_memory += pool.texture_slots[slot].size;
+			}
+			for (Uint32 slot = 0; slot < pool.buffer_slots.size(); ++slot)
+			{
+				if (!free_buffer_slots.contains(slot)) live_memory += pool.buffer_slots[slot].size;
+			}
+			if (live_memory != pool.GetPooledMemory()) ++stats.invalid_events;
+		}
+		return stats;
+	}
+
+	Bool RenderGraphValidation::ValidatePoolTrace(std::string const& trace_path)
+	{
+		std::vector<RGPoolTraceEvent> trace;
+		if (!LoadRenderGraphPoolTrace(trace_path, trace))
+		{
+			ADRIA_LOG(ERROR, "Failed to load render graph resource pool trace %s", trace_path.c_str());
+			return false;
+		}
+		IConsoleVariable const* max_idle_frames_cvar = g_ConsoleManager.FindConsoleVariable("r.RenderGraph.PoolMaxIdleFrames");
+		Uint64 const max_idle_frames = (Uint64)std::max(max_idle_frames_cvar ? max_idle_frames_cvar->GetInt() : 4, 0);
+		Uint64 const frame_count = std::count_if(trace.begin(), trace.end(), [](RGPoolTraceEvent const& event) { return event.type == RGPoolTraceEventType::Tick; });
+
+		PoolReplayStats const checked_stats = ReplayPoolTrace(trace, true);
+		PoolReplayStats const pool_stats = ReplayPoolTrace(trace, false);
+		PoolReplayStats const linear_scan_stats = ReplayPoolTraceOnLinearScanPool(trace, max_idle_frames);
+		if (checked_stats.invalid_events > 0)
+		{
+			ADRIA_LOG(ERROR, "Render graph resource pool trace replay found %llu invalid events", checked_stats.invalid_events);
+		}
+		ADRIA_LOG(INFO, "Render graph resource pool trace replay: %llu events over %llu frames, pool %llu creations, peak %.1f MB, %.3f ms, linear scan %llu creations, peak %.1f MB, %.3f ms",
+			trace.size(), frame_count, pool_stats.created_count, pool_stats.peak_memory / (1024.0f * 1024.0f), 1000.0f * pool_stats.time,
+			linear_scan_stats.created_count, linear_scan_stats.peak_memory / (1024.0f * 1024.0f), 1000.0f * linear_scan_stats.time);
+		return checked_stats.invalid_events == 0;
+	}
+
+	Bool ValidateRenderGraphDependencies(Uint32 graph_count, Uint32 pass_count)
+	{
+		return RenderGraphValidation::ValidateDependencies(graph_count, pass_count);
+	}
+
+	Bool ValidateRenderGraphRecording(Uint32 graph_count, Uint32 pass_count)
+	{
+		return RenderGraphValidation::ValidateRecording(graph_count, pass_count);
+	}
+
+	Bool ValidateRenderGraphBarriers()
+	{
+		return RenderGraphValidation::ValidateBarriers();
+	}
+
+	Bool ValidateRenderGraphPoolTrace(std::string const& trace_path)
+	{
+		return RenderGraphValidation::ValidatePoolTrace(trace_path);
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace adria
+{
+	class RenderGraph;
+
+	//Declares a random but reproducible graph of pass_count passes that create, read and write textures and buffers
+	void AddSyntheticRenderGraphPasses(RenderGraph& rg, Uint32 pass_count, Uint64 seed);
+
+	//Builds synthetic graphs with and without the compile cache and logs the average build times,
+	//used by the -rgcompilebenchmark command line option
+	Bool BenchmarkRenderGraphCompile(Uint32 pass_count, Uint32 iterations);
+	//Checks that the single sweep dependency builder produces a subset of the all-pairs edges with the same reachability
+	//and the same dependency levels on synthetic graphs, used by the -rgdependencytest command line option
+	Bool ValidateRenderGraphDependencies(Uint32 graph_count, Uint32 pass_count);
+	//Records the dependency levels of synthetic graphs into mock command lists with the batching used for multithreaded recording
+	//and checks that submitting the lists in order reproduces the single threaded pass order, used by the -rgrecordingtest command line option
+	Bool ValidateRenderGraphRecording(Uint32 graph_count, Uint32 pass_count);
+	//Builds small graphs with idle resources, async compute passes and resources read with different states in one level and checks
+	//the planned begin and end barriers against hand written lists, used by the -rgbarriertest command line option
+	Bool ValidateRenderGraphBarriers();
+	//Replays a resource pool trace captured with r.RenderGraph.PoolTraceFrames on a pool without a device and on a linear scan reference pool,
+	//checks that no resource is handed out twice or with an incompatible desc and logs creations, peak memory and replay times,
+	//used by the -rgpooltrace command line option
+	Bool ValidateRenderGraphPoolTrace(std::string const& trace_path);
+}
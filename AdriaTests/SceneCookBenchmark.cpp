@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "SceneCookBenchmark.h"
+#include "Rendering/ModelCache.h"
+#include "Rendering/GLTFAccessors.h"
+#include "Rendering/SceneConfig.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		//times bulk decoding against reading every element through cgltf for the accessor layouts models use most
+		void BenchmarkAccessorDecoding(Uint32 iterations)
+		{
+			struct AccessorBenchmark
+			{
+				Char const* name;
+				cgltf_type type;
+				cgltf_component_type component_type;
+				Bool normalized;
+				Uint64 stride;
+			};
+			AccessorBenchmark const benchmarks[] =
+			{
+				{ "u8 indices", cgltf_type_scalar, cgltf_component_type_r_8u, false, 1 },
+				{ "u16 indices", cgltf_type_scalar, cgltf_component_type_r_16u, false, 2 },
+				{ "u32 indices", cgltf_type_scalar, cgltf_component_type_r_32u, false, 4 },
+				{ "vec2 f32", cgltf_type_vec2, cgltf_component_type_r_32f, false, 8 },
+				{ "vec3 f32", cgltf_type_vec3, cgltf_component_type_r_32f, false, 12 },
+				{ "vec3 f32 interleaved", cgltf_type_vec3, cgltf_component_type_r_32f, false, 32 },
+				{ "vec4 f32", cgltf_type_vec4, cgltf_component_type_r_32f, false, 16 },
+				{ "vec2 unorm8", cgltf_type_vec2, cgltf_component_type_r_8u, true, 2 },
+				{ "vec2 unorm16", cgltf_type_vec2, cgltf_component_type_r_16u, true, 4 },
+			};
+
+			constexpr Uint64 element_count = 1 << 20;
+			std::vector<Uint8> data(element_count * 32);
+			std::vector<Float> decoded(element_count * 4);
+			cgltf_buffer buffer{};
+			buffer.data = data.data();
+			buffer.size = data.size();
+			cgltf_buffer_view buffer_view{};
+			buffer_view.buffer = &buffer;
+			buffer_view.size = data.size();
+
+			for (AccessorBenchmark const& benchmark : benchmarks)
+			{
+				cgltf_accessor accessor{};
+				accessor.type = benchmark.type;
+				accessor.component_type = benchmark.component_type;
+				accessor.normalized = benchmark.normalized;
+				accessor.count = element_count;
+				accessor.stride = benchmark.stride;
+				accessor.buffer_view = &buffer_view;
+				Uint64 const component_count = cgltf_num_components(benchmark.type);
+
+				Float bulk_time = FLT_MAX;
+				Float element_time = FLT_MAX;
+				for (Uint32 i = 0; i < iterations; ++i)
+				{
+					Timer timer;
+					switch (component_count)
+					{
+					case 1: DecodeIndices(&accessor, reinterpret_cast<Uint32*>(decoded.data())); break;
+					case 2: DecodeAttribute(&accessor, reinterpret_cast<Vector2*>(decoded.data())); break;
+					case 3: DecodeAttribute(&accessor, reinterpret_cast<Vector3*>(decoded.data())); break;
+					case 4: DecodeAttribute(&accessor, reinterpret_cast<Vector4*>(decoded.data())); break;
+					}
+					bulk_time = std::min(bulk_time, timer.ElapsedInSeconds());
+
+					Timer element_timer;
+					for (Uint64 j = 0; j < element_count; ++j)
+					{
+						if (component_count == 1) reinterpret_cast<Uint32*>(decoded.data())[j] = (Uint32)cgltf_accessor_read_index(&accessor, j);
+						else cgltf_accessor_read_float(&accessor, j, decoded.data() + j * component_count, component_count);
+					}
+					element_time = std::min(element_time, element_timer.ElapsedInSeconds());
+				}
+				ADRIA_LOG(INFO, "Accessor benchmark %s: bulk %.3f ms, per element %.3f ms for %llu elements", benchmark.name,
+					bulk_time * 1000.0f, element_time * 1000.0f, element_count);
+			}
+		}
+	}
+
+	Bool BenchmarkSceneCook(std::string const& scene_file, Uint32 iterations)
+	{
+		BenchmarkAccessorDecoding(iterations);
+
+		SceneConfig scene_config{};
+		if (!ParseSceneConfig(scene_file, scene_config)) return false;
+
+		std::vector<Uint8> cooked_data;
+		for (ModelParameters const& model_params : scene_config.scene_models)
+		{
+			Float total_time = 0.0f;
+			Float min_time = FLT_MAX;
+			for (Uint32 i = 0; i < iterations; ++i)
+			{
+				Timer timer;
+				if (!ImportModel(model_params, cooked_data)) return false;
+				Float const cook_time = timer.ElapsedInSeconds();
+				total_time += cook_time;
+				min_time = std::min(min_time, cook_time);
+			}
+			ADRIA_LOG(INFO, "Cook benchmark %s: %u iterations on %llu threads, average %.3f s, min %.3f s", model_params.model_path.c_str(),
+				iterations, g_ThreadPool.GetThreadCount(), total_time / std::max(iterations, 1u), min_time);
+		}
+		return true;
+	}
+}
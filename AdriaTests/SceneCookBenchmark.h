@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Times accessor decoding for common layouts, then imports the models of the scene the given number of times without touching
+	//the model cache and logs the import times, used by the -cookbenchmark command line option
+	Bool BenchmarkSceneCook(std::string const& scene_file, Uint32 iterations);
+}
@@ -0,0 +1,121 @@
+#include "SceneInstanceBenchmark.h"
+#include "Rendering/SceneInstances.h"
+#include "Rendering/Components.h"
+#include "Logging/Logger.h"
+#include "Utilities/Timer.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 BENCHMARK_INSTANCES_PER_MESH = 64;
+
+		std::vector<entt::entity> CreateBenchmarkScene(entt::registry& reg, Uint32 instance_count)
+		{
+			RealRandomGenerator<Float> random(-100.0f, 100.0f, std::mt19937{ 0 });
+			std::vector<entt::entity> mesh_entities;
+			for (Uint32 first_instance = 0; first_instance < instance_count; first_instance += BENCHMARK_INSTANCES_PER_MESH)
+			{
+				entt::entity const mesh_entity = mesh_entities.emplace_back(reg.create());
+				Mesh& mesh = reg.emplace<Mesh>(mesh_entity);
+				mesh.materials.resize(2);
+				mesh.submeshes.resize(4);
+				for (Uint32 i = 0; i < mesh.submeshes.size(); ++i)
+				{
+					mesh.submeshes[i].material_index = i % (Uint32)mesh.materials.size();
+					mesh.submeshes[i].bounding_box = BoundingBox(Vector3::Zero, Vector3::One);
+				}
+				Uint32 const mesh_instance_count = std::min(BENCHMARK_INSTANCES_PER_MESH, instance_count - first_instance);
+				for (Uint32 i = 0; i < mesh_instance_count; ++i)
+				{
+					SubMeshInstance& instance = mesh.instances.emplace_back();
+					instance.parent = mesh_entity;
+					instance.submesh_index = i % (Uint32)mesh.submeshes.size();
+					instance.world_transform = Matrix::CreateScale(1.0f + std::abs(random()) * 0.01f) * Matrix::CreateTranslation(random(), random(), random());
+				}
+			}
+			return mesh_entities;
+		}
+
+		//the rebuild the renderer did every frame before scene instances were kept across frames
+		void RecreateSceneBatches(entt::registry& reg, std::vector<InstanceGPU>& instances)
+		{
+			for (auto e : reg.view<Batch>()) reg.destroy(e);
+			reg.clear<Batch>();
+			instances.clear();
+			Uint32 mesh_offset = 0, material_offset = 0;
+			for (auto mesh_entity : reg.view<Mesh>())
+			{
+				Mesh& mesh = reg.get<Mesh>(mesh_entity);
+				for (SubMeshInstance const& instance : mesh.instances)
+				{
+					Uint32 const instance_id = (Uint32)instances.size();
+					Batch& batch = reg.emplace<Batch>(reg.create());
+					PackSceneInstance(mesh, instance, instance_id, mesh_offset, material_offset, batch, instances.emplace_back());
+				}
+				mesh_offset += (Uint32)mesh.submeshes.size();
+				material_offset += (Uint32)mesh.materials.size();
+			}
+		}
+	}
+
+	Bool BenchmarkSceneInstances(Uint32 instance_count, Uint32 frame_count)
+	{
+		frame_count = std::max(frame_count, 1u);
+		Timer timer;
+
+		entt::registry recreate_reg;
+		CreateBenchmarkScene(recreate_reg, instance_count);
+		std::vector<InstanceGPU> recreated_instances;
+		timer.Mark();
+		for (Uint32 frame = 0; frame < frame_count; ++frame) RecreateSceneBatches(recreate_reg, recreated_instances);
+		Float const recreate_time = timer.MarkInSeconds();
+
+		entt::registry persistent_reg;
+		std::vector<entt::entity> const mesh_entities = CreateBenchmarkScene(persistent_reg, instance_count);
+		std::vector<InstanceGPU> persistent_instances;
+		Float static_time = 0.0f, moving_time = 0.0f;
+		Bool partial_updates = true;
+		{
+			SceneInstances scene_instances(persistent_reg);
+			scene_instances.Update(true);
+			timer.Mark();
+			for (Uint32 frame = 0; frame < frame_count; ++frame) scene_instances.Update(true);
+			static_time = timer.MarkInSeconds();
+
+			//a hundredth of the meshes move every frame, each through reg.patch like the editor
+			Uint64 const moving_mesh_count = std::max<Uint64>(mesh_entities.size() / 100, 1);
+			for (Uint32 frame = 0; frame < frame_count; ++frame)
+			{
+				for (Uint64 i = 0; i < moving_mesh_count; ++i)
+				{
+					entt::entity const mesh_entity = mesh_entities[(i * 100 + frame) % mesh_entities.size()];
+					persistent_reg.patch<Mesh>(mesh_entity, [](Mesh& mesh)
+					{
+						for (SubMeshInstance& instance : mesh.instances) instance.world_transform *= Matrix::CreateTranslation(0.0f, 0.01f, 0.0f);
+					});
+				}
+				scene_instances.Update(true);
+				//the renderer uploads only these ranges of the instance buffer
+				Uint64 const dirty_range_count = scene_instances.GetDirtyInstanceRanges().size();
+				if (scene_instances.WasRebuilt() || dirty_range_count == 0 || dirty_range_count > moving_mesh_count) partial_updates = false;
+			}
+			moving_time = timer.MarkInSeconds();
+			persistent_instances = scene_instances.GetInstances();
+		}
+
+		//the persistent instances have to match a full rebuild of the moved scene
+		RecreateSceneBatches(persistent_reg, recreated_instances);
+		Bool const instances_match = std::equal(persistent_instances.begin(), persistent_instances.end(), recreated_instances.begin(), recreated_instances.end(),
+			[](InstanceGPU const& a, InstanceGPU const& b)
+			{
+				return a.instance_id == b.instance_id && a.material_idx == b.material_idx && a.mesh_index == b.mesh_index &&
+					   a.world_matrix == b.world_matrix && a.inverse_world_matrix == b.inverse_world_matrix;
+			});
+		ADRIA_LOG(INFO, "Scene instance benchmark: %u instances, %u frames, recreate %.3f ms, persistent static %.3f ms, persistent with 1%% of meshes moving %.3f ms per frame, "
+			"instances %s, moved meshes %s", instance_count, frame_count, 1000.0f * recreate_time / frame_count, 1000.0f * static_time / frame_count,
+			1000.0f * moving_time / frame_count, instances_match ? "match" : "differ", partial_updates ? "packed on their own" : "caused full rebuilds");
+		return instances_match && partial_updates;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Times the per frame rebuild of every scene batch against the scene instances the renderer keeps across frames on a synthetic registry,
+	//for a static scene and one where a hundredth of the meshes move every frame through reg.patch, checks that moved meshes are packed
+	//on their own and that both produce the same instances. Used by the -sceneinstancebenchmark command line option
+	Bool BenchmarkSceneInstances(Uint32 instance_count, Uint32 frame_count);
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include "ShaderKeyBenchmark.h"
+#include "Graphics/GfxShaderKey.h"
+#include "Graphics/GfxShader.h"
+#include "Rendering/ShaderManager.h"
+#include "Utilities/HashUtil.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		//the previous key layout, a heap allocated define list that is concatenated and hashed on every GetHash() and comparison
+		class StringShaderKey
+		{
+		public:
+			explicit StringShaderKey(ShaderID id) : id(id) {}
+
+			void AddDefine(Char const* name, Char const* value)
+			{
+				defines.emplace_back(name, value);
+			}
+			Uint64 GetHash() const
+			{
+				std::string define_key;
+				for (GfxShaderDefine const& define : defines)
+				{
+					define_key += define.name;
+					define_key += define.value;
+				}
+				define_key += std::to_string(id);
+				return crc64(define_key.c_str(), define_key.size());
+			}
+			Bool operator==(StringShaderKey const& key) const
+			{
+				return id == key.id && GetHash() == key.GetHash();
+			}
+
+		private:
+			ShaderID id;
+			std::vector<GfxShaderDefine> defines;
+		};
+		struct StringShaderKeyHash
+		{
+			Uint64 operator()(StringShaderKey const& key) const
+			{
+				return key.GetHash();
+			}
+		};
+	}
+
+	Bool BenchmarkShaderKeys(Uint32 key_count)
+	{
+		static constexpr Char const* define_names[] = { "RAIN", "MASK", "SHADOWS", "SSR", "DEBUG_VIEW", "TILED", "CLUSTERED", "INSTANCED",
+														"USE_NORMAL_MAP", "PCF", "CASCADES", "RAY_TRACED", "MULTIPLE_SCATTERING", "VOLUMETRIC", "LOD" };
+		static constexpr Uint32 define_name_count = (Uint32)std::size(define_names);
+		static_assert(define_name_count <= GfxShaderKey::MAX_DEFINES);
+
+		//key i sets the defines of the bits of i, keys of different shaders get the same define combinations
+		auto AddKeyDefines = [](auto& key, Uint32 i)
+		{
+			for (Uint32 bit = 0; bit < define_name_count; ++bit)
+			{
+				if ((i >> bit) & 1) key.AddDefine(define_names[bit], "1");
+			}
+		};
+		auto GetKeyShader = [](Uint32 i) { return (ShaderID)(1 + (i >> define_name_count) % 64); };
+
+		Timer timer;
+		std::vector<GfxShaderKey> interned_keys;
+		interned_keys.reserve(key_count);
+		for (Uint32 i = 0; i < key_count; ++i)
+		{
+			GfxShaderKey& key = interned_keys.emplace_back(GetKeyShader(i));
+			AddKeyDefines(key, i);
+		}
+		Float const interned_build_time = timer.MarkInSeconds();
+
+		std::vector<StringShaderKey> string_keys;
+		string_keys.reserve(key_count);
+		for (Uint32 i = 0; i < key_count; ++i)
+		{
+			StringShaderKey& key = string_keys.emplace_back(GetKeyShader(i));
+			AddKeyDefines(key, i);
+		}
+		Float const string_build_time = timer.MarkInSeconds();
+
+		std::unordered_map<GfxShaderKey, Uint32, GfxShaderKeyHash> interned_map;
+		for (Uint32 i = 0; i < key_count; ++i) interned_map.emplace(interned_keys[i], i);
+		std::unordered_map<StringShaderKey, Uint32, StringShaderKeyHash> string_map;
+		for (Uint32 i = 0; i < key_count; ++i) string_map.emplace(string_keys[i], i);
+
+		//every key is looked up once through a copy, like a pso desc copy resolving its shaders
+		timer.Mark();
+		Uint32 interned_hits = 0;
+		for (Uint32 i = 0; i < key_count; ++i)
+		{
+			GfxShaderKey const key = interned_keys[i];
+			if (auto it = interned_map.find(key); it != interned_map.end() && it->second == i) ++interned_hits;
+		}
+		Float const interned_lookup_time = timer.MarkInSeconds();
+		Uint32 string_hits = 0;
+		for (Uint32 i = 0; i < key_count; ++i)
+		{
+			StringShaderKey const key = string_keys[i];
+			if (auto it = string_map.find(key); it != string_map.end() && it->second == i) ++string_hits;
+		}
+		Float const string_lookup_time = timer.MarkInSeconds();
+
+		//defines added in a different order have to produce the same key
+		Bool order_independent = true;
+		for (Uint32 i = 0; i < std::min(key_count, 1024u); ++i)
+		{
+			GfxShaderKey key(GetKeyShader(i));
+			for (Int32 bit = define_name_count - 1; bit >= 0; --bit)
+			{
+				if ((i >> bit) & 1) key.AddDefine(define_names[bit], "1");
+			}
+			order_independent &= key == interned_keys[i] && key.GetHash() == interned_keys[i].GetHash();
+		}
+
+		Bool const success = interned_hits == key_count && string_hits == interned_hits && order_independent;
+		ADRIA_LOG(INFO, "Shader key benchmark: %u keys, %zu unique, build interned %.3f ms, string %.3f ms, lookup interned %.3f ms, string %.3f ms, %s",
+			key_count, interned_map.size(), 1000.0f * interned_build_time, 1000.0f * string_build_time, 1000.0f * interned_lookup_time, 1000.0f * string_lookup_time,
+			success ? "lookups match" : "lookups differ");
+		return success;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Builds key_count keys with interned defines and with the previous string based layout, looks every key up through a copy
+	//and logs the build and lookup times, used by the -shaderkeybenchmark command line option
+	Bool BenchmarkShaderKeys(Uint32 key_count);
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include "ShaderPrecompileBenchmark.h"
+#include "Rendering/ShaderManager.h"
+#include "Graphics/GfxShaderKey.h"
+#include "Graphics/GfxShaderCompiler.h"
+#include "Core/ConsoleManager.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	Bool BenchmarkShaderPrecompile()
+	{
+		IConsoleVariable* use_cache_cvar = g_ConsoleManager.FindConsoleVariable("r.Shaders.UseCache");
+		Bool const was_using_cache = use_cache_cvar ? use_cache_cvar->GetBool() : true;
+		if (use_cache_cvar) use_cache_cvar->Set(false);
+
+		std::vector<GfxShaderKey> shader_keys = ShaderManager::GetPrecompileShaderKeys();
+		Bool const has_manifest = !shader_keys.empty();
+		//shaders that need defines to compile fail without them and count as not compiled in both runs
+		if (!has_manifest)
+		{
+			for (Uint32 shader_id = ShaderID_Invalid + 1; shader_id < ShaderId_Count; ++shader_id) shader_keys.emplace_back((ShaderID)shader_id);
+		}
+		Uint64 const shader_count = shader_keys.size();
+
+		//without precompilation every shader is compiled by the thread that first asks for it, one after another
+		Timer timer;
+		std::vector<Uint8> serial_compiled(shader_count);
+		for (Uint64 i = 0; i < shader_count; ++i)
+		{
+			GfxShaderCompileOutput output;
+			serial_compiled[i] = ShaderManager::CompileShaderToOutput(shader_keys[i], output);
+		}
+		Float const serial_time = timer.MarkInSeconds();
+
+		std::vector<Uint8> parallel_compiled(shader_count);
+		g_ThreadPool.ParallelFor(shader_count, 1, [&](Uint64 begin, Uint64 end)
+			{
+				for (Uint64 i = begin; i < end; ++i)
+				{
+					GfxShaderCompileOutput output;
+					parallel_compiled[i] = ShaderManager::CompileShaderToOutput(shader_keys[i], output);
+				}
+			});
+		Float const parallel_time = timer.MarkInSeconds();
+		if (use_cache_cvar) use_cache_cvar->Set(was_using_cache);
+
+		Uint64 const compiled_count = std::count(serial_compiled.begin(), serial_compiled.end(), 1);
+		Bool const results_match = serial_compiled == parallel_compiled;
+		ADRIA_LOG(INFO, "Shader precompile benchmark: %llu shaders %s, %llu compiled, serial %.2f s, parallel on %llu threads %.2f s, results %s",
+			shader_count, has_manifest ? "from the shader manifest" : "without defines", compiled_count, serial_time, g_ThreadPool.GetThreadCount(), parallel_time,
+			results_match ? "match" : "differ");
+		return results_match;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace adria
+{
+	//Compiles the precompile shader list, or every shader without defines if there is no shader manifest, once on the calling thread
+	//and once on the thread pool with the shader cache disabled, like a first start, and logs both times.
+	//Used by the -shaderprecompilebenchmark command line option
+	Bool BenchmarkShaderPrecompile();
+}
@@ -0,0 +1,174 @@
+#include <condition_variable>
+#include "ThreadPoolBenchmark.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 BENCHMARK_CHUNK_SIZE = 1024;
+
+		//the pool before the job system: type erased tasks in one queue behind a mutex, idle workers wait on a condition variable
+		class MutexThreadPool
+		{
+		public:
+			explicit MutexThreadPool(Uint64 thread_count)
+			{
+				for (Uint64 i = 0; i < thread_count; ++i) threads.emplace_back(&MutexThreadPool::ThreadWork, this);
+			}
+			~MutexThreadPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					done = true;
+				}
+				cond_var.notify_all();
+				for (std::thread& thread : threads) thread.join();
+			}
+
+			template<typename F>
+			std::future<void> Submit(F&& f)
+			{
+				auto task = std::make_shared<std::packaged_task<void()>>(std::forward<F>(f));
+				std::future<void> future = task->get_future();
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					tasks.push([task]() { (*task)(); });
+				}
+				cond_var.notify_one();
+				return future;
+			}
+
+		private:
+			std::vector<std::thread> threads;
+			std::queue<std::function<void()>> tasks;
+			std::mutex mutex;
+			std::condition_variable cond_var;
+			Bool done = false;
+
+		private:
+			void ThreadWork()
+			{
+				while (true)
+				{
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						cond_var.wait(lock, [this]() { return done || !tasks.empty(); });
+						if (done && tasks.empty()) return;
+						task = std::move(tasks.front());
+						tasks.pop();
+					}
+					task();
+				}
+			}
+		};
+
+		struct JobTree
+		{
+			std::atomic<Uint64> leaf_count = 0;
+			Uint32 depth;
+		};
+
+		void SpawnJobTree(JobTree& tree, Uint32 level, JobCounter& counter)
+		{
+			if (level == tree.depth)
+			{
+				tree.leaf_count.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			for (Uint32 i = 0; i < 2; ++i) g_ThreadPool.Run([&tree, level, &counter]() { SpawnJobTree(tree, level + 1, counter); }, &counter);
+		}
+
+		void SpawnJobTree(JobTree& tree, Uint32 level, MutexThreadPool& pool)
+		{
+			if (level == tree.depth)
+			{
+				tree.leaf_count.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			for (Uint32 i = 0; i < 2; ++i) std::ignore = pool.Submit([&tree, level, &pool]() { SpawnJobTree(tree, level + 1, pool); });
+		}
+
+		Float ParallelForWork(std::vector<Float>& values, Uint64 begin, Uint64 end)
+		{
+			Float sum = 0.0f;
+			for (Uint64 i = begin; i < end; ++i)
+			{
+				values[i] = std::sqrt((Float)i);
+				sum += values[i];
+			}
+			return sum;
+		}
+	}
+
+	Bool BenchmarkThreadPool(Uint32 job_count)
+	{
+		//binary trees where every job starts its two children, declared before the mutex pool so that they outlive its workers
+		Uint32 const tree_depth = (Uint32)std::log2(std::max(job_count, 2u));
+		JobTree job_system_tree{ .depth = tree_depth };
+		JobTree mutex_pool_tree{ .depth = tree_depth };
+
+		//the calling thread only waits on the mutex pool, so it gets a worker even when the job system has none
+		MutexThreadPool mutex_pool(std::max<Uint64>(g_ThreadPool.GetThreadCount() - 1, 1));
+		Timer timer;
+		Bool success = true;
+
+		std::atomic<Uint64> executed_jobs = 0;
+		{
+			JobCounter counter;
+			timer.Mark();
+			for (Uint32 i = 0; i < job_count; ++i) g_ThreadPool.Run([&executed_jobs]() { executed_jobs.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			g_ThreadPool.Wait(counter);
+		}
+		Float const job_system_empty_time = timer.MarkInSeconds();
+		{
+			std::vector<std::future<void>> futures;
+			futures.reserve(job_count);
+			timer.Mark();
+			for (Uint32 i = 0; i < job_count; ++i) futures.push_back(mutex_pool.Submit([&executed_jobs]() { executed_jobs.fetch_add(1, std::memory_order_relaxed); }));
+			for (std::future<void>& future : futures) future.wait();
+		}
+		Float const mutex_pool_empty_time = timer.MarkInSeconds();
+		success &= executed_jobs == 2ull * job_count;
+
+		{
+			JobCounter counter;
+			timer.Mark();
+			SpawnJobTree(job_system_tree, 0, counter);
+			g_ThreadPool.Wait(counter);
+		}
+		Float const job_system_tree_time = timer.MarkInSeconds();
+		timer.Mark();
+		SpawnJobTree(mutex_pool_tree, 0, mutex_pool);
+		while (mutex_pool_tree.leaf_count.load() < (1ull << tree_depth)) std::this_thread::yield();
+		Float const mutex_pool_tree_time = timer.MarkInSeconds();
+		success &= job_system_tree.leaf_count == (1ull << tree_depth) && mutex_pool_tree.leaf_count == (1ull << tree_depth);
+
+		Uint64 const value_count = (Uint64)job_count * BENCHMARK_CHUNK_SIZE / 16;
+		std::vector<Float> values(value_count);
+		Uint64 const chunk_count = (value_count + BENCHMARK_CHUNK_SIZE - 1) / BENCHMARK_CHUNK_SIZE;
+		std::vector<Float> job_system_sums(chunk_count), mutex_pool_sums(chunk_count);
+		timer.Mark();
+		g_ThreadPool.ParallelFor(value_count, BENCHMARK_CHUNK_SIZE, [&](Uint64 begin, Uint64 end) { job_system_sums[begin / BENCHMARK_CHUNK_SIZE] = ParallelForWork(values, begin, end); });
+		Float const job_system_parallel_for_time = timer.MarkInSeconds();
+		{
+			std::vector<std::future<void>> futures;
+			for (Uint64 begin = 0; begin < value_count; begin += BENCHMARK_CHUNK_SIZE)
+			{
+				futures.push_back(mutex_pool.Submit([&, begin]() { mutex_pool_sums[begin / BENCHMARK_CHUNK_SIZE] = ParallelForWork(values, begin, std::min(begin + BENCHMARK_CHUNK_SIZE, value_count)); }));
+			}
+			for (std::future<void>& future : futures) future.wait();
+		}
+		Float const mutex_pool_parallel_for_time = timer.MarkInSeconds();
+		success &= job_system_sums == mutex_pool_sums;
+
+		ADRIA_LOG(INFO, "Thread pool benchmark on %llu threads: %u empty jobs %.3f ms (mutex pool %.3f ms), job tree with %llu leaves %.3f ms (mutex pool %.3f ms), parallel for over %llu chunks %.3f ms (mutex pool %.3f ms), %s",
+			g_ThreadPool.GetThreadCount(), job_count, 1000.0f * job_system_empty_time, 1000.0f * mutex_pool_empty_time,
+			1ull << tree_depth, 1000.0f * job_system_tree_time, 1000.0f * mutex_pool_tree_time,
+			chunk_count, 1000.0f * job_system_parallel_for_time, 1000.0f * mutex_pool_parallel_for_time, success ? "every job ran" : "jobs are missing");
+		return success;
+	}
+}
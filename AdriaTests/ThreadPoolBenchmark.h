@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Times empty jobs, job trees and a parallel for on g_ThreadPool and on a mutex and condition variable pool with one shared queue
+	//like the one it replaced, and checks that every job ran, used by the -threadpoolbenchmark command line option
+	Bool BenchmarkThreadPool(Uint32 job_count);
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include "VertexCompressionTest.h"
+#include "Math/Packing.h"
+#include "Utilities/Random.h"
+#include "Logging/Logger.h"
+
+namespace adria
+{
+	namespace
+	{
+		Float GetAngleInDegrees(Vector3 const& a, Vector3 const& b)
+		{
+			return DirectX::XMConvertToDegrees(std::atan2(a.Cross(b).Length(), a.Dot(b)));
+		}
+	}
+
+	Bool TestVertexCompression(Uint32 sample_count)
+	{
+		RealRandomGenerator random(-1.0f, 1.0f, std::mt19937{ 0 });
+		Float max_position_error = 0.0f;
+		Float max_uv_error = 0.0f;
+		Float max_normal_error = 0.0f;
+		Float max_tangent_error = 0.0f;
+		Uint32 tangent_sign_errors = 0;
+		for (Uint32 i = 0; i < sample_count; ++i)
+		{
+			//position error relative to the quantization step, uv error relative to the precision of half floats at that value
+			Vector3 const center(random() * 10.0f, random() * 10.0f, random() * 10.0f);
+			Vector3 const extents(50.0f + random() * 49.0f, 50.0f + random() * 49.0f, 50.0f + random() * 49.0f);
+			Vector3 const position = center + Vector3(random(), random(), random()) * extents;
+			Vector3 const position_error = UnpackPositionSnorm16x4(PackPositionSnorm16x4(position, center, extents), center, extents) - position;
+			max_position_error = std::max({ max_position_error, std::abs(position_error.x) / extents.x, std::abs(position_error.y) / extents.y,
+											std::abs(position_error.z) / extents.z });
+
+			Vector3 direction(random(), random(), random());
+			if (direction.LengthSquared() < 1e-6f) continue;
+			direction.Normalize();
+			max_normal_error = std::max(max_normal_error, GetAngleInDegrees(direction, UnpackNormalOctahedron16x2(PackNormalOctahedron16x2(direction))));
+
+			Float const tangent_sign = random() < 0.0f ? -1.0f : 1.0f;
+			Vector4 const tangent = UnpackTangentOctahedron16x15(PackTangentOctahedron16x15(Vector4(direction.x, direction.y, direction.z, tangent_sign)));
+			max_tangent_error = std::max(max_tangent_error, GetAngleInDegrees(direction, Vector3(tangent.x, tangent.y, tangent.z)));
+			if (tangent.w != tangent_sign) ++tangent_sign_errors;
+
+			Vector2 const uv(random() * 8.0f, random() * 8.0f);
+			Vector2 const uv_error = UnpackTwoFloatsFromUint32(PackTwoFloatsToUint32(uv.x, uv.y)) - uv;
+			max_uv_error = std::max({ max_uv_error, std::abs(uv_error.x) / std::max(std::abs(uv.x), 1.0f / 16384.0f),
+									  std::abs(uv_error.y) / std::max(std::abs(uv.y), 1.0f / 16384.0f) });
+		}
+
+		Bool const success = max_position_error <= 1.0f / 32767.0f && max_normal_error <= 0.05f && max_tangent_error <= 0.05f &&
+							 tangent_sign_errors == 0 && max_uv_error <= 1.0f / 2048.0f;
+		ADRIA_LOG(INFO, "Vertex compression round trip of %u samples %s: position %.2f steps, normal %.4f deg, tangent %.4f deg, %u tangent signs, uv %.2e relative",
+			sample_count, success ? "passed" : "failed", max_position_error * 32767.0f, max_normal_error, max_tangent_error, tangent_sign_errors, max_uv_error);
+		return success;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace adria
+{
+	//Encodes and decodes random vertices with the compressed vertex format and checks the errors against the precision of each encoding,
+	//used by the -vertexcompressiontest command line option
+	Bool TestVertexCompression(Uint32 sample_count);
+}
@@ -0,0 +1,142 @@
+#include "Logging/FileLogger.h"
+#include "Logging/OutputStreamLogger.h"
+#include "Utilities/CLIParser.h"
+#include "Utilities/ThreadPool.h"
+#include "Graphics/GfxShaderCompiler.h"
+#include "RenderGraphValidation.h"
+#include "SceneInstanceBenchmark.h"
+#include "FrustumCullingBenchmark.h"
+#include "ThreadPoolBenchmark.h"
+#include "ConcurrentQueueBenchmark.h"
+#include "LoggerBenchmark.h"
+#include "GBufferSubmissionBenchmark.h"
+#include "ShaderKeyBenchmark.h"
+#include "ShaderPrecompileBenchmark.h"
+#include "FileWatcherBenchmark.h"
+#include "SceneCookBenchmark.h"
+#include "VertexCompressionTest.h"
+
+using namespace adria;
+
+//Benchmarks and validation checks of engine systems that run without a window or a device.
+//Each mode runs one of them and the exit code is 0 when it passes.
+int wmain(int argc, wchar_t** argv)
+{
+	CLIParser cli_parser{};
+	{
+		cli_parser.AddArg(true, "-log", "--logfile");
+		cli_parser.AddArg(true, "-loglvl", "--loglevel");
+		cli_parser.AddArg(true, "-rgcompilebenchmark");
+		cli_parser.AddArg(true, "-rgdependencytest");
+		cli_parser.AddArg(true, "-rgrecordingtest");
+		cli_parser.AddArg(false, "-rgbarriertest");
+		cli_parser.AddArg(true, "-rgpasses");
+		cli_parser.AddArg(true, "-rgpooltrace");
+		cli_parser.AddArg(true, "-sceneinstancebenchmark");
+		cli_parser.AddArg(true, "-instances");
+		cli_parser.AddArg(true, "-cullingbenchmark");
+		cli_parser.AddArg(true, "-threadpoolbenchmark");
+		cli_parser.AddArg(true, "-queuebenchmark");
+		cli_parser.AddArg(true, "-producers");
+		cli_parser.AddArg(true, "-consumers");
+		cli_parser.AddArg(true, "-logbenchmark");
+		cli_parser.AddArg(true, "-gbuffersubmissionbenchmark");
+		cli_parser.AddArg(true, "-shaderkeybenchmark");
+		cli_parser.AddArg(false, "-shaderprecompilebenchmark");
+		cli_parser.AddArg(true, "-filewatcherbenchmark");
+		cli_parser.AddArg(true, "-cookbenchmark");
+		cli_parser.AddArg(true, "-scene", "--scenefile");
+		cli_parser.AddArg(true, "-vertexcompressiontest");
+	}
+	CLIParseResult cli_result = cli_parser.Parse(argc, argv);
+
+	std::string log_file = cli_result["-log"].AsStringOr("adria_tests.log");
+	LogLevel log_level = static_cast<LogLevel>(cli_result["-loglvl"].AsIntOr(0));
+	g_Log.Register(new FileLogger(log_file.c_str(), log_level));
+	g_Log.Register(new OutputStreamLogger(false, log_level));
+
+	if (cli_result["-rgcompilebenchmark"])
+	{
+		return BenchmarkRenderGraphCompile((Uint32)cli_result["-rgpasses"].AsIntOr(256), (Uint32)cli_result["-rgcompilebenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-rgdependencytest"])
+	{
+		return ValidateRenderGraphDependencies((Uint32)cli_result["-rgdependencytest"].AsInt(), (Uint32)cli_result["-rgpasses"].AsIntOr(256)) ? 0 : 1;
+	}
+	if (cli_result["-rgrecordingtest"])
+	{
+		g_ThreadPool.Initialize();
+		Bool const success = ValidateRenderGraphRecording((Uint32)cli_result["-rgrecordingtest"].AsInt(), (Uint32)cli_result["-rgpasses"].AsIntOr(256));
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
+	if (cli_result["-rgbarriertest"])
+	{
+		return ValidateRenderGraphBarriers() ? 0 : 1;
+	}
+	if (cli_result["-rgpooltrace"])
+	{
+		return ValidateRenderGraphPoolTrace(cli_result["-rgpooltrace"].AsString()) ? 0 : 1;
+	}
+	if (cli_result["-sceneinstancebenchmark"])
+	{
+		g_ThreadPool.Initialize();
+		Bool const success = BenchmarkSceneInstances((Uint32)cli_result["-instances"].AsIntOr(100000), (Uint32)cli_result["-sceneinstancebenchmark"].AsInt());
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
+	if (cli_result["-cullingbenchmark"])
+	{
+		return BenchmarkFrustumCulling((Uint32)cli_result["-instances"].AsIntOr(100000), (Uint32)cli_result["-cullingbenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-threadpoolbenchmark"])
+	{
+		g_ThreadPool.Initialize();
+		Bool const success = BenchmarkThreadPool((Uint32)cli_result["-threadpoolbenchmark"].AsInt());
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
+	if (cli_result["-queuebenchmark"])
+	{
+		return BenchmarkConcurrentQueue((Uint32)cli_result["-queuebenchmark"].AsInt(), (Uint32)cli_result["-producers"].AsIntOr(4), (Uint32)cli_result["-consumers"].AsIntOr(4)) ? 0 : 1;
+	}
+	if (cli_result["-logbenchmark"])
+	{
+		return BenchmarkLogger((Uint32)cli_result["-logbenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-gbuffersubmissionbenchmark"])
+	{
+		return BenchmarkGBufferSubmission((Uint32)cli_result["-instances"].AsIntOr(50000), (Uint32)cli_result["-gbuffersubmissionbenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-shaderkeybenchmark"])
+	{
+		return BenchmarkShaderKeys((Uint32)cli_result["-shaderkeybenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-shaderprecompilebenchmark"])
+	{
+		g_ThreadPool.Initialize();
+		GfxShaderCompiler::Initialize();
+		Bool const success = BenchmarkShaderPrecompile();
+		GfxShaderCompiler::Destroy();
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
+	if (cli_result["-filewatcherbenchmark"])
+	{
+		return BenchmarkFileWatcher((Uint32)cli_result["-filewatcherbenchmark"].AsInt()) ? 0 : 1;
+	}
+	if (cli_result["-cookbenchmark"])
+	{
+		g_ThreadPool.Initialize();
+		Bool const success = BenchmarkSceneCook(cli_result["-scene"].AsStringOr("sponza.json"), (Uint32)cli_result["-cookbenchmark"].AsInt());
+		g_ThreadPool.Destroy();
+		return success ? 0 : 1;
+	}
+	if (cli_result["-vertexcompressiontest"])
+	{
+		return TestVertexCompression((Uint32)cli_result["-vertexcompressiontest"].AsInt()) ? 0 : 1;
+	}
+
+	ADRIA_LOG(ERROR, "No test mode was given, the modes are listed in AdriaTests/main.cpp");
+	return 1;
+}